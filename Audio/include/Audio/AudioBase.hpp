@@ -1,4 +1,5 @@
 #pragma once
+#include <Shared/LockFreeQueue.hpp>
 
 /*
 	Base class for Digital Signal Processors
@@ -11,11 +12,22 @@ public:
 	virtual ~DSP();
 	// Process <numSamples> amount of samples in stereo float format
 	virtual void Process(float* out, uint32 numSamples) = 0;
+	// Clears the processing state, so the DSP can be reused
+	virtual void Reset() {}
+	// Allocates buffers for lengths up to <length> in ms, so setting the length later doesn't allocate memory
+	virtual void SetMaxLength(uint32 length) {}
+
+	// True while there are add/remove commands for this DSP that the audio thread hasn't processed yet
+	bool IsQueued() const
+	{
+		return queuedCommands.load(std::memory_order_acquire) != 0;
+	}
 
 	float mix = 1.0f;
 	uint32 priority = 0;
 	class AudioBase* audioBase = nullptr;
 	class Audio_Impl* audio = nullptr;
+	std::atomic<uint32> queuedCommands{0};
 };
 
 /*
@@ -24,6 +36,7 @@ public:
 class AudioBase
 {
 public:
+	AudioBase();
 	virtual ~AudioBase();
 	// Process <numSamples> amount of samples in stereo float format
 	virtual void Process(float* out, uint32 numSamples) = 0;
@@ -33,6 +46,15 @@ public:
 	// Removes a signal processor from the audio
 	void RemoveDSP(DSP* dsp);
 
+	// Adds or removes a signal processor on the audio thread, without locking
+	//	the DSP is still used by the audio thread until DSP::IsQueued returns false
+	void QueueAddDSP(DSP* dsp);
+	void QueueRemoveDSP(DSP* dsp);
+	// Applies the queued DSP commands, called by the audio thread before processing
+	void ApplyDSPCommands();
+	// Applies the queued DSP commands from another thread
+	void FlushDSPCommands();
+
 	void Deregister();
 
 	// Stream volume from 0-1
@@ -48,5 +70,14 @@ public:
 	Vector<DSP*> DSPs;
 	class Audio_Impl* audio = nullptr;
 private:
+	struct DSPCommand
+	{
+		DSP* dsp;
+		bool add;
+	};
+	void m_QueueDSPCommand(DSP* dsp, bool add);
+	void m_InsertDSP(DSP* dsp);
+
 	float m_volume = 1.0f;
+	LockFreeQueue<DSPCommand> m_dspCommands;
 };
\ No newline at end of file
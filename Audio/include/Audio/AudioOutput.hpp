@@ -19,7 +19,7 @@ public:
 
 	// Safe to start mixing
 	void Start(IMixer* mixer);
-	// Should stop mixing
+	// Stops mixing, the mixer isn't called anymore once this returns
 	void Stop();
 
 	uint32_t GetNumChannels() const;
@@ -27,6 +27,7 @@ public:
 	float a2 = 0.0f;
 
 	virtual void Process(float* out, uint32 numSamples);
+	virtual void Reset();
 
 	// Sets the filter parameters
 	void SetPeaking(float q, float freq, float gain);
@@ -40,9 +41,9 @@ private:
 	// Delayed samples
 	static const uint32 order = 2;
 	// FIR Delay buffers
-	float zb[2][order];
+	float zb[2][order] = { { 0.0f } };
 	// IIR Delay buffers
-	float za[2][order];
+	float za[2][order] = { { 0.0f } };
 };
 
 // Combinded Low/High-pass and Peaking filter
@@ -53,6 +54,7 @@ public:
 	void SetHighPass(float q, float freq, float peakQ, float peakGain);
 
 	virtual void Process(float* out, uint32 numSamples);
+	virtual void Reset();
 private:
 	BQFDSP a;
 	BQFDSP peak;
@@ -75,6 +77,7 @@ public:
 	// Duration of samples, <1 = disable
 	void SetPeriod(float period = 0);
 	virtual void Process(float* out, uint32 numSamples);
+	virtual void Reset();
 private:
 	uint32 m_period = 1;
 	uint32 m_increment = 0;
@@ -93,6 +96,7 @@ public:
 	float low = 0.1f;
 
 	virtual void Process(float* out, uint32 numSamples);
+	virtual void Reset();
 private:
 	float m_gating = 0.75f;
 	uint32 m_length = 0;
@@ -106,8 +110,10 @@ class TapeStopDSP : public DSP
 {
 public:
 	void SetLength(uint32 length);
+	virtual void SetMaxLength(uint32 length);
 
 	virtual void Process(float* out, uint32 numSamples);
+	virtual void Reset();
 private:
 	uint32 m_length = 0;
 	Vector<float> m_sampleBuffer;
@@ -122,9 +128,10 @@ public:
 	void SetLength(uint32 length);
 	void SetResetDuration(uint32 resetDuration);
 	void SetGating(float gating);
-	void SetMaxLength(uint32 length);
+	virtual void SetMaxLength(uint32 length);
 
 	virtual void Process(float* out, uint32 numSamples);
+	virtual void Reset();
 private:
 	float m_gating = 0.75f;
 	uint32 m_length = 0;
@@ -133,7 +140,6 @@ private:
 	Vector<float> m_sampleBuffer;
 	uint32 m_loops = 0;
 	uint32 m_currentSample = 0;
-	bool m_bufferReserved = false;
 };
 
 class WobbleDSP : public BQFDSP
@@ -147,6 +153,7 @@ public:
 	float q = 1.414f;
 
 	virtual void Process(float* out, uint32 numSamples);
+	virtual void Reset();
 private:
 	uint32 m_length;
 	uint32 m_currentSample = 0;
@@ -167,6 +174,7 @@ public:
 	void SetLength(uint32 length);
 
 	virtual void Process(float* out, uint32 numSamples);
+	virtual void Reset();
 
 private:
 	uint32 m_length = 0;
@@ -187,9 +195,11 @@ class FlangerDSP : public DSP
 {
 public:
 	void SetLength(uint32 length);
+	// Delay range in samples at 44100hz, the buffer only grows so setting the largest range first preallocates it
 	void SetDelayRange(uint32 min, uint32 max);
 
 	virtual void Process(float* out, uint32 numSamples);
+	virtual void Reset();
 private:
 	uint32 m_length = 0;
 
@@ -207,10 +217,12 @@ class EchoDSP : public DSP
 {
 public:
 	void SetLength(uint32 length);
+	virtual void SetMaxLength(uint32 length);
 
 	float feedback = 0.6f;
 
 	virtual void Process(float* out, uint32 numSamples);
+	virtual void Reset();
 private:
 	uint32 m_bufferLength = 0;
 	size_t m_bufferOffset = 0;
@@ -231,6 +243,7 @@ public:
 	Interpolation::CubicBezier curve;
 
 	virtual void Process(float* out, uint32 numSamples);
+	virtual void Reset();
 private:
 	uint32 m_length = 0;
 	size_t m_time = 0;
@@ -246,6 +259,7 @@ public:
 	~PitchShiftDSP();
 
 	virtual void Process(float* out, uint32 numSamples);
+	virtual void Reset();
 private:
 	class PitchShiftDSP_Impl* m_impl;
 };
\ No newline at end of file
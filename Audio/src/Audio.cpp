@@ -4,12 +4,17 @@
 #include "Audio_Impl.hpp"
 #include "AudioOutput.hpp"
 #include "DSP.hpp"
+#include <Shared/Profiler.hpp>
 
 Audio* g_audio = nullptr;
 Audio_Impl impl;
 
 void Audio_Impl::Mix(float* data, uint32& numSamples)
 {
+	// Called from the audio device's thread
+	Profiler::SetThreadName("Audio");
+	PROFILE_ZONE("Audio::Mix");
+
 #if _DEBUG
 	static const uint32 guardBand = 1024;
 #else
@@ -47,6 +52,7 @@ void Audio_Impl::Mix(float* data, uint32& numSamples)
 					assert(guardBuffer[i] == 0);
 				}
 #endif
+				item->ApplyDSPCommands();
 				item->ProcessDSPs(tempData, m_sampleBufferLength);
 #if _DEBUG
 				// Check for memory corruption
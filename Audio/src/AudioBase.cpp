@@ -9,6 +9,14 @@ DSP::~DSP()
 	assert(!audioBase);
 }
 
+// Number of DSPs that can be added before the DSP list needs to grow
+static const uint32 dspCapacity = 32;
+static const uint32 dspCommandCapacity = 64;
+
+AudioBase::AudioBase() : m_dspCommands(dspCommandCapacity)
+{
+	DSPs.reserve(dspCapacity);
+}
 AudioBase::~AudioBase()
 {
 	// Check this to make sure the audio is not being destroyed while it is still registered
@@ -25,14 +33,8 @@ void AudioBase::ProcessDSPs(float*& out, uint32 numSamples)
 void AudioBase::AddDSP(DSP* dsp)
 {
 	audio->lock.lock();
-	DSPs.AddUnique(dsp);
-	// Sort by priority
-	DSPs.Sort([](DSP* l, DSP* r)
-	{
-		if(l->priority == r->priority)
-			return l < r;
-		return l->priority < r->priority;
-	});
+	if(!DSPs.Contains(dsp))
+		m_InsertDSP(dsp);
 	dsp->audioBase = this;
 	dsp->audio = audio;
 	audio->lock.unlock();
@@ -47,6 +49,70 @@ void AudioBase::RemoveDSP(DSP* dsp)
 	audio->lock.unlock();
 }
 
+void AudioBase::QueueAddDSP(DSP* dsp)
+{
+	m_QueueDSPCommand(dsp, true);
+}
+void AudioBase::QueueRemoveDSP(DSP* dsp)
+{
+	m_QueueDSPCommand(dsp, false);
+}
+void AudioBase::ApplyDSPCommands()
+{
+	DSPCommand command;
+	while(m_dspCommands.Pop(command))
+	{
+		DSP* dsp = command.dsp;
+		if(command.add)
+		{
+			if(!DSPs.Contains(dsp))
+				m_InsertDSP(dsp);
+			dsp->audioBase = this;
+		}
+		else
+		{
+			DSPs.Remove(dsp);
+			dsp->audioBase = nullptr;
+		}
+		// The DSP is no longer touched after this
+		dsp->queuedCommands.fetch_sub(1, std::memory_order_release);
+	}
+}
+void AudioBase::FlushDSPCommands()
+{
+	if(audio)
+	{
+		audio->lock.lock();
+		ApplyDSPCommands();
+		audio->lock.unlock();
+	}
+	else
+	{
+		// Not being rendered
+		ApplyDSPCommands();
+	}
+}
+void AudioBase::m_QueueDSPCommand(DSP* dsp, bool add)
+{
+	dsp->queuedCommands.fetch_add(1, std::memory_order_relaxed);
+	while(!m_dspCommands.Push({ dsp, add }))
+	{
+		// Only happens when a lot of DSPs are changed while the audio thread is not running
+		FlushDSPCommands();
+	}
+}
+void AudioBase::m_InsertDSP(DSP* dsp)
+{
+	// Sorted by priority
+	auto it = DSPs.begin();
+	for(; it != DSPs.end(); it++)
+	{
+		if((*it)->priority > dsp->priority || ((*it)->priority == dsp->priority && *it > dsp))
+			break;
+	}
+	DSPs.insert(it, dsp);
+}
+
 void AudioBase::Deregister()
 {
 	// Remove from audio manager
@@ -57,6 +123,7 @@ void AudioBase::Deregister()
 
 	// Unbind DSP's
 	// It is safe to do here since the audio won't be rendered again after a call to deregister
+	ApplyDSPCommands();
 	for(DSP* dsp : DSPs)
 	{
 		dsp->audioBase = nullptr;
@@ -137,10 +137,15 @@ double AudioOutput::GetBufferLength() const
 }
 void AudioOutput::Start(IMixer* mixer)
 {
+	SDL_LockAudioDevice(m_impl->m_deviceId);
 	m_impl->m_mixer = mixer;
+	SDL_UnlockAudioDevice(m_impl->m_deviceId);
 }
 void AudioOutput::Stop()
 {
+	// Locking the device waits for a running callback to finish
+	SDL_LockAudioDevice(m_impl->m_deviceId);
 	m_impl->m_mixer = nullptr;
+	SDL_UnlockAudioDevice(m_impl->m_deviceId);
 }
 #endif
@@ -5,17 +5,36 @@ extern "C"
 	#include "minimp3.h"
 }
 
+// Sidecar file that stores the seek index of an mp3 file
+static const uint32 seekIndexMagic = 0x4B455353; // "SSEK"
+static const uint32 seekIndexVersion = 1;
+// Number of frames between seek index entries
+static const uint32 seekIndexInterval = 16;
+
 class AudioStreamMP3_Impl : public AudioStreamBase
 {
-	mp3_decoder_t* m_decoder;
+	mp3_decoder_t* m_decoder = nullptr;
 	size_t m_mp3dataOffset = 0;
 	size_t m_mp3dataLength = 0;
 	int32 m_mp3samplePosition = 0;
 	int32 m_samplingRate = 0;
 	uint8* m_dataSource = 0;
 
-	Map<int32, size_t> m_frameIndices;
-	uint32 m_largetsFrameIndex;
+	// Every Nth frame's position, sorted by sample position
+	struct SeekPoint
+	{
+		int32 sample;
+		uint32 offset;
+	};
+	Vector<SeekPoint> m_seekIndex;
+	// The index is extended when frames past the scanned part are decoded or seeked to
+	size_t m_scanOffset = 0;
+	int32 m_scanSample = 0;
+	uint32 m_numScannedFrames = 0;
+	bool m_indexComplete = false;
+	bool m_indexLoaded = false;
+	String m_indexPath;
+	uint64 m_lastWriteTime = 0;
 
 	bool m_firstFrame = true;
 
@@ -42,11 +61,120 @@ class AudioStreamMP3_Impl : public AudioStreamBase
 
 	}
 
+	// Finds the next frame header at or after offset
+	//	returns false at the end of the data or when the header is invalid
+	bool m_ReadFrameHeader(size_t& offset, uint32& frameLength, uint32& frameSamples) const
+	{
+		for(; offset + 4 <= m_mp3dataLength; offset++)
+		{
+			const uint8* header = m_dataSource + offset;
+			if(header[0] != 0xFF || (header[1] & 0xE0) != 0xE0) // Frame Sync
+				continue;
+
+			uint8 version = (header[1] & 0x18) >> 3;
+			uint8 bitrateIndex = (header[2] & 0xF0) >> 4;
+			uint8 rateIndex = (header[2] & 0x0C) >> 2;
+			bool paddingEnabled = ((header[2] & 0x02) >> 1) != 0;
+			if(bitrateIndex == 0xF || rateIndex > 2) // bad
+				return false;
+
+			uint32 linearVersion = version == 0x03 ? 0 : 1; // Version 1/2
+			uint32 bitrate = mp3_bitrate_tab[linearVersion][bitrateIndex] * 1000;
+			uint32 sampleRate = mp3_freq_tab[rateIndex];
+			uint32 padding = paddingEnabled ? 1 : 0;
+
+			frameLength = 144 * bitrate / sampleRate + padding;
+			if(frameLength == 0)
+				return false;
+			frameSamples = (linearVersion == 0) ? 1152 : 576;
+			return true;
+		}
+		return false;
+	}
+	// Adds the next frame after the scanned part to the seek index
+	bool m_ScanFrame()
+	{
+		if(m_indexComplete)
+			return false;
+
+		size_t offset = m_scanOffset;
+		uint32 frameLength, frameSamples;
+		if(!m_ReadFrameHeader(offset, frameLength, frameSamples))
+		{
+			m_indexComplete = true;
+			m_samplesTotal = m_scanSample;
+			return false;
+		}
+		if(m_numScannedFrames % seekIndexInterval == 0)
+			m_seekIndex.Add({ m_scanSample, (uint32)offset });
+		m_numScannedFrames++;
+		m_scanSample += frameSamples;
+		m_scanOffset = offset + frameLength;
+		return true;
+	}
+
+	bool m_LoadSeekIndex()
+	{
+		if(!Path::FileExists(m_indexPath))
+			return false;
+		File file;
+		if(!file.OpenRead(m_indexPath))
+			return false;
+
+		uint32 magic = 0, version = 0, interval = 0, count = 0;
+		uint64 dataLength = 0, lastWriteTime = 0;
+		int64 samplesTotal = 0;
+		file.Read(&magic, sizeof(magic));
+		file.Read(&version, sizeof(version));
+		file.Read(&dataLength, sizeof(dataLength));
+		file.Read(&lastWriteTime, sizeof(lastWriteTime));
+		file.Read(&samplesTotal, sizeof(samplesTotal));
+		file.Read(&interval, sizeof(interval));
+		file.Read(&count, sizeof(count));
+		if(magic != seekIndexMagic || version != seekIndexVersion || interval != seekIndexInterval)
+			return false;
+		// Index of a different version of the file
+		if(dataLength != m_mp3dataLength || lastWriteTime != m_lastWriteTime)
+			return false;
+		if(count == 0 || file.Tell() + count * sizeof(SeekPoint) != file.GetSize())
+			return false;
+
+		m_seekIndex.resize(count);
+		file.Read(m_seekIndex.data(), count * sizeof(SeekPoint));
+		m_samplesTotal = samplesTotal;
+		m_indexComplete = true;
+		m_indexLoaded = true;
+		return true;
+	}
+	void m_SaveSeekIndex()
+	{
+		File file;
+		if(!file.OpenWrite(m_indexPath))
+			return;
+
+		uint32 count = (uint32)m_seekIndex.size();
+		uint64 dataLength = m_mp3dataLength;
+		int64 samplesTotal = m_samplesTotal;
+		file.Write(&seekIndexMagic, sizeof(seekIndexMagic));
+		file.Write(&seekIndexVersion, sizeof(seekIndexVersion));
+		file.Write(&dataLength, sizeof(dataLength));
+		file.Write(&m_lastWriteTime, sizeof(m_lastWriteTime));
+		file.Write(&samplesTotal, sizeof(samplesTotal));
+		file.Write(&seekIndexInterval, sizeof(seekIndexInterval));
+		file.Write(&count, sizeof(count));
+		file.Write(m_seekIndex.data(), count * sizeof(SeekPoint));
+	}
+
 public:
 	~AudioStreamMP3_Impl()
 	{
 		Deregister();
-		mp3_done(m_decoder);
+		if(m_decoder)
+			mp3_done(m_decoder);
+
+		// Store the index once all frames are scanned, so the next time the file is opened it doesn't need to be scanned again
+		if(m_indexComplete && !m_indexLoaded && !m_seekIndex.empty())
+			m_SaveSeekIndex();
 	}
 	bool Init(Audio* audio, const String& path, bool preload)
 	{
@@ -69,67 +197,24 @@ public:
 			/// TODO: Check if tag has footer and add another 10 to the size
 			tagSize = m_unsynchsafe(m_toLittleEndian(*(int32*)(m_dataSource + 6))) + 10;
 		}
-		// Scan MP3 frame offsets
-		uint32 sampleOffset = 0;
-		for(size_t i = tagSize; i < m_mp3dataLength;)
+		// Use the stored seek index if there is one, otherwise the index is built while the stream is decoded
+		m_indexPath = path + ".seekindex";
+		m_lastWriteTime = File::GetLastWriteTime(path);
+		if(!m_LoadSeekIndex())
 		{
-			if(m_dataSource[i] == 0xFF)
+			m_seekIndex.clear();
+			m_scanOffset = tagSize;
+			// Not known until all frames are scanned
+			m_samplesTotal = INT64_MAX;
+			if(!m_ScanFrame())
 			{
-				if(i + 1 > m_mp3dataLength)
-					continue;
-				if((m_dataSource[i + 1] & 0xE0) == 0xE0) // Frame Sync
-				{
-					uint8 version = (m_dataSource[i+1] & 0x18) >> 3;
-					uint8 layer = (m_dataSource[i + 1] & 0x06) >> 1;
-					bool crc = (m_dataSource[i + 1] & 0x01) != 0;
-					uint8 bitrateIndex = (m_dataSource[i + 2] & 0xF0) >> 4;
-					uint8 rateIndex = (m_dataSource[i + 2] & 0x0C) >> 2;
-					bool paddingEnabled = ((m_dataSource[i + 2] & 0x02) >> 1) != 0;
-					uint8 channelFlags = ((m_dataSource[i + 3] & 0xC0) >> 6);
-					if(bitrateIndex == 0xF || rateIndex > 2) // bad
-					{
-						return false;
-						i++;
-						continue;
-					}
-
-					uint8 channels = ((channelFlags & 0x3) == 0x3) ? 1 : 2;
-
-					uint32 linearVersion = version == 0x03 ? 0 : 1; // Version 1/2
-					uint32 bitrate = mp3_bitrate_tab[linearVersion][bitrateIndex] * 1000;
-					uint32 sampleRate = mp3_freq_tab[rateIndex];
-					uint32 padding = paddingEnabled ? 1 : 0;
-
-					uint32 frameLength = 144 * bitrate / sampleRate + padding;
-					if(frameLength == 0)
-					{
-						return false;
-						i++;
-						continue;
-					}
-					
-					i += frameLength;
-					uint32 frameSamples = (linearVersion == 0) ? 1152 : 576;
-					m_frameIndices.Add((int32)sampleOffset, i);
-					sampleOffset += frameSamples;
-					continue; // Skip header
-				}
+				Logf("No valid mp3 frames found in file \"%s\"", Logger::Warning, path);
+				return false;
 			}
-			i++;
-		}
-
-		// No mp3 frames found
-		if(m_frameIndices.empty())
-		{
-			Logf("No valid mp3 frames found in file \"%s\"", Logger::Warning, path);
-			return false;
 		}
 
 		SetPosition_Internal(0);
 
-		// Total sample
-		m_samplesTotal = sampleOffset;
-
 		m_decoder = (mp3_decoder_t*)mp3_create();
 		int32 r = DecodeData_Internal();
 		if(r <= 0)
@@ -139,16 +224,36 @@ public:
 	}
 	virtual void SetPosition_Internal(int32 pos)
 	{
-		auto it = m_frameIndices.lower_bound(pos);
-		if(it == m_frameIndices.end())
+		// Extend the index up to the requested position, this only reads frame headers
+		while(m_scanSample <= pos && m_ScanFrame())
 		{
-			--it; // Take the last frame
 		}
-		if(it != m_frameIndices.end())
+
+		// Last indexed frame before the position
+		auto it = std::upper_bound(m_seekIndex.begin(), m_seekIndex.end(), pos, [](int32 pos, const SeekPoint& point)
+		{
+			return pos < point.sample;
+		});
+		if(it != m_seekIndex.begin())
+			--it;
+
+		// Find the frame that contains the position, or take the last frame
+		size_t offset = it->offset;
+		int32 sample = it->sample;
+		size_t frameOffset = offset;
+		int32 frameSample = sample;
+		uint32 frameLength, frameSamples;
+		while(m_ReadFrameHeader(offset, frameLength, frameSamples))
 		{
-			m_mp3samplePosition = it->first;
-			m_mp3dataOffset = it->second;
+			frameOffset = offset;
+			frameSample = sample;
+			if(sample + (int32)frameSamples > pos)
+				break;
+			sample += frameSamples;
+			offset += frameLength;
 		}
+		m_mp3samplePosition = frameSample;
+		m_mp3dataOffset = frameOffset;
 	}
 	virtual int32 GetStreamPosition_Internal()
 	{
@@ -168,7 +273,13 @@ public:
 			readData = mp3_decode(m_decoder, (uint8*)m_dataSource + m_mp3dataOffset, (int)(m_mp3dataLength - m_mp3dataOffset), buffer, &info);
 			m_mp3dataOffset += readData;
 			if(m_mp3dataOffset >= m_mp3dataLength) // EOF
+			{
+				// All frames were decoded, finish the index so it can be stored
+				while(m_ScanFrame())
+				{
+				}
 				return -1;
+			}
 			if(readData <= 0)
 				return -1;
 			if(info.audio_bytes >= 0)
@@ -178,6 +289,11 @@ public:
 		int32 samplesGotten = info.audio_bytes / (info.channels * sizeof(short));
 		m_mp3samplePosition += samplesGotten;
 
+		// Index the frames that were just decoded
+		while(m_scanOffset < m_mp3dataOffset && m_ScanFrame())
+		{
+		}
+
 		if(m_firstFrame)
 		{
 			m_bufferSize = MP3_MAX_SAMPLES_PER_FRAME / 2;
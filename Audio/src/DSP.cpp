@@ -43,6 +43,11 @@ void BQFDSP::Process(float* out, uint32 numSamples)
 		}
 	}
 }
+void BQFDSP::Reset()
+{
+	memset(zb, 0, sizeof(zb));
+	memset(za, 0, sizeof(za));
+}
 void BQFDSP::SetLowPass(float q, float freq, float sampleRate)
 {
 	// Limit q
@@ -160,6 +165,12 @@ void BitCrusherDSP::Process(float* out, uint32 numSamples)
 		out[i * 2 + 1] = m_sampleBuffer[1] * mix + out[i * 2+1] * (1.0f - mix);
 	}
 }
+void BitCrusherDSP::Reset()
+{
+	m_sampleBuffer[0] = 0.0f;
+	m_sampleBuffer[1] = 0.0f;
+	m_currentDuration = 0;
+}
 
 void GateDSP::SetLength(uint32 length)
 {
@@ -212,6 +223,10 @@ void GateDSP::Process(float* out, uint32 numSamples)
 		m_currentSample %= m_length;
 	}
 }
+void GateDSP::Reset()
+{
+	m_currentSample = 0;
+}
 
 void TapeStopDSP::SetLength(uint32 length)
 {
@@ -220,7 +235,13 @@ void TapeStopDSP::SetLength(uint32 length)
 	float flength = (float)length / 1000.0f * (float)audio->GetSampleRate();
 	m_length = (uint32)flength;
 	m_sampleBuffer.clear();
-	m_sampleBuffer.reserve(length);
+	// Stores a stereo sample for every sample until it is stopped
+	m_sampleBuffer.reserve((m_length + 1) * 2);
+}
+void TapeStopDSP::SetMaxLength(uint32 length)
+{
+	float flength = (float)length / 1000.0f * (float)audio->GetSampleRate();
+	m_sampleBuffer.reserve(((uint32)flength + 1) * 2);
 }
 void TapeStopDSP::Process(float* out, uint32 numSamples)
 {
@@ -249,17 +270,19 @@ void TapeStopDSP::Process(float* out, uint32 numSamples)
 		m_currentSample++;
 	}
 }
+void TapeStopDSP::Reset()
+{
+	m_sampleBuffer.clear();
+	m_sampleIdx = 0.0f;
+	m_currentSample = 0;
+}
 
 void RetriggerDSP::SetLength(uint32 length)
 {
 	float flength = (float)length / 1000.0f * (float)audio->GetSampleRate();
 	m_length = (uint32)flength;
 	SetGating(m_gating);
-	if (!m_bufferReserved)
-	{
-		m_sampleBuffer.reserve(m_length + 100);
-		m_bufferReserved = true;
-	}
+	m_sampleBuffer.reserve((m_length + 100) * 2);
 }
 void RetriggerDSP::SetResetDuration(uint32 resetDuration)
 {
@@ -274,11 +297,7 @@ void RetriggerDSP::SetGating(float gating)
 void RetriggerDSP::SetMaxLength(uint32 length)
 {
 	float flength = (float)length / 1000.0f * (float)audio->GetSampleRate();
-	if (!m_bufferReserved)
-	{
-		m_sampleBuffer.reserve((uint32_t)flength + 100);
-		m_bufferReserved = true;
-	}
+	m_sampleBuffer.reserve(((uint32)flength + 100) * 2);
 }
 void RetriggerDSP::Process(float* out, uint32 numSamples)
 {
@@ -319,6 +338,12 @@ void RetriggerDSP::Process(float* out, uint32 numSamples)
 		m_currentSample = Math::Clamp(m_currentSample, (uint32_t)0, (uint32_t)m_sampleBuffer.size());
 	}
 }
+void RetriggerDSP::Reset()
+{
+	m_sampleBuffer.clear();
+	m_loops = 0;
+	m_currentSample = 0;
+}
 
 void WobbleDSP::SetLength(uint32 length)
 {
@@ -348,6 +373,11 @@ void WobbleDSP::Process(float* out, uint32 numSamples)
 		m_currentSample %= m_length;
 	}
 }
+void WobbleDSP::Reset()
+{
+	BQFDSP::Reset();
+	m_currentSample = 0;
+}
 
 void PhaserDSP::SetLength(uint32 length)
 {
@@ -393,6 +423,16 @@ void PhaserDSP::Process(float* out, uint32 numSamples)
 		time %= m_length;
 	}
 }
+void PhaserDSP::Reset()
+{
+	for(uint32 c = 0; c < 2; c++)
+	{
+		for(uint32 i = 0; i < 6; i++)
+			filters[c][i].za = 0.0f;
+		za[c] = 0.0f;
+	}
+	time = 0;
+}
 float PhaserDSP::APF::Update(float in)
 {
 	float y = in * -a1 + za;
@@ -414,6 +454,8 @@ void FlangerDSP::SetDelayRange(uint32 min, uint32 max)
 	m_max = max * mult;
 	m_bufferLength = m_max * 2;
 	m_sampleBuffer.resize(m_bufferLength);
+	if(m_bufferOffset >= m_bufferLength)
+		m_bufferOffset = 0;
 }
 void FlangerDSP::Process(float* out, uint32 numSamples)
 {
@@ -450,6 +492,12 @@ void FlangerDSP::Process(float* out, uint32 numSamples)
 		m_time++;
 	}
 }
+void FlangerDSP::Reset()
+{
+	memset(m_sampleBuffer.data(), 0, sizeof(float) * m_sampleBuffer.size());
+	m_bufferOffset = 0;
+	m_time = 0;
+}
 
 void EchoDSP::SetLength(uint32 length)
 {
@@ -458,8 +506,14 @@ void EchoDSP::SetLength(uint32 length)
 	m_bufferLength = (uint32)flength * 2;
 	m_sampleBuffer.resize(m_bufferLength);
 	memset(m_sampleBuffer.data(), 0, sizeof(float) * m_bufferLength);
+	m_bufferOffset = 0;
 	m_numLoops = 0;
 }
+void EchoDSP::SetMaxLength(uint32 length)
+{
+	float flength = (float)length / 1000.0f * (float)audio->GetSampleRate();
+	m_sampleBuffer.reserve((uint32)flength * 2);
+}
 void EchoDSP::Process(float* out, uint32 numSamples)
 {
 	float* data = m_sampleBuffer.data();
@@ -491,6 +545,12 @@ void EchoDSP::Process(float* out, uint32 numSamples)
 		}
 	}
 }
+void EchoDSP::Reset()
+{
+	memset(m_sampleBuffer.data(), 0, sizeof(float) * m_sampleBuffer.size());
+	m_bufferOffset = 0;
+	m_numLoops = 0;
+}
 
 void SidechainDSP::SetLength(uint32 length)
 {
@@ -520,6 +580,10 @@ void SidechainDSP::Process(float* out, uint32 numSamples)
 		}
 	}
 }
+void SidechainDSP::Reset()
+{
+	m_time = 0;
+}
 
 void CombinedFilterDSP::SetLowPass(float q, float freq, float peakQ, float peakGain)
 {
@@ -540,6 +604,11 @@ void CombinedFilterDSP::Process(float* out, uint32 numSamples)
 	a.Process(out, numSamples);
 	peak.Process(out, numSamples);
 }
+void CombinedFilterDSP::Reset()
+{
+	a.Reset();
+	peak.Reset();
+}
 
 #include "SoundTouch.h"
 using namespace soundtouch;
@@ -569,6 +638,11 @@ public:
 		m_soundtouch.setSetting(SETTING_SEQUENCE_MS, 5);
 		//m_soundtouch.setSetting(SETTING_SEEKWINDOW_MS, 10);
 		//m_soundtouch.setSetting(SETTING_OVERLAP_MS, 10);
+		init = true;
+	}
+	void Reset()
+	{
+		m_soundtouch.clear();
 	}
 	void Process(float* out, uint32 numSamples)
 	{
@@ -598,3 +672,7 @@ void PitchShiftDSP::Process(float* out, uint32 numSamples)
 		m_impl->Init(audio);
 	m_impl->Process(out, numSamples);
 }
+void PitchShiftDSP::Reset()
+{
+	m_impl->Reset();
+}
@@ -2,6 +2,7 @@
 
 /*
 	Compiled operation on local database object
+	statements returned by Database::CachedQuery are reset instead of destroyed when finished
 */
 class DBStatement : public Unique
 {
@@ -27,14 +28,40 @@ public:
 
 private:
 	DBStatement(const String& statement, class Database* db);
+	DBStatement(struct DBCachedStatement* cached, class Database* db);
 	friend class Database;
 
 	Database& m_db;
 	struct sqlite3_stmt* m_stmt = nullptr;
+	struct DBCachedStatement* m_cached = nullptr;
 	int32 m_compileResult;
 	int32 m_queryResult;
 };
 
+/*
+	Connection settings applied when opening a database
+	empty or negative values keep the sqlite defaults
+*/
+struct DatabaseSettings
+{
+	// journal_mode, e.g. "WAL"
+	String journalMode;
+	// synchronous, e.g. "NORMAL"
+	String synchronous;
+	// mmap_size in bytes
+	int64 mmapSize = -1;
+	// cache_size, positive values are pages, negative values KiB
+	int32 cacheSize = 0;
+	// temp_store, e.g. "MEMORY"
+	String tempStore;
+	// Time in milliseconds to wait for other connections to release a lock
+	int32 busyTimeout = 0;
+
+	// Settings for a database that is only used by this process and can be rebuilt if it's lost,
+	//	the WAL journal with NORMAL sync doesn't sync on every commit, only on checkpoints
+	static DatabaseSettings Tuned();
+};
+
 /*
 	Local database object
 */
@@ -43,10 +70,19 @@ class Database : public Unique
 public:
 	~Database();
 	void Close();
-	bool Open(const String& path);
+	bool Open(const String& path, const DatabaseSettings& settings = DatabaseSettings());
+	bool ApplySettings(const DatabaseSettings& settings);
 	DBStatement Query(const String& queryString);
+	// Same as Query but the statement is only compiled the first time, later calls with the same query string reuse it
+	//	if the statement is still in use a new one is compiled
+	DBStatement CachedQuery(const String& queryString);
+	void ClearStatementCache();
+	uint32 GetNumCachedStatements() const;
 	bool Exec(const String& queryString);
 	bool ExecDirect(const String& queryString);
 
 	struct sqlite3* db = nullptr;
+
+private:
+	Map<String, struct DBCachedStatement*> m_statementCache;
 };
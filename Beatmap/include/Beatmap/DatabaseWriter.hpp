@@ -0,0 +1,76 @@
+#pragma once
+#include "Database.hpp"
+#include <Shared/Thread.hpp>
+#include <functional>
+#include <future>
+#include <condition_variable>
+
+/*
+	Writes to a database on a background thread with it's own connection
+	queued commands are grouped into a single transaction, each command runs in it's own savepoint so a failing command doesn't undo the others
+	when the transaction can't be started because another connection keeps the database locked, none of the commands run and they all fail
+
+	Pending commands are always written before the writer is destroyed
+	to see pending writes when reading on another connection, call Flush before reading
+*/
+class DatabaseWriter : public Unique
+{
+public:
+	// Runs on the writer thread, returns false if the command failed and it's changes should be rolled back
+	typedef std::function<bool(Database&)> Command;
+	// Called from Update with the result of a command
+	typedef std::function<void(bool)> Callback;
+
+	// Time to wait for more commands before starting a transaction, in seconds
+	static const double coalesceTime;
+	// Maximum number of commands in a single transaction
+	static const uint32 maxBatchSize = 512;
+	// Number of times to try starting a transaction while another connection holds the write lock, each try waits up to the busy timeout
+	static const uint32 maxBeginAttempts = 3;
+
+	DatabaseWriter() = default;
+	~DatabaseWriter();
+
+	// Opens a connection to the database and starts the writer thread
+	bool Open(const String& path, const DatabaseSettings& settings = DatabaseSettings());
+	// Writes all pending commands and stops the writer thread
+	void Close();
+
+	std::future<bool> Queue(Command command, Callback callback = Callback());
+	// Waits until all commands queued before this call are written
+	void Flush();
+	bool HasPendingWrites();
+
+	// Calls the callbacks of finished commands
+	void Update();
+
+	// Number of transactions that have been committed
+	uint32 GetNumTransactions() const;
+
+private:
+	struct PendingCommand
+	{
+		Command command;
+		Callback callback;
+		std::promise<bool> promise;
+	};
+
+	void m_WriterThread();
+	void m_Write(Vector<PendingCommand>& commands);
+	// Reports the results of written commands
+	void m_Finish(Vector<PendingCommand>& commands, const Vector<bool>& results);
+
+	Database m_database;
+	Thread m_thread;
+
+	Mutex m_lock;
+	std::condition_variable_any m_commandCondition;
+	std::condition_variable_any m_writtenCondition;
+	Vector<PendingCommand> m_commands;
+	Vector<std::pair<Callback, bool>> m_finishedCallbacks;
+	uint64 m_numQueued = 0;
+	uint64 m_numWritten = 0;
+	uint32 m_numTransactions = 0;
+	bool m_flushRequested = false;
+	bool m_stopping = false;
+};
@@ -69,6 +69,7 @@ public:
 	MapIndex* GetMap(int32 idx);
 
 	void AddSearchPath(const String& path);
+	// The score is written to the database in the background
 	void AddScore(const DifficultyIndex& diff, int score, int crit, int almost, int miss, float gauge);
 	void RemoveSearchPath(const String& path);
 
@@ -2,21 +2,37 @@
 #include "Database.hpp"
 #include "sqlite3.h"
 
+struct DBCachedStatement
+{
+	sqlite3_stmt* stmt;
+	bool inUse;
+};
+
 DBStatement::DBStatement(const String& statement, Database* db) : m_db(*db)
 {
 	m_queryResult = 0;
-	m_compileResult = sqlite3_prepare(m_db.db, *statement, (int)statement.size()+1, &m_stmt, nullptr);
+	m_compileResult = sqlite3_prepare_v2(m_db.db, *statement, (int)statement.size()+1, &m_stmt, nullptr);
 	if(m_compileResult != SQLITE_OK)
 	{
 		Logf("Failed to compile statement:\n%s\n-> %s", Logger::Error, statement, sqlite3_errmsg(m_db.db));
 	}
 }
+DBStatement::DBStatement(DBCachedStatement* cached, Database* db) : m_db(*db)
+{
+	m_queryResult = 0;
+	m_compileResult = SQLITE_OK;
+	m_stmt = cached->stmt;
+	m_cached = cached;
+	m_cached->inUse = true;
+}
 DBStatement::DBStatement(DBStatement&& other) : m_db(other.m_db)
 {
 	m_stmt = other.m_stmt;
+	m_cached = other.m_cached;
 	m_compileResult = other.m_compileResult;
 	m_queryResult = other.m_queryResult;
 	other.m_stmt = nullptr;
+	other.m_cached = nullptr;
 }
 DBStatement::~DBStatement()
 {
@@ -50,7 +66,16 @@ void DBStatement::Rewind()
 }
 void DBStatement::Finish()
 {
-	if(m_stmt)
+	if(m_cached)
+	{
+		// Keep the compiled statement for the next query
+		sqlite3_reset(m_stmt);
+		sqlite3_clear_bindings(m_stmt);
+		m_cached->inUse = false;
+		m_cached = nullptr;
+		m_stmt = nullptr;
+	}
+	else if(m_stmt)
 	{
 		sqlite3_finalize(m_stmt);
 		m_stmt = nullptr;
@@ -127,19 +152,32 @@ DBStatement::operator bool()
 	return m_stmt != nullptr;
 }
 
+DatabaseSettings DatabaseSettings::Tuned()
+{
+	DatabaseSettings settings;
+	settings.journalMode = "WAL";
+	settings.synchronous = "NORMAL";
+	settings.mmapSize = 64 * 1024 * 1024;
+	settings.cacheSize = -16 * 1024;
+	settings.tempStore = "MEMORY";
+	settings.busyTimeout = 5000;
+	return settings;
+}
+
 Database::~Database()
 {
 	Close();
 }
 void Database::Close()
 {
+	ClearStatementCache();
 	if(db)
 	{
 		sqlite3_close(db);
 	}
 	db = nullptr;
 }
-bool Database::Open(const String& path)
+bool Database::Open(const String& path, const DatabaseSettings& settings)
 {
 	Close();
  	int32 r = sqlite3_open(*path, &db);
@@ -147,13 +185,75 @@ bool Database::Open(const String& path)
 	{
 		return false;
 	}
-	return true;
+	return ApplySettings(settings);
+}
+bool Database::ApplySettings(const DatabaseSettings& settings)
+{
+	bool success = true;
+	if(!settings.journalMode.empty())
+	{
+		DBStatement journalMode = Query("PRAGMA journal_mode=" + settings.journalMode);
+		// Returns the new journal mode, which stays the same if the requested one isn't supported
+		if(!journalMode || !journalMode.StepRow() || sqlite3_stricmp(*journalMode.StringColumn(0), *settings.journalMode) != 0)
+		{
+			Logf("Failed to set database journal mode to %s", Logger::Warning, settings.journalMode);
+			success = false;
+		}
+	}
+	if(!settings.synchronous.empty())
+		success &= ExecDirect("PRAGMA synchronous=" + settings.synchronous);
+	if(settings.mmapSize >= 0)
+		success &= ExecDirect(Utility::Sprintf("PRAGMA mmap_size=%lld", (long long)settings.mmapSize));
+	if(settings.cacheSize != 0)
+		success &= ExecDirect(Utility::Sprintf("PRAGMA cache_size=%d", settings.cacheSize));
+	if(!settings.tempStore.empty())
+		success &= ExecDirect("PRAGMA temp_store=" + settings.tempStore);
+	if(settings.busyTimeout > 0)
+		sqlite3_busy_timeout(db, settings.busyTimeout);
+	return success;
 }
 DBStatement Database::Query(const String& queryString)
 {
 	DBStatement statement(queryString, this);
 	return std::move(statement);
 }
+DBStatement Database::CachedQuery(const String& queryString)
+{
+	DBCachedStatement** found = m_statementCache.Find(queryString);
+	if(found)
+	{
+		if((*found)->inUse)
+			return Query(queryString);
+		return DBStatement(*found, this);
+	}
+
+	DBStatement statement(queryString, this);
+	if(!statement)
+		return std::move(statement);
+
+	// Hand over the compiled statement to the cache
+	DBCachedStatement* cached = new DBCachedStatement();
+	cached->stmt = statement.m_stmt;
+	cached->inUse = false;
+	statement.m_stmt = nullptr;
+	m_statementCache.Add(queryString, cached);
+	return DBStatement(cached, this);
+}
+void Database::ClearStatementCache()
+{
+	for(auto& it : m_statementCache)
+	{
+		// Statements can't be removed while they're being used
+		assert(!it.second->inUse);
+		sqlite3_finalize(it.second->stmt);
+		delete it.second;
+	}
+	m_statementCache.clear();
+}
+uint32 Database::GetNumCachedStatements() const
+{
+	return (uint32)m_statementCache.size();
+}
 bool Database::Exec(const String& queryString)
 {
 	DBStatement stmt = Query(queryString);
@@ -0,0 +1,183 @@
+#include "stdafx.h"
+#include "DatabaseWriter.hpp"
+#include "Shared/Profiler.hpp"
+#include <chrono>
+#include <thread>
+
+const double DatabaseWriter::coalesceTime = 0.05;
+
+DatabaseWriter::~DatabaseWriter()
+{
+	Close();
+}
+
+bool DatabaseWriter::Open(const String& path, const DatabaseSettings& settings)
+{
+	Close();
+	if(!m_database.Open(path, settings))
+	{
+		Logf("Failed to open database for writing [%s]", Logger::Warning, path);
+		return false;
+	}
+	m_stopping = false;
+	m_thread = Thread(&DatabaseWriter::m_WriterThread, this);
+	return true;
+}
+void DatabaseWriter::Close()
+{
+	if(m_thread.joinable())
+	{
+		m_lock.lock();
+		m_stopping = true;
+		m_lock.unlock();
+		m_commandCondition.notify_all();
+		m_thread.join();
+	}
+	// Closing the last connection also checkpoints the journal
+	m_database.Close();
+}
+
+std::future<bool> DatabaseWriter::Queue(Command command, Callback callback)
+{
+	PendingCommand pending;
+	pending.command = std::move(command);
+	pending.callback = std::move(callback);
+	std::future<bool> future = pending.promise.get_future();
+
+	m_lock.lock();
+	assert(m_thread.joinable());
+	m_commands.emplace_back(std::move(pending));
+	m_numQueued++;
+	m_lock.unlock();
+	m_commandCondition.notify_one();
+	return future;
+}
+void DatabaseWriter::Flush()
+{
+	std::unique_lock<Mutex> lock(m_lock);
+	uint64 target = m_numQueued;
+	if(m_numWritten >= target)
+		return;
+	m_flushRequested = true;
+	m_commandCondition.notify_one();
+	m_writtenCondition.wait(lock, [&]() { return m_numWritten >= target; });
+}
+bool DatabaseWriter::HasPendingWrites()
+{
+	std::lock_guard<Mutex> guard(m_lock);
+	return m_numWritten < m_numQueued;
+}
+
+void DatabaseWriter::Update()
+{
+	Vector<std::pair<Callback, bool>> callbacks;
+	m_lock.lock();
+	std::swap(callbacks, m_finishedCallbacks);
+	m_lock.unlock();
+
+	for(auto& callback : callbacks)
+		callback.first(callback.second);
+}
+
+uint32 DatabaseWriter::GetNumTransactions() const
+{
+	return m_numTransactions;
+}
+
+void DatabaseWriter::m_WriterThread()
+{
+	Profiler::SetThreadName("Database Writer");
+	std::unique_lock<Mutex> lock(m_lock);
+	while(true)
+	{
+		m_commandCondition.wait(lock, [&]() { return !m_commands.empty() || m_stopping; });
+		if(m_commands.empty())
+			break;
+
+		// Give other commands a chance to be added to the same transaction
+		auto coalesceEnd = std::chrono::steady_clock::now() + std::chrono::duration<double>(coalesceTime);
+		m_commandCondition.wait_until(lock, coalesceEnd, [&]()
+		{
+			return m_flushRequested || m_stopping || m_commands.size() >= maxBatchSize;
+		});
+		m_flushRequested = false;
+
+		Vector<PendingCommand> commands;
+		if(m_commands.size() > maxBatchSize)
+		{
+			for(uint32 i = 0; i < maxBatchSize; i++)
+				commands.emplace_back(std::move(m_commands[i]));
+			m_commands.erase(m_commands.begin(), m_commands.begin() + maxBatchSize);
+		}
+		else
+		{
+			std::swap(commands, m_commands);
+		}
+		lock.unlock();
+
+		m_Write(commands);
+
+		lock.lock();
+		m_numWritten += commands.size();
+		m_numTransactions++;
+		m_writtenCondition.notify_all();
+	}
+}
+void DatabaseWriter::m_Write(Vector<PendingCommand>& commands)
+{
+	PROFILE_ZONE("Database Write");
+
+	auto Exec = [&](const char* queryString)
+	{
+		DBStatement statement = m_database.CachedQuery(queryString);
+		return statement && statement.Step();
+	};
+
+	Vector<bool> results(commands.size(), false);
+	// Take the write lock right away, so the transaction can't fail halfway through when another connection writes
+	//	without a transaction every command would be committed on it's own, so the batch fails if the lock can't be taken
+	bool began = false;
+	for(uint32 attempt = 0; attempt < maxBeginAttempts && !began; attempt++)
+	{
+		if(attempt > 0)
+			std::this_thread::sleep_for(std::chrono::duration<double>(coalesceTime));
+		began = Exec("BEGIN IMMEDIATE");
+	}
+	if(!began)
+	{
+		Logf("Failed to start a transaction for %d database commands", Logger::Error, (uint32)commands.size());
+		m_Finish(commands, results);
+		return;
+	}
+
+	for(size_t i = 0; i < commands.size(); i++)
+	{
+		Exec("SAVEPOINT command");
+		results[i] = commands[i].command(m_database);
+		if(!results[i])
+			Exec("ROLLBACK TO command");
+		Exec("RELEASE command");
+	}
+	if(!Exec("COMMIT"))
+	{
+		Logf("Failed to commit %d database commands", Logger::Error, (uint32)commands.size());
+		Exec("ROLLBACK");
+		for(size_t i = 0; i < results.size(); i++)
+			results[i] = false;
+	}
+	m_Finish(commands, results);
+}
+void DatabaseWriter::m_Finish(Vector<PendingCommand>& commands, const Vector<bool>& results)
+{
+	for(size_t i = 0; i < commands.size(); i++)
+	{
+		commands[i].promise.set_value(results[i]);
+	}
+	m_lock.lock();
+	for(size_t i = 0; i < commands.size(); i++)
+	{
+		if(commands[i].callback)
+			m_finishedCallbacks.Add({ std::move(commands[i].callback), results[i] });
+	}
+	m_lock.unlock();
+}
@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include "MapDatabase.hpp"
 #include "Database.hpp"
+#include "DatabaseWriter.hpp"
 #include "Beatmap.hpp"
 #include "Shared/Profiling.hpp"
 #include "Shared/Files.hpp"
@@ -11,6 +12,21 @@ using std::thread;
 using std::mutex;
 using namespace std;
 
+// Writer shared by all map databases, so a database reading from the file sees the writes of the others
+static std::weak_ptr<DatabaseWriter> s_sharedWriter;
+
+static std::shared_ptr<DatabaseWriter> GetSharedWriter(const String& databasePath)
+{
+	std::shared_ptr<DatabaseWriter> writer = s_sharedWriter.lock();
+	if(!writer)
+	{
+		writer = std::make_shared<DatabaseWriter>();
+		writer->Open(databasePath, DatabaseSettings::Tuned());
+		s_sharedWriter = writer;
+	}
+	return writer;
+}
+
 class MapDatabase_Impl
 {
 public:
@@ -21,7 +37,9 @@ public:
 	bool m_searching = false;
 	bool m_interruptSearch = false;
 	Set<String> m_searchPaths;
+	// Only used for reading, writes are done by m_writer
 	Database m_database;
+	std::shared_ptr<DatabaseWriter> m_writer;
 
 	Map<int32, MapIndex*> m_maps;
 	Map<int32, DifficultyIndex*> m_difficulties;
@@ -69,11 +87,12 @@ public:
 	MapDatabase_Impl(MapDatabase& outer) : m_outer(outer)
 	{
 		String databasePath = "maps.db";
-		if(!m_database.Open(databasePath))
+		if(!m_database.Open(databasePath, DatabaseSettings::Tuned()))
 		{
 			Logf("Failed to open database [%s]", Logger::Warning, databasePath);
 			assert(false);
 		}
+		m_writer = GetSharedWriter(databasePath);
 
 		bool rebuild = false;
 		DBStatement versionQuery = m_database.Query("SELECT version FROM `Database`");
@@ -186,25 +205,24 @@ public:
 	
 	Map<int32, MapIndex*> FindMaps(const String& searchString)
 	{
-		WString test = Utility::ConvertToWString(searchString);
+		m_writer->Flush();
 		String stmt = "SELECT rowid FROM Maps WHERE";
 
-		//search.spl
+		// Terms are bound as parameters, so the statement only depends on the number of terms and can be reused
 		Vector<String> terms = searchString.Explode(" ");
 		int32 i = 0;
 		for(auto term : terms)
 		{
 			if(i > 0)
 				stmt += " AND";
-			stmt += " (artist LIKE \"%" + term + "%\"" + 
-				" OR title LIKE \"%" + term + "%\"" +
-				" OR path LIKE \"%" + term + "%\"" +
-				" OR tags LIKE \"%" + term + "%\")";
+			stmt += Utility::Sprintf(" (artist LIKE ?%d OR title LIKE ?%d OR path LIKE ?%d OR tags LIKE ?%d)", i + 1, i + 1, i + 1, i + 1);
 			i++;
 		}
 
 		Map<int32, MapIndex*> res;
-		DBStatement search = m_database.Query(stmt);
+		DBStatement search = m_database.CachedQuery(stmt);
+		for(i = 0; i < (int32)terms.size(); i++)
+			search.BindString(i + 1, "%" + terms[i] + "%");
 		while(search.StepRow())
 		{
 			int32 id = search.IntColumn(0);
@@ -221,14 +239,15 @@ public:
 
 	Map<int32, MapIndex*> FindMapsByFolder(const String& folder)
 	{
+		m_writer->Flush();
 		char csep[2];
 		csep[0] = Path::sep;
 		csep[1] = 0;
 		String sep(csep);
-		String stmt = "SELECT rowid FROM Maps WHERE path LIKE \"%" + sep + folder + sep + "%\"";
 
 		Map<int32, MapIndex*> res;
-		DBStatement search = m_database.Query(stmt);
+		DBStatement search = m_database.CachedQuery("SELECT rowid FROM Maps WHERE path LIKE ?");
+		search.BindString(1, "%" + sep + folder + sep + "%");
 		while (search.StepRow())
 		{
 			int32 id = search.IntColumn(0);
@@ -248,22 +267,19 @@ public:
 		if(changes.empty())
 			return;
 
-		DBStatement addDiff = m_database.Query("INSERT INTO Difficulties(path,lwt,metadata,rowid,mapid) VALUES(?,?,?,?,?)");
-		DBStatement addMap = m_database.Query("INSERT INTO Maps(path,artist,title,tags,rowid) VALUES(?,?,?,?,?)");
-		DBStatement update = m_database.Query("UPDATE Difficulties SET lwt=?,metadata=? WHERE rowid=?");
-		DBStatement removeDiff = m_database.Query("DELETE FROM Difficulties WHERE rowid=?");
-		DBStatement removeMap = m_database.Query("DELETE FROM Maps WHERE rowid=?");
+		// Database changes are collected here and written on the writer thread
+		//	every statement is it's own command, so a failing one only rolls back itself and the others still match the index in memory
+		Vector<DatabaseWriter::Command> writes;
 
 		Set<MapIndex*> addedEvents;
 		Set<MapIndex*> removeEvents;
 		Set<MapIndex*> updatedEvents;
 
-		m_database.Exec("BEGIN");
 		for(Event& e : changes)
 		{
 			if(e.action == Event::Added)
 			{
-				Buffer metadata;
+				CopyableBuffer metadata;
 				MemoryWriter metadataWriter(metadata);
 				metadataWriter.SerializeObject(*e.mapData);
 
@@ -283,13 +299,20 @@ public:
 					m_maps.Add(map->id, map);
 					m_mapsByPath.Add(map->path, map);
 
-					addMap.BindString(1, map->path);
-					addMap.BindString(2, e.mapData->artist);
-					addMap.BindString(3, e.mapData->title);
-					addMap.BindString(4, e.mapData->tags);
-					addMap.BindInt(5, map->id);
-					addMap.Step();
-					addMap.Rewind();
+					int32 mapId = map->id;
+					String artist = e.mapData->artist;
+					String title = e.mapData->title;
+					String tags = e.mapData->tags;
+					writes.Add([=](Database& db)
+					{
+						DBStatement addMap = db.CachedQuery("INSERT INTO Maps(path,artist,title,tags,rowid) VALUES(?,?,?,?,?)");
+						addMap.BindString(1, mapPath);
+						addMap.BindString(2, artist);
+						addMap.BindString(3, title);
+						addMap.BindString(4, tags);
+						addMap.BindInt(5, mapId);
+						return addMap.Step();
+					});
 
 					existingUpdated = false; // New map
 				}
@@ -312,13 +335,20 @@ public:
 				m_SortDifficulties(map);
 
 				// Add Diff
-				addDiff.BindString(1, diff->path);
-				addDiff.BindInt64(2, diff->lwt);
-				addDiff.BindBlob(3, metadata);
-				addDiff.BindInt64(4, diff->id); // rowid
-				addDiff.BindInt64(5, diff->mapId); // mapid
-				addDiff.Step();
-				addDiff.Rewind();
+				String diffPath = diff->path;
+				uint64 lwt = diff->lwt;
+				int32 diffId = diff->id;
+				int32 mapId = diff->mapId;
+				writes.Add([=](Database& db)
+				{
+					DBStatement addDiff = db.CachedQuery("INSERT INTO Difficulties(path,lwt,metadata,rowid,mapid) VALUES(?,?,?,?,?)");
+					addDiff.BindString(1, diffPath);
+					addDiff.BindInt64(2, lwt);
+					addDiff.BindBlob(3, metadata);
+					addDiff.BindInt64(4, diffId); // rowid
+					addDiff.BindInt64(5, mapId); // mapid
+					return addDiff.Step();
+				});
 
 				// Send appropriate notification
 				if(existingUpdated)
@@ -332,15 +362,20 @@ public:
 			}
 			else if(e.action == Event::Updated)
 			{
-				Buffer metadata;
+				CopyableBuffer metadata;
 				MemoryWriter metadataWriter(metadata);
 				metadataWriter.SerializeObject(*e.mapData);
 
-				update.BindInt64(1, e.lwt);
-				update.BindBlob(2, metadata);
-				update.BindInt(3, e.id);
-				update.Step();
-				update.Rewind();
+				uint64 lwt = e.lwt;
+				int32 diffId = e.id;
+				writes.Add([=](Database& db)
+				{
+					DBStatement update = db.CachedQuery("UPDATE Difficulties SET lwt=?,metadata=? WHERE rowid=?");
+					update.BindInt64(1, lwt);
+					update.BindBlob(2, metadata);
+					update.BindInt(3, diffId);
+					return update.Step();
+				});
 				
 				auto itDiff = m_difficulties.find(e.id);
 				assert(itDiff != m_difficulties.end());
@@ -368,17 +403,25 @@ public:
 				m_difficulties.erase(e.id);
 
 				// Remove diff in db
-				removeDiff.BindInt(1, e.id);
-				removeDiff.Step();
-				removeDiff.Rewind();
+				int32 diffId = e.id;
+				writes.Add([=](Database& db)
+				{
+					DBStatement removeDiff = db.CachedQuery("DELETE FROM Difficulties WHERE rowid=?");
+					removeDiff.BindInt(1, diffId);
+					return removeDiff.Step();
+				});
 
 				if(itMap->second->difficulties.empty()) // Remove map as well
 				{
 					removeEvents.Add(itMap->second);
 
-					removeMap.BindInt(1, itMap->first);
-					removeMap.Step();
-					removeMap.Rewind();
+					int32 mapId = itMap->first;
+					writes.Add([=](Database& db)
+					{
+						DBStatement removeMap = db.CachedQuery("DELETE FROM Maps WHERE rowid=?");
+						removeMap.BindInt(1, mapId);
+						return removeMap.Step();
+					});
 
 					m_mapsByPath.erase(itMap->second->path);
 					m_maps.erase(itMap);
@@ -391,7 +434,9 @@ public:
 			if(e.mapData)
 				delete e.mapData;
 		}
-		m_database.Exec("END");
+		// The writer groups the commands into one transaction, failed statements are logged by DBStatement
+		for(auto& write : writes)
+			m_writer->Queue(std::move(write));
 
 		// Fire events
 		if(!removeEvents.empty())
@@ -437,22 +482,18 @@ public:
 
 	void AddScore(const DifficultyIndex& diff, int score, int crit, int almost, int miss, float gauge)
 	{
-		DBStatement addScore = m_database.Query("INSERT INTO Scores(score,crit,near,miss,gauge,diffid) VALUES(?,?,?,?,?,?)");
-
-		m_database.Exec("BEGIN");
-
-		addScore.BindInt(1, score);
-		addScore.BindInt(2, crit);
-		addScore.BindInt(3, almost);
-		addScore.BindInt(4, miss);
-		addScore.BindDouble(5, gauge);
-		addScore.BindInt(6, diff.id);
-
-		addScore.Step();
-		addScore.Rewind();
-
-		m_database.Exec("END");
-
+		int32 diffId = diff.id;
+		m_writer->Queue([=](Database& db)
+		{
+			DBStatement addScore = db.CachedQuery("INSERT INTO Scores(score,crit,near,miss,gauge,diffid) VALUES(?,?,?,?,?,?)");
+			addScore.BindInt(1, score);
+			addScore.BindInt(2, crit);
+			addScore.BindInt(3, almost);
+			addScore.BindInt(4, miss);
+			addScore.BindDouble(5, gauge);
+			addScore.BindInt(6, diffId);
+			return addScore.Step();
+		});
 	}
 
 private:
@@ -471,6 +512,7 @@ private:
 	}
 	void m_CreateTables()
 	{
+		m_database.ClearStatementCache();
 		m_database.Exec("DROP TABLE IF EXISTS Maps");
 		m_database.Exec("DROP TABLE IF EXISTS Difficulties");
 		m_database.Exec("DROP TABLE IF EXISTS Scores");
@@ -490,6 +532,9 @@ private:
 	{
 		assert(!m_searching);
 
+		// Pending writes of this or other map databases should be in the file before reading it
+		m_writer->Flush();
+
 		// Clear search state
 		m_searchState.difficulties.clear();
 
@@ -589,6 +634,7 @@ private:
 	// Main search thread
 	void m_SearchThread()
 	{
+		Profiler::SetThreadName("Map Database");
 		Map<String, FileInfo> fileList;
 
 		{
@@ -718,6 +764,10 @@ void MapDatabase::StopSearching()
 {
 	m_impl->StopSearching();
 }
+Map<int32, MapIndex*> MapDatabase::GetMaps()
+{
+	return m_impl->m_maps;
+}
 Map<int32, MapIndex*> MapDatabase::FindMaps(const String& search)
 {
 	return m_impl->FindMaps(search);
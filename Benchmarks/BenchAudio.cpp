@@ -0,0 +1,183 @@
+#include "stdafx.h"
+#include <Audio/Audio.hpp>
+#include <Audio/Audio_Impl.hpp>
+#include <Audio/DSP.hpp>
+
+// Generates a saw wave, so the DSPs have a signal to work with
+class SawAudio : public AudioBase
+{
+public:
+	virtual void Process(float* out, uint32 numSamples) override
+	{
+		for(uint32 i = 0; i < numSamples; i++)
+		{
+			float sample = (float)(m_time++ % 200) / 100.0f - 1.0f;
+			out[i * 2 + 0] = sample * 0.5f;
+			out[i * 2 + 1] = sample * 0.5f;
+		}
+	}
+
+private:
+	uint32 m_time = 0;
+};
+
+Benchmark("Audio")
+{
+#ifndef _WIN32
+	// Sound is not needed, use SDL's null output if no other driver was requested
+	setenv("SDL_AUDIODRIVER", "dummy", 0);
+#endif
+	Audio* audio = new Audio();
+	if(!audio->Init())
+	{
+		delete audio;
+		throw BenchmarkFailure("audio->Init()");
+	}
+	Audio_Impl* impl = audio->GetImpl();
+	uint32 sampleRate = impl->GetSampleRate();
+
+	// Detach the mixer from the output device, so Mix is only called here
+	impl->output->Stop();
+
+	const uint32 numTracks = 4;
+	SawAudio tracks[numTracks];
+	for(uint32 i = 0; i < numTracks; i++)
+		impl->Register(&tracks[i]);
+
+	// One second of audio per iteration, in the output buffer size used by the device
+	const uint32 bufferSamples = 1024;
+	uint32 numChannels = impl->output->GetNumChannels();
+	Vector<float> buffer;
+	buffer.resize(bufferSamples * numChannels);
+	context.Measure("Mix", 5, [&]()
+	{
+		for(uint32 i = 0; i < sampleRate; i += bufferSamples)
+		{
+			uint32 numSamples = bufferSamples;
+			impl->Mix(buffer.data(), numSamples);
+		}
+	});
+	for(uint32 i = 0; i < numTracks; i++)
+		impl->Deregister(&tracks[i]);
+
+	// Each DSP processes one second of audio from a reset state per iteration
+	Vector<float> signal;
+	signal.resize(sampleRate * 2);
+	SawAudio source;
+	source.Process(signal.data(), sampleRate);
+	Vector<float> samples;
+	samples.resize(signal.size());
+
+	auto MeasureDSP = [&](const String& name, DSP* dsp, uint32 iterations)
+	{
+		context.Measure("DSP." + name, iterations, [&]()
+		{
+			dsp->Reset();
+			memcpy(samples.data(), signal.data(), signal.size() * sizeof(float));
+			for(uint32 i = 0; i < sampleRate; i += impl->m_sampleBufferLength)
+			{
+				uint32 numSamples = Math::Min(impl->m_sampleBufferLength, sampleRate - i);
+				dsp->Process(samples.data() + i * 2, numSamples);
+			}
+		});
+		delete dsp;
+	};
+
+	{
+		BQFDSP* dsp = new BQFDSP();
+		dsp->audio = impl;
+		dsp->SetPeaking(1.0f, 2000.0f, 10.0f);
+		MeasureDSP("Peaking", dsp, 5);
+	}
+	{
+		BQFDSP* dsp = new BQFDSP();
+		dsp->audio = impl;
+		dsp->SetLowPass(1.0f, 2000.0f);
+		MeasureDSP("LowPass", dsp, 5);
+	}
+	{
+		CombinedFilterDSP* dsp = new CombinedFilterDSP();
+		dsp->audio = impl;
+		dsp->SetLowPass(1.0f, 2000.0f, 1.0f, 10.0f);
+		MeasureDSP("CombinedFilter", dsp, 5);
+	}
+	{
+		PanDSP* dsp = new PanDSP();
+		dsp->audio = impl;
+		dsp->panning = 0.5f;
+		MeasureDSP("Pan", dsp, 5);
+	}
+	{
+		LimiterDSP* dsp = new LimiterDSP();
+		dsp->audio = impl;
+		MeasureDSP("Limiter", dsp, 5);
+	}
+	{
+		BitCrusherDSP* dsp = new BitCrusherDSP();
+		dsp->audio = impl;
+		dsp->SetPeriod(10.0f);
+		MeasureDSP("BitCrusher", dsp, 5);
+	}
+	{
+		GateDSP* dsp = new GateDSP();
+		dsp->audio = impl;
+		dsp->SetLength(125);
+		MeasureDSP("Gate", dsp, 5);
+	}
+	{
+		TapeStopDSP* dsp = new TapeStopDSP();
+		dsp->audio = impl;
+		dsp->SetMaxLength(1000);
+		dsp->SetLength(1000);
+		MeasureDSP("TapeStop", dsp, 5);
+	}
+	{
+		RetriggerDSP* dsp = new RetriggerDSP();
+		dsp->audio = impl;
+		dsp->SetMaxLength(250);
+		dsp->SetLength(125);
+		dsp->SetResetDuration(500);
+		MeasureDSP("Retrigger", dsp, 5);
+	}
+	{
+		WobbleDSP* dsp = new WobbleDSP();
+		dsp->audio = impl;
+		dsp->SetLength(250);
+		MeasureDSP("Wobble", dsp, 5);
+	}
+	{
+		PhaserDSP* dsp = new PhaserDSP();
+		dsp->audio = impl;
+		dsp->SetLength(2000);
+		MeasureDSP("Phaser", dsp, 5);
+	}
+	{
+		FlangerDSP* dsp = new FlangerDSP();
+		dsp->audio = impl;
+		dsp->SetLength(2000);
+		dsp->SetDelayRange(10, 40);
+		MeasureDSP("Flanger", dsp, 5);
+	}
+	{
+		EchoDSP* dsp = new EchoDSP();
+		dsp->audio = impl;
+		dsp->SetMaxLength(250);
+		dsp->SetLength(250);
+		MeasureDSP("Echo", dsp, 5);
+	}
+	{
+		SidechainDSP* dsp = new SidechainDSP();
+		dsp->audio = impl;
+		dsp->SetLength(500);
+		dsp->curve = Interpolation::CubicBezier(Interpolation::EaseOutExpo);
+		MeasureDSP("Sidechain", dsp, 5);
+	}
+	{
+		PitchShiftDSP* dsp = new PitchShiftDSP();
+		dsp->audio = impl;
+		dsp->amount = 12.0f;
+		MeasureDSP("PitchShift", dsp, 1);
+	}
+
+	delete audio;
+}
@@ -0,0 +1,143 @@
+#include "stdafx.h"
+#include <Shared/MemoryStream.hpp>
+#include <Beatmap/Beatmap.hpp>
+#include <Beatmap/BeatmapPlayback.hpp>
+#include <Beatmap/KShootMap.hpp>
+#include "BenchBeatmap.hpp"
+
+String GenerateBenchmarkChart(uint32 numMeasures, const String& title)
+{
+	String chart = Utility::Sprintf("title=%s\r\nartist=Benchmark\r\neffect=Benchmark\r\njacket=jacket.png\r\nillustrator=Benchmark\r\n"
+		"difficulty=extended\r\nlevel=16\r\nt=120\r\nm=song.ogg\r\no=0\r\nbeat=4/4\r\n--\r\n", title);
+	for(uint32 m = 0; m < numMeasures; m++)
+	{
+		if(m % 32 == 16)
+			chart += "t=180\r\n";
+		else if(m % 32 == 0 && m > 0)
+			chart += "t=120\r\n";
+		if(m % 8 == 0)
+			chart += Utility::Sprintf("zoom_bottom=%d\r\nzoom_top=%d\r\n", (int32)(m % 3) * 50, (int32)(m % 5) * 20);
+
+		for(uint32 l = 0; l < 16; l++)
+		{
+			char bt[5] = "0000";
+			if(l % 4 == 0)
+				bt[(m + l / 4) % 4] = '1';
+			if(m % 8 == 7)
+				bt[3] = '2';
+
+			char fx[3] = "00";
+			if(m % 6 == 3)
+				fx[0] = '1';
+			else if(l % 8 == 4)
+				fx[(l / 8) % 2] = '2';
+
+			// Left laser sweeps every measure, the right laser every other measure
+			char laser[3] = "--";
+			laser[0] = (l == 0) ? '0' : (l == 15) ? 'o' : ':';
+			if(m % 2 == 0)
+				laser[1] = (l == 0) ? 'o' : (l == 15) ? '0' : ':';
+
+			chart += Utility::Sprintf("%s|%s|%s\r\n", bt, fx, laser);
+		}
+		chart += "--\r\n";
+	}
+	return chart;
+}
+
+static Buffer ChartToBuffer(const String& chart)
+{
+	Buffer data;
+	data.resize(chart.size());
+	memcpy(data.data(), chart.data(), chart.size());
+	return data;
+}
+
+Benchmark("KSH")
+{
+	Buffer chartData = ChartToBuffer(GenerateBenchmarkChart(400));
+
+	context.Measure("Parse", 5, [&]()
+	{
+		KShootMap kshootMap;
+		MemoryReader reader(chartData);
+		BenchmarkEnsure(kshootMap.Init(reader, false));
+	});
+	context.Measure("ParseMetadata", 100, [&]()
+	{
+		KShootMap kshootMap;
+		MemoryReader reader(chartData);
+		BenchmarkEnsure(kshootMap.Init(reader, true));
+	});
+	context.Measure("Load", 5, [&]()
+	{
+		Beatmap beatmap;
+		MemoryReader reader(chartData);
+		BenchmarkEnsure(beatmap.Load(reader));
+	});
+}
+
+Benchmark("Playback")
+{
+	Buffer chartData = ChartToBuffer(GenerateBenchmarkChart(400));
+	Beatmap beatmap;
+	MemoryReader reader(chartData);
+	BenchmarkEnsure(beatmap.Load(reader));
+	MapTime lastTime = beatmap.GetLinearObjects().back()->time;
+
+	// Plays the whole map at 60 fps
+	context.Measure("Update", 1, [&]()
+	{
+		BeatmapPlayback playback(beatmap);
+		BenchmarkEnsure(playback.Reset());
+		for(MapTime time = 0; time < lastTime; time += 16)
+			playback.Update(time);
+	});
+
+	// Playbacks spread out over the map, so the queries below don't include updating the playback
+	Vector<BeatmapPlayback*> playbacks;
+	for(uint32 i = 0; i < 64; i++)
+	{
+		BeatmapPlayback* playback = new BeatmapPlayback(beatmap);
+		BenchmarkEnsure(playback->Reset());
+		for(MapTime time = 0; time < lastTime * i / 64; time += 16)
+			playback->Update(time);
+		playbacks.Add(playback);
+	}
+
+	// Same view range as the track
+	const float viewRange = 2.0f;
+	context.Measure("GetObjectsInRange", 20, [&]()
+	{
+		for(BeatmapPlayback* playback : playbacks)
+		{
+			Vector<ObjectState*> objects = playback->GetObjectsInRange(playback->ViewDistanceToDuration(viewRange));
+			BenchmarkEnsure(!objects.empty());
+		}
+	});
+
+	// Positions and lengths of the visible objects, as calculated by the track every frame
+	Vector<Vector<ObjectState*>> visibleObjects;
+	for(BeatmapPlayback* playback : playbacks)
+	{
+		visibleObjects.Add(playback->GetObjectsInRange(playback->ViewDistanceToDuration(viewRange)));
+	}
+	context.Measure("ViewDistance", 20, [&]()
+	{
+		for(size_t i = 0; i < playbacks.size(); i++)
+		{
+			for(ObjectState* obj : visibleObjects[i])
+			{
+				MultiObjectState* mobj = *obj;
+				playbacks[i]->TimeToViewDistance(obj->time);
+				if(obj->type == ObjectType::Hold)
+					playbacks[i]->DurationToViewDistanceAtTime(obj->time, mobj->hold.duration);
+				else if(obj->type == ObjectType::Laser)
+					playbacks[i]->DurationToViewDistanceAtTime(obj->time, mobj->laser.duration);
+			}
+		}
+	});
+
+	for(BeatmapPlayback* playback : playbacks)
+		delete playback;
+}
@@ -0,0 +1,4 @@
+#pragma once
+
+// Generates a ksh chart with 16 lines per measure, using buttons, holds, fx, lasers, slams, bpm and zoom changes
+String GenerateBenchmarkChart(uint32 numMeasures, const String& title = "Benchmark");
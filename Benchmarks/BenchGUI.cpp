@@ -0,0 +1,99 @@
+#include "stdafx.h"
+#include <Graphics/RenderQueue.hpp>
+#include <Graphics/Font.hpp>
+using namespace Graphics;
+#include <GUI/GUI.hpp>
+
+// Element with a fixed size that doesn't render anything
+class FixedSizeElement : public GUIElementBase
+{
+public:
+	FixedSizeElement(Vector2 size) : size(size)
+	{
+	}
+	virtual void Render(GUIRenderData rd) override
+	{
+	}
+	virtual Vector2 GetDesiredSize(GUIRenderData rd) override
+	{
+		return size;
+	}
+	void SetSize(Vector2 newSize)
+	{
+		size = newSize;
+		InvalidateLayout();
+	}
+
+	Vector2 size;
+};
+
+// Builds a song select like tree of canvases, layout boxes and panels
+static Ref<Canvas> CreateLayout(uint32 numItems, Vector<FixedSizeElement*>& leaves)
+{
+	Ref<Canvas> root = Ref<Canvas>(new Canvas());
+	LayoutBox* list = new LayoutBox();
+	list->layoutDirection = LayoutBox::Vertical;
+	Canvas::Slot* listSlot = root->Add(list->MakeShared());
+	listSlot->anchor = Anchors::Full;
+
+	for(uint32 i = 0; i < numItems; i++)
+	{
+		Panel* panel = new Panel();
+		LayoutBox::Slot* panelSlot = list->Add(panel->MakeShared());
+		panelSlot->fillX = true;
+		panelSlot->padding = Margin(2);
+
+		LayoutBox* row = new LayoutBox();
+		row->layoutDirection = LayoutBox::Horizontal;
+		panel->SetContent(row->MakeShared());
+		for(uint32 j = 0; j < 4; j++)
+		{
+			FixedSizeElement* leaf = new FixedSizeElement(Vector2(50.0f, 20.0f));
+			LayoutBox::Slot* leafSlot = row->Add(leaf->MakeShared());
+			leafSlot->fillX = (j == 0);
+			leaves.Add(leaf);
+		}
+	}
+	return root;
+}
+
+static void LayoutPass(Ref<Canvas> root)
+{
+	GUIRenderData rd;
+	rd.guiRenderer = nullptr;
+	rd.rq = nullptr;
+	rd.area = Rect(0, 0, 1280, 720);
+	rd.deltaTime = 0.0f;
+	GUIElementBase* inputElement = nullptr;
+	root->PreRender(rd, inputElement);
+}
+
+Benchmark("GUI")
+{
+	const uint32 numItems = 500;
+
+	// Building the tree and the first layout pass
+	context.Measure("Layout.Initial", 5, [&]()
+	{
+		Vector<FixedSizeElement*> leaves;
+		Ref<Canvas> root = CreateLayout(numItems, leaves);
+		LayoutPass(root);
+	});
+
+	Vector<FixedSizeElement*> leaves;
+	Ref<Canvas> root = CreateLayout(numItems, leaves);
+	LayoutPass(root);
+	context.Measure("Layout.Static", 100, [&]()
+	{
+		LayoutPass(root);
+	});
+
+	// Changing one element every pass
+	uint32 pass = 0;
+	context.Measure("Layout.SingleChange", 100, [&]()
+	{
+		leaves[pass % leaves.size()]->SetSize(Vector2(50.0f + (pass % 2), 20.0f));
+		LayoutPass(root);
+		pass++;
+	});
+}
@@ -0,0 +1,106 @@
+#include "stdafx.h"
+#include <Beatmap/MapDatabase.hpp>
+#include "BenchBeatmap.hpp"
+#include <thread>
+
+static const char* titleWords[] = { "Angel", "Blue", "Crystal", "Dream", "Echo", "Flame", "Galaxy", "Heart" };
+
+static bool WriteChart(const String& path, const String& chart)
+{
+	File file;
+	if(!file.OpenWrite(path))
+		return false;
+	file.Write(chart.data(), chart.size());
+	return true;
+}
+
+// Scans all maps in the search path and waits until they are added to the database
+static void ScanMaps(MapDatabase& database)
+{
+	database.StartSearching();
+	while(database.IsSearching())
+	{
+		database.Update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	database.Update();
+}
+
+// Restores the working directory when leaving the scope, also when a benchmark check fails
+class WorkingDirectoryGuard
+{
+public:
+	WorkingDirectoryGuard() : m_path(Path::GetCurrentPath())
+	{
+	}
+	~WorkingDirectoryGuard()
+	{
+		Path::SetCurrentPath(m_path);
+	}
+
+private:
+	String m_path;
+};
+
+static void DeleteDatabase()
+{
+	Path::Delete("maps.db");
+	Path::Delete("maps.db-wal");
+	Path::Delete("maps.db-shm");
+}
+
+Benchmark("MapDatabase")
+{
+	// The map database is always created in the working directory
+	WorkingDirectoryGuard workingDirGuard;
+	String dataPath = context.GetDataPath();
+	BenchmarkEnsure(Path::SetCurrentPath(dataPath));
+
+	// Folders with 2 difficulties each
+	const uint32 numMaps = 200;
+	String songsPath = dataPath + Path::sep + "songs";
+	BenchmarkEnsure(Path::CreateDir(songsPath));
+	for(uint32 i = 0; i < numMaps; i++)
+	{
+		String mapPath = songsPath + Path::sep + Utility::Sprintf("map%d", i);
+		BenchmarkEnsure(Path::CreateDir(mapPath));
+		String title = Utility::Sprintf("%s %s %d", titleWords[i % 8], titleWords[(i / 8) % 8], i);
+		BenchmarkEnsure(WriteChart(mapPath + Path::sep + "nov.ksh", GenerateBenchmarkChart(20, title)));
+		BenchmarkEnsure(WriteChart(mapPath + Path::sep + "exh.ksh", GenerateBenchmarkChart(40, title)));
+	}
+
+	// Scanning into an empty database
+	context.Measure("Scan", 1, [&]()
+	{
+		DeleteDatabase();
+		MapDatabase database;
+		database.AddSearchPath(songsPath);
+		ScanMaps(database);
+		BenchmarkEnsure(database.GetMaps().size() == numMaps);
+	});
+
+	// Startup with an existing database where nothing changed
+	context.Measure("Rescan", 1, [&]()
+	{
+		MapDatabase database;
+		database.AddSearchPath(songsPath);
+		ScanMaps(database);
+		BenchmarkEnsure(database.GetMaps().size() == numMaps);
+	});
+
+	{
+		MapDatabase database;
+		database.AddSearchPath(songsPath);
+		ScanMaps(database);
+
+		// Searches as they are typed in song select
+		const char* searches[] = { "A", "An", "Ang", "Angel", "Angel B", "Angel Bl", "Angel Blue", "1", "12", "Echo 1" };
+		context.Measure("Search", 10, [&]()
+		{
+			for(const char* search : searches)
+				database.FindMaps(search);
+		});
+	}
+
+	DeleteDatabase();
+}
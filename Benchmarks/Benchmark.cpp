@@ -0,0 +1,286 @@
+#include "stdafx.h"
+#include "Benchmark.hpp"
+
+#ifndef BENCHMARK_BUILD_TYPE
+#define BENCHMARK_BUILD_TYPE ""
+#endif
+
+BenchmarkManager& BenchmarkManager::Get()
+{
+	static BenchmarkManager inst;
+	return inst;
+}
+
+int32 BenchmarkManager::Run(const Vector<String>& filters)
+{
+	m_results.clear();
+
+	m_basePath = Path::Absolute("BenchmarkFilesystem_" + Path::GetModuleName());
+	if(Path::FileExists(m_basePath))
+		Path::DeleteDir(m_basePath);
+	if(!Path::CreateDir(m_basePath))
+	{
+		Logf("Failed to create folder for benchmark files: %s", Logger::Error, m_basePath);
+		return -1;
+	}
+
+	Logf("Running benchmarks with %d warmup and %d measured repetitions", Logger::Info, settings.warmup, settings.repetitions);
+	int32 failed = 0;
+	for(BenchmarkEntry* benchmark : m_benchmarks)
+	{
+		bool selected = filters.empty();
+		for(const String& filter : filters)
+		{
+			if(benchmark->m_name.compare(0, filter.size(), filter) == 0)
+				selected = true;
+		}
+		if(!selected)
+			continue;
+		if(!m_RunBenchmark(benchmark))
+			failed++;
+	}
+
+	Path::DeleteDir(m_basePath);
+	return failed;
+}
+
+bool BenchmarkManager::m_RunBenchmark(BenchmarkEntry* benchmark)
+{
+	Logf("Running benchmark [%s]", Logger::Info, benchmark->m_name);
+	BenchmarkContext context(benchmark->m_name, this);
+	try
+	{
+		benchmark->m_function(context);
+	}
+	catch(BenchmarkFailure failure)
+	{
+		Logf("Benchmark [%s] failed:\n\t%s", Logger::Error, benchmark->m_name, failure.expression);
+		return false;
+	}
+	return true;
+}
+
+void BenchmarkManager::m_AddResult(const String& name, uint32 iterations, Vector<double>& samples)
+{
+	assert(!samples.empty());
+	std::sort(samples.begin(), samples.end());
+
+	// Nearest rank percentile
+	auto Percentile = [&](double p)
+	{
+		size_t rank = (size_t)ceil(p * (double)samples.size());
+		return samples[Math::Clamp<size_t>(rank, 1, samples.size()) - 1];
+	};
+
+	BenchmarkResult result;
+	result.name = name;
+	result.iterations = iterations;
+	result.repetitions = (uint32)samples.size();
+	for(double sample : samples)
+		result.mean += sample;
+	result.mean /= (double)samples.size();
+	result.min = samples.front();
+	result.max = samples.back();
+	result.median = Percentile(0.5);
+	result.p90 = Percentile(0.9);
+	result.p99 = Percentile(0.99);
+	m_results.Add(result);
+
+	Logf("  %-40s median %10.2f us   p90 %10.2f us   p99 %10.2f us", Logger::Info, result.name, result.median, result.p90, result.p99);
+}
+
+Vector<String> BenchmarkManager::GetAvailableBenchmarks() const
+{
+	Vector<String> names;
+	for(auto& b : m_benchmarks)
+	{
+		names.Add(b->m_name);
+	}
+	return names;
+}
+
+bool BenchmarkManager::WriteResults(const String& path) const
+{
+	String json = Utility::Sprintf("{\"buildType\":\"%s\",\"warmup\":%d,\"repetitions\":%d,\"results\":[\n",
+		GetBuildType(), settings.warmup, settings.repetitions);
+	for(size_t i = 0; i < m_results.size(); i++)
+	{
+		const BenchmarkResult& r = m_results[i];
+		json += Utility::Sprintf("{\"name\":\"%s\",\"iterations\":%d,\"repetitions\":%d,\"mean\":%.3f,\"min\":%.3f,\"median\":%.3f,\"p90\":%.3f,\"p99\":%.3f,\"max\":%.3f}",
+			r.name, r.iterations, r.repetitions, r.mean, r.min, r.median, r.p90, r.p99, r.max);
+		json += (i + 1 < m_results.size()) ? ",\n" : "\n";
+	}
+	json += "]}\n";
+
+	File file;
+	if(!file.OpenWrite(path))
+	{
+		Logf("Failed to open benchmark results file for writing: %s", Logger::Error, path);
+		return false;
+	}
+	file.Write(json.data(), json.size());
+	Logf("Wrote %d benchmark results to %s", Logger::Info, (uint32)m_results.size(), path);
+	return true;
+}
+
+// Finds the value of a key in a single line json object written by WriteResults
+//	names never contain quotes, so strings end at the next quote
+static bool FindJsonValue(const String& line, const char* key, String& out)
+{
+	String pattern = Utility::Sprintf("\"%s\":", key);
+	size_t start = line.find(pattern);
+	if(start == String::npos)
+		return false;
+	start += pattern.size();
+	size_t end;
+	if(start < line.size() && line[start] == '"')
+	{
+		start++;
+		end = line.find('"', start);
+	}
+	else
+	{
+		end = line.find_first_of(",}", start);
+	}
+	if(end == String::npos)
+		return false;
+	out = line.substr(start, end - start);
+	return true;
+}
+
+bool BenchmarkManager::ReadResults(const String& path, Vector<BenchmarkResult>& out, String& outBuildType)
+{
+	File file;
+	if(!file.OpenRead(path))
+	{
+		Logf("Failed to open benchmark results file: %s", Logger::Error, path);
+		return false;
+	}
+	String json;
+	json.resize(file.GetSize());
+	file.Read(&json.front(), json.size());
+
+	Vector<String> lines = json.Explode("\n");
+	// Files written before the build type was stored can't be compared
+	outBuildType = "Unknown";
+	if(!lines.empty())
+		FindJsonValue(lines[0], "buildType", outBuildType);
+	for(const String& line : lines)
+	{
+		BenchmarkResult result;
+		String value;
+		if(!FindJsonValue(line, "name", result.name))
+			continue;
+		if(FindJsonValue(line, "iterations", value))
+			result.iterations = atoi(*value);
+		if(FindJsonValue(line, "repetitions", value))
+			result.repetitions = atoi(*value);
+		if(FindJsonValue(line, "mean", value))
+			result.mean = atof(*value);
+		if(FindJsonValue(line, "min", value))
+			result.min = atof(*value);
+		if(!FindJsonValue(line, "median", value))
+			continue;
+		result.median = atof(*value);
+		if(FindJsonValue(line, "p90", value))
+			result.p90 = atof(*value);
+		if(FindJsonValue(line, "p99", value))
+			result.p99 = atof(*value);
+		if(FindJsonValue(line, "max", value))
+			result.max = atof(*value);
+		out.Add(result);
+	}
+	return true;
+}
+
+int32 BenchmarkManager::CompareToBaseline(const Vector<BenchmarkResult>& baseline, const String& baselineBuildType) const
+{
+	// Optimization changes the timings far more than any regression, so there is nothing to compare
+	if(!CheckBuildType(baselineBuildType))
+		return -1;
+
+	Map<String, const BenchmarkResult*> baselineByName;
+	for(const BenchmarkResult& r : baseline)
+	{
+		baselineByName.Add(r.name, &r);
+	}
+
+	Logf("Comparing to baseline, threshold %.0f%%", Logger::Info, settings.threshold * 100.0);
+	int32 regressions = 0;
+	for(const BenchmarkResult& r : m_results)
+	{
+		const BenchmarkResult** base = baselineByName.Find(r.name);
+		if(!base)
+		{
+			Logf("  %-40s no baseline", Logger::Info, r.name);
+			continue;
+		}
+		// Compare medians, they are less affected by outliers than the mean
+		//	a change is only reported if the repetitions barely overlap with the baseline, so noise on a busy machine isn't reported
+		double change = (*base)->median > 0.0 ? r.median / (*base)->median - 1.0 : 0.0;
+		if(change > settings.threshold && r.min > (*base)->p90)
+		{
+			Logf("  %-40s %10.2f us -> %10.2f us (%+.1f%%) regression", Logger::Warning, r.name, (*base)->median, r.median, change * 100.0);
+			regressions++;
+		}
+		else if(change < -settings.threshold && r.p90 < (*base)->min)
+		{
+			Logf("  %-40s %10.2f us -> %10.2f us (%+.1f%%) improvement", Logger::Info, r.name, (*base)->median, r.median, change * 100.0);
+		}
+		else
+		{
+			Logf("  %-40s %10.2f us -> %10.2f us (%+.1f%%)", Logger::Info, r.name, (*base)->median, r.median, change * 100.0);
+		}
+	}
+	return regressions;
+}
+
+String BenchmarkManager::GetBuildType()
+{
+	String buildType = BENCHMARK_BUILD_TYPE;
+	// Single configuration builds without CMAKE_BUILD_TYPE don't enable optimizations
+	return buildType.empty() ? "None" : buildType;
+}
+bool BenchmarkManager::CheckBuildType(const String& buildType)
+{
+	if(buildType == GetBuildType())
+		return true;
+	Logf("Can't compare results of a %s build to this %s build, record the baseline with the same build type", Logger::Error,
+		buildType, GetBuildType());
+	return false;
+}
+
+BenchmarkEntry::BenchmarkEntry(String name, BenchmarkFunction function) : m_name(name), m_function(function)
+{
+	BenchmarkManager::Get().m_benchmarks.Add(this);
+}
+
+void BenchmarkContext::Measure(const String& name, uint32 iterations, std::function<void()> function)
+{
+	const BenchmarkSettings& settings = m_manager->settings;
+	for(uint32 r = 0; r < settings.warmup; r++)
+	{
+		for(uint32 i = 0; i < iterations; i++)
+			function();
+	}
+
+	Vector<double> samples;
+	for(uint32 r = 0; r < settings.repetitions; r++)
+	{
+		Timer timer;
+		for(uint32 i = 0; i < iterations; i++)
+			function();
+		samples.Add((double)timer.Nanoseconds() / 1000.0 / (double)iterations);
+	}
+
+	// Write out the messages of the measured code, so the result doesn't get dropped from a full log queue
+	Logger::Get().Flush();
+	m_manager->m_AddResult(m_name + "." + name, iterations, samples);
+}
+String BenchmarkContext::GetDataPath() const
+{
+	String path = m_manager->m_basePath + Path::sep + m_name;
+	if(!Path::FileExists(path))
+		Path::CreateDir(path);
+	return path;
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <Shared/Macro.hpp>
+#include <functional>
+
+// Benchmark setup failure exception
+class BenchmarkFailure
+{
+public:
+	BenchmarkFailure(String expression = String()) : expression(expression)
+	{
+	}
+	String expression;
+};
+
+// Timing statistics of a single measurement, all times are in microseconds per iteration
+struct BenchmarkResult
+{
+	String name;
+	uint32 iterations = 0;
+	uint32 repetitions = 0;
+	double mean = 0.0;
+	double min = 0.0;
+	double median = 0.0;
+	double p90 = 0.0;
+	double p99 = 0.0;
+	double max = 0.0;
+};
+
+struct BenchmarkSettings
+{
+	// Repetitions that are run before measuring, so caches are filled and lazy initialization is done
+	uint32 warmup = 2;
+	// Measured repetitions
+	uint32 repetitions = 15;
+	// Relative increase of the median over the baseline that is reported as a regression
+	//	the fastest repetition also has to be slower than 90% of the baseline repetitions
+	double threshold = 0.15;
+};
+
+class BenchmarkEntry
+{
+public:
+	typedef void(*BenchmarkFunction)(class BenchmarkContext& context);
+
+	BenchmarkEntry(String name, BenchmarkFunction function);
+
+private:
+	String m_name;
+	BenchmarkFunction m_function;
+	friend class BenchmarkManager;
+};
+
+class BenchmarkManager
+{
+	BenchmarkManager() = default;
+public:
+	static BenchmarkManager& Get();
+
+	// Runs all benchmarks that start with one of the filters, or all benchmarks if there are no filters
+	// returns the number of benchmarks that failed
+	int32 Run(const Vector<String>& filters);
+
+	// Writes the results as json, every result is on a separate line
+	bool WriteResults(const String& path) const;
+	// Reads results written by WriteResults, and the build type they were measured with
+	static bool ReadResults(const String& path, Vector<BenchmarkResult>& out, String& outBuildType);
+	// Logs the difference between the results and a baseline
+	// returns the number of results that regressed by more than the threshold,
+	//	or -1 without comparing when the baseline was measured with a different build type
+	int32 CompareToBaseline(const Vector<BenchmarkResult>& baseline, const String& baselineBuildType) const;
+
+	// Build type of this executable, e.g. Release or Debug
+	static String GetBuildType();
+	// Logs an error and returns false when results of the given build type can't be compared to this build
+	static bool CheckBuildType(const String& buildType);
+
+	const Vector<BenchmarkResult>& GetResults() const { return m_results; }
+	Vector<String> GetAvailableBenchmarks() const;
+
+	BenchmarkSettings settings;
+
+private:
+	bool m_RunBenchmark(BenchmarkEntry* benchmark);
+	void m_AddResult(const String& name, uint32 iterations, Vector<double>& samples);
+	Vector<BenchmarkEntry*> m_benchmarks;
+	Vector<BenchmarkResult> m_results;
+	String m_basePath;
+	friend class BenchmarkEntry;
+	friend class BenchmarkContext;
+};
+
+class BenchmarkContext
+{
+public:
+	BenchmarkContext(String name, BenchmarkManager* mgr) : m_name(name), m_manager(mgr) {};
+
+	// Measures the time it takes to call a function
+	//	every repetition calls the function <iterations> times, the result is stored as <benchmark name>.<name>
+	void Measure(const String& name, uint32 iterations, std::function<void()> function);
+
+	// Folder for files generated by the benchmark, it is removed after all benchmarks have run
+	String GetDataPath() const;
+	String GetName() const { return m_name; }
+
+private:
+	BenchmarkManager* m_manager;
+	String m_name;
+};
+
+#define Benchmark(benchmarkName)\
+static void CONCAT(LocalBenchmark, __LINE__)(BenchmarkContext& context);\
+static BenchmarkEntry* CONCAT(be, __LINE__) = new BenchmarkEntry(benchmarkName, &CONCAT(LocalBenchmark, __LINE__));\
+void CONCAT(LocalBenchmark, __LINE__)(BenchmarkContext& context)
+#define BenchmarkEnsure(__expr) if(!(__expr)) throw BenchmarkFailure(STRINGIFY(__expr));
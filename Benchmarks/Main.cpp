@@ -0,0 +1,101 @@
+#include "stdafx.h"
+
+/*
+	Usage: Benchmarks [benchmark names...] [options]
+		-list					Lists the available benchmarks
+		-output=<path>			Writes the results as json
+		-baseline=<path>		Compares the results to a file written with -output, regressions are reported as errors
+								the baseline has to be measured with the same build type, the checked-in baseline is from a Release build
+		-threshold=<fraction>	Relative increase of the median time that counts as a regression (default 0.15)
+		-repetitions=<n>		Measured repetitions of every measurement
+		-warmup=<n>				Unmeasured repetitions before measuring
+
+	returns the number of failed benchmarks and regressions
+*/
+
+void ListBenchmarks()
+{
+	Logf("Available Benchmarks:", Logger::Info);
+	for(const String& name : BenchmarkManager::Get().GetAvailableBenchmarks())
+	{
+		Logf(" %s", Logger::Info, name);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Vector<String> cmdLine = Path::SplitCommandLine(argc, argv);
+	BenchmarkManager& manager = BenchmarkManager::Get();
+
+	Vector<String> filters;
+	String outputPath;
+	String baselinePath;
+	// First argument is the executable
+	for(size_t i = 1; i < cmdLine.size(); i++)
+	{
+		const String& arg = cmdLine[i];
+		String key, value;
+		if(arg == "-list")
+		{
+			ListBenchmarks();
+			return 0;
+		}
+		else if(arg.Split("=", &key, &value))
+		{
+			if(key == "-output")
+				outputPath = value;
+			else if(key == "-baseline")
+				baselinePath = value;
+			else if(key == "-threshold")
+				manager.settings.threshold = atof(*value);
+			else if(key == "-repetitions")
+				manager.settings.repetitions = Math::Max(atoi(*value), 1);
+			else if(key == "-warmup")
+				manager.settings.warmup = Math::Max(atoi(*value), 0);
+			else
+				Logf("Unknown option \"%s\"", Logger::Warning, arg);
+		}
+		else if(arg.front() == '-')
+		{
+			Logf("Unknown option \"%s\"", Logger::Warning, arg);
+		}
+		else
+		{
+			filters.Add(arg);
+		}
+	}
+
+	// Read the baseline first, so a missing file is reported before spending time on the benchmarks
+	Vector<BenchmarkResult> baseline;
+	String baselineBuildType;
+	if(!baselinePath.empty())
+	{
+		if(!BenchmarkManager::ReadResults(baselinePath, baseline, baselineBuildType))
+			return 1;
+		if(!BenchmarkManager::CheckBuildType(baselineBuildType))
+			return 1;
+	}
+
+	int32 failed = manager.Run(filters);
+	if(failed < 0)
+		return 1;
+	if(manager.GetResults().empty())
+	{
+		Logf("No benchmarks matched the given names", Logger::Error);
+		ListBenchmarks();
+		return 1;
+	}
+
+	if(!outputPath.empty() && !manager.WriteResults(outputPath))
+		failed++;
+
+	int32 regressions = 0;
+	if(!baselinePath.empty())
+	{
+		regressions = manager.CompareToBaseline(baseline, baselineBuildType);
+		if(regressions > 0)
+			Logf("%d benchmarks regressed compared to %s", Logger::Error, regressions, baselinePath);
+	}
+
+	return failed + regressions;
+}
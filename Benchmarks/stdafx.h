@@ -0,0 +1,5 @@
+#pragma once
+
+#include <Graphics/Graphics.hpp>
+#include <Shared/Shared.hpp>
+#include "Benchmark.hpp"
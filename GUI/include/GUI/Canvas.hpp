@@ -32,6 +32,17 @@ public:
 		//	a value of (0,0) places the widget starting from the top-left corner extending to bottom-right
 		//	a value of(1,0) places the widget starting from the top-right corner extending to bottom-left
 		Vector2 alignment;
+
+	protected:
+		// Places the slot again when anchor, offset, auto-sizing or alignment were changed
+		virtual void m_DetectPropertyChanges() override;
+
+	private:
+		Anchor m_lastAnchor;
+		Rect m_lastOffset;
+		bool m_lastAutoSizeX = false;
+		bool m_lastAutoSizeY = false;
+		Vector2 m_lastAlignment;
 	};
 
 	class Canvas::Slot* Add(GUIElement element);
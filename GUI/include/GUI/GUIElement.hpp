@@ -29,12 +29,18 @@ public:
 	virtual bool AddAnimation(Ref<IGUIAnimation> anim, bool removeOld = false);
 	Ref<IGUIAnimation> GetAnimation(void* target);
 	Ref<IGUIAnimation> GetAnimation(uint32 uid);
+	// Removes all animations without finishing them
+	void ClearAnimations();
 
 	// If this element should receive keyboard input events or not
 	virtual bool HasInputFocus() const;
 
 	static bool OverlapTest(Rect rect, Vector2 point);
 
+	// Marks the cached layout of this element and all its parents as outdated
+	//	call this after changing anything that affects the desired size of this element
+	void InvalidateLayout();
+
 	// The slot that contains this element
 	class GUISlotBase* slot = nullptr;
 
@@ -50,11 +56,15 @@ protected:
 	virtual void m_AddedToSlot(GUISlotBase* slot);
 	// Called when the ZOrder of a child slot changed
 	virtual void m_OnZOrderChanged(GUISlotBase* slot);
+	// Updates animations and invalidates layout while any are running
 	void m_TickAnimations(float deltaTime);
 
 	// Animation mapped to target
 	Map<void*, Ref<IGUIAnimation>> m_animationMap;
 
+	// Set by InvalidateLayout, containers that keep the placement of their children recompute it when this is set
+	bool m_layoutInvalid = true;
+
 	// Set if we got input focus from a renderer
 	// this should then be cleared when this element is destroyed
 	GUIRenderer* m_rendererFocus = nullptr;
@@ -90,10 +100,14 @@ public:
 	virtual void PreRender(GUIRenderData rd, GUIElementBase*& inputElement);
 	virtual void Render(GUIRenderData rd);
 	virtual Vector2 GetDesiredSize(GUIRenderData rd);
+	// Clears cached desired sizes and placement of this slot and propagates the invalidation to the parent element
+	void InvalidateLayout();
 	// Applies filling logic based on the selected fill mode
 	static Rect ApplyFill(FillMode fillMode, const Vector2& inSize, const Rect& rect);
 	// Applies alignment to an input rectangle
 	static Rect ApplyAlignment(const Vector2& alignment, const Rect& rect, const Rect& parent);
+	// Compares the position and size of two rectangles
+	static bool SameRect(const Rect& l, const Rect& r);
 
 	// Element that contains this slot
 	GUIElementBase* parent = nullptr;
@@ -107,11 +121,45 @@ public:
 	void SetZOrder(int32 zorder);
 	int32 GetZOrder() const;
 
+	// Number of desired size calculations that could not be served from a slot's cache
+	static uint64 GetDesiredSizeUpdates();
+	// Number of times a slot placement was computed instead of reusing the previous one
+	static uint64 GetPlacementUpdates();
+
 protected:
+	// Desired size of the contained element, without padding
+	//	cached per area size until the layout is invalidated
+	Vector2 m_GetElementDesiredSize(const GUIRenderData& rd);
+	// Invalidates layout when padding or element visibility were changed directly since the last frame
+	//	changes detected this way become visible to parent elements one frame later
+	//	slots extend this with their own placement properties
+	virtual void m_DetectPropertyChanges();
+	// True if m_cachedArea was placed in this area and nothing affecting the placement changed since
+	bool m_IsPlacementRetained(const Rect& area) const;
+	// Keeps the next m_cachedArea until the layout is invalidated or the area changes
+	//	call this before placing the element, so invalidations caused while measuring it are not lost
+	void m_RetainPlacement(const Rect& area);
+	// Places this slot again in the next layout pass, without invalidating the parent element
+	void m_InvalidatePlacement();
+
 	// Cached placement of item
 	Rect m_cachedArea;
 
 private:
+	struct DesiredSizeCacheEntry
+	{
+		bool valid = false;
+		Vector2 areaSize;
+		Vector2 size;
+	};
+	// Most containers request desired sizes for both the full and the assigned area, so keep 2 entries
+	DesiredSizeCacheEntry m_desiredSizeCache[2];
+	uint32 m_desiredSizeCacheNext = 0;
+	bool m_placementValid = false;
+	Rect m_placementArea;
+	Margin m_lastPadding;
+	Visibility m_lastVisibility = Visibility::Visible;
+
 	// Depth sorting for this slot, if applicable
 	int32 m_zorder = 0;
 };
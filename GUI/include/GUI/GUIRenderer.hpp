@@ -16,6 +16,18 @@ public:
 	WString composition;
 };
 
+// Statistics of a rendered GUI frame
+struct GUIRenderStats
+{
+	uint32 drawCalls = 0;
+	// Draw calls of batched rectangles, buttons and text
+	uint32 batchedDrawCalls = 0;
+	// Number of RenderText calls
+	uint32 textCount = 0;
+	// Time spent in RenderText, in milliseconds
+	float textTime = 0.0f;
+};
+
 class GUIRenderer
 {
 public:
@@ -33,6 +45,9 @@ public:
 	void SetWindow(Graphics::Window* window);
 	Graphics::Window* GetWindow() const;
 
+	// Statistics of the last GUI that was rendered with Begin/End
+	const GUIRenderStats& GetLastFrameStats() const;
+
 	void PushScissorRect(const Rect& scissor);
 	void PopScissorRect();
 	Rect GetScissorRect() const;
@@ -88,6 +103,8 @@ public:
 	Material buttonMaterial;
 	// Graph material
 	Material graphMaterial;
+	// Material for batched rectangles, buttons and text
+	Material batchMaterial;
 
 	// Quad material for drawing gui elements
 	Mesh guiQuad;
@@ -104,11 +121,15 @@ private:
 	void m_OnMouseScroll(int32 scroll);
 	// Call to reset text input state after render frame
 	void m_ResetTextInput();
+	// Writes the 6 vertices of a quad and returns the end of the written vertices
+	BatchVertex* m_AddQuad(BatchVertex* dst, const Rect& rect, const Rect& texCoords, const Color& color);
 
 	GUITextInput m_textInput;
 	OpenGL* m_gl;
 	Graphics::Window* m_window = nullptr;
-	RenderQueue* m_renderQueue = nullptr;
+	RenderQueue m_renderQueue;
+	// Set between Begin and End
+	bool m_rendering = false;
 	GUIElementBase* m_hoveredElement = nullptr;
 
 	bool m_mouseButtonState[3] = { 0 };
@@ -123,6 +144,9 @@ private:
 
 	Rect m_viewportSize;
 
+	GUIRenderStats m_frameStats;
+	GUIRenderStats m_lastFrameStats;
+
 	// Size.x < 0 means disabled
 	Rect m_scissorRect;
 	// Stack of scissor rectangles
@@ -40,6 +40,18 @@ public:
 
 		virtual void PreRender(GUIRenderData rd, GUIElementBase*& inputElement);
 		virtual void Render(GUIRenderData rd) override;
+
+	protected:
+		// Invalidates the layout when filling settings were changed, places the slot again when the alignment changed
+		virtual void m_DetectPropertyChanges() override;
+
+	private:
+		bool m_lastFillX = false;
+		bool m_lastFillY = false;
+		float m_lastFillAmount = 1.0f;
+		Vector2 m_lastAlignment = Vector2(0.0f, 0.0f);
+
+		friend class LayoutBox;
 	};
 
 	Slot* Add(GUIElement element);
@@ -49,4 +61,7 @@ public:
 	const Vector<LayoutBox::Slot*>& GetChildren();
 private:
 	Vector<Slot*> m_children;
+	// Child sizes of the last layout pass, kept until the layout is invalidated or the area changes
+	Vector<float> m_childSizes;
+	Rect m_childSizesArea;
 };
\ No newline at end of file
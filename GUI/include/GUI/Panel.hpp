@@ -20,6 +20,13 @@ public:
 
 		// Content alignment
 		Vector2 alignment = Vector2(0.5f,0.5f);
+
+	protected:
+		// Places the slot again when the alignment was changed
+		virtual void m_DetectPropertyChanges() override;
+
+	private:
+		Vector2 m_lastAlignment = Vector2(0.5f, 0.5f);
 	};
 
 	// Sets panel content
@@ -36,5 +43,10 @@ public:
 	Texture texture;
 
 private:
+	// Invalidates layout when the texture or fill mode were changed since the last layout
+	void m_DetectImageChanges();
+
 	Slot* m_content = nullptr;
+	Texture m_layoutTexture;
+	FillMode m_layoutFillMode = FillMode::Stretch;
 };
\ No newline at end of file
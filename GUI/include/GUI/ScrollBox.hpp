@@ -49,6 +49,8 @@ private:
 	Rect m_cachedContentClipRect;
 	Rect m_cachedContentRect;
 	Rect m_cachedSliderRect;
+	// Area the cached rectangles were computed for, they are kept until the layout is invalidated or the area changes
+	Rect m_cachedSourceRect;
 
 	Ref<CommonGUIStyle> m_style;
 	Slot* m_content = nullptr;
@@ -12,6 +12,7 @@ void Button::SetText(const WString& text)
 	{
 		m_textString = text;
 		m_dirty = true;
+		InvalidateLayout();
 	}
 }
 uint32 Button::GetFontSize() const
@@ -24,6 +25,7 @@ void Button::SetFontSize(uint32 size)
 	{
 		m_fontSize = size;
 		m_dirty = true;
+		InvalidateLayout();
 	}
 }
 void Button::PreRender(GUIRenderData rd, GUIElementBase*& inputElement)
@@ -31,6 +33,7 @@ void Button::PreRender(GUIRenderData rd, GUIElementBase*& inputElement)
 	if(m_dirty)
 	{
 		m_text = rd.guiRenderer->font->CreateText(m_textString, m_fontSize);
+		m_dirty = false;
 	}
 
 	m_cachedInnerRect = m_style->buttonBorder.Apply(rd.area);
@@ -98,6 +101,7 @@ Vector2 Button::GetDesiredSize(GUIRenderData rd)
 	if(m_dirty)
 	{
 		m_text = rd.guiRenderer->font->CreateText(m_textString, m_fontSize);
+		m_dirty = false;
 	}
 
 	Vector2 sizeOut;
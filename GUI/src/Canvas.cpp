@@ -43,6 +43,7 @@ class Canvas::Slot* Canvas::Add(GUIElement element)
 	Slot* slot = CreateSlot<Canvas::Slot>(element);
 	m_children.AddUnique(slot);
 	m_SortChildren();
+	InvalidateLayout();
 	return slot;
 }
 void Canvas::Remove(GUIElement element)
@@ -53,6 +54,7 @@ void Canvas::Remove(GUIElement element)
 		{
 			delete *it;
 			it = m_children.erase(it);
+			InvalidateLayout();
 			return;
 		}
 		else
@@ -67,6 +69,7 @@ void Canvas::Clear()
 		delete c;
 	}
 	m_children.clear();
+	InvalidateLayout();
 }
 const Vector<Canvas::Slot*>& Canvas::GetChildren()
 {
@@ -86,36 +89,62 @@ void Canvas::m_SortChildren()
 
 void Canvas::Slot::PreRender(GUIRenderData rd, GUIElementBase*& inputElement)
 {
-	// Apply anchor and offset to get the canvas rectangle
-	rd.area = anchor.Apply(rd.area);
-	
-	// Perform auto-sizing
+	m_DetectPropertyChanges();
+
+	if(!m_IsPlacementRetained(rd.area))
 	{
-		Vector2 size = GetDesiredSize(rd);
-		Rect autoSized = ApplyAlignment(alignment, Rect(Vector2(), size), rd.area);
-		if(autoSizeX)
-		{
-			rd.area.pos.x = autoSized.pos.x;
-			rd.area.size.x = autoSized.size.x;
-		}
-		if(autoSizeY)
+		m_RetainPlacement(rd.area);
+
+		// Apply anchor and offset to get the canvas rectangle
+		rd.area = anchor.Apply(rd.area);
+
+		// Perform auto-sizing
 		{
-			rd.area.pos.y = autoSized.pos.y;
-			rd.area.size.y = autoSized.size.y;
+			Vector2 size = GetDesiredSize(rd);
+			Rect autoSized = ApplyAlignment(alignment, Rect(Vector2(), size), rd.area);
+			if(autoSizeX)
+			{
+				rd.area.pos.x = autoSized.pos.x;
+				rd.area.size.x = autoSized.size.x;
+			}
+			if(autoSizeY)
+			{
+				rd.area.pos.y = autoSized.pos.y;
+				rd.area.size.y = autoSized.size.y;
+			}
 		}
-	}
 
-	rd.area.pos += offset.pos;
-	rd.area.size += offset.size;
+		rd.area.pos += offset.pos;
+		rd.area.size += offset.size;
+
+		// Apply padding
+		rd.area = padding.Apply(rd.area);
+		// Cache area
+		m_cachedArea = rd.area;
+	}
+	rd.area = m_cachedArea;
 
-	// Apply padding
-	rd.area = padding.Apply(rd.area);
-	// Cache area
-	m_cachedArea = rd.area;
-	
 	element->PreRender(rd, inputElement);
 
 }
+void Canvas::Slot::m_DetectPropertyChanges()
+{
+	GUISlotBase::m_DetectPropertyChanges();
+
+	bool sameAnchor = anchor.left == m_lastAnchor.left && anchor.top == m_lastAnchor.top &&
+		anchor.right == m_lastAnchor.right && anchor.bottom == m_lastAnchor.bottom;
+	if(!sameAnchor || !SameRect(offset, m_lastOffset) || autoSizeX != m_lastAutoSizeX || autoSizeY != m_lastAutoSizeY ||
+		alignment.x != m_lastAlignment.x || alignment.y != m_lastAlignment.y)
+	{
+		m_lastAnchor = anchor;
+		m_lastOffset = offset;
+		m_lastAutoSizeX = autoSizeX;
+		m_lastAutoSizeY = autoSizeY;
+		m_lastAlignment = alignment;
+		// These don't affect the desired size, so the parent doesn't need to be invalidated
+		m_InvalidatePlacement();
+	}
+}
 void Canvas::Slot::Render(GUIRenderData rd)
 {
 	rd.area = m_cachedArea;
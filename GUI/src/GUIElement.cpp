@@ -2,6 +2,16 @@
 #include "GUI.hpp"
 #include "GUIRenderer.hpp"
 
+// Desired size calculations that missed the slot caches
+static uint64 desiredSizeUpdates = 0;
+// Slot placements that could not be reused from the previous layout pass
+static uint64 placementUpdates = 0;
+
+static bool SameMargin(const Margin& l, const Margin& r)
+{
+	return l.left == r.left && l.top == r.top && l.right == r.right && l.bottom == r.bottom;
+}
+
 GUIElementBase::~GUIElementBase()
 {
 	if(m_rendererFocus)
@@ -43,6 +53,11 @@ Ref<IGUIAnimation> GUIElementBase::GetAnimation(void* target)
 	return Ref<IGUIAnimation>();
 }
 
+void GUIElementBase::ClearAnimations()
+{
+	m_animationMap.clear();
+}
+
 bool GUIElementBase::HasInputFocus() const
 {
 	return m_rendererFocus != nullptr;
@@ -57,6 +72,13 @@ bool GUIElementBase::OverlapTest(Rect rect, Vector2 point)
 	return true;
 }
 
+void GUIElementBase::InvalidateLayout()
+{
+	m_layoutInvalid = true;
+	if(slot)
+		slot->InvalidateLayout();
+}
+
 void GUIElementBase::m_OnRemovedFromParent()
 {
 	slot = nullptr;
@@ -69,6 +91,10 @@ void GUIElementBase::m_OnZOrderChanged(GUISlotBase* slot)
 }
 void GUIElementBase::m_TickAnimations(float deltaTime)
 {
+	// Animated properties may affect the layout
+	if(!m_animationMap.empty())
+		InvalidateLayout();
+
 	for(auto it = m_animationMap.begin(); it != m_animationMap.end();)
 	{
 		bool done = !it->second->Update(deltaTime);
@@ -89,11 +115,16 @@ GUISlotBase::~GUISlotBase()
 }
 void GUISlotBase::PreRender(GUIRenderData rd, GUIElementBase*& inputElement)
 {
-	// Apply padding
-	Rect scissorRect = rd.area = padding.Apply(rd.area);
+	m_DetectPropertyChanges();
+
+	if(!m_IsPlacementRetained(rd.area))
+	{
+		m_RetainPlacement(rd.area);
 
-	// Store area
-	m_cachedArea = rd.area;
+		// Apply padding
+		m_cachedArea = padding.Apply(rd.area);
+	}
+	rd.area = m_cachedArea;
 
 	element->PreRender(rd, inputElement);
 }
@@ -111,9 +142,66 @@ void GUISlotBase::Render(GUIRenderData rd)
 
 Vector2 GUISlotBase::GetDesiredSize(GUIRenderData rd)
 {
-	Vector2 size = element->GetDesiredSize(rd);
+	Vector2 size = m_GetElementDesiredSize(rd);
 	return size + padding.GetSize();
 }
+void GUISlotBase::InvalidateLayout()
+{
+	for(auto& e : m_desiredSizeCache)
+		e.valid = false;
+	m_placementValid = false;
+	if(parent)
+		parent->InvalidateLayout();
+}
+uint64 GUISlotBase::GetDesiredSizeUpdates()
+{
+	return desiredSizeUpdates;
+}
+uint64 GUISlotBase::GetPlacementUpdates()
+{
+	return placementUpdates;
+}
+Vector2 GUISlotBase::m_GetElementDesiredSize(const GUIRenderData& rd)
+{
+	m_DetectPropertyChanges();
+
+	for(auto& e : m_desiredSizeCache)
+	{
+		if(e.valid && e.areaSize.x == rd.area.size.x && e.areaSize.y == rd.area.size.y)
+			return e.size;
+	}
+
+	DesiredSizeCacheEntry& entry = m_desiredSizeCache[m_desiredSizeCacheNext];
+	m_desiredSizeCacheNext = (m_desiredSizeCacheNext + 1) % 2;
+	entry.size = element->GetDesiredSize(rd);
+	entry.areaSize = rd.area.size;
+	entry.valid = true;
+	desiredSizeUpdates++;
+	return entry.size;
+}
+void GUISlotBase::m_DetectPropertyChanges()
+{
+	if(!SameMargin(padding, m_lastPadding) || element->visibility != m_lastVisibility)
+	{
+		m_lastPadding = padding;
+		m_lastVisibility = element->visibility;
+		InvalidateLayout();
+	}
+}
+bool GUISlotBase::m_IsPlacementRetained(const Rect& area) const
+{
+	return m_placementValid && SameRect(area, m_placementArea);
+}
+void GUISlotBase::m_RetainPlacement(const Rect& area)
+{
+	m_placementValid = true;
+	m_placementArea = area;
+	placementUpdates++;
+}
+void GUISlotBase::m_InvalidatePlacement()
+{
+	m_placementValid = false;
+}
 Rect GUISlotBase::ApplyFill(FillMode fillMode, const Vector2& inSize, const Rect& rect)
 {
 	if(fillMode == FillMode::None)
@@ -177,6 +265,10 @@ Rect GUISlotBase::ApplyAlignment(const Vector2& alignment, const Rect& rect, con
 
 	return Rect(parent.pos + remaining * alignment, rect.size);
 }
+bool GUISlotBase::SameRect(const Rect& l, const Rect& r)
+{
+	return l.pos.x == r.pos.x && l.pos.y == r.pos.y && l.size.x == r.size.x && l.size.y == r.size.y;
+}
 
 void GUISlotBase::SetZOrder(int32 zorder)
 {
@@ -10,7 +10,7 @@
 
 GUIRenderer::~GUIRenderer()
 {
-	assert(!m_renderQueue);
+	assert(!m_rendering);
 	SetInputFocus(nullptr);
 	SetWindow(nullptr);
 }
@@ -49,6 +49,11 @@ bool GUIRenderer::Init(class OpenGL* gl, class Graphics::Window* window, String
 	buttonMaterial->opaque = false;
 	CheckedLoad(graphMaterial = LoadMaterial("guiGraph"));
 	graphMaterial->opaque = false;
+	CheckedLoad(batchMaterial = LoadMaterial("guiBatch"));
+	batchMaterial->opaque = false;
+
+	// The queue is reused every frame so it's batched vertices don't need to be reallocated
+	m_renderQueue = RenderQueue(m_gl, RenderState());
 
 	guiQuad = MeshGenerators::Quad(m_gl, Vector2(0, 0), Vector2(1, 1));
 
@@ -76,7 +81,7 @@ void GUIRenderer::Render(float deltaTime, Rect viewportSize, Ref<class GUIElemen
 
 	// Render GUI
 	GUIRenderData grd;
-	grd.rq = m_renderQueue;
+	grd.rq = &m_renderQueue;
 	grd.guiRenderer = this;
 	grd.deltaTime = deltaTime;
 	grd.area = viewportSize;
@@ -111,11 +116,14 @@ void GUIRenderer::Render(float deltaTime, Rect viewportSize, Ref<class GUIElemen
 Graphics::RenderQueue& GUIRenderer::Begin()
 {
 	// Must have not called begin before this / or have called end
-	assert(m_renderQueue == nullptr);
+	assert(!m_rendering);
+	m_rendering = true;
 
 	// Set initial scissor rect to be disabled
 	m_scissorRect = Rect(Vector2(0, 0), Vector2(-1));
 
+	m_frameStats = GUIRenderStats();
+
 	// Render state/queue for the GUI
 	Vector2 windowSize = m_window->GetWindowSize();
 	RenderState guiRs;
@@ -123,30 +131,33 @@ Graphics::RenderQueue& GUIRenderer::Begin()
 	guiRs.projectionTransform = ProjectionMatrix::CreateOrthographic(0, windowSize.x, windowSize.y, 0.0f, -1.0f, 100.0f);
 	guiRs.aspectRatio = windowSize.y / windowSize.x;
 	guiRs.time = m_time;
-	m_renderQueue = new RenderQueue(m_gl, guiRs);
+	m_renderQueue.SetRenderState(guiRs);
 
-	return *m_renderQueue;
+	return m_renderQueue;
 }
 void GUIRenderer::End()
 {
 	// Must have called Begin
-	assert(m_renderQueue);
+	assert(m_rendering);
 
 	// Render all elements placed in the queue previously
 
 	/// NOTE: GUI is the other way around
-	glCullFace(GL_FRONT);
+	m_gl->Enqueue([]() { glCullFace(GL_FRONT); });
 
-	m_renderQueue->Process();
+	m_renderQueue.Process();
+	const RenderQueueStats& queueStats = m_renderQueue.GetStats();
+	m_frameStats.drawCalls = queueStats.drawCalls;
+	m_frameStats.batchedDrawCalls = queueStats.batchedDrawCalls;
+	m_lastFrameStats = m_frameStats;
 
 	// Verify if scissor rectangle state was correctly restored
 	assert(m_scissorRectangles.empty());
 
-	delete m_renderQueue;
-	m_renderQueue = nullptr;
+	m_rendering = false;
 
 	// Reset face culling mode
-	glCullFace(GL_BACK);
+	m_gl->Enqueue([]() { glCullFace(GL_BACK); });
 }
 
 void GUIRenderer::SetWindow(Graphics::Window* window)
@@ -182,6 +193,11 @@ Graphics::Window* GUIRenderer::GetWindow() const
 	return m_window;
 }
 
+const GUIRenderStats& GUIRenderer::GetLastFrameStats() const
+{
+	return m_lastFrameStats;
+}
+
 void GUIRenderer::PushScissorRect(const Rect& scissor)
 {
 	if(!m_scissorRectangles.empty())
@@ -265,12 +281,11 @@ Vector2i GUIRenderer::RenderText(const WString& str, const Vector2& position, co
 	if(m_scissorRect.size.x == 0 || m_scissorRect.size.y == 0)
 		return Vector2i(0, 0);
 
+	Timer textTimer;
 	Text text = font->CreateText(str, fontSize);
-	Transform textTransform;
-	textTransform *= Transform::Translation(position);
-	MaterialParameterSet params;
-	params.SetParameter("color", color);
-	m_renderQueue->DrawScissored(m_scissorRect, textTransform, text, fontMaterial, params);
+	m_renderQueue.DrawTextBatched(m_scissorRect, position, text, batchMaterial, color);
+	m_frameStats.textCount++;
+	m_frameStats.textTime += textTimer.SecondsAsFloat() * 1000.0f;
 	return text->size;
 }
 Vector2i GUIRenderer::RenderText(const String& str, const Vector2& position, const Color& color /*= Color(1.0f)*/, uint32 fontSize /*= 16*/)
@@ -282,31 +297,21 @@ void GUIRenderer::RenderText(Text& text, const Vector2& position, const Color& c
 	if(m_scissorRect.size.x == 0 || m_scissorRect.size.y == 0)
 		return;
 
-	Transform textTransform;
-	textTransform *= Transform::Translation(position);
-	MaterialParameterSet params;
-	params.SetParameter("color", color);
-	m_renderQueue->DrawScissored(m_scissorRect, textTransform, text, fontMaterial, params);
+	Timer textTimer;
+	m_renderQueue.DrawTextBatched(m_scissorRect, position, text, batchMaterial, color);
+	m_frameStats.textCount++;
+	m_frameStats.textTime += textTimer.SecondsAsFloat() * 1000.0f;
 }
 void GUIRenderer::RenderRect(const Rect& rect, const Color& color /*= Color(1.0f)*/, Texture texture /*= Texture()*/)
 {
 	if(m_scissorRect.size.x == 0 || m_scissorRect.size.y == 0)
 		return;
 
-	Transform transform;
-	transform *= Transform::Translation(rect.pos);
-	transform *= Transform::Scale(Vector3(rect.size.x, rect.size.y, 1.0f));
-	MaterialParameterSet params;
-	params.SetParameter("color", color);
+	BatchVertex* vertices = m_renderQueue.DrawBatched(m_scissorRect, batchMaterial, texture, 6);
 	if(texture)
-	{
-		params.SetParameter("mainTex", texture);
-		m_renderQueue->DrawScissored(m_scissorRect, transform, guiQuad, textureMaterial, params);
-	}
+		m_AddQuad(vertices, rect, Rect(0, 0, 1, 1), color);
 	else
-	{
-		m_renderQueue->DrawScissored(m_scissorRect, transform, guiQuad, colorMaterial, params);
-	}
+		m_AddQuad(vertices, rect, Rect(Vector2(-1), Vector2()), color);
 }
 void GUIRenderer::RenderGraph(const Rect& rect, const Texture& graphTex, const Color& upperColor, const Color& lowerColor, const float& colorBorder)
 {
@@ -322,7 +327,7 @@ void GUIRenderer::RenderGraph(const Rect& rect, const Texture& graphTex, const C
 	params.SetParameter("lowerColor", lowerColor);
 	params.SetParameter("colorBorder", colorBorder);
 	params.SetParameter("viewport", Vector2(rect.size.x,rect.size.y));
-	m_renderQueue->DrawScissored(m_scissorRect, transform, guiQuad, graphMaterial, params);
+	m_renderQueue.DrawScissored(m_scissorRect, transform, guiQuad, graphMaterial, params);
 	
 }
 
@@ -332,31 +337,36 @@ void GUIRenderer::RenderButton(const Rect& rect, Texture texture, Margini border
 	if(m_scissorRect.size.x == 0 || m_scissorRect.size.y == 0)
 		return;
 
-	Transform transform;
-	transform *= Transform::Translation(rect.pos);
-	MaterialParameterSet params;
-	params.SetParameter("color", color);
-	params.SetParameter("mainTex", texture);
-
-	// Calculate border offsets
-	Rect r2 = border.Apply(Recti(rect));
-	Vector2 size = texture->GetSize();
-
-	Vector2 tl = (r2.pos - rect.pos) / rect.size;
-	Vector2 br = (r2.size + r2.pos - rect.pos) / rect.size;
-	Vector4 borderCoords = Vector4(tl.x, tl.y, br.x, br.y);
-
-	// Texture border coords
-	Vector2 textl = Vector2((float)border.left, (float)border.top) / size;
-	Vector2 texbr = Vector2(1.0f) - Vector2((float)border.right, (float)border.bottom) / size;
-	Vector4 texBorderCoords = Vector4(textl.x, textl.y, texbr.x, texbr.y);
-
-	params.SetParameter("border", borderCoords);
-	params.SetParameter("texBorder", texBorderCoords);
-	params.SetParameter("size", rect.size);
-	params.SetParameter("texSize", size);
-
-	m_renderQueue->DrawScissored(m_scissorRect, transform, pointMesh, buttonMaterial, params);
+	// Split the button into 9 parts, only the center and sides are stretched
+	Vector2 texSize = texture->GetSize();
+	float x[4], y[4], u[4], v[4];
+	x[0] = rect.Left();
+	x[3] = rect.Right();
+	x[1] = Math::Min(x[0] + border.left, x[3]);
+	x[2] = Math::Max(x[3] - border.right, x[1]);
+	y[0] = rect.Top();
+	y[3] = rect.Bottom();
+	y[1] = Math::Min(y[0] + border.top, y[3]);
+	y[2] = Math::Max(y[3] - border.bottom, y[1]);
+	u[0] = 0.0f;
+	u[1] = (float)border.left / texSize.x;
+	u[2] = 1.0f - (float)border.right / texSize.x;
+	u[3] = 1.0f;
+	v[0] = 0.0f;
+	v[1] = (float)border.top / texSize.y;
+	v[2] = 1.0f - (float)border.bottom / texSize.y;
+	v[3] = 1.0f;
+
+	BatchVertex* vertices = m_renderQueue.DrawBatched(m_scissorRect, batchMaterial, texture, 9 * 6);
+	for(uint32 i = 0; i < 3; i++)
+	{
+		for(uint32 j = 0; j < 3; j++)
+		{
+			Rect quad = Rect(x[j], y[i], x[j + 1], y[i + 1]);
+			Rect texCoords = Rect(u[j], v[i], u[j + 1], v[i + 1]);
+			vertices = m_AddQuad(vertices, quad, texCoords, color);
+		}
+	}
 }
 
 const Vector2i& GUIRenderer::GetMousePos() const
@@ -391,6 +401,22 @@ GUIElementBase* GUIRenderer::GetHoveredElement()
 	return m_hoveredElement;
 }
 
+BatchVertex* GUIRenderer::m_AddQuad(BatchVertex* dst, const Rect& rect, const Rect& texCoords, const Color& color)
+{
+	Colori vertexColor = color.ToRGBA8();
+	Vector2 tl = rect.pos;
+	Vector2 br = rect.pos + rect.size;
+	Vector2 uvtl = texCoords.pos;
+	Vector2 uvbr = texCoords.pos + texCoords.size;
+	*dst++ = BatchVertex(Vector2(br.x, br.y), Vector2(uvbr.x, uvbr.y), vertexColor);
+	*dst++ = BatchVertex(Vector2(tl.x, tl.y), Vector2(uvtl.x, uvtl.y), vertexColor);
+	*dst++ = BatchVertex(Vector2(br.x, tl.y), Vector2(uvbr.x, uvtl.y), vertexColor);
+	*dst++ = BatchVertex(Vector2(tl.x, br.y), Vector2(uvtl.x, uvbr.y), vertexColor);
+	*dst++ = BatchVertex(Vector2(tl.x, tl.y), Vector2(uvtl.x, uvtl.y), vertexColor);
+	*dst++ = BatchVertex(Vector2(br.x, br.y), Vector2(uvbr.x, uvbr.y), vertexColor);
+	return dst;
+}
+
 void GUIRenderer::m_OnTextInput(const WString& input)
 {
 	m_textInput.input += input;
@@ -39,15 +39,21 @@ void Label::SetText(const WString& text)
 		return; // No needless updates
 	m_textString = text;
 	m_dirty = true;
+	InvalidateLayout();
 }
 void Label::SetFont(Graphics::Font font)
 {
 	m_font = font;
+	m_dirty = true;
+	InvalidateLayout();
 }
 void Label::SetTextOptions(FontRes::TextOptions options)
 {
 	if(m_textOptions != options)
+	{
 		m_dirty = true;
+		InvalidateLayout();
+	}
 	m_textOptions = options;
 }
 Graphics::FontRes::TextOptions Label::GetTextOptions() const
@@ -62,6 +68,7 @@ void Label::SetFontSize(uint32 size)
 {
 	m_fontSize = size;
 	m_dirty = true;
+	InvalidateLayout();
 }
 uint32 Label::GetFontSize() const
 {
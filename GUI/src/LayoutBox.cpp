@@ -16,13 +16,23 @@ void LayoutBox::PreRender(GUIRenderData rd, GUIElementBase*& inputElement)
 {
 	m_TickAnimations(rd.deltaTime);
 
+	// Pick up directly changed slot settings before deciding if the child sizes can be kept
+	for(Slot* s : m_children)
+		s->m_DetectPropertyChanges();
+
 	Rect sourceRect = rd.area;
-	Vector<float> elementSizes = CalculateSizes(rd);
+	if(m_layoutInvalid || !GUISlotBase::SameRect(sourceRect, m_childSizesArea))
+	{
+		// Cleared first, so invalidations caused while measuring the children are not lost
+		m_layoutInvalid = false;
+		m_childSizesArea = sourceRect;
+		m_childSizes = CalculateSizes(rd);
+	}
 
 	float offset = 0.0f;
 	for(size_t i = 0; i < m_children.size(); i++)
 	{
-		float mySize = elementSizes[i];
+		float mySize = m_childSizes[i];
 
 		rd.area = sourceRect;
 		if(layoutDirection == Vertical)
@@ -86,6 +96,7 @@ LayoutBox::Slot* LayoutBox::Add(GUIElement element)
 
 	Slot* slot = CreateSlot<LayoutBox::Slot>(element);
 	m_children.AddUnique(slot);
+	InvalidateLayout();
 	return slot;
 }
 void LayoutBox::Remove(GUIElement element)
@@ -95,6 +106,7 @@ void LayoutBox::Remove(GUIElement element)
 		if((*it)->element == element)
 		{
 			m_children.erase(it);
+			InvalidateLayout();
 			break;
 		}
 		else
@@ -173,33 +185,60 @@ void LayoutBox::Clear()
 		delete s;
 	}
 	m_children.clear();
+	InvalidateLayout();
 }
 
 void LayoutBox::Slot::PreRender(GUIRenderData rd, GUIElementBase*& inputElement)
 {
-	Vector2 size = GetDesiredSize(rd);
+	m_DetectPropertyChanges();
 
-	// Padding
-	rd.area = padding.Apply(rd.area);
-
-	// Filling
-	if(!fillX || !fillY)
+	if(!m_IsPlacementRetained(rd.area))
 	{
-		Rect rect = rd.area;
-		if(!fillX && size.x < rd.area.size.x)
-		{
-			rect.size.x = size.x;
-		}
-		if(!fillY && size.y < rd.area.size.y)
+		m_RetainPlacement(rd.area);
+
+		Vector2 size = GetDesiredSize(rd);
+
+		// Padding
+		rd.area = padding.Apply(rd.area);
+
+		// Filling
+		if(!fillX || !fillY)
 		{
-			rect.size.y = size.y;
+			Rect rect = rd.area;
+			if(!fillX && size.x < rd.area.size.x)
+			{
+				rect.size.x = size.x;
+			}
+			if(!fillY && size.y < rd.area.size.y)
+			{
+				rect.size.y = size.y;
+			}
+			rd.area = GUISlotBase::ApplyAlignment(alignment, rect, rd.area);
 		}
-		rd.area = GUISlotBase::ApplyAlignment(alignment, rect, rd.area);
+		m_cachedArea = rd.area;
 	}
-	m_cachedArea = rd.area;
+	rd.area = m_cachedArea;
 
 	element->PreRender(rd, inputElement);
 }
+void LayoutBox::Slot::m_DetectPropertyChanges()
+{
+	GUISlotBase::m_DetectPropertyChanges();
+
+	// Filling changes the sizes the parent assigns to its children
+	if(fillX != m_lastFillX || fillY != m_lastFillY || fillAmount != m_lastFillAmount)
+	{
+		m_lastFillX = fillX;
+		m_lastFillY = fillY;
+		m_lastFillAmount = fillAmount;
+		InvalidateLayout();
+	}
+	if(alignment.x != m_lastAlignment.x || alignment.y != m_lastAlignment.y)
+	{
+		m_lastAlignment = alignment;
+		m_InvalidatePlacement();
+	}
+}
 void LayoutBox::Slot::Render(GUIRenderData rd)
 {
 	rd.area = m_cachedArea;
@@ -14,6 +14,7 @@ Panel::~Panel()
 void Panel::PreRender(GUIRenderData rd, GUIElementBase*& inputElement)
 {
 	m_TickAnimations(rd.deltaTime);
+	m_DetectImageChanges();
 
 	if(m_content)
 	{
@@ -41,6 +42,8 @@ void Panel::Render(GUIRenderData rd)
 }
 Vector2 Panel::GetDesiredSize(GUIRenderData rd)
 {
+	m_DetectImageChanges();
+
 	if(visibility == Visibility::Collapsed)
 		return Vector2();
 
@@ -68,21 +71,37 @@ Panel::Slot* Panel::SetContent(GUIElement content)
 	{
 		m_content = CreateSlot<Slot>(content);
 	}
+	InvalidateLayout();
 	return m_content;
 }
 Panel::Slot* Panel::GetContentSlot()
 {
 	return m_content;
 }
+void Panel::m_DetectImageChanges()
+{
+	if(texture == m_layoutTexture && imageFillMode == m_layoutFillMode)
+		return;
+	m_layoutTexture = texture;
+	m_layoutFillMode = imageFillMode;
+	InvalidateLayout();
+}
 
 void Panel::Slot::PreRender(GUIRenderData rd, GUIElementBase*& inputElement)
 {
-	rd.area = padding.Apply(rd.area);
+	m_DetectPropertyChanges();
+
+	if(!m_IsPlacementRetained(rd.area))
+	{
+		m_RetainPlacement(rd.area);
+
+		rd.area = padding.Apply(rd.area);
 
-	Vector2 size = GetDesiredSize(rd);
+		Vector2 size = GetDesiredSize(rd);
 
-	rd.area = GUISlotBase::ApplyAlignment(alignment, Rect(Vector2(),size), rd.area);
-	m_cachedArea = rd.area;
+		m_cachedArea = GUISlotBase::ApplyAlignment(alignment, Rect(Vector2(),size), rd.area);
+	}
+	rd.area = m_cachedArea;
 
 	element->PreRender(rd, inputElement);
 }
@@ -93,5 +112,15 @@ void Panel::Slot::Render(GUIRenderData rd)
 }
 Vector2 Panel::Slot::GetDesiredSize(GUIRenderData rd)
 {
-	return element->GetDesiredSize(rd);
+	return m_GetElementDesiredSize(rd);
+}
+void Panel::Slot::m_DetectPropertyChanges()
+{
+	GUISlotBase::m_DetectPropertyChanges();
+
+	if(alignment.x != m_lastAlignment.x || alignment.y != m_lastAlignment.y)
+	{
+		m_lastAlignment = alignment;
+		m_InvalidatePlacement();
+	}
 }
@@ -35,30 +35,37 @@ void ScrollBox::PreRender(GUIRenderData rd, GUIElementBase*& inputElement)
 		}
 	}
 
-	m_cachedSliderRect = Rect(Vector2(), m_vscroll->GetDesiredSize(rd));
-	m_cachedContentRect = sourceRect;
-	m_cachedContentRect.size.x -= m_cachedSliderRect.size.x;
-	m_cachedSliderRect.pos = m_cachedContentRect.pos;
-	m_cachedSliderRect.pos.x += m_cachedContentRect.size.x;
-	m_cachedSliderRect.size.y = m_cachedContentRect.size.y;
-	if(m_content)
-	{
-		m_cachedContentClipRect = m_cachedContentRect;
-
-		/// Note: Maybe change way of getting desired size of vertical box containers
-		rd.area.size.y = 100000000.0f;
-		Vector2 contentSize = m_content->GetDesiredSize(rd);
-
-		// Check for vertical overflow of content
-		if(contentSize.y > sourceRect.size.y)
-		{
-			m_vscroll->showButton = true;
-			m_cachedContentRect.size.y = contentSize.y;
-		}
-		else
+	if(m_layoutInvalid || !GUISlotBase::SameRect(sourceRect, m_cachedSourceRect))
+	{
+		// Cleared first, so invalidations caused while measuring the content are not lost
+		m_layoutInvalid = false;
+		m_cachedSourceRect = sourceRect;
+
+		m_cachedSliderRect = Rect(Vector2(), m_vscroll->GetDesiredSize(rd));
+		m_cachedContentRect = sourceRect;
+		m_cachedContentRect.size.x -= m_cachedSliderRect.size.x;
+		m_cachedSliderRect.pos = m_cachedContentRect.pos;
+		m_cachedSliderRect.pos.x += m_cachedContentRect.size.x;
+		m_cachedSliderRect.size.y = m_cachedContentRect.size.y;
+		if(m_content)
 		{
-			// No scrolling required
-			m_vscroll->showButton = false;
+			m_cachedContentClipRect = m_cachedContentRect;
+
+			/// Note: Maybe change way of getting desired size of vertical box containers
+			rd.area.size.y = 100000000.0f;
+			Vector2 contentSize = m_content->GetDesiredSize(rd);
+
+			// Check for vertical overflow of content
+			if(contentSize.y > sourceRect.size.y)
+			{
+				m_vscroll->showButton = true;
+				m_cachedContentRect.size.y = contentSize.y;
+			}
+			else
+			{
+				// No scrolling required
+				m_vscroll->showButton = false;
+			}
 		}
 	}
 
@@ -114,6 +121,7 @@ ScrollBox::Slot* ScrollBox::SetContent(GUIElement content)
 		m_content = CreateSlot<Slot>(content);
 		m_vscroll->SetValue(0);
 	}
+	InvalidateLayout();
 	return m_content;
 }
 ScrollBox::Slot* ScrollBox::GetContentSlot()
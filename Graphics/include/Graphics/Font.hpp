@@ -1,5 +1,6 @@
 #pragma once
 #include <Graphics/ResourceTypes.hpp>
+#include <Graphics/VertexFormat.hpp>
 
 #ifdef None
 #undef None
@@ -7,18 +8,32 @@
 
 namespace Graphics
 {
+	// Vertex used for text, the color is white unless the text was added to a batch
+	struct TextVertex : public VertexFormat<Vector2, Vector2, VectorMath::VectorBase<uint8, 4>>
+	{
+		TextVertex() = default;
+		TextVertex(Vector2 point, Vector2 uv, Colori color = Colori::White) : pos(point), tex(uv), color(color) {}
+		Vector2 pos;
+		Vector2 tex;
+		Colori color;
+	};
+
 	/*
-		A prerendered text object, contains all the vertices and texture sheets to draw itself
+		A prerendered text object, contains the glyph quads and texture sheet to draw itself
+		the mesh is only created when the text is drawn on it's own instead of through a text batch
 	*/
 	class TextRes
 	{
 		friend class Font_Impl;
 		struct FontSize* fontSize;
 		Ref<class MeshRes> mesh;
+		Vector<TextVertex> vertices;
 	public:
 		~TextRes();
 		Ref<class TextureRes> GetTexture();
-		Ref<class MeshRes> GetMesh() { return mesh; }
+		Ref<class MeshRes> GetMesh();
+		// Glyph quads as triangle lists, relative to the top left of the text
+		const Vector<TextVertex>& GetVertices() const { return vertices; }
 		void Draw();
 		Vector2 size;
 	};
@@ -42,6 +57,20 @@ namespace Graphics
 		// Renders the input string into a drawable text object
 		virtual Ref<TextRes> CreateText(const WString& str, uint32 nFontSize, TextOptions options = TextOptions::None) = 0;
 
+		// Rasterizes all the characters in the input string ahead of time, so they don't have to be rendered when text is created
+		//	safe to call from job threads, the results are added to the glyph atlas in a single upload on the next CreateText call
+		virtual void PreloadGlyphs(const WString& str, uint32 nFontSize) = 0;
+
+		// Statistics of the text layout caches of all fonts
+		struct TextCacheStats
+		{
+			uint64 hits;
+			uint64 misses;
+			uint64 evictions;
+			// Total time spent laying out text that was not in the cache, in seconds
+			double layoutTime;
+		};
+		static TextCacheStats GetTextCacheStats();
 	};
 
 	typedef Ref<FontRes> Font;
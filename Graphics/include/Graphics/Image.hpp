@@ -12,6 +12,8 @@ namespace Graphics
 	public:
 		virtual ~ImageRes() = default;
 		static Ref<ImageRes> Create(const String& assetPath);
+		// Loads an image scaled down to fit within the given size keeping it's aspect ratio, for thumbnails
+		static Ref<ImageRes> Create(const String& assetPath, Vector2i size);
 		static Ref<ImageRes> Create(Vector2i size = Vector2i());
 	public:
 		virtual void SetSize(Vector2i size) = 0;
@@ -21,25 +23,46 @@ namespace Graphics
 		virtual const Colori* GetBits() const = 0;
 	};
 
+	/*
+		Counters for texture uploads performed by sprite maps
+	*/
+	struct SpriteMapUploadStats
+	{
+		// Number of texture uploads, partial or full
+		uint64 numUploads = 0;
+		// Number of uploads that had to send the whole image
+		uint64 numFullUploads = 0;
+		// Total amount of pixel data sent
+		uint64 bytesUploaded = 0;
+	};
+
 	/*
 		Sprite map
 		Adding images to this will pack the image into a final image that contains all the added images
 		After this the UV coordinates of these images can be asked for given and image index
 
-		!! The packing is not optimal as the images are stacked for bottom to top and placed in columns based on their width
+		Images are packed into horizontal shelves on a preallocated page, the page only grows (doubles in size) when it is full
+		The region modified since the last texture update is tracked so only that part needs to be uploaded
 	*/
 	class TextureRes;
 	class SpriteMapRes
 	{
 	public:
 		virtual ~SpriteMapRes() = default;
-		static Ref<SpriteMapRes> Create();
+		static Ref<SpriteMapRes> Create(Vector2i initialSize = Vector2i(512));
 	public:
 		virtual uint32 AddSegment(Ref<ImageRes> image) = 0;
 		virtual void Clear() = 0;
 		virtual Ref<ImageRes> GetImage() = 0;
 		virtual Ref<class TextureRes> GenerateTexture(class OpenGL* gl) = 0;
+		// Brings a texture created from this sprite map up to date
+		//	only the modified region is uploaded, the texture is recreated if it doesn't exist or the sprite map has grown
+		//	returns true if anything was uploaded
+		virtual bool UpdateTexture(class OpenGL* gl, Ref<class TextureRes>& texture) = 0;
 		virtual Recti GetCoords(uint32 nIndex) = 0;
+
+		// Upload counters of all sprite maps combined
+		static SpriteMapUploadStats GetUploadStats();
 	};
 
 	typedef Ref<ImageRes> Image;
@@ -13,5 +13,11 @@ namespace Graphics
 	{
 	public:
 		static bool Load(ImageRes* outPtr, const String& fullPath);
+		// Loads an image scaled down to fit within the given size, keeping it's aspect ratio
+		//	images that already fit are not scaled up
+		//	JPEGs are decoded at a reduced scale when they are much larger than the requested size
+		static bool Load(ImageRes* outPtr, const String& fullPath, Vector2i size);
+		// Saves an image as a JPEG, the alpha channel is discarded
+		static bool SaveJPEG(const ImageRes* image, const String& fullPath, int32 quality = 90);
 	};
 }
\ No newline at end of file
@@ -41,6 +41,9 @@ namespace Graphics
 		virtual void Draw() = 0;
 		// Draws the mesh after if has already been drawn once, reuse of bound objects
 		virtual void Redraw() = 0;
+		// Draws a range of the vertices in the mesh
+		virtual void DrawRange(size_t first, size_t count) = 0;
+		virtual void RedrawRange(size_t first, size_t count) = 0;
 
 	private:
 		virtual void SetData(const void* pData, size_t vertexCount, const VertexFormatList& desc) = 0;
@@ -1,6 +1,7 @@
 #pragma once
 #include <Graphics/GL.hpp>
 #include <Graphics/Window.hpp>
+#include <Graphics/RenderThread.hpp>
 
 namespace Graphics
 {
@@ -19,7 +20,10 @@ namespace Graphics
 		uint32 m_mainProgramPipeline;
 		class OpenGL_Impl* m_impl;
 		Window* m_window;
-		class FramebufferRes* m_boundFramebuffer;
+		class FramebufferRes* m_boundFramebuffer = nullptr;
+		// Last viewport set through SetViewport, so it can be read without waiting for the render thread
+		Recti m_viewport;
+		RenderThread m_renderThread;
 
 		friend class ShaderRes;
 		friend class TextureRes;
@@ -35,6 +39,7 @@ namespace Graphics
 		bool Init(Window& window);
 		void UnbindFramebuffer();
 
+		// Viewport of the frame being recorded
 		Recti GetViewport() const;
 		void SetViewport(Vector2i size);
 		void SetViewport(Recti vp);
@@ -42,6 +47,22 @@ namespace Graphics
 		// Check if the calling thread is the thread that runs this OpenGL context
 		bool IsOpenGLThread() const;
 
+		// Moves the context to a render thread, GL work from the main thread is forwarded to it after this
+		bool StartRenderThread();
+		// Executes all remaining work and moves the context back to the calling thread
+		void StopRenderThread();
+		bool HasRenderThread() const;
+		const RenderThread& GetRenderThread() const;
+
+		// Adds GL commands to the frame being recorded by the main thread
+		//	runs them right away when called on the OpenGL thread
+		void Enqueue(RenderThread::Command&& command);
+		// Runs GL work on the OpenGL thread before the next frame without waiting for it
+		void Post(RenderThread::Command&& task);
+		// Runs GL work on the OpenGL thread and waits for it
+		void Invoke(const RenderThread::Command& task) const;
+
+		// Presents the frame, with a render thread this submits the recorded frame to it instead
 		virtual void SwapBuffers();
 	};
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include <Graphics/Material.hpp>
 #include <Graphics/Texture.hpp>
+#include <Graphics/Mesh.hpp>
 #include <Graphics/ParticleParameter.hpp>
 
 namespace Graphics
@@ -69,6 +70,8 @@ namespace Graphics
 
 		class Particle* m_particles = nullptr;
 		uint32 m_poolSize = 0;
+		// Vertices of the particles of the last frame
+		Mesh m_mesh;
 
 		// Particle parameters private
 #define PARTICLE_PARAMETER(__name, __type)\
@@ -29,6 +29,9 @@ namespace Graphics
 		Transform worldTransform; 
 		// Scissor rectangle
 		Rect scissorRect;
+		// Range of vertices to draw, the whole mesh is drawn when the count is 0
+		uint32 firstVertex = 0;
+		uint32 numVertices = 0;
 	};
 
 	// Command for points/lines with size/width parameter
@@ -42,11 +45,38 @@ namespace Graphics
 		float size;
 	};
 
+	// Batched 2D geometry uses the same vertex layout as text, so glyph quads can be copied directly
+	typedef TextVertex BatchVertex;
+
+	// Command that draws a range of the batched vertices collected by the render queue
+	class BatchedDrawCall : public RenderQueueItem
+	{
+	public:
+		BatchedDrawCall();
+		Material mat;
+		MaterialParameterSet params;
+		// Texture used by all the vertices in this batch, may be null if none of them are textured
+		Texture texture;
+		Rect scissorRect;
+		uint32 firstVertex = 0;
+		uint32 numVertices = 0;
+	};
+
+	// Statistics of the last processed queue
+	struct RenderQueueStats
+	{
+		uint32 drawCalls = 0;
+		// Draw calls used for batched geometry
+		uint32 batchedDrawCalls = 0;
+		uint32 batchedVertices = 0;
+	};
+
 	/*
 		This class is a queue that collects draw commands
 		each of these is stored together with their wanted render state.
 
 		When Process is called, the commands are sorted and grouped, then sent to the graphics pipeline.
+		Processing a queue on another thread than the OpenGL thread adds its commands to the frame recorded for the render thread
 	*/
 	class RenderQueue : public Unique
 	{
@@ -56,6 +86,8 @@ namespace Graphics
 		RenderQueue(RenderQueue&& other);
 		RenderQueue& operator=(RenderQueue&& other);
 		~RenderQueue();
+		// Sets the render state used by the next Process call
+		void SetRenderState(const RenderState& rs);
 		// Processes all render commands
 		void Process(bool clearQueue = true);
 		// Clears all the render commands in the queue
@@ -64,13 +96,39 @@ namespace Graphics
 		void Draw(Transform worldTransform, Ref<class TextRes> text, Material mat, const MaterialParameterSet& params = MaterialParameterSet());
 		void DrawScissored(Rect scissor, Transform worldTransform, Mesh m, Material mat, const MaterialParameterSet& params = MaterialParameterSet());
 		void DrawScissored(Rect scissor, Transform worldTransform, Ref<class TextRes> text, Material mat, const MaterialParameterSet& params = MaterialParameterSet());
+		// Draws a range of the vertices in a mesh
+		//	the mesh data only needs to contain this range when the queue is processed
+		void DrawRange(Transform worldTransform, Mesh m, uint32 firstVertex, uint32 numVertices, Material mat, const MaterialParameterSet& params = MaterialParameterSet());
 
 		// Draw for lines/points with point size parameter
 		void DrawPoints(Mesh m, Material mat, const MaterialParameterSet& params, float pointSize);
 
+		// Adds vertices to a stream shared by all batched geometry in this queue and returns them to be filled in
+		//	vertices added right after other batched vertices with the same material, texture and scissor rectangle don't need another draw call
+		//	a null texture matches any texture, the material should ignore the texture for these vertices
+		//	the returned pointer is only valid until the next batched draw
+		BatchVertex* DrawBatched(Rect scissor, Material mat, Texture texture, uint32 numVertices);
+		// Adds text to the batched geometry, the color is stored in the vertices
+		//	the material should use normalized texture coordinates
+		void DrawTextBatched(Rect scissor, Vector2 position, Ref<class TextRes> text, Material mat, const Color& color);
+
+		// Statistics of the last time Process was called
+		const RenderQueueStats& GetStats() const;
+
 	private:
+		// Uploads the batched vertices, on the OpenGL thread right before the commands that draw them
+		void m_UploadBatch();
+		// Sends the commands to the graphics pipeline, only touches resources through raw pointers
+		void m_Execute();
+		static RenderQueueItem* m_CopyItem(RenderQueueItem* item);
+
 		RenderState m_renderState;
 		Vector<RenderQueueItem*> m_orderedCommands;
 		class OpenGL* m_ogl = nullptr;
+
+		// Vertices of all batched geometry, kept between frames to reuse their storage
+		Vector<BatchVertex> m_batchVertices;
+		Mesh m_batchMesh;
+		RenderQueueStats m_stats;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+#include <Shared/Thread.hpp>
+#include <Shared/Action.hpp>
+#include <functional>
+#include <condition_variable>
+
+namespace Graphics
+{
+	/*
+		Thread that executes the GL commands recorded by another thread
+		frames are recorded into one of two command lists while the other one is executed,
+		this way the next frame can be simulated and recorded while the previous one is still being submitted to the driver.
+		Executed frames are released on the recording thread when their command list is reused, so commands may hold references to resources.
+
+		Tasks are executed in between frames in the order they were posted, they are released on the render thread
+	*/
+	class RenderThread : public Unique
+	{
+	public:
+		typedef std::function<void()> Command;
+
+		~RenderThread();
+
+		// Called on the render thread after it starts and before it stops, used to take over the context
+		Action<void> onStart;
+		Action<void> onStop;
+
+		// Starts the thread, returns false if it was already running
+		bool Start();
+		// Executes all remaining frames and tasks and stops the thread
+		void Stop();
+		bool IsRunning() const;
+		std::thread::id GetThreadId() const;
+
+		// Adds a command to the frame that is being recorded
+		void Enqueue(Command&& command);
+		// Hands the recorded frame to the render thread
+		//	waits until the frame before it has finished executing, so only a single frame is in flight
+		void SubmitFrame();
+		// Runs a task before the next frame, without waiting for it
+		void Post(Command&& task);
+		// Runs a task before the next frame and waits until it is done
+		void Invoke(const Command& task);
+		// Waits until all submitted frames and posted tasks have been executed
+		void Finish();
+
+		// Time the render thread spent executing the last frame
+		double GetLastFrameTime() const;
+		// Time the recording thread spent waiting for the previous frame in the last SubmitFrame
+		double GetLastSubmitWait() const;
+
+	private:
+		void m_Run();
+		// Releases the commands of the executed frame
+		void m_RecycleFrame(std::unique_lock<std::mutex>& lock);
+
+		std::thread m_thread;
+		std::thread::id m_threadId;
+		mutable std::mutex m_lock;
+		// Wakes the render thread
+		std::condition_variable m_wake;
+		// Wakes threads waiting for frames or tasks to finish
+		std::condition_variable m_done;
+
+		Vector<Command> m_frames[2];
+		// Frame being recorded, the other one is in flight or executed
+		uint32 m_recordIndex = 0;
+		bool m_framePending = false;
+		bool m_frameExecuted = false;
+
+		Vector<Command> m_tasks;
+		uint64 m_numTasksPosted = 0;
+		uint64 m_numTasksDone = 0;
+		// Number of tasks posted before the pending frame was submitted
+		uint64 m_frameTaskMark = 0;
+
+		bool m_running = false;
+		bool m_stop = false;
+
+		double m_lastFrameTime = 0.0;
+		double m_lastSubmitWait = 0.0;
+	};
+}
@@ -30,6 +30,9 @@ namespace Graphics
 	public:
 		virtual void Init(Vector2i size, TextureFormat format = TextureFormat::RGBA8) = 0;
 		virtual void SetData(Vector2i size, void* pData) = 0;
+		// Updates a region of an RGBA8 texture that has already been initialized
+		//	rowLength is the width of the source data in pixels, 0 means the source is tightly packed
+		virtual void SetSubData(Vector2i pos, Vector2i size, const void* pData, uint32 rowLength = 0) = 0;
 		virtual void SetMipmaps(bool enabled) = 0;
 		virtual void SetFilter(bool enabled, bool mipFiltering = true, float anisotropic = 1.0f) = 0;
 		virtual const Vector2i& GetSize() const = 0;
@@ -61,8 +61,9 @@ namespace Graphics
 		// Window Client area size
 		Vector2i GetWindowSize() const;
 
-		// Set vsync setting
-		void SetVSync(int8 setting);
+		// Set vsync setting, 0 = off, 1 = on, -1 = adaptive
+		//	returns false if the setting is not supported
+		bool SetVSync(int8 setting);
 
 		// Window is active
 		bool IsActive() const;
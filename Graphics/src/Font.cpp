@@ -6,50 +6,81 @@
 #include "Mesh.hpp"
 #include "OpenGL.hpp"
 #include <Shared/Timer.hpp>
+#include <Shared/Thread.hpp>
+#include <atomic>
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
 namespace Graphics
 {
-	struct CachedText
+	// Identifies a text layout in the text cache, the string itself is stored with the layout to resolve hash collisions
+	struct TextCacheKey
 	{
-		Text text;
-		float lastUsage;
+		uint32 fontSize;
+		uint32 options;
+		size_t hash;
+		bool operator<(const TextCacheKey& other) const
+		{
+			if(hash != other.hash)
+				return hash < other.hash;
+			if(fontSize != other.fontSize)
+				return fontSize < other.fontSize;
+			return options < other.options;
+		}
 	};
+
+	static FontRes::TextCacheStats textCacheStats = { 0 };
+
 	// Prevents continuous recreation of text that doesn't change
-	class TextCache : public Map<WString, CachedText>
+	//	holds a fixed number of text layouts, the least recently used layout is removed when the cache is full
+	class TextCache
 	{
-		Timer timer;
+		struct Entry
+		{
+			TextCacheKey key;
+			WString str;
+			Text text;
+		};
+		// Most recently used layouts are at the front
+		List<Entry> m_entries;
+		Map<TextCacheKey, List<Entry>::iterator> m_lookup;
+		size_t m_maxEntries;
 	public:
-		void Update()
+		TextCache(size_t maxEntries) : m_maxEntries(maxEntries)
 		{
-			float currentTime = timer.SecondsAsFloat();
-			for(auto it = begin(); it != end();)
-			{
-				float durationSinceUsed = currentTime - it->second.lastUsage;
-				if(durationSinceUsed > 1.0f)
-				{
-					it = erase(it);
-					continue;
-				}
-				it++;
-			}
 		}
-		Text GetText(const WString& key)
+		Text GetText(const TextCacheKey& key, const WString& str)
 		{
-			auto it = find(key);
-			if(it != end())
+			auto it = m_lookup.find(key);
+			if(it == m_lookup.end() || it->second->str != str)
 			{
-				it->second.lastUsage = timer.SecondsAsFloat();
-				return it->second.text;
+				textCacheStats.misses++;
+				return Text();
 			}
-			return Text();
+			textCacheStats.hits++;
+			m_entries.splice(m_entries.begin(), m_entries, it->second);
+			return it->second->text;
 		}
-		void AddText(const WString& key, Text obj)
+		void AddText(const TextCacheKey& key, const WString& str, Text obj)
 		{
-			Update();
-			Add(key, { obj, timer.SecondsAsFloat() });
+			// Replace text with a colliding hash
+			auto it = m_lookup.find(key);
+			if(it != m_lookup.end())
+			{
+				m_entries.erase(it->second);
+				m_lookup.erase(it);
+			}
+
+			while(m_entries.size() >= m_maxEntries)
+			{
+				m_lookup.erase(m_entries.back().key);
+				m_entries.pop_back();
+				textCacheStats.evictions++;
+			}
+
+			m_entries.AddFront({ key, str, obj });
+			m_lookup.Add(key, m_entries.begin());
 		}
 	};
 
@@ -79,22 +110,72 @@ namespace Graphics
 		int32 topOffset;
 		Recti coords;
 	};
-	struct FontSize
+
+	// A glyph that was rendered ahead of time and still has to be added to the atlas
+	struct PreloadedGlyph
+	{
+		wchar_t character;
+		CharInfo info;
+		Image image;
+	};
+
+	// Glyph atlas shared by all sizes of a single font
+	struct FontAtlas
 	{
 		SpriteMap spriteMap;
 		Texture textureMap;
+	};
+
+	// Protects creation and destruction of faces, the FreeType library object is not thread safe
+	static Mutex libraryLock;
+
+	// Renders a single glyph into an image, the fallback face is used for characters that are not in the font
+	static Image RasterizeGlyph(FT_Face face, FT_Face fallback, wchar_t t, CharInfo& ci)
+	{
+		FT_Face* pFace = &face;
+
+		ci.glyphID = FT_Get_Char_Index(*pFace, t);
+		if(ci.glyphID == 0)
+		{
+			pFace = &fallback;
+			ci.glyphID = FT_Get_Char_Index(*pFace, t);
+		}
+		FT_Load_Glyph(*pFace, ci.glyphID, FT_LOAD_DEFAULT);
+
+		if((*pFace)->glyph->format != FT_GLYPH_FORMAT_BITMAP)
+		{
+			FT_Render_Glyph((*pFace)->glyph, FT_RENDER_MODE_NORMAL);
+		}
+
+		ci.topOffset = (*pFace)->glyph->bitmap_top;
+		ci.leftOffset = (*pFace)->glyph->bitmap_left;
+		ci.advance = (float)(*pFace)->glyph->advance.x / 64.0f;
+
+		Image img = ImageRes::Create(Vector2i((*pFace)->glyph->bitmap.width, (*pFace)->glyph->bitmap.rows));
+		Colori* pDst = img->GetBits();
+		uint8* pSrc = (*pFace)->glyph->bitmap.buffer;
+		uint32 nLen = (*pFace)->glyph->bitmap.width * (*pFace)->glyph->bitmap.rows;
+		for(uint32 i = 0; i < nLen; i++)
+		{
+			pDst[0].w = pSrc[0];
+			Reinterpret<VectorBase<uint8, 3>>(pDst[0]) = VectorBase<uint8, 3>(255, 255, 255);
+			pSrc++;
+			pDst++;
+		}
+		return img;
+	}
+
+	struct FontSize
+	{
+		FontAtlas* atlas;
 		FT_Face face;
 		Vector<CharInfo> infos;
 		Map<wchar_t, uint32> infoByChar;
-		bool bUpdated = false;
 		float lineHeight;
-		TextCache cache;
 
-		FontSize(OpenGL* gl, FT_Face& face)
-			: face(face), m_gl(gl)
+		FontSize(OpenGL* gl, FT_Face& face, FontAtlas* atlas)
+			: atlas(atlas), face(face), m_gl(gl)
 		{
-			spriteMap = SpriteMapRes::Create();
-			textureMap = TextureRes::Create(m_gl);
 			lineHeight = (float)face->size->metrics.height / 64.0f;
 		}
 		~FontSize()
@@ -108,55 +189,41 @@ namespace Graphics
 				return AddCharInfo(t);
 			return infos[it->second];
 		}
+		OpenGL* GetGL()
+		{
+			return m_gl;
+		}
 		Texture GetTextureMap()
 		{
-			if(bUpdated)
+			// Only uploads glyphs that were added since the last call
+			Texture previous = atlas->textureMap;
+			atlas->spriteMap->UpdateTexture(m_gl, atlas->textureMap);
+			if(atlas->textureMap != previous)
 			{
-				textureMap = spriteMap->GenerateTexture(m_gl);
-				bUpdated = false;
+				// Glyphs are drawn at whole pixel positions, so they are sampled without filtering
+				atlas->textureMap->SetFilter(false, false);
 			}
-			return textureMap;
+			return atlas->textureMap;
+		}
+		void AddPreloadedGlyph(const PreloadedGlyph& glyph)
+		{
+			if(infoByChar.Contains(glyph.character))
+				return;
+			infoByChar.Add(glyph.character, (uint32)infos.size());
+			CharInfo& ci = infos.Add(glyph.info);
+			uint32 nIndex = atlas->spriteMap->AddSegment(glyph.image);
+			ci.coords = atlas->spriteMap->GetCoords(nIndex);
 		}
 	private:
 		const CharInfo& AddCharInfo(wchar_t t)
 		{
-			bUpdated = true;
 			infoByChar.Add(t, (uint32)infos.size());
 			infos.emplace_back();
 			CharInfo& ci = infos.back();
 
-			FT_Face* pFace = &face;
-
-			ci.glyphID = FT_Get_Char_Index(*pFace, t);
-			if(ci.glyphID == 0)
-			{
-				pFace = &fallbackFont;
-				ci.glyphID = FT_Get_Char_Index(*pFace, t);
-			}
-			FT_Load_Glyph(*pFace, ci.glyphID, FT_LOAD_DEFAULT);
-
-			if((*pFace)->glyph->format != FT_GLYPH_FORMAT_BITMAP)
-			{
-				FT_Render_Glyph((*pFace)->glyph, FT_RENDER_MODE_NORMAL);
-			}
-
-			ci.topOffset = (*pFace)->glyph->bitmap_top;
-			ci.leftOffset = (*pFace)->glyph->bitmap_left;
-			ci.advance = (float)(*pFace)->glyph->advance.x / 64.0f;
-
-			Image img = ImageRes::Create(Vector2i((*pFace)->glyph->bitmap.width, (*pFace)->glyph->bitmap.rows));
-			Colori* pDst = img->GetBits();
-			uint8* pSrc = (*pFace)->glyph->bitmap.buffer;
-			uint32 nLen = (*pFace)->glyph->bitmap.width * (*pFace)->glyph->bitmap.rows;
-			for(uint32 i = 0; i < nLen; i++)
-			{
-				pDst[0].w = pSrc[0];
-				Reinterpret<VectorBase<uint8, 3>>(pDst[0]) = VectorBase<uint8, 3>(255, 255, 255);
-				pSrc++;
-				pDst++;
-			}
-			uint32 nIndex = spriteMap->AddSegment(img);
-			ci.coords = spriteMap->GetCoords(nIndex);
+			Image img = RasterizeGlyph(face, fallbackFont, t, ci);
+			uint32 nIndex = atlas->spriteMap->AddSegment(img);
+			ci.coords = atlas->spriteMap->GetCoords(nIndex);
 
 			return ci;
 		}
@@ -173,10 +240,21 @@ namespace Graphics
 	{
 		return fontSize->GetTextureMap();
 	}
+	Ref<class MeshRes> TextRes::GetMesh()
+	{
+		// Text that is only drawn through text batches never needs a mesh
+		if(!mesh)
+		{
+			mesh = MeshRes::Create(fontSize->GetGL());
+			mesh->SetData(vertices);
+			mesh->SetPrimitiveType(PrimitiveType::TriangleList);
+		}
+		return mesh;
+	}
 	void TextRes::Draw()
 	{
 		GetTexture()->Bind();
-		mesh->Draw();
+		GetMesh()->Draw();
 	}
 
 	class Font_Impl : public FontRes
@@ -187,11 +265,29 @@ namespace Graphics
 		Map<uint32, FontSize*> m_sizes;
 		uint32 m_currentSize = 0;
 
+		// Glyphs of all sizes are packed into the same atlas
+		FontAtlas m_atlas;
+
+		// Layouts of recently created text of all sizes
+		TextCache m_textCache;
+
+		// Separate faces used to render glyphs on other threads
+		FT_Face m_preloadFace = nullptr;
+		FT_Face m_preloadFallbackFace = nullptr;
+		bool m_preloadFacesFailed = false;
+		Mutex m_preloadFaceLock;
+
+		// Glyphs rendered on other threads, keyed by font size
+		Map<uint32, Vector<PreloadedGlyph>> m_preloadedGlyphs;
+		Map<uint32, Set<wchar_t>> m_preloadedChars;
+		std::atomic<bool> m_havePreloadedGlyphs;
+		Mutex m_preloadLock;
+
 		OpenGL* m_gl;
 
 		friend class TextRes;
 	public:
-		Font_Impl(class OpenGL* gl) : m_gl(gl)
+		Font_Impl(class OpenGL* gl) : m_textCache(2048), m_havePreloadedGlyphs(false), m_gl(gl)
 		{
 
 		}
@@ -202,7 +298,14 @@ namespace Graphics
 				delete s.second;
 			}
 			m_sizes.clear();
+
+			libraryLock.lock();
 			FT_Done_Face(m_face);
+			if(m_preloadFace)
+				FT_Done_Face(m_preloadFace);
+			if(m_preloadFallbackFace)
+				FT_Done_Face(m_preloadFallbackFace);
+			libraryLock.unlock();
 		}
 		bool Init(const String& assetPath)
 		{
@@ -216,12 +319,17 @@ namespace Graphics
 
 			in.Read(&m_data.front(), m_data.size());
 
-			if(FT_New_Memory_Face(library, m_data.data(), (FT_Long)m_data.size(), 0, &m_face) != 0)
+			libraryLock.lock();
+			bool loaded = FT_New_Memory_Face(library, m_data.data(), (FT_Long)m_data.size(), 0, &m_face) == 0;
+			libraryLock.unlock();
+			if(!loaded)
 				return false;
 
 			if(FT_Select_Charmap(m_face, FT_ENCODING_UNICODE) != 0)
 				assert(false);
 
+			m_atlas.spriteMap = SpriteMapRes::Create();
+
 			return true;
 		}
 
@@ -242,31 +350,67 @@ namespace Graphics
 			if(it != m_sizes.end())
 				return it->second;
 
-			FontSize* pMap = new FontSize(m_gl, m_face);
+			FontSize* pMap = new FontSize(m_gl, m_face, &m_atlas);
 			m_sizes.Add(nSize, pMap);
 			return pMap;
 		}
+		void PreloadGlyphs(const WString& str, uint32 nFontSize) override
+		{
+			Vector<PreloadedGlyph> glyphs;
+
+			m_preloadFaceLock.lock();
+			if(m_preloadFacesFailed || (!m_preloadFace && !m_CreatePreloadFaces()))
+			{
+				m_preloadFaceLock.unlock();
+				return;
+			}
+			FT_Set_Pixel_Sizes(m_preloadFace, 0, nFontSize);
+			FT_Set_Pixel_Sizes(m_preloadFallbackFace, 0, nFontSize);
+
+			for(wchar_t c : str)
+			{
+				// Skip characters that were preloaded before
+				m_preloadLock.lock();
+				bool known = m_preloadedChars.FindOrAdd(nFontSize).Contains(c);
+				if(!known)
+					m_preloadedChars[nFontSize].Add(c);
+				m_preloadLock.unlock();
+				if(known)
+					continue;
+
+				PreloadedGlyph& glyph = glyphs.Add();
+				glyph.character = c;
+				glyph.image = RasterizeGlyph(m_preloadFace, m_preloadFallbackFace, c, glyph.info);
+			}
+			m_preloadFaceLock.unlock();
+
+			if(glyphs.empty())
+				return;
+
+			m_preloadLock.lock();
+			Vector<PreloadedGlyph>& pending = m_preloadedGlyphs.FindOrAdd(nFontSize);
+			pending.insert(pending.end(), glyphs.begin(), glyphs.end());
+			m_havePreloadedGlyphs = true;
+			m_preloadLock.unlock();
+		}
 		Ref<TextRes> CreateText(const WString& str, uint32 nFontSize, TextOptions options)
 		{
+			m_AddPreloadedGlyphs();
 			FontSize* size = GetSize(nFontSize);
 
-			Text cachedText = size->cache.GetText(str);
+			TextCacheKey key = { nFontSize, (uint32)options, std::hash<std::wstring>()(str) };
+			Text cachedText = m_textCache.GetText(key, str);
 			if(cachedText)
 				return cachedText;
 
-			struct TextVertex : public VertexFormat<Vector2, Vector2>
-			{
-				TextVertex(Vector2 point, Vector2 uv) : pos(point), tex(uv) {}
-				Vector2 pos;
-				Vector2 tex;
-			};
+			Timer layoutTimer;
 
 			TextRes* ret = new TextRes();
-			ret->mesh = MeshRes::Create(m_gl);
 
 			float monospaceWidth = size->GetCharInfo(L'_').advance;
 
-			Vector<TextVertex> vertices;
+			Vector<TextVertex>& vertices = ret->vertices;
+			vertices.reserve(str.size() * 6);
 			Vector2 pen;
 			for(wchar_t c : str)
 			{
@@ -331,16 +475,59 @@ namespace Graphics
 			ret->size.y += size->lineHeight;
 
 			ret->fontSize = size;
-			ret->mesh->SetData(vertices);
-			ret->mesh->SetPrimitiveType(PrimitiveType::TriangleList);
 
 			Text textObj = Ref<TextRes>(ret);
 			// Insert into cache
-			size->cache.AddText(str, textObj);
+			m_textCache.AddText(key, str, textObj);
+			textCacheStats.layoutTime += layoutTimer.SecondsAsDouble();
 			return textObj;
 		}
+
+	private:
+		bool m_CreatePreloadFaces()
+		{
+			Buffer& fallbackData = _libraryInitializer.loadedFallbackFont;
+			libraryLock.lock();
+			bool success = FT_New_Memory_Face(library, m_data.data(), (FT_Long)m_data.size(), 0, &m_preloadFace) == 0;
+			success = success && FT_New_Memory_Face(library, fallbackData.data(), (FT_Long)fallbackData.size(), 0, &m_preloadFallbackFace) == 0;
+			libraryLock.unlock();
+			success = success && FT_Select_Charmap(m_preloadFace, FT_ENCODING_UNICODE) == 0;
+			success = success && FT_Select_Charmap(m_preloadFallbackFace, FT_ENCODING_UNICODE) == 0;
+			if(!success)
+			{
+				Log("Failed to create faces for glyph preloading", Logger::Warning);
+				m_preloadFacesFailed = true;
+			}
+			return success;
+		}
+		// Moves glyphs rendered by PreloadGlyphs into the atlas
+		void m_AddPreloadedGlyphs()
+		{
+			if(!m_havePreloadedGlyphs)
+				return;
+
+			m_preloadLock.lock();
+			Map<uint32, Vector<PreloadedGlyph>> preloaded = std::move(m_preloadedGlyphs);
+			m_preloadedGlyphs.clear();
+			m_havePreloadedGlyphs = false;
+			m_preloadLock.unlock();
+
+			for(auto& p : preloaded)
+			{
+				FontSize* size = GetSize(p.first);
+				for(auto& glyph : p.second)
+				{
+					size->AddPreloadedGlyph(glyph);
+				}
+			}
+		}
 	};
 
+	FontRes::TextCacheStats FontRes::GetTextCacheStats()
+	{
+		return textCacheStats;
+	}
+
 	Font FontRes::Create(OpenGL* gl, const String& assetPath)
 	{
 		Font_Impl* pImpl = new Font_Impl(gl);
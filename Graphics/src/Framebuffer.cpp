@@ -21,12 +21,20 @@ namespace Graphics
 		}
 		~Framebuffer_Impl()
 		{
-			if(m_fb > 0)
-				glDeleteFramebuffers(1, &m_fb);
 			assert(!m_isBound);
+			// Deleted in order with the frame, after the binds that were recorded before
+			uint32 fb = m_fb;
+			if(fb > 0)
+				m_gl->Enqueue([fb]() { glDeleteFramebuffers(1, &fb); });
 		}
 		bool Init()
 		{
+			if(!m_gl->IsOpenGLThread())
+			{
+				bool result = false;
+				m_gl->Invoke([&]() { result = Init(); });
+				return result;
+			}
 			glGenFramebuffers(1, &m_fb);
 			return m_fb != 0;
 		}
@@ -34,6 +42,12 @@ namespace Graphics
 		{
 			if(!tex)
 				return false;
+			if(!m_gl->IsOpenGLThread())
+			{
+				bool result = false;
+				m_gl->Invoke([&]() { result = AttachTexture(tex); });
+				return result;
+			}
 			m_textureSize = tex->GetSize();
 			uint32 texHandle = (uint32)tex->Handle();
 			TextureFormat fmt = tex->GetFormat();
@@ -60,45 +74,60 @@ namespace Graphics
 		}
 		virtual void Bind()
 		{
+			// The bound state belongs to the thread that records the frame
 			assert(!m_isBound);
+			m_isBound = true;
+			m_gl->m_boundFramebuffer = this;
 
-			// Adjust viewport to frame buffer
-			//glGetIntegerv(GL_VIEWPORT, &m_gl->m_lastViewport.pos.x);
-			//glViewport(0, 0, m_textureSize.x, m_textureSize.y);
-			glBindFramebuffer(GL_FRAMEBUFFER, m_fb);
-
-			if(m_depthAttachment)
-			{
-				GLenum drawBuffers[2] =
-				{
-					GL_COLOR_ATTACHMENT0,
-					GL_DEPTH_ATTACHMENT
-				};
-				glDrawBuffers(2, drawBuffers);
-			}
-			else
+			// Bound in order with the draws of the frame being recorded
+			//	the command only uses copies, the framebuffer may be released before the frame is executed
+			uint32 fb = m_fb;
+			bool depthAttachment = m_depthAttachment;
+			m_gl->Enqueue([fb, depthAttachment]()
 			{
-				glDrawBuffer(GL_COLOR_ATTACHMENT0);
-			}
+				// Adjust viewport to frame buffer
+				//glGetIntegerv(GL_VIEWPORT, &m_gl->m_lastViewport.pos.x);
+				//glViewport(0, 0, m_textureSize.x, m_textureSize.y);
+				glBindFramebuffer(GL_FRAMEBUFFER, fb);
 
-			m_isBound = true;
-			m_gl->m_boundFramebuffer = this;
+				if(depthAttachment)
+				{
+					GLenum drawBuffers[2] =
+					{
+						GL_COLOR_ATTACHMENT0,
+						GL_DEPTH_ATTACHMENT
+					};
+					glDrawBuffers(2, drawBuffers);
+				}
+				else
+				{
+					glDrawBuffer(GL_COLOR_ATTACHMENT0);
+				}
+			});
 		}
 		virtual void Unbind()
 		{
 			assert(m_isBound && m_gl->m_boundFramebuffer == this);
-
-			// Restore viewport
-			//Recti& vp = m_gl->m_lastViewport;
-			//glViewport(vp.pos.x, vp.pos.y, vp.size.x, vp.size.y);
-			glBindFramebuffer(GL_FRAMEBUFFER, 0);
-			glDrawBuffer(GL_BACK);
-
 			m_isBound = false;
 			m_gl->m_boundFramebuffer = nullptr;
+
+			m_gl->Enqueue([]()
+			{
+				// Restore viewport
+				//Recti& vp = m_gl->m_lastViewport;
+				//glViewport(vp.pos.x, vp.pos.y, vp.size.x, vp.size.y);
+				glBindFramebuffer(GL_FRAMEBUFFER, 0);
+				glDrawBuffer(GL_BACK);
+			});
 		}
 		virtual bool IsComplete() const
 		{
+			if(!m_gl->IsOpenGLThread())
+			{
+				bool result = false;
+				m_gl->Invoke([&]() { result = IsComplete(); });
+				return result;
+			}
 			#ifdef __APPLE__
 			int complete = glCheckFramebufferStatus(m_fb);
 			#else
@@ -94,4 +94,18 @@ namespace Graphics
 		}
 		return Image();
 	}
+	Image ImageRes::Create(const String& assetPath, Vector2i size)
+	{
+		Image_Impl* pImpl = new Image_Impl();
+		if(ImageLoader::Load(pImpl, assetPath, size))
+		{
+			return GetResourceManager<ResourceType::Image>().Register(pImpl);
+		}
+		else
+		{
+			delete pImpl;
+			pImpl = nullptr;
+		}
+		return Image();
+	}
 }
\ No newline at end of file
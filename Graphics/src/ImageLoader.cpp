@@ -46,7 +46,54 @@ namespace Graphics
 		{
 		}
 
-		bool LoadJPEG(ImageRes* pImage, Buffer& in)
+		// Largest size that fits within maxSize with the aspect ratio of the source, never larger than the source
+		static Vector2i FitSize(Vector2i srcSize, Vector2i maxSize)
+		{
+			if(srcSize.x <= maxSize.x && srcSize.y <= maxSize.y)
+				return srcSize;
+			// Limited by the width or the height, whichever needs to shrink more
+			if((int64)srcSize.x * maxSize.y >= (int64)srcSize.y * maxSize.x)
+				return Vector2i(maxSize.x, Math::Max(1, (int32)(((int64)srcSize.y * maxSize.x + srcSize.x / 2) / srcSize.x)));
+			return Vector2i(Math::Max(1, (int32)(((int64)srcSize.x * maxSize.y + srcSize.y / 2) / srcSize.y)), maxSize.y);
+		}
+
+		// Scales an image to the given size, averaging all the source pixels covered by each destination pixel
+		static void Resample(ImageRes* pImage, Vector2i size)
+		{
+			Vector2i srcSize = pImage->GetSize();
+			if((srcSize.x == size.x && srcSize.y == size.y) || size.x <= 0 || size.y <= 0 || srcSize.x <= 0 || srcSize.y <= 0)
+				return;
+
+			Vector<Colori> src(pImage->GetBits(), pImage->GetBits() + srcSize.x * srcSize.y);
+			pImage->SetSize(size);
+			Colori* pBits = pImage->GetBits();
+			for(int32 y = 0; y < size.y; y++)
+			{
+				int32 y0 = y * srcSize.y / size.y;
+				int32 y1 = Math::Max(y0 + 1, (y + 1) * srcSize.y / size.y);
+				for(int32 x = 0; x < size.x; x++)
+				{
+					int32 x0 = x * srcSize.x / size.x;
+					int32 x1 = Math::Max(x0 + 1, (x + 1) * srcSize.x / size.x);
+					uint32 sum[4] = { 0 };
+					for(int32 sy = y0; sy < y1; sy++)
+					{
+						const uint8* row = (const uint8*)(src.data() + sy * srcSize.x);
+						for(int32 sx = x0; sx < x1; sx++)
+						{
+							for(uint32 c = 0; c < 4; c++)
+								sum[c] += row[sx * 4 + c];
+						}
+					}
+					uint32 count = (x1 - x0) * (y1 - y0);
+					uint8* dst = (uint8*)(pBits + y * size.x + x);
+					for(uint32 c = 0; c < 4; c++)
+						dst[c] = (uint8)((sum[c] + count / 2) / count);
+				}
+			}
+		}
+
+		bool LoadJPEG(ImageRes* pImage, Buffer& in, Vector2i targetSize = Vector2i())
 		{
 
 			/* This struct contains the JPEG decompression parameters and pointers to
@@ -68,6 +115,20 @@ namespace Graphics
 				jpeg_mem_src(&cinfo, in.data(), (uint32)in.size());
 				int res = jpeg_read_header(&cinfo, TRUE);
 
+				// Let the decoder skip detail that is lost when scaling down anyways
+				if(targetSize.x > 0 && targetSize.y > 0)
+				{
+					targetSize = FitSize(Vector2i(cinfo.image_width, cinfo.image_height), targetSize);
+					cinfo.scale_num = 1;
+					cinfo.scale_denom = 1;
+					while(cinfo.scale_denom < 8 &&
+						cinfo.image_width / (cinfo.scale_denom * 2) >= (uint32)targetSize.x &&
+						cinfo.image_height / (cinfo.scale_denom * 2) >= (uint32)targetSize.y)
+					{
+						cinfo.scale_denom *= 2;
+					}
+				}
+
 				jpeg_start_decompress(&cinfo);
 				int row_stride = cinfo.output_width * cinfo.output_components;
 				JSAMPARRAY sample = (*cinfo.mem->alloc_sarray)
@@ -125,7 +186,7 @@ namespace Graphics
 			png_image_free(&image);
 			return true;
 		}
-		bool Load(ImageRes* pImage, const String& fullPath)
+		bool Load(ImageRes* pImage, const String& fullPath, Vector2i size = Vector2i())
 		{
 			File f;
 			if(!f.OpenRead(fullPath))
@@ -137,10 +198,74 @@ namespace Graphics
 				return false;
 
 			// Check for PNG based on first 4 bytes
+			bool loaded;
 			if(*(uint32*)b.data() == (uint32&)"PNG")
-				return LoadPNG(pImage, b);
+				loaded = LoadPNG(pImage, b);
 			else // jay-PEG ?
-				return LoadJPEG(pImage, b);
+				loaded = LoadJPEG(pImage, b, size);
+
+			if(loaded && size.x > 0 && size.y > 0)
+				Resample(pImage, FitSize(pImage->GetSize(), size));
+			return loaded;
+		}
+
+		bool SaveJPEG(const ImageRes* pImage, const String& fullPath, int32 quality)
+		{
+			Vector2i size = pImage->GetSize();
+			if(size.x <= 0 || size.y <= 0)
+				return false;
+
+			jpeg_compress_struct cinfo;
+			jpegErrorMgr jerr = {};
+			jerr.reset_error_mgr = &jpegErrorReset;
+			jerr.error_exit = &jpegErrorExit;
+			jerr.emit_message = &jpegEmitMessage;
+			jerr.format_message = &jpegFormatMessage;
+			jerr.output_message = &jpegOutputMessage;
+			cinfo.err = &jerr;
+
+			unsigned char* outBuffer = nullptr;
+			unsigned long outSize = 0;
+			Vector<uint8> row(size.x * 3);
+			bool compressed = false;
+
+			// Return point for long jump
+			if(setjmp(jerr.jmpBuf) == 0)
+			{
+				jpeg_create_compress(&cinfo);
+				jpeg_mem_dest(&cinfo, &outBuffer, &outSize);
+				cinfo.image_width = size.x;
+				cinfo.image_height = size.y;
+				cinfo.input_components = 3;
+				cinfo.in_color_space = JCS_RGB;
+				jpeg_set_defaults(&cinfo);
+				jpeg_set_quality(&cinfo, quality, TRUE);
+				jpeg_start_compress(&cinfo, TRUE);
+
+				const Colori* pBits = pImage->GetBits();
+				while(cinfo.next_scanline < cinfo.image_height)
+				{
+					const Colori* src = pBits + cinfo.next_scanline * size.x;
+					for(int32 i = 0; i < size.x; i++)
+						memcpy(row.data() + i * 3, src + i, 3);
+					JSAMPROW rowPointer = row.data();
+					jpeg_write_scanlines(&cinfo, &rowPointer, 1);
+				}
+
+				jpeg_finish_compress(&cinfo);
+				compressed = true;
+			}
+			jpeg_destroy_compress(&cinfo);
+
+			bool saved = false;
+			if(compressed)
+			{
+				File f;
+				if(f.OpenWrite(fullPath))
+					saved = f.Write(outBuffer, outSize) == outSize;
+			}
+			free(outBuffer);
+			return saved;
 		}
 
 		static ImageLoader_Impl& Main()
@@ -155,4 +280,12 @@ namespace Graphics
 	{
 		return ImageLoader_Impl::Main().Load(pImage, fullPath);
 	}
+	bool ImageLoader::Load(ImageRes* pImage, const String& fullPath, Vector2i size)
+	{
+		return ImageLoader_Impl::Main().Load(pImage, fullPath, size);
+	}
+	bool ImageLoader::SaveJPEG(const ImageRes* pImage, const String& fullPath, int32 quality)
+	{
+		return ImageLoader_Impl::Main().SaveJPEG(pImage, fullPath, quality);
+	}
 }
\ No newline at end of file
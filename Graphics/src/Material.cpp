@@ -77,14 +77,18 @@ namespace Graphics
 
 		Material_Impl(OpenGL* gl) : m_gl(gl)
 		{
-			glGenProgramPipelines(1, &m_pipeline);
+			m_gl->Invoke([this]() { glGenProgramPipelines(1, &m_pipeline); });
 		}
 		~Material_Impl()
 		{
-			glDeleteProgramPipelines(1, &m_pipeline);
+			uint32 pipeline = m_pipeline;
+			m_gl->Post([pipeline]() { glDeleteProgramPipelines(1, &pipeline); });
 		}
 		void AssignShader(ShaderType t, Shader shader)
 		{
+			if(!m_gl->IsOpenGLThread())
+				return m_gl->Invoke([&]() { AssignShader(t, shader); });
+
 			m_shaders[(size_t)t] = shader;
 
 			uint32 handle = shader->Handle();
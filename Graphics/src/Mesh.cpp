@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "Mesh.hpp"
+#include "OpenGL.hpp"
 #include <Graphics/ResourceManagers.hpp>
 
 namespace Graphics
@@ -13,38 +14,87 @@ namespace Graphics
 		GL_LINE_STRIP,
 		GL_POINTS,
 	};
+	// GL objects of a mesh, only used on the OpenGL thread
+	//	kept apart from the mesh so uploads posted to the render thread don't depend on the lifetime of the mesh
+	struct MeshBuffers
+	{
+		uint32 buffer = 0;
+		uint32 vao = 0;
+		size_t vertexCount = 0;
+	};
+
 	class Mesh_Impl : public MeshRes
 	{
-		uint32 m_buffer = 0;
-		uint32 m_vao = 0;
+		OpenGL* m_gl;
+		MeshBuffers* m_buffers;
 		PrimitiveType m_type;
 		uint32 m_glType;
-		size_t m_vertexCount;
 		bool m_bDynamic = true;
 	public:
-		Mesh_Impl()
+		Mesh_Impl(OpenGL* gl) : m_gl(gl)
 		{
+			m_buffers = new MeshBuffers();
 		}
 		~Mesh_Impl()
 		{
-			if(m_buffer)
-				glDeleteBuffers(1, &m_buffer);
-			if(m_vao)
-				glDeleteVertexArrays(1, &m_vao);
+			// Deleted after the frames that may still use it
+			MeshBuffers* buffers = m_buffers;
+			m_gl->Post([buffers]()
+			{
+				if(buffers->buffer)
+					glDeleteBuffers(1, &buffers->buffer);
+				if(buffers->vao)
+					glDeleteVertexArrays(1, &buffers->vao);
+				delete buffers;
+			});
+		}
+		static void CreateBuffers(MeshBuffers* buffers)
+		{
+			glGenBuffers(1, &buffers->buffer);
+			glGenVertexArrays(1, &buffers->vao);
 		}
 		bool Init()
 		{
-			glGenBuffers(1, &m_buffer);
-			glGenVertexArrays(1, &m_vao);
-			return m_buffer != 0 && m_vao != 0;
+			// Created by the render thread before the mesh is first used
+			if(!m_gl->IsOpenGLThread())
+			{
+				MeshBuffers* buffers = m_buffers;
+				m_gl->Post([buffers]() { CreateBuffers(buffers); });
+				return true;
+			}
+			CreateBuffers(m_buffers);
+			return m_buffers->buffer != 0 && m_buffers->vao != 0;
 		}
 
 		virtual void SetData(const void* pData, size_t vertexCount, const VertexFormatList& desc)
 		{
-			glBindVertexArray(m_vao);
-			glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+			if(!m_gl->IsOpenGLThread())
+			{
+				// Copy the vertices, they are uploaded before the next frame is rendered
+				size_t totalVertexSize = 0;
+				for(auto e : desc)
+					totalVertexSize += e.componentSize * e.components;
+				CopyableBuffer data;
+				data.resize(totalVertexSize * vertexCount);
+				if(!data.empty())
+					memcpy(data.data(), pData, data.size());
+
+				MeshBuffers* buffers = m_buffers;
+				bool dynamic = m_bDynamic;
+				m_gl->Post([buffers, vertexCount, desc, dynamic, data]()
+				{
+					Upload(buffers, data.data(), vertexCount, desc, dynamic);
+				});
+				return;
+			}
+			Upload(m_buffers, pData, vertexCount, desc, m_bDynamic);
+		}
+		static void Upload(MeshBuffers* buffers, const void* pData, size_t vertexCount, const VertexFormatList& desc, bool dynamic)
+		{
+			glBindVertexArray(buffers->vao);
+			glBindBuffer(GL_ARRAY_BUFFER, buffers->buffer);
 
-			m_vertexCount = vertexCount;
+			buffers->vertexCount = vertexCount;
 			size_t totalVertexSize = 0;
 			for(auto e : desc)
 				totalVertexSize += e.componentSize * e.components;
@@ -75,19 +125,28 @@ namespace Graphics
 				offset += e.componentSize * e.components;
 				index++;
 			}
-			glBufferData(GL_ARRAY_BUFFER, totalVertexSize * vertexCount, pData, m_bDynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+			glBufferData(GL_ARRAY_BUFFER, totalVertexSize * vertexCount, pData, dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
 
 			glBindVertexArray(0);
 			glBindBuffer(GL_ARRAY_BUFFER, 0);
 		}
 		virtual void Draw()
 		{
-			glBindVertexArray(m_vao);
-			glDrawArrays(m_glType, 0, (int)m_vertexCount);
+			glBindVertexArray(m_buffers->vao);
+			glDrawArrays(m_glType, 0, (int)m_buffers->vertexCount);
 		}
 		virtual void Redraw()
 		{
-			glDrawArrays(m_glType, 0, (int)m_vertexCount);
+			glDrawArrays(m_glType, 0, (int)m_buffers->vertexCount);
+		}
+		virtual void DrawRange(size_t first, size_t count)
+		{
+			glBindVertexArray(m_buffers->vao);
+			glDrawArrays(m_glType, (int)first, (int)count);
+		}
+		virtual void RedrawRange(size_t first, size_t count)
+		{
+			glDrawArrays(m_glType, (int)first, (int)count);
 		}
 
 		virtual void SetPrimitiveType(PrimitiveType pt)
@@ -103,7 +162,7 @@ namespace Graphics
 
 	Mesh MeshRes::Create(class OpenGL* gl)
 	{
-		Mesh_Impl* pImpl = new Mesh_Impl();
+		Mesh_Impl* pImpl = new Mesh_Impl(gl);
 		if(!pImpl->Init())
 		{
 			delete pImpl;
@@ -14,6 +14,7 @@
 #include "ParticleSystem.hpp"
 #include "Window.hpp"
 #include <Shared/Thread.hpp>
+#include <atomic>
 
 namespace Graphics
 {
@@ -21,7 +22,7 @@ namespace Graphics
 	{
 	public:
 		SDL_GLContext context;
-		std::thread::id threadId;
+		std::atomic<std::thread::id> threadId;
 	};
 
 	OpenGL::OpenGL()
@@ -30,6 +31,7 @@ namespace Graphics
 	}
 	OpenGL::~OpenGL()
 	{
+		StopRenderThread();
 		if(m_impl->context)
 		{
 			// Cleanup resource managers
@@ -130,6 +132,8 @@ namespace Graphics
 		glEnable(GL_TEXTURE_2D);
 		glDisable(GL_BLEND);
 
+		glGetIntegerv(GL_VIEWPORT, &m_viewport.pos.x);
+
 		return true;
 	}
 
@@ -143,17 +147,16 @@ namespace Graphics
 
 	Recti OpenGL::GetViewport() const
 	{
-		Recti vp;
-		glGetIntegerv(GL_VIEWPORT, &vp.pos.x);
-		return vp;
+		return m_viewport;
 	}
 	void OpenGL::SetViewport(Recti vp)
 	{
-		glViewport(vp.pos.x, vp.pos.y, vp.size.x, vp.size.y);
+		m_viewport = vp;
+		Enqueue([=]() { glViewport(vp.pos.x, vp.pos.y, vp.size.x, vp.size.y); });
 	}
 	void OpenGL::SetViewport(Vector2i size)
 	{
-		glViewport(0, 0, size.x, size.y);
+		SetViewport(Recti(Vector2i(), size));
 	}
 
 	bool OpenGL::IsOpenGLThread() const
@@ -161,8 +164,72 @@ namespace Graphics
 		return m_impl->threadId == std::this_thread::get_id();
 	}
 
+	bool OpenGL::StartRenderThread()
+	{
+		if(!m_impl->context || !IsOpenGLThread() || m_renderThread.IsRunning())
+			return false;
+
+		SDL_Window* sdlWnd = (SDL_Window*)m_window->Handle();
+		SDL_GL_MakeCurrent(sdlWnd, nullptr);
+		m_renderThread.onStart.BindLambda([=]()
+		{
+			if(SDL_GL_MakeCurrent(sdlWnd, m_impl->context) != 0)
+				Logf("Failed to move OpenGL context to the render thread: %s", Logger::Error, SDL_GetError());
+		});
+		m_renderThread.onStop.BindLambda([=]()
+		{
+			glFinish();
+			SDL_GL_MakeCurrent(sdlWnd, nullptr);
+		});
+		m_renderThread.Start();
+		m_impl->threadId = m_renderThread.GetThreadId();
+		Log("Started render thread", Logger::Info);
+		return true;
+	}
+	void OpenGL::StopRenderThread()
+	{
+		if(!m_renderThread.IsRunning())
+			return;
+
+		m_renderThread.Stop();
+		m_impl->threadId = std::this_thread::get_id();
+		SDL_GL_MakeCurrent((SDL_Window*)m_window->Handle(), m_impl->context);
+	}
+	bool OpenGL::HasRenderThread() const
+	{
+		return m_renderThread.IsRunning();
+	}
+	const RenderThread& OpenGL::GetRenderThread() const
+	{
+		return m_renderThread;
+	}
+
+	void OpenGL::Enqueue(RenderThread::Command&& command)
+	{
+		if(!IsOpenGLThread() && m_renderThread.IsRunning())
+			m_renderThread.Enqueue(std::move(command));
+		else
+			command();
+	}
+	void OpenGL::Post(RenderThread::Command&& task)
+	{
+		m_renderThread.Post(std::move(task));
+	}
+	void OpenGL::Invoke(const RenderThread::Command& task) const
+	{
+		// Waiting for the render thread doesn't change the context
+		const_cast<RenderThread&>(m_renderThread).Invoke(task);
+	}
+
 	void OpenGL::SwapBuffers()
 	{
+		if(!IsOpenGLThread() && m_renderThread.IsRunning())
+		{
+			m_renderThread.Enqueue([this]() { SwapBuffers(); });
+			m_renderThread.SubmitFrame();
+			return;
+		}
+
 		glFlush();
 		SDL_Window* sdlWnd = (SDL_Window*)m_window->Handle();
 		SDL_GL_SwapWindow(sdlWnd);
@@ -30,7 +30,7 @@ namespace Graphics
 		virtual void Render(const class RenderState& rs, float deltaTime) override
 		{
 			// Enable blending for all particles
-			glEnable(GL_BLEND);
+			gl->Enqueue([]() { glEnable(GL_BLEND); });
 
 			// Tick all emitters and remove old ones
 			for(auto it = m_emitters.begin(); it != m_emitters.end();)
@@ -266,30 +266,37 @@ namespace Graphics
 		{
 			params.SetParameter("mainTex", texture);
 		}
-		material->Bind(rs, params);
 
-		// Select blending mode based on material
-		switch(material->blendMode)
+		// Vertex buffer is reused every frame
+		if(!m_mesh)
 		{
-		case MaterialBlendMode::Normal:
-			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-			break;
-		case MaterialBlendMode::Additive:
-			glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-			break;
-		case MaterialBlendMode::Multiply:
-			glBlendFunc(GL_SRC_ALPHA, GL_SRC_COLOR);
-			break;
+			m_mesh = MeshRes::Create(m_system->gl);
+			m_mesh->SetPrimitiveType(PrimitiveType::PointList);
 		}
+		m_mesh->SetData(verts);
 
-		// Create vertex buffer
-		Mesh mesh = MeshRes::Create(m_system->gl);
+		// Drawn in order with the rest of the frame, the command keeps the mesh and material alive
+		m_system->gl->Enqueue([mesh = m_mesh, mat = material, params, rs]() mutable
+		{
+			MaterialRes* material = mat.GetData();
+			material->Bind(rs, params);
 
-		mesh->SetData(verts);
-		mesh->SetPrimitiveType(PrimitiveType::PointList);
+			// Select blending mode based on material
+			switch(material->blendMode)
+			{
+			case MaterialBlendMode::Normal:
+				glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+				break;
+			case MaterialBlendMode::Additive:
+				glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+				break;
+			case MaterialBlendMode::Multiply:
+				glBlendFunc(GL_SRC_ALPHA, GL_SRC_COLOR);
+				break;
+			}
 
-		mesh->Draw();
-		mesh.Destroy();
+			mesh->Draw();
+		});
 	}
 
 	void ParticleEmitter::Reset()
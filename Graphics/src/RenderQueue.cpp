@@ -1,10 +1,16 @@
 #include "stdafx.h"
 #include "RenderQueue.hpp"
 #include "OpenGL.hpp"
+#include <Shared/Profiler.hpp>
 using Utility::Cast;
 
 namespace Graphics
 {
+	static bool SameRect(const Rect& a, const Rect& b)
+	{
+		return a.pos.x == b.pos.x && a.pos.y == b.pos.y && a.size.x == b.size.x && a.size.y == b.size.y;
+	}
+
 	RenderQueue::RenderQueue(OpenGL* ogl, const RenderState& rs)
 	{
 		m_ogl = ogl;
@@ -16,6 +22,8 @@ namespace Graphics
 		other.m_ogl = nullptr;
 		m_orderedCommands = move(other.m_orderedCommands);
 		m_renderState = other.m_renderState;
+		m_batchVertices = move(other.m_batchVertices);
+		m_batchMesh = std::move(other.m_batchMesh);
 	}
 	RenderQueue& RenderQueue::operator=(RenderQueue&& other)
 	{
@@ -24,28 +32,103 @@ namespace Graphics
 		other.m_ogl = nullptr;
 		m_orderedCommands = move(other.m_orderedCommands);
 		m_renderState = other.m_renderState;
+		m_batchVertices = move(other.m_batchVertices);
+		m_batchMesh = std::move(other.m_batchMesh);
 		return *this;
 	}
 	RenderQueue::~RenderQueue()
 	{
 		Clear();
 	}
+	void RenderQueue::SetRenderState(const RenderState& rs)
+	{
+		m_renderState = rs;
+	}
 	void RenderQueue::Process(bool clearQueue)
 	{
+		PROFILE_ZONE("RenderQueue::Process");
 		assert(m_ogl);
 
+		m_stats = RenderQueueStats();
+
+		if(!m_batchVertices.empty())
+		{
+			if(!m_batchMesh)
+			{
+				m_batchMesh = MeshRes::Create(m_ogl);
+				m_batchMesh->SetPrimitiveType(PrimitiveType::TriangleList);
+			}
+			m_stats.batchedVertices = (uint32)m_batchVertices.size();
+		}
+
+		// Every command is a single draw call
+		for(RenderQueueItem* item : m_orderedCommands)
+		{
+			m_stats.drawCalls++;
+			BatchedDrawCall* bdc = Cast<BatchedDrawCall>(item);
+			if(bdc)
+			{
+				m_stats.batchedDrawCalls++;
+				if(bdc->texture)
+					bdc->params.SetParameter("mainTex", bdc->texture);
+			}
+		}
+
+		if(!m_ogl->IsOpenGLThread())
+		{
+			// Hand the commands to the render thread, they are released when the frame is done
+			std::shared_ptr<RenderQueue> frameQueue = std::make_shared<RenderQueue>(m_ogl, m_renderState);
+			if(clearQueue)
+			{
+				frameQueue->m_orderedCommands = std::move(m_orderedCommands);
+				m_orderedCommands.clear();
+				frameQueue->m_batchVertices = std::move(m_batchVertices);
+				m_batchVertices.clear();
+			}
+			else
+			{
+				for(RenderQueueItem* item : m_orderedCommands)
+					frameQueue->m_orderedCommands.Add(m_CopyItem(item));
+				frameQueue->m_batchVertices = m_batchVertices;
+			}
+			// The batch is uploaded in order with the draws of the frame instead of before it,
+			//	so a queue that is processed several times per frame draws the vertices of each call
+			frameQueue->m_batchMesh = m_batchMesh;
+			m_ogl->Enqueue([frameQueue]()
+			{
+				frameQueue->m_UploadBatch();
+				frameQueue->m_Execute();
+			});
+			return;
+		}
+
+		m_UploadBatch();
+		m_Execute();
+		if(clearQueue)
+		{
+			Clear();
+		}
+	}
+	void RenderQueue::m_UploadBatch()
+	{
+		// Upload all batched geometry at once
+		if(!m_batchVertices.empty())
+			m_batchMesh->SetData(m_batchVertices);
+	}
+	void RenderQueue::m_Execute()
+	{
 		bool scissorEnabled = false;
 		bool blendEnabled = false;
 		MaterialBlendMode activeBlendMode = (MaterialBlendMode)-1;
 
-		Set<Material> initializedShaders;
-		Mesh currentMesh;
-		Material currentMaterial;
+		// Raw pointers, the render thread can't change reference counts
+		Set<MaterialRes*> initializedShaders;
+		MeshRes* currentMesh = nullptr;
+		MaterialRes* currentMaterial = nullptr;
 
-		// Create a new list of items
 		for(RenderQueueItem* item : m_orderedCommands)
 		{
-			auto SetupMaterial = [&](Material& mat, MaterialParameterSet& params)
+			auto SetupMaterial = [&](MaterialRes* mat, MaterialParameterSet& params)
 			{
 				// Only bind params if material is already bound to context
 				if(currentMaterial == mat)
@@ -101,27 +184,10 @@ namespace Graphics
 				}
 			};
 
-			// Draw mesh helper
-			auto DrawOrRedrawMesh = [&](Mesh& mesh)
+			// Enables or disables the scissor test, a scissor rectangle with a negative size disables it
+			auto SetupScissor = [&](const Rect& scissorRect)
 			{
-				if(currentMesh == mesh)
-					mesh->Redraw();
-				else
-				{
-					mesh->Draw();
-					currentMesh = mesh;
-				}
-			};
-
-			if(Cast<SimpleDrawCall>(item))
-			{
-				SimpleDrawCall* sdc = (SimpleDrawCall*)item;
-				m_renderState.worldTransform = sdc->worldTransform;
-				SetupMaterial(sdc->mat, sdc->params);
-
-				// Check if scissor is enabled
-				bool useScissor = (sdc->scissorRect.size.x >= 0);
-				if(useScissor)
+				if(scissorRect.size.x >= 0)
 				{
 					// Apply scissor
 					if(!scissorEnabled)
@@ -129,9 +195,9 @@ namespace Graphics
 						glEnable(GL_SCISSOR_TEST);
 						scissorEnabled = true;
 					}
-					float scissorY = m_renderState.viewportSize.y - sdc->scissorRect.Bottom();
-					glScissor((int32)sdc->scissorRect.Left(), (int32)scissorY,
-						(int32)sdc->scissorRect.size.x, (int32)sdc->scissorRect.size.y);
+					float scissorY = m_renderState.viewportSize.y - scissorRect.Bottom();
+					glScissor((int32)scissorRect.Left(), (int32)scissorY,
+						(int32)scissorRect.size.x, (int32)scissorRect.size.y);
 				}
 				else
 				{
@@ -141,8 +207,52 @@ namespace Graphics
 						scissorEnabled = false;
 					}
 				}
+			};
 
-				DrawOrRedrawMesh(sdc->mesh);
+			// Draw mesh helper
+			auto DrawOrRedrawMesh = [&](MeshRes* mesh)
+			{
+				if(currentMesh == mesh)
+					mesh->Redraw();
+				else
+				{
+					mesh->Draw();
+					currentMesh = mesh;
+				}
+			};
+			auto DrawOrRedrawMeshRange = [&](MeshRes* mesh, uint32 first, uint32 count)
+			{
+				if(currentMesh == mesh)
+					mesh->RedrawRange(first, count);
+				else
+				{
+					mesh->DrawRange(first, count);
+					currentMesh = mesh;
+				}
+			};
+
+			if(Cast<SimpleDrawCall>(item))
+			{
+				SimpleDrawCall* sdc = (SimpleDrawCall*)item;
+				m_renderState.worldTransform = sdc->worldTransform;
+				SetupMaterial(sdc->mat.GetData(), sdc->params);
+
+				SetupScissor(sdc->scissorRect);
+
+				if(sdc->numVertices > 0)
+					DrawOrRedrawMeshRange(sdc->mesh.GetData(), sdc->firstVertex, sdc->numVertices);
+				else
+					DrawOrRedrawMesh(sdc->mesh.GetData());
+			}
+			else if(Cast<BatchedDrawCall>(item))
+			{
+				BatchedDrawCall* bdc = (BatchedDrawCall*)item;
+				// Batched vertices are already transformed
+				m_renderState.worldTransform = Transform();
+				SetupMaterial(bdc->mat.GetData(), bdc->params);
+				SetupScissor(bdc->scissorRect);
+
+				DrawOrRedrawMeshRange(m_batchMesh.GetData(), bdc->firstVertex, bdc->numVertices);
 			}
 			else if(Cast<PointDrawCall>(item))
 			{
@@ -155,7 +265,7 @@ namespace Graphics
 
 				PointDrawCall* pdc = (PointDrawCall*)item;
 				m_renderState.worldTransform = Transform();
-				SetupMaterial(pdc->mat, pdc->params);
+				SetupMaterial(pdc->mat.GetData(), pdc->params);
 				PrimitiveType pt = pdc->mesh->GetPrimitiveType();
 				if(pt >= PrimitiveType::LineList && pt <= PrimitiveType::LineStrip)
 				{
@@ -166,18 +276,22 @@ namespace Graphics
 					glPointSize(pdc->size);
 				}
 				
-				DrawOrRedrawMesh(pdc->mesh);
+				DrawOrRedrawMesh(pdc->mesh.GetData());
 			}
 		}
 
 		// Disable all states that were on
 		glDisable(GL_BLEND);
 		glDisable(GL_SCISSOR_TEST);
-
-		if(clearQueue)
-		{
-			Clear();
-		}
+	}
+	RenderQueueItem* RenderQueue::m_CopyItem(RenderQueueItem* item)
+	{
+		if(Cast<SimpleDrawCall>(item))
+			return new SimpleDrawCall(*(SimpleDrawCall*)item);
+		if(Cast<BatchedDrawCall>(item))
+			return new BatchedDrawCall(*(BatchedDrawCall*)item);
+		assert(Cast<PointDrawCall>(item));
+		return new PointDrawCall(*(PointDrawCall*)item);
 	}
 
 	void RenderQueue::Clear()
@@ -188,6 +302,7 @@ namespace Graphics
 			delete item;
 		}
 		m_orderedCommands.clear();
+		m_batchVertices.clear();
 	}
 
 	void RenderQueue::Draw(Transform worldTransform, Mesh m, Material mat, const MaterialParameterSet& params)
@@ -234,6 +349,20 @@ namespace Graphics
 		m_orderedCommands.push_back(sdc);
 	}
 
+	void RenderQueue::DrawRange(Transform worldTransform, Mesh m, uint32 firstVertex, uint32 numVertices, Material mat, const MaterialParameterSet& params /*= MaterialParameterSet()*/)
+	{
+		if(numVertices == 0)
+			return;
+		SimpleDrawCall* sdc = new SimpleDrawCall();
+		sdc->mat = mat;
+		sdc->mesh = m;
+		sdc->params = params;
+		sdc->worldTransform = worldTransform;
+		sdc->firstVertex = firstVertex;
+		sdc->numVertices = numVertices;
+		m_orderedCommands.push_back(sdc);
+	}
+
 	void RenderQueue::DrawPoints(Mesh m, Material mat, const MaterialParameterSet& params, float pointSize)
 	{
 		PointDrawCall* pdc = new PointDrawCall();
@@ -244,10 +373,67 @@ namespace Graphics
 		m_orderedCommands.push_back(pdc);
 	}
 
+	BatchVertex* RenderQueue::DrawBatched(Rect scissor, Material mat, Texture texture, uint32 numVertices)
+	{
+		// Extend the previous batch if it has the same state
+		BatchedDrawCall* bdc = nullptr;
+		if(!m_orderedCommands.empty())
+		{
+			BatchedDrawCall* last = Cast<BatchedDrawCall>(m_orderedCommands.back());
+			if(last && last->mat == mat && SameRect(last->scissorRect, scissor) &&
+				(!texture || !last->texture || last->texture == texture))
+			{
+				bdc = last;
+				if(!bdc->texture)
+					bdc->texture = texture;
+			}
+		}
+		if(!bdc)
+		{
+			bdc = new BatchedDrawCall();
+			bdc->mat = mat;
+			bdc->texture = texture;
+			bdc->scissorRect = scissor;
+			bdc->firstVertex = (uint32)m_batchVertices.size();
+			m_orderedCommands.push_back(bdc);
+		}
+
+		size_t first = m_batchVertices.size();
+		m_batchVertices.resize(first + numVertices);
+		bdc->numVertices += numVertices;
+		return m_batchVertices.data() + first;
+	}
+	void RenderQueue::DrawTextBatched(Rect scissor, Vector2 position, Ref<class TextRes> text, Material mat, const Color& color)
+	{
+		const Vector<TextVertex>& textVertices = text->GetVertices();
+		if(textVertices.empty())
+			return;
+
+		Texture texture = text->GetTexture();
+		// Glyph quads use pixel coordinates in the font atlas
+		Vector2 texelSize = Vector2(1.0f) / Vector2(texture->GetSize());
+
+		BatchVertex* dst = DrawBatched(scissor, mat, texture, (uint32)textVertices.size());
+		Colori vertexColor = color.ToRGBA8();
+		for(const TextVertex& v : textVertices)
+		{
+			*dst++ = BatchVertex(v.pos + position, v.tex * texelSize, vertexColor);
+		}
+	}
+
+	const RenderQueueStats& RenderQueue::GetStats() const
+	{
+		return m_stats;
+	}
+
 	// Initializes the simple draw call structure
 	SimpleDrawCall::SimpleDrawCall()
 		: scissorRect(Vector2(), Vector2(-1))
 	{
 	}
+	BatchedDrawCall::BatchedDrawCall()
+		: scissorRect(Vector2(), Vector2(-1))
+	{
+	}
 
-}
+}
\ No newline at end of file
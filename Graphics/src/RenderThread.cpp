@@ -0,0 +1,194 @@
+#include "stdafx.h"
+#include "RenderThread.hpp"
+#include <Shared/Profiler.hpp>
+
+namespace Graphics
+{
+	RenderThread::~RenderThread()
+	{
+		Stop();
+	}
+
+	bool RenderThread::Start()
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		if(m_running)
+			return false;
+		m_stop = false;
+		m_running = true;
+		m_thread = std::thread(&RenderThread::m_Run, this);
+		m_threadId = m_thread.get_id();
+		return true;
+	}
+	void RenderThread::Stop()
+	{
+		if(!IsRunning())
+			return;
+		// Commands recorded after the last submitted frame still need to run
+		if(!m_frames[m_recordIndex].empty())
+			SubmitFrame();
+		Finish();
+		{
+			std::unique_lock<std::mutex> lock(m_lock);
+			m_stop = true;
+		}
+		m_wake.notify_one();
+		m_thread.join();
+
+		std::unique_lock<std::mutex> lock(m_lock);
+		m_running = false;
+		m_threadId = std::thread::id();
+	}
+	bool RenderThread::IsRunning() const
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		return m_running;
+	}
+	std::thread::id RenderThread::GetThreadId() const
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		return m_threadId;
+	}
+
+	void RenderThread::Enqueue(Command&& command)
+	{
+		// Only the recording thread touches the frame being recorded
+		m_frames[m_recordIndex].Add(std::move(command));
+	}
+	void RenderThread::SubmitFrame()
+	{
+		Timer waitTimer;
+		std::unique_lock<std::mutex> lock(m_lock);
+		m_done.wait(lock, [this]() { return !m_framePending; });
+		m_lastSubmitWait = waitTimer.SecondsAsDouble();
+
+		m_RecycleFrame(lock);
+		m_recordIndex = 1 - m_recordIndex;
+		m_framePending = true;
+		m_frameTaskMark = m_numTasksPosted;
+		lock.unlock();
+		m_wake.notify_one();
+	}
+	void RenderThread::Post(Command&& task)
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		if(!m_running || std::this_thread::get_id() == m_threadId)
+		{
+			lock.unlock();
+			task();
+			return;
+		}
+		m_tasks.Add(std::move(task));
+		m_numTasksPosted++;
+		lock.unlock();
+		m_wake.notify_one();
+	}
+	void RenderThread::Invoke(const Command& task)
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		if(!m_running || std::this_thread::get_id() == m_threadId)
+		{
+			lock.unlock();
+			task();
+			return;
+		}
+		m_tasks.Add([&task]() { task(); });
+		uint64 ticket = ++m_numTasksPosted;
+		m_wake.notify_one();
+		m_done.wait(lock, [&]() { return m_numTasksDone >= ticket; });
+	}
+	void RenderThread::Finish()
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		while(true)
+		{
+			m_done.wait(lock, [this]() { return !m_framePending && m_numTasksDone == m_numTasksPosted; });
+			// Releasing the executed frame can post more tasks
+			if(!m_frameExecuted)
+				break;
+			m_RecycleFrame(lock);
+		}
+	}
+
+	double RenderThread::GetLastFrameTime() const
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		return m_lastFrameTime;
+	}
+	double RenderThread::GetLastSubmitWait() const
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		return m_lastSubmitWait;
+	}
+
+	void RenderThread::m_RecycleFrame(std::unique_lock<std::mutex>& lock)
+	{
+		if(!m_frameExecuted)
+			return;
+		m_frameExecuted = false;
+
+		// Released without holding the lock, releasing resources can post tasks
+		//	the render thread doesn't touch this frame again until it is submitted
+		Vector<Command>& executed = m_frames[1 - m_recordIndex];
+		lock.unlock();
+		executed.clear();
+		lock.lock();
+	}
+
+	void RenderThread::m_Run()
+	{
+		Profiler::SetThreadName("Render");
+		if(onStart.IsBound())
+			onStart.Call();
+
+		Vector<Command> tasks;
+		std::unique_lock<std::mutex> lock(m_lock);
+		while(true)
+		{
+			// Tasks posted before the frame was submitted go first, later ones wait until after the frame
+			size_t numTasks = m_tasks.size();
+			if(m_framePending)
+				numTasks = Math::Min(numTasks, (size_t)(m_frameTaskMark - m_numTasksDone));
+			if(numTasks > 0)
+			{
+				tasks.assign(std::make_move_iterator(m_tasks.begin()), std::make_move_iterator(m_tasks.begin() + numTasks));
+				m_tasks.erase(m_tasks.begin(), m_tasks.begin() + numTasks);
+				lock.unlock();
+				for(auto& task : tasks)
+					task();
+				tasks.clear();
+				lock.lock();
+				m_numTasksDone += numTasks;
+				m_done.notify_all();
+				continue;
+			}
+
+			if(m_framePending)
+			{
+				Vector<Command>& frame = m_frames[1 - m_recordIndex];
+				lock.unlock();
+				Timer frameTimer;
+				{
+					PROFILE_ZONE("Execute Frame");
+					for(auto& command : frame)
+						command();
+				}
+				double frameTime = frameTimer.SecondsAsDouble();
+				lock.lock();
+				m_lastFrameTime = frameTime;
+				m_framePending = false;
+				m_frameExecuted = true;
+				m_done.notify_all();
+				continue;
+			}
+
+			if(m_stop)
+				break;
+			m_wake.wait(lock);
+		}
+		lock.unlock();
+
+		if(onStop.IsBound())
+			onStop.Call();
+	}
+}
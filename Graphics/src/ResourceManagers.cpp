@@ -5,9 +5,10 @@
 
 namespace Graphics
 {
-	static Timer gcTimer;
 	static Timer cleanupTimer;
 	static int disabled = 0;
+	// Number of objects checked by each resource manager every tick
+	static const size_t gcObjectsPerTick = 32;
 
 	static ResourceManagers inst;
 	static IResourceManager* managers[(size_t)ResourceType::_Length] = { nullptr };
@@ -71,14 +72,13 @@ namespace Graphics
 	}
 	void ResourceManagers::m_TickAll()
 	{
-		if(gcTimer.Milliseconds() > 250 && disabled == 0)
+		if(disabled == 0)
 		{
 			for(auto rm : managers)
 			{
 				if(rm)
-					rm->GarbageCollect();
+					rm->GarbageCollect(gcObjectsPerTick);
 			}
-			gcTimer.Restart();
 		}
 	}
 }
@@ -21,7 +21,7 @@ namespace Graphics
 	class Shader_Impl : public ShaderRes
 	{
 		ShaderType m_type;
-		uint32 m_prog;
+		uint32 m_prog = 0;
 		OpenGL* m_gl;
 
 		String m_sourcePath;
@@ -38,10 +38,14 @@ namespace Graphics
 		~Shader_Impl()
 		{
 			// Cleanup OpenGL resource
-			if(glIsProgram(m_prog))
+			uint32 prog = m_prog;
+			m_gl->Post([prog]()
 			{
-				glDeleteProgram(m_prog);
-			}
+				if(glIsProgram(prog))
+				{
+					glDeleteProgram(prog);
+				}
+			});
 
 #ifdef _WIN32
 			// Close change notification handle
@@ -131,6 +135,13 @@ namespace Graphics
 
 		bool Init(ShaderType type, const String& name)
 		{
+			if(!m_gl->IsOpenGLThread())
+			{
+				bool result = false;
+				m_gl->Invoke([&]() { result = Init(type, name); });
+				return result;
+			}
+
 			m_sourcePath = Path::Normalize(name);
 			m_type = type;
 			return LoadProgram(m_prog);
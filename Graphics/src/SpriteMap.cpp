@@ -2,22 +2,24 @@
 #include "Image.hpp"
 #include "Texture.hpp"
 #include <Graphics/ResourceManagers.hpp>
-#include <set>
+#include <atomic>
 
 namespace Graphics
 {
-	static uint32 maxHeight = 1024;
-	static uint32 border = 2;
+	// Spacing between packed images
+	static int32 border = 1;
 
-	struct Category
-	{
-		uint32 width = 0;
-		Vector2i offset;
-		Vector<uint32> segments;
-	};
-	struct Segment
+	// Upload counters shared by all sprite maps
+	static std::atomic<uint64> numUploads(0);
+	static std::atomic<uint64> numFullUploads(0);
+	static std::atomic<uint64> bytesUploaded(0);
+
+	// A single row of images that all have a height less than or equal to the height of the row
+	struct Shelf
 	{
-		Recti coords;
+		int32 y = 0;
+		int32 height = 0;
+		int32 usedX = 0;
 	};
 
 	class SpriteMap_Impl : public SpriteMapRes
@@ -26,34 +28,34 @@ namespace Graphics
 
 		// The image that contains the current data
 		Image m_image;
+		Vector2i m_initialSize;
 
-		// Used size over the X axis
-		int32 m_usedSize = 0;
+		// Used size over the Y axis
+		int32 m_usedY = 0;
 
-		// Linear index of al segements
-		Vector<Segment*> m_segments;
-		Vector<Category> m_widths;
-		std::multimap<uint32, uint32> m_categoryByWidth;
+		// Linear index of all segments
+		Vector<Recti> m_segments;
+		Vector<Shelf> m_shelves;
+
+		// Region modified since the last texture update
+		Recti m_dirty;
+		// Set when the whole image needs to be uploaded again
+		bool m_fullyDirty = true;
 	public:
-		SpriteMap_Impl()
+		SpriteMap_Impl(Vector2i initialSize) : m_initialSize(initialSize)
 		{
 			m_image = ImageRes::Create();
+			m_AllocatePage(m_initialSize);
 		}
 		~SpriteMap_Impl()
 		{
-			Clear();
 		}
 		virtual void Clear()
 		{
-			for(auto s : m_segments)
-			{
-				delete s;
-			}
 			m_segments.clear();
-			m_widths.clear();
-			m_categoryByWidth.clear();
-			m_usedSize = 0;
-			m_image->SetSize(Vector2i(0));
+			m_shelves.clear();
+			m_usedY = 0;
+			m_AllocatePage(m_initialSize);
 		}
 
 		virtual Vector2i GetSize() const
@@ -69,96 +71,62 @@ namespace Graphics
 			return m_image->GetBits();
 		}
 
-		// Returns the category that has space for the requested size
-		Category& AssignCategory(Vector2i requestedSize)
+		// Finds a location for an image of the requested size, growing the page if it is full
+		Vector2i AssignLocation(Vector2i requestedSize)
 		{
-			int32 mostSpace = 0;
-			Category* dstCat = nullptr;
-
+			Vector2i paddedSize = requestedSize + Vector2i(border);
 			while(true)
 			{
-				auto range = m_categoryByWidth.equal_range(requestedSize.x);
-				// Find a suitable category first
-				for(auto it = range.first; it != range.second; it++)
-				{
-					Category& cat = m_widths[it->second];
-					int32 remainingY = m_image->GetSize().y - cat.offset.y;
-					if(remainingY > requestedSize.y)
-					{
-						// This category is OK
-						mostSpace = remainingY;
-						dstCat = &cat;
-						break;
-					}
-				}
+				Vector2i pageSize = m_image->GetSize();
+
+				// Find the shelf that wastes the least space
+				//	small images are kept off much higher shelves while there is still room for new shelves
+				Shelf* dstShelf = m_FindShelf(paddedSize, true);
 
-				// Create a new category if required
-				if(!dstCat)
+				// Open a new shelf if required
+				if(!dstShelf && pageSize.y - m_usedY >= paddedSize.y && pageSize.x >= paddedSize.x)
 				{
-					int32 remainingX = m_image->GetSize().x - m_usedSize;
-					// Use horizontal space to add another collumn
-					//	if height of image is big enough
-					if(m_image->GetSize().y >= requestedSize.y && remainingX >= requestedSize.x)
-					{
-						Category& cat = m_widths.Add();
-						cat.width = requestedSize.x;
-						cat.offset = Vector2i(m_usedSize, 0);
-						m_categoryByWidth.insert(std::make_pair(cat.width, (uint32)m_widths.size()-1));
-						m_usedSize += cat.width + 1;
-					}
-					else
-					{
-						int32 remainingX = (m_image->GetSize().x - m_usedSize);
-
-						// Resize image
-						int32 largestDim = Math::Max(m_usedSize + requestedSize.x,
-							Math::Max(m_image->GetSize().y, requestedSize.y));
-						int32 targetSize = (int32)pow(2, ceil(log(largestDim) / log(2)));
-						if(m_image->GetSize().x != targetSize)
-						{
-							// Resize image
-							Image newImage = ImageRes::Create(Vector2i(targetSize));
-							// Copy old image into new image
-							if(m_image->GetSize().x > 0)
-								CopySubImage(newImage, m_image, Vector2i());
-							m_image = newImage;
-						}
-					}
+					dstShelf = &m_shelves.Add();
+					dstShelf->y = m_usedY;
+					dstShelf->height = paddedSize.y;
+					m_usedY += paddedSize.y;
 				}
-				else
+				if(!dstShelf)
+					dstShelf = m_FindShelf(paddedSize, false);
+
+				if(dstShelf)
 				{
-					break;
+					Vector2i pos = Vector2i(dstShelf->usedX, dstShelf->y);
+					dstShelf->usedX += paddedSize.x;
+					return pos;
 				}
+
+				// Page is full
+				Vector2i newSize = pageSize * 2;
+				while(newSize.x < paddedSize.x || newSize.y < paddedSize.y)
+					newSize *= 2;
+				m_GrowPage(newSize);
 			}
-			
-			return *dstCat;
 		}
 		virtual uint32 AddSegment(Image image)
 		{
-			// Create a new segment
 			uint32 nI = (uint32)m_segments.size();
-			Segment* pCurrentSegment = m_segments.Add(new Segment());
-			pCurrentSegment->coords.size = image->GetSize();
-
-			// Get a category that has space
-			Category& cat = AssignCategory(image->GetSize());
+			Recti& coords = m_segments.Add();
+			coords.size = image->GetSize();
+			if(coords.size.x == 0 || coords.size.y == 0)
+				return nI;
 
-			// Set offset for current segment
-			pCurrentSegment->coords.pos = cat.offset;
-			// Add size offset in category
-			cat.offset.y += pCurrentSegment->coords.size.y + 1;
+			coords.pos = AssignLocation(coords.size);
 
 			// Copy image data
-			CopySubImage(m_image, image, pCurrentSegment->coords.pos);
+			CopySubImage(m_image, image, coords.pos);
+			m_MarkDirty(coords);
 
-			// Add segment to this category
-			cat.segments.push_back(nI);
 			return nI;
 		}
 
 		void CopySubImage(Image dst, Image src, Vector2i dstPos)
 		{
-			Vector2i dstSize = dst->GetSize();
 			Vector2i srcSize = src->GetSize();
 
 			Colori* pSrc = src->GetBits();
@@ -166,19 +134,15 @@ namespace Graphics
 			Colori* pDst = dst->GetBits() + dstPos.x + dstPos.y * nDstPitch;
 			for(uint32 y = 0; y < (uint32)srcSize.y; y++)
 			{
-				for(uint32 x = 0; x < (uint32)srcSize.x; x++)
-				{
-					*pDst = *pSrc;
-					pSrc++;
-					pDst++;
-				}
-				pDst += (nDstPitch - srcSize.x);
+				memcpy(pDst, pSrc, srcSize.x * sizeof(Colori));
+				pSrc += srcSize.x;
+				pDst += nDstPitch;
 			}
 		}
 		virtual Recti GetCoords(uint32 nIndex)
 		{
 			assert(nIndex < m_segments.size());
-			return m_segments[nIndex]->coords;
+			return m_segments[nIndex];
 		}
 		virtual Ref<ImageRes> GetImage() override
 		{
@@ -188,13 +152,97 @@ namespace Graphics
 		{
 			Texture tex = TextureRes::Create(gl, m_image);
 			tex->SetWrap(TextureWrap::Clamp, TextureWrap::Clamp);
+
+			Vector2i size = m_image->GetSize();
+			numUploads++;
+			numFullUploads++;
+			bytesUploaded += size.x * size.y * sizeof(Colori);
+
+			m_fullyDirty = false;
+			m_dirty = Recti();
 			return tex;
 		}
+		virtual bool UpdateTexture(OpenGL* gl, Texture& texture)
+		{
+			Vector2i size = m_image->GetSize();
+			if(!texture || m_fullyDirty || texture->GetSize().x != size.x || texture->GetSize().y != size.y)
+			{
+				texture = GenerateTexture(gl);
+				return true;
+			}
+			if(m_dirty.size.x == 0 || m_dirty.size.y == 0)
+				return false;
+
+			uint32 pitch = size.x;
+			const Colori* pSrc = m_image->GetBits() + m_dirty.pos.x + m_dirty.pos.y * pitch;
+			texture->SetSubData(m_dirty.pos, m_dirty.size, pSrc, pitch);
+
+			numUploads++;
+			bytesUploaded += m_dirty.size.x * m_dirty.size.y * sizeof(Colori);
+
+			m_dirty = Recti();
+			return true;
+		}
+
+	private:
+		Shelf* m_FindShelf(Vector2i paddedSize, bool limitWaste)
+		{
+			Shelf* dstShelf = nullptr;
+			for(Shelf& shelf : m_shelves)
+			{
+				if(shelf.height < paddedSize.y || m_image->GetSize().x - shelf.usedX < paddedSize.x)
+					continue;
+				if(limitWaste && shelf.height > paddedSize.y * 2 + 4)
+					continue;
+				if(!dstShelf || shelf.height < dstShelf->height)
+					dstShelf = &shelf;
+			}
+			return dstShelf;
+		}
+		void m_AllocatePage(Vector2i size)
+		{
+			m_image->SetSize(size);
+			memset(m_image->GetBits(), 0, size.x * size.y * sizeof(Colori));
+			m_dirty = Recti();
+			m_fullyDirty = true;
+		}
+		void m_GrowPage(Vector2i newSize)
+		{
+			Image newImage = ImageRes::Create(newSize);
+			memset(newImage->GetBits(), 0, newSize.x * newSize.y * sizeof(Colori));
+			CopySubImage(newImage, m_image, Vector2i());
+			m_image = newImage;
+			m_dirty = Recti();
+			m_fullyDirty = true;
+		}
+		void m_MarkDirty(const Recti& rect)
+		{
+			if(m_fullyDirty)
+				return;
+			if(m_dirty.size.x == 0 || m_dirty.size.y == 0)
+			{
+				m_dirty = rect;
+				return;
+			}
+			int32 left = Math::Min(m_dirty.Left(), rect.Left());
+			int32 top = Math::Min(m_dirty.Top(), rect.Top());
+			int32 right = Math::Max(m_dirty.Right(), rect.Right());
+			int32 bottom = Math::Max(m_dirty.Bottom(), rect.Bottom());
+			m_dirty = Recti(left, top, right, bottom);
+		}
 	};
 
-	SpriteMap SpriteMapRes::Create()
+	SpriteMap SpriteMapRes::Create(Vector2i initialSize)
 	{
-		SpriteMap_Impl* pImpl = new SpriteMap_Impl();
+		SpriteMap_Impl* pImpl = new SpriteMap_Impl(initialSize);
 		return GetResourceManager<ResourceType::SpriteMap>().Register(pImpl);
 	}
+	SpriteMapUploadStats SpriteMapRes::GetUploadStats()
+	{
+		SpriteMapUploadStats stats;
+		stats.numUploads = numUploads;
+		stats.numFullUploads = numFullUploads;
+		stats.bytesUploaded = bytesUploaded;
+		return stats;
+	}
 }
@@ -8,6 +8,7 @@ namespace Graphics
 {
 	class Texture_Impl : public TextureRes
 	{
+		OpenGL* m_gl;
 		uint32 m_texture = 0;
 		TextureWrap m_wmode[2] = { TextureWrap::Repeat };
 		TextureFormat m_format = TextureFormat::Invalid;
@@ -19,16 +20,24 @@ namespace Graphics
 		void* m_data = nullptr;
 
 	public:
-		Texture_Impl()
+		Texture_Impl(OpenGL* gl) : m_gl(gl)
 		{
 		}
 		~Texture_Impl()
 		{
-			if(m_texture)
-				glDeleteTextures(1, &m_texture);
+			uint32 texture = m_texture;
+			if(texture)
+				m_gl->Post([texture]() { glDeleteTextures(1, &texture); });
 		}
 		bool Init()
 		{
+			if(!m_gl->IsOpenGLThread())
+			{
+				bool result = false;
+				m_gl->Invoke([&]() { result = Init(); });
+				return result;
+			}
+
 			#ifdef __APPLE__
 			glGenTextures(1, &m_texture);
 			#else
@@ -44,6 +53,9 @@ namespace Graphics
 		}
 		virtual void Init(Vector2i size, TextureFormat format)
 		{
+			if(!m_gl->IsOpenGLThread())
+				return m_gl->Invoke([&]() { Init(size, format); });
+
 			m_format = format;
 			m_size = size;
 
@@ -82,6 +94,9 @@ namespace Graphics
 		}
 		virtual void SetData(Vector2i size, void* pData)
 		{
+			if(!m_gl->IsOpenGLThread())
+				return m_gl->Invoke([&]() { SetData(size, pData); });
+
 			m_format = TextureFormat::RGBA8;
 			m_size = size;
 			m_data = pData;
@@ -105,6 +120,44 @@ namespace Graphics
 			UpdateFilterState();
 			UpdateWrap();
 		}
+		virtual void SetSubData(Vector2i pos, Vector2i size, const void* pData, uint32 rowLength)
+		{
+			assert(m_format == TextureFormat::RGBA8);
+			assert(pos.x >= 0 && pos.y >= 0 && pos.x + size.x <= m_size.x && pos.y + size.y <= m_size.y);
+
+			if(!m_gl->IsOpenGLThread())
+			{
+				// Copy the rows, they are uploaded before the next frame is rendered
+				CopyableBuffer data;
+				size_t rowSize = size.x * 4;
+				size_t pitch = (rowLength > 0 ? rowLength : size.x) * 4;
+				data.resize(rowSize * size.y);
+				for(int32 y = 0; y < size.y; y++)
+					memcpy(data.data() + rowSize * y, (const uint8*)pData + pitch * y, rowSize);
+
+				uint32 texture = m_texture;
+				m_gl->Post([texture, pos, size, data]()
+				{
+					UploadSubData(texture, pos, size, data.data(), size.x);
+				});
+				return;
+			}
+			UploadSubData(m_texture, pos, size, pData, rowLength);
+		}
+		static void UploadSubData(uint32 texture, Vector2i pos, Vector2i size, const void* pData, uint32 rowLength)
+		{
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, rowLength);
+			#ifdef __APPLE__
+			glBindTexture(GL_TEXTURE_2D, texture);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, pos.x, pos.y, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, pData);
+			#else
+			if(glTextureSubImage2D)
+				glTextureSubImage2D(texture, 0, pos.x, pos.y, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, pData);
+			else
+				glTextureSubImage2DEXT(texture, GL_TEXTURE_2D, 0, pos.x, pos.y, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, pData);
+			#endif
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+		}
 		void UpdateFilterState()
 		{
 			#ifdef __APPLE__
@@ -171,6 +224,8 @@ namespace Graphics
 		}
 		virtual void SetFilter(bool enabled, bool mipFiltering, float anisotropic)
 		{
+			if(!m_gl->IsOpenGLThread())
+				return m_gl->Invoke([&]() { SetFilter(enabled, mipFiltering, anisotropic); });
 			m_mipFilter = mipFiltering;
 			m_filter = enabled;
 			m_anisotropic = anisotropic;
@@ -179,6 +234,8 @@ namespace Graphics
 		}
 		virtual void SetMipmaps(bool enabled)
 		{
+			if(!m_gl->IsOpenGLThread())
+				return m_gl->Invoke([&]() { SetMipmaps(enabled); });
 			if(enabled)
 			{
 				#ifdef __APPLE__
@@ -221,6 +278,8 @@ namespace Graphics
 
 		virtual void SetWrap(TextureWrap u, TextureWrap v) override
 		{
+			if(!m_gl->IsOpenGLThread())
+				return m_gl->Invoke([&]() { SetWrap(u, v); });
 			m_wmode[0] = u;
 			m_wmode[1] = v;
 			UpdateWrap();
@@ -260,7 +319,7 @@ namespace Graphics
 
 	Texture TextureRes::Create(OpenGL* gl)
 	{
-		Texture_Impl* pImpl = new Texture_Impl();
+		Texture_Impl* pImpl = new Texture_Impl(gl);
 		if(pImpl->Init())
 		{
 			return GetResourceManager<ResourceType::Texture>().Register(pImpl);
@@ -275,7 +334,7 @@ namespace Graphics
 	{
 		if(!image)
 			return Texture();
-		Texture_Impl* pImpl = new Texture_Impl();
+		Texture_Impl* pImpl = new Texture_Impl(gl);
 		if(pImpl->Init())
 		{
 			pImpl->SetData(image->GetSize(), image->GetBits());
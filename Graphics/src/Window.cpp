@@ -132,10 +132,14 @@ namespace Graphics
 			return res;
 		}
 
-		void SetVSync(int8 setting)
+		bool SetVSync(int8 setting)
 		{
 			if(SDL_GL_SetSwapInterval(setting) == -1)
+			{
 				Logf("Failed to set VSync: %s", Logger::Error, SDL_GetError());
+				return false;
+			}
+			return true;
 		}
 
 		void SetWindowStyle(WindowStyle style)
@@ -475,9 +479,9 @@ namespace Graphics
 {
 		return m_impl->GetWindowSize();
 	}
-	void Window::SetVSync(int8 setting)
+	bool Window::SetVSync(int8 setting)
 	{
-		m_impl->SetVSync(setting);
+		return m_impl->SetVSync(setting);
 	}
 	void Window::SetWindowSize(const Vector2i& size)
 	{
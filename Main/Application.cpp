@@ -172,8 +172,13 @@ bool Application::m_Init()
 		Logf("Failed to load config file", Logger::Warning);
 	}
 
+	// Record from the start to profile loading
+	if(m_commandLine.Contains("-profile"))
+		Profiler::SetEnabled(true);
+
 	// Job sheduler
-	g_jobSheduler = new JobSheduler();
+	g_jobSheduler = new JobSheduler((uint32)Math::Max(g_gameConfig.GetInt(GameConfigKeys::JobThreads), 0),
+		(uint32)Math::Max(g_gameConfig.GetInt(GameConfigKeys::IOJobs), 1));
 
 	m_allowMapConversion = false;
 	bool debugMute = false;
@@ -281,7 +286,13 @@ bool Application::m_Init()
 	// call the initial OnWindowResized now that we have intialized OpenGL
 	m_OnWindowResized(g_resolution);
 
-	g_gameWindow->SetVSync(g_gameConfig.GetInt(GameConfigKeys::VSync));
+	// -1 requests adaptive vsync, which tears late frames instead of waiting a full refresh
+	int32 vsync = g_gameConfig.GetInt(GameConfigKeys::VSync);
+	if(!g_gameWindow->SetVSync(vsync) && vsync < 0)
+	{
+		Logf("Adaptive vsync not supported, using regular vsync", Logger::Warning);
+		g_gameWindow->SetVSync(1);
+	}
 
 	{
 		ProfilerScope $1("GUI Init");
@@ -308,8 +319,17 @@ bool Application::m_Init()
 }
 void Application::m_MainLoop()
 {
-	Timer appTimer;
+	// Submit GL commands from a separate thread, so simulation and input don't wait on the driver
+	if(g_gameConfig.GetBool(GameConfigKeys::RenderThread))
+		g_gl->StartRenderThread();
+
+	Profiler::SetThreadName("Main");
 	m_lastRenderTime = 0.0f;
+	m_framePacer.SetSimulationRate((double)Math::Max(g_gameConfig.GetInt(GameConfigKeys::SimulationRate), 0));
+	m_framePacer.onPoll.BindLambda([]()
+	{
+		return g_gameWindow->Update();
+	});
 	while(true)
 	{
 		// Process changes in the list of items
@@ -368,7 +388,6 @@ void Application::m_MainLoop()
 
 		// Determine target tick rates for update and render
 		int32 targetFPS = 120; // Default to 120 FPS
-		float targetRenderTime = 0.0f;
 		for(auto tickable : g_tickables)
 		{
 			int32 tempTarget = 0;
@@ -377,85 +396,113 @@ void Application::m_MainLoop()
 				targetFPS = tempTarget;
 			}
 		}
-		if(targetFPS > 0)
-			targetRenderTime = 1.0f / (float)targetFPS;
-			
+		m_framePacer.SetTargetFrameRate((double)Math::Max(targetFPS, 0));
 
-		// Main loop
-		float currentTime = appTimer.SecondsAsFloat();
-		float timeSinceRender = currentTime - m_lastRenderTime;
-		if(timeSinceRender > targetRenderTime)
-		{
-			// Calculate actual deltatime for timing calculations
-			currentTime = appTimer.SecondsAsFloat();
-			float actualDeltaTime = currentTime - m_lastRenderTime;
-			g_avgRenderDelta = g_avgRenderDelta * 0.75f + actualDeltaTime * 0.25f; // Calculate avg
+		// Keep polling the window while waiting for the next frame
+		//	so input events are timestamped close to when they happened instead of once per frame
+		if(!m_framePacer.WaitForFrame())
+			return;
 
-			m_deltaTime = actualDeltaTime;
-			m_lastRenderTime = currentTime;
+		// Main loop
+		Profiler::BeginFrame();
+		uint32 numSteps = m_framePacer.BeginFrame();
+		m_deltaTime = m_framePacer.GetFrameDelta();
+		m_lastRenderTime = (float)m_framePacer.GetFrameStartTime();
+		g_avgRenderDelta = g_avgRenderDelta * 0.75f + m_deltaTime * 0.25f; // Calculate avg
 
-			// Set time in render state
-			m_renderStateBase.time = currentTime;
+		// Set time in render state
+		m_renderStateBase.time = m_lastRenderTime;
 
-			// Also update window in render loop
-			if(!g_gameWindow->Update())
-				return;
+		// Also update window in render loop
+		if(!g_gameWindow->Update())
+			return;
 
-			m_Tick();
-			timeSinceRender = 0.0f;
+		float stepTime = m_framePacer.GetSimulationStep();
+		for(uint32 i = 0; i < numSteps; i++)
+			m_Tick(stepTime);
+		if(!m_Render(m_deltaTime))
+			return;
+		Profiler::Counter("Frame Time (ms)", m_deltaTime * 1000.0);
 
+		{
+			PROFILE_ZONE("Resources and Jobs");
 			// Garbage collect resources
 			ResourceManagers::TickAll();
-		}
 
-		// Tick job sheduler
-		// processed callbacks for finished tasks
-		g_jobSheduler->Update();
-
-		if(timeSinceRender < targetRenderTime)
-		{
-			float timeLeft = (targetRenderTime - timeSinceRender);
-			uint32 sleepMicroSecs = (uint32)(timeLeft*1000000.0f * 0.75f);
-			std::this_thread::sleep_for(std::chrono::microseconds(sleepMicroSecs));
+			// Tick job sheduler
+			// processed callbacks for finished tasks
+			g_jobSheduler->Update();
 		}
 	}
 }
 
-void Application::m_Tick()
+void Application::m_Tick(float deltaTime)
 {
+	PROFILE_ZONE("Tick");
+
 	// Handle input first
-	g_input.Update(m_deltaTime);
+	g_input.Update(deltaTime);
 
 	// Tick all items
 	for(auto& tickable : g_tickables)
 	{
-		tickable->Tick(m_deltaTime);
+		tickable->Tick(deltaTime);
 	}
+}
+bool Application::m_Render(float deltaTime)
+{
+	PROFILE_ZONE("Render");
 
 	// Not minimized / Valid resolution
 	if(g_resolution.x > 0 && g_resolution.y > 0)
 	{
-		glClearColor(0, 0, 0, 0);
-		glClear(GL_COLOR_BUFFER_BIT);
+		g_gl->Enqueue([]()
+		{
+			glClearColor(0, 0, 0, 0);
+			glClear(GL_COLOR_BUFFER_BIT);
+		});
 
 		// Render all items
 		for(auto& tickable : g_tickables)
 		{
-			tickable->Render(m_deltaTime);
+			tickable->Render(deltaTime);
 		}
 
 		// Time to render GUI
-		g_guiRenderer->Render(m_deltaTime, Rect(Vector2(0, 0), g_resolution), g_rootCanvas.As<GUIElementBase>());
+		{
+			PROFILE_ZONE("GUI");
+			g_guiRenderer->Render(deltaTime, Rect(Vector2(0, 0), g_resolution), g_rootCanvas.As<GUIElementBase>());
+		}
 
-		// Swap buffers
+		// Hold the frame until its present deadline, then swap buffers
+		//	with a render thread the frame is handed over right away and presented by that thread
+		if(!g_gl->HasRenderThread())
+		{
+			PROFILE_ZONE("Wait For Present");
+			if(!m_framePacer.WaitForPresent())
+				return false;
+		}
+		PROFILE_ZONE("Present");
+		m_framePacer.BeginPresent();
 		g_gl->SwapBuffers();
+		m_framePacer.EndPresent();
+	}
+	else
+	{
+		// Nothing is shown while minimized, still wait for the next frame instead of spinning
+		m_framePacer.SkipPresent();
 	}
+	return true;
 }
 
 void Application::m_Cleanup()
 {
 	ProfilerScope $("Application Cleanup");
 
+	// Take the context back before anything is released
+	if(g_gl)
+		g_gl->StopRenderThread();
+
 	for(auto it : g_tickables)
 	{
 		delete it;
@@ -603,6 +650,16 @@ Transform Application::GetGUIProjection() const
 }
 void Application::m_OnKeyPressed(int32 key)
 {
+	// Profiler toggle, the recorded trace is written out when it is turned off
+	if(key == SDLK_F10)
+	{
+		bool enable = !Profiler::IsEnabled();
+		Profiler::SetEnabled(enable);
+		if(!enable)
+			Profiler::ExportChromeTrace("profiler_trace.json");
+		return;
+	}
+
 	// Fullscreen toggle
 	if(key == SDLK_RETURN)
 	{
@@ -639,8 +696,8 @@ void Application::m_OnWindowResized(const Vector2i& newSize)
 
 	m_renderStateBase.aspectRatio = g_aspectRatio;
 	m_renderStateBase.viewportSize = g_resolution;
-	glViewport(0, 0, newSize.x, newSize.y);
-	glScissor(0, 0, newSize.x, newSize.y);
+	g_gl->SetViewport(newSize);
+	g_gl->Enqueue([=]() { glScissor(0, 0, newSize.x, newSize.y); });
 
 	// Set in config
 	if (g_gameWindow->IsFullscreen()){
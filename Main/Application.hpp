@@ -1,5 +1,6 @@
 #pragma once
 #include <Audio/Sample.hpp>
+#include <Shared/FramePacer.hpp>
 
 extern class OpenGL* g_gl;
 extern class Graphics::Window* g_gameWindow;
@@ -53,6 +54,8 @@ public:
 
 	float GetAppTime() const { return m_lastRenderTime; }
 	float GetRenderFPS() const;
+	// Frame timing of the main loop
+	const FramePacer& GetFramePacer() const { return m_framePacer; }
 
 	Transform GetGUIProjection() const;
 
@@ -62,7 +65,9 @@ private:
 
 	bool m_Init();
 	void m_MainLoop();
-	void m_Tick();
+	void m_Tick(float deltaTime);
+	// Returns false when the window was closed while waiting to present
+	bool m_Render(float deltaTime);
 
 	void m_Cleanup();
 	void m_OnKeyPressed(int32 key);
@@ -75,6 +80,7 @@ private:
 	String m_lastMapPath;
 	class Beatmap* m_currentMap = nullptr;
 
+	FramePacer m_framePacer;
 	float m_lastRenderTime;
 	float m_deltaTime;
 	bool m_allowMapConversion;
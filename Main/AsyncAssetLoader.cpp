@@ -1,10 +1,25 @@
 #include "stdafx.h"
 #include "AsyncAssetLoader.hpp"
 #include "Application.hpp"
+#include "Shared/Jobs.hpp"
+#include <atomic>
 
 struct AsyncLoadOperation : public IAsyncLoadable
 {
 	String name;
+	// Loader that owns this operation
+	class AsyncAssetLoader_Impl* loader = nullptr;
+	bool loaded = false;
+	bool finalized = false;
+	bool finalizeFailed = false;
+	double loadTime = 0.0;
+	double finalizeTime = 0.0;
+
+	// Operations that don't depend on anything else being finalized can be finalized as soon as they are loaded
+	virtual bool CanFinalizeEarly() const
+	{
+		return false;
+	}
 };
 struct AsyncTextureLoadOperation : public AsyncLoadOperation
 {
@@ -22,14 +37,20 @@ struct AsyncTextureLoadOperation : public AsyncLoadOperation
 	bool AsyncFinalize()
 	{
 		target = TextureRes::Create(g_gl, image);
+		image.Release();
 		return target.IsValid();
 	}
+	bool CanFinalizeEarly() const override
+	{
+		return true;
+	}
 };
 struct AsyncMeshLoadOperation : public AsyncLoadOperation
 {
 	Mesh& target;
 	AsyncMeshLoadOperation(Mesh& target, const String& path) : target(target)
 	{
+		name = path;
 	}
 	bool AsyncLoad()
 	{
@@ -41,7 +62,7 @@ struct AsyncMeshLoadOperation : public AsyncLoadOperation
 		/// TODO: No mesh loading yet
 		return false;
 	}
-}; 
+};
 struct AsyncMaterialLoadOperation : public AsyncLoadOperation
 {
 	Material& target;
@@ -57,6 +78,10 @@ struct AsyncMaterialLoadOperation : public AsyncLoadOperation
 	{
 		return (target = g_application->LoadMaterial(name)).IsValid();
 	}
+	bool CanFinalizeEarly() const override
+	{
+		return true;
+	}
 };
 struct AsyncWrapperOperation : public AsyncLoadOperation
 {
@@ -78,19 +103,104 @@ struct AsyncWrapperOperation : public AsyncLoadOperation
 class AsyncAssetLoader_Impl
 {
 public:
+	AsyncAssetLoader* parent;
 	Vector<AsyncLoadOperation*> loadables;
+	Timer loadTimer;
+
+	// Operations of this loader and nested loaders that are loaded and can be finalized early
+	Mutex readyLock;
+	Vector<AsyncLoadOperation*> readyOperations;
+	// Progress of this loader and nested loaders
+	std::atomic<uint32> numOperations;
+	std::atomic<uint32> numLoaded;
+	std::atomic<uint32> numFinalized;
+
+	AsyncAssetLoader_Impl(AsyncAssetLoader* parent) : parent(parent), numOperations(0), numLoaded(0), numFinalized(0)
+	{
+	}
 	~AsyncAssetLoader_Impl()
 	{
+		GetOutermost()->RemoveReadyOperations(loadables);
 		for(auto& loadable : loadables)
 		{
+			// Keeps the progress of parent loaders complete
+			if(!loadable->finalized)
+				Count(&AsyncAssetLoader_Impl::numFinalized);
+			if(!loadable->loaded)
+				Count(&AsyncAssetLoader_Impl::numLoaded);
 			delete loadable;
 		}
 	}
+	AsyncAssetLoader_Impl* GetParent()
+	{
+		return parent ? parent->m_impl : nullptr;
+	}
+	// The loader that collects the ready operations
+	AsyncAssetLoader_Impl* GetOutermost()
+	{
+		AsyncAssetLoader_Impl* impl = this;
+		while(impl->GetParent())
+			impl = impl->GetParent();
+		return impl;
+	}
+	// Increments a progress counter of this loader and all parent loaders
+	void Count(std::atomic<uint32> AsyncAssetLoader_Impl::* counter)
+	{
+		for(AsyncAssetLoader_Impl* impl = this; impl; impl = impl->GetParent())
+			(impl->*counter)++;
+	}
+	void RemoveReadyOperations(const Vector<AsyncLoadOperation*>& operations)
+	{
+		readyLock.lock();
+		for(auto it = readyOperations.begin(); it != readyOperations.end();)
+		{
+			if(operations.Contains(*it))
+				it = readyOperations.erase(it);
+			else
+				it++;
+		}
+		readyLock.unlock();
+	}
+	void Add(AsyncLoadOperation* operation)
+	{
+		operation->loader = this;
+		loadables.Add(operation);
+		Count(&AsyncAssetLoader_Impl::numOperations);
+	}
+	bool Load(AsyncLoadOperation* operation)
+	{
+		Timer timer;
+		bool success = operation->AsyncLoad();
+		operation->loadTime = timer.SecondsAsDouble();
+		operation->loaded = true;
+		Count(&AsyncAssetLoader_Impl::numLoaded);
+		if(!success)
+		{
+			Logf("[AsyncLoad] Load failed on %s", Logger::Error, operation->name);
+			return false;
+		}
+		if(operation->CanFinalizeEarly())
+		{
+			AsyncAssetLoader_Impl* outermost = GetOutermost();
+			outermost->readyLock.lock();
+			outermost->readyOperations.Add(operation);
+			outermost->readyLock.unlock();
+		}
+		return true;
+	}
+	static void Finalize(AsyncLoadOperation* operation)
+	{
+		Timer timer;
+		operation->finalizeFailed = !operation->AsyncFinalize();
+		operation->finalizeTime = timer.SecondsAsDouble();
+		operation->finalized = true;
+		operation->loader->Count(&AsyncAssetLoader_Impl::numFinalized);
+	}
 };
 
-AsyncAssetLoader::AsyncAssetLoader()
+AsyncAssetLoader::AsyncAssetLoader(AsyncAssetLoader* parent /*= nullptr*/)
 {
-	m_impl = new AsyncAssetLoader_Impl();
+	m_impl = new AsyncAssetLoader_Impl(parent);
 }
 AsyncAssetLoader::~AsyncAssetLoader()
 {
@@ -99,49 +209,124 @@ AsyncAssetLoader::~AsyncAssetLoader()
 
 void AsyncAssetLoader::AddTexture(Texture& out, const String& path)
 {
-	m_impl->loadables.Add(new AsyncTextureLoadOperation(out, path));
+	m_impl->Add(new AsyncTextureLoadOperation(out, path));
 }
 void AsyncAssetLoader::AddMesh(Mesh& out, const String& path)
 {
-	m_impl->loadables.Add(new AsyncMeshLoadOperation(out, path));
+	m_impl->Add(new AsyncMeshLoadOperation(out, path));
 }
 void AsyncAssetLoader::AddMaterial(Material& out, const String& path)
 {
-	m_impl->loadables.Add(new AsyncMaterialLoadOperation(out, path));
+	m_impl->Add(new AsyncMaterialLoadOperation(out, path));
 }
 void AsyncAssetLoader::AddLoadable(IAsyncLoadable& loadable, const String& id /*= "unknown"*/)
 {
-	m_impl->loadables.Add(new AsyncWrapperOperation(loadable, id));
+	m_impl->Add(new AsyncWrapperOperation(loadable, id));
 }
 
 bool AsyncAssetLoader::Load()
 {
-	bool success = true;
-	for(auto& ld : m_impl->loadables)
+	m_impl->loadTimer.Restart();
+	Vector<AsyncLoadOperation*>& loadables = m_impl->loadables;
+
+	if(!g_jobSheduler)
 	{
-		if(!ld->AsyncLoad())
+		bool success = true;
+		for(auto& ld : loadables)
 		{
-			Logf("[AsyncLoad] Load failed on %s", Logger::Error, ld->name);
-			success = false;
+			if(!m_impl->Load(ld))
+				success = false;
 		}
+		return success;
 	}
+
+	// Every operation is it's own batch, so a slow one doesn't hold up others
+	std::atomic<bool> success(true);
+	g_jobSheduler->ParallelFor((uint32)loadables.size(), [&](uint32 begin, uint32 end)
+	{
+		for(uint32 i = begin; i < end; i++)
+		{
+			if(!m_impl->Load(loadables[i]))
+				success = false;
+		}
+	}, 1);
 	return success;
 }
 bool AsyncAssetLoader::Finalize()
 {
+	// Operations that weren't finalized early are finalized here
+	m_impl->GetOutermost()->RemoveReadyOperations(m_impl->loadables);
+
 	bool success = true;
+	double loadTime = 0.0;
+	double finalizeTime = 0.0;
 	for(auto& ld : m_impl->loadables)
 	{
-		if(!ld->AsyncFinalize())
+		if(!ld->finalized)
+			AsyncAssetLoader_Impl::Finalize(ld);
+		if(ld->finalizeFailed)
 		{
 			Logf("[AsyncLoad] Finalize failed on %s", Logger::Error, ld->name);
 			success = false;
 		}
+		loadTime += ld->loadTime;
+		finalizeTime += ld->finalizeTime;
+	}
+
+	if(!m_impl->loadables.empty())
+	{
+		Logf("[AsyncLoad] %d operations finished after %.1fms, total load time %.1fms, finalize time %.1fms", Logger::Info,
+			(uint32)m_impl->loadables.size(), m_impl->loadTimer.SecondsAsDouble() * 1000.0, loadTime * 1000.0, finalizeTime * 1000.0);
+#ifdef _DEBUG
+		// Slowest operations first
+		Vector<AsyncLoadOperation*> sorted = m_impl->loadables;
+		std::sort(sorted.begin(), sorted.end(), [](const AsyncLoadOperation* l, const AsyncLoadOperation* r)
+		{
+			return l->loadTime + l->finalizeTime > r->loadTime + r->finalizeTime;
+		});
+		for(auto& ld : sorted)
+		{
+			Logf("[AsyncLoad]   %s: load %.2fms, finalize %.2fms", Logger::Info, ld->name, ld->loadTime * 1000.0, ld->finalizeTime * 1000.0);
+		}
+#endif // _DEBUG
 	}
 
 	// Clear state
+	AsyncAssetLoader* parent = m_impl->parent;
 	delete m_impl;
-	m_impl = new AsyncAssetLoader_Impl();
+	m_impl = new AsyncAssetLoader_Impl(parent);
 
 	return success;
 }
+
+bool AsyncAssetLoader::FinalizeReady(double timeBudget)
+{
+	Timer timer;
+	while(true)
+	{
+		m_impl->readyLock.lock();
+		if(m_impl->readyOperations.empty())
+		{
+			m_impl->readyLock.unlock();
+			return true;
+		}
+		if(timer.SecondsAsDouble() >= timeBudget)
+		{
+			m_impl->readyLock.unlock();
+			return false;
+		}
+		AsyncLoadOperation* operation = m_impl->readyOperations.front();
+		m_impl->readyOperations.erase(m_impl->readyOperations.begin());
+		m_impl->readyLock.unlock();
+
+		AsyncAssetLoader_Impl::Finalize(operation);
+	}
+}
+AsyncLoadProgress AsyncAssetLoader::GetProgress() const
+{
+	AsyncLoadProgress progress;
+	progress.numOperations = m_impl->numOperations;
+	progress.numLoaded = m_impl->numLoaded;
+	progress.numFinalized = m_impl->numFinalized;
+	return progress;
+}
@@ -1,14 +1,29 @@
 #pragma once
 #include "AsyncLoadable.hpp"
 
+// Number of load operations of a loader and the loaders nested in it in each stage
+struct AsyncLoadProgress
+{
+	uint32 numOperations = 0;
+	uint32 numLoaded = 0;
+	uint32 numFinalized = 0;
+};
+
 /*
-	Loads assets and IAsyncLoadables 
+	Loads assets and IAsyncLoadables
 	Acts like a queue that stores loading commands
+
+	Load runs the operations on the job threads.
+	Textures and materials that finished loading can be finalized while the other operations are still loading,
+	by calling FinalizeReady every frame on the main thread, Finalize then only needs to finalize the remaining operations
+
+	A loader created by an operation of another loader can pass that loader as its parent,
+	its ready operations and progress are then reported to the parent, so only the outermost loader needs to be watched
 */
 class AsyncAssetLoader : public Unique
 {
 public:
-	AsyncAssetLoader();
+	AsyncAssetLoader(AsyncAssetLoader* parent = nullptr);
 	~AsyncAssetLoader();
 
 	/// NOTE: the caller is responsible for keeping the passed in variable valid the this object is destroyed or finished with the loading
@@ -24,6 +39,12 @@ public:
 	bool Load();
 	bool Finalize();
 
+	// Finalizes operations of this loader and nested loaders that have finished loading, until the time budget in seconds is used up
+	//	should be called from the main thread, returns true when no finished operations are left
+	bool FinalizeReady(double timeBudget);
+	AsyncLoadProgress GetProgress() const;
+
 private:
+	friend class AsyncAssetLoader_Impl;
 	class AsyncAssetLoader_Impl* m_impl;
-};
\ No newline at end of file
+};
@@ -18,6 +18,12 @@ public:
 	//	for example, any OpenGL stuff
 	//	returns success
 	virtual bool AsyncFinalize() = 0;
+	// The loader that AsyncLoad queues assets on, if any
+	//	the loading screen finalizes the assets that finished loading early and shows its progress
+	virtual class AsyncAssetLoader* GetAssetLoader()
+	{
+		return nullptr;
+	}
 };
 
 // Both an application tickable and async loadable
@@ -10,18 +10,14 @@ AudioPlayback::AudioPlayback()
 }
 AudioPlayback::~AudioPlayback()
 {
-	m_CleanupDSP(m_buttonDSPs[0]);
-	m_CleanupDSP(m_buttonDSPs[1]);
-	m_CleanupDSP(m_laserDSP);
+	m_CleanupDSPs();
 }
 bool AudioPlayback::Init(class BeatmapPlayback& playback, const String& mapRootPath)
 {
 	// Cleanup exising DSP's
 	m_currentHoldEffects[0] = nullptr;
 	m_currentHoldEffects[1] = nullptr;
-	m_CleanupDSP(m_buttonDSPs[0]);
-	m_CleanupDSP(m_buttonDSPs[1]);
-	m_CleanupDSP(m_laserDSP);
+	m_CleanupDSPs();
 
 	m_playback = &playback;
 	m_beatmap = &playback.GetBeatmap();
@@ -67,6 +63,9 @@ bool AudioPlayback::Init(class BeatmapPlayback& playback, const String& mapRootP
 		}
 	}
 
+	// Allocate all effects used by the map up front
+	m_dspPool.Init(*m_beatmap, m_GetDSPTrack().GetData());
+
 	return true;
 }
 void AudioPlayback::Tick(float deltaTime)
@@ -131,13 +130,14 @@ void AudioPlayback::SetEffect(uint32 index, HoldObjectState* object, class Beatm
 	DSP*& dsp = m_buttonDSPs[index];
 
 	m_buttonEffects[index] = m_beatmap->GetEffect(object->effectType);
-	dsp = m_buttonEffects[index].CreateDSP(m_GetDSPTrack().GetData(), *this);
+	dsp = m_buttonEffects[index].CreateDSP(m_dspPool, *this);
 
 	if(dsp)
 	{
 		m_buttonEffects[index].SetParams(dsp, *this, object);
 		// Initialize mix value to previous value
 		dsp->mix = m_effectMix[index];
+		m_GetDSPTrack()->QueueAddDSP(dsp);
 	}
 }
 void AudioPlayback::SetEffectEnabled(uint32 index, bool enabled)
@@ -178,16 +178,22 @@ void AudioPlayback::SetLaserFilterInput(float input, bool active)
 			if(m_fxtrack.IsValid() && m_laserEffectType == EffectType::Bitcrush)
 				return;
 
-			m_laserDSP = m_laserEffect.CreateDSP(m_GetDSPTrack().GetData(), *this);
+			m_laserDSP = m_laserEffect.CreateDSP(m_dspPool, *this);
 			if(!m_laserDSP)
 			{
 				Logf("Failed to create laser DSP with type %d", Logger::Warning, m_laserEffect.type);
 				return;
 			}
-		}
 
-		// Set params
-		m_SetLaserEffectParameter(input);
+			// Set params before the audio thread uses it
+			m_SetLaserEffectParameter(input);
+			m_GetDSPTrack()->QueueAddDSP(m_laserDSP);
+		}
+		else
+		{
+			// Set params
+			m_SetLaserEffectParameter(input);
+		}
 		m_laserInput = input;
 	}
 	else
@@ -249,11 +255,19 @@ void AudioPlayback::m_CleanupDSP(DSP*& ptr)
 {
 	if(ptr)
 	{
-		m_GetDSPTrack()->RemoveDSP(ptr);
-		delete ptr;
+		// The DSP can be reused once the audio thread has removed it
+		m_GetDSPTrack()->QueueRemoveDSP(ptr);
+		m_dspPool.Release(ptr);
 		ptr = nullptr;
 	}
 }
+void AudioPlayback::m_CleanupDSPs()
+{
+	m_CleanupDSP(m_buttonDSPs[0]);
+	m_CleanupDSP(m_buttonDSPs[1]);
+	m_CleanupDSP(m_laserDSP);
+	m_dspPool.Clear();
+}
 void AudioPlayback::m_SetLaserEffectParameter(float input)
 {
 	if(!m_laserDSP)
@@ -2,6 +2,7 @@
 #include <Beatmap/Beatmap.hpp>
 #include <Beatmap/AudioEffects.hpp>
 #include <Audio/AudioStream.hpp>
+#include "DSPPool.hpp"
 
 /*
 	Audio effect with customized parameters
@@ -13,8 +14,9 @@ public:
 	GameAudioEffect() = default;
 	GameAudioEffect(const AudioEffect& other);
 
-	// Creates a DSP matching this effect
-	DSP* CreateDSP(class AudioBase* audioTrack, AudioPlayback& playback);
+	// Takes a DSP matching this effect from the pool and sets it up
+	//	the DSP still needs to be added to the audio track
+	DSP* CreateDSP(DSPPool& pool, AudioPlayback& playback);
 	// Applies the given parameters overriding some settings for this effect (depending on the effect)
 	void SetParams(DSP* dsp, AudioPlayback& playback, HoldObjectState* object);
 };
@@ -75,6 +77,7 @@ private:
 	// Returns the track that should have effects applied to them
 	AudioStream m_GetDSPTrack();
 	void m_CleanupDSP(class DSP*& ptr);
+	void m_CleanupDSPs();
 	void m_SetLaserEffectParameter(float input);
 
 	// Map player
@@ -88,6 +91,9 @@ private:
 	bool m_paused = false;
 	bool m_fxtrackEnabled = true;
 
+	// Effect DSPs for the current map, used on the DSP track
+	DSPPool m_dspPool;
+
 	EffectType m_laserEffectType = EffectType::None;
 	GameAudioEffect m_laserEffect;
 	class DSP* m_laserDSP = nullptr;
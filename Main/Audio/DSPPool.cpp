@@ -0,0 +1,230 @@
+#include "stdafx.h"
+#include "DSPPool.hpp"
+#include <Audio/DSP.hpp>
+#include <Audio/Audio.hpp>
+
+// Longest duration of an effect in ms
+static uint32 GetMaxDuration(const AudioEffect& effect, double noteDuration)
+{
+	return Math::Max(effect.duration.Sample(0.0f).Absolute(noteDuration), effect.duration.Sample(1.0f).Absolute(noteDuration));
+}
+static uint32 GetMaxFlangerDelay(const AudioEffect& effect)
+{
+	return (uint32)Math::Max(effect.flanger.depth.Sample(0.0f), effect.flanger.depth.Sample(1.0f));
+}
+
+DSPPool::~DSPPool()
+{
+	Clear();
+}
+
+void DSPPool::Init(const Beatmap& beatmap, AudioBase* track)
+{
+	Clear();
+	m_track = track;
+	assert(m_track->audio);
+
+	double maxNoteDuration = 0.0;
+	for(TimingPoint* tp : beatmap.GetLinearTimingPoints())
+	{
+		maxNoteDuration = Math::Max(maxNoteDuration, tp->GetWholeNoteLength());
+	}
+
+	// Find the effects used on buttons and lasers
+	Set<EffectType> buttonEffects;
+	Set<EffectType> laserEffects;
+	laserEffects.Add(EffectType::PeakingFilter);
+	laserEffects.Add(beatmap.GetMapSettings().laserEffectType);
+	for(ObjectState* obj : beatmap.GetLinearObjects())
+	{
+		if(obj->type == ObjectType::Hold)
+		{
+			HoldObjectState* hold = (HoldObjectState*)obj;
+			if(hold->effectType == EffectType::None)
+				continue;
+			buttonEffects.Add(hold->effectType);
+
+			// Hold parameters that override the effect length, same as GameAudioEffect::SetParams
+			uint32& maxLength = m_maxLengths.FindOrAdd(hold->effectType, 0);
+			double param = (double)Math::Max(hold->effectParams[0], (int16)1);
+			switch(hold->effectType)
+			{
+			case EffectType::Gate:
+			case EffectType::Retrigger:
+			case EffectType::Wobble:
+				maxLength = Math::Max(maxLength, (uint32)(maxNoteDuration / param));
+				break;
+			case EffectType::TapeStop:
+				maxLength = Math::Max(maxLength, (uint32)(1000 * (16.0 / param)));
+				break;
+			}
+		}
+		else if(obj->type == ObjectType::Event)
+		{
+			EventObjectState* evt = (EventObjectState*)obj;
+			if(evt->key == EventKey::LaserEffectType)
+				laserEffects.Add(evt->data.effectVal);
+		}
+	}
+
+	// Flanger holds always use a delay of up to 40 samples
+	m_maxFlangerDelay = 40;
+	Set<EffectType> usedEffects;
+	for(EffectType type : buttonEffects)
+	{
+		AudioEffect effect = beatmap.GetEffect(type);
+		uint32& maxLength = m_maxLengths.FindOrAdd(type, 0);
+		maxLength = Math::Max(maxLength, GetMaxDuration(effect, maxNoteDuration));
+		if(type == EffectType::Flanger)
+			m_maxFlangerDelay = Math::Max(m_maxFlangerDelay, GetMaxFlangerDelay(effect));
+		usedEffects.Add(type);
+	}
+	for(EffectType type : laserEffects)
+	{
+		if(type == EffectType::None)
+			continue;
+		AudioEffect effect = beatmap.GetFilter(type);
+		uint32& maxLength = m_maxLengths.FindOrAdd(type, 0);
+		maxLength = Math::Max(maxLength, GetMaxDuration(effect, maxNoteDuration));
+		if(type == EffectType::Flanger)
+			m_maxFlangerDelay = Math::Max(m_maxFlangerDelay, GetMaxFlangerDelay(effect));
+		usedEffects.Add(type);
+	}
+
+	// One for each FX button and one for lasers
+	//	with an extra one, since the previous DSP is still in use until the audio thread removes it
+	for(EffectType type : usedEffects)
+	{
+		uint32 count = 1;
+		if(buttonEffects.Contains(type))
+			count += 2;
+		if(laserEffects.Contains(type))
+			count += 1;
+		for(uint32 i = 0; i < count; i++)
+		{
+			DSP* dsp = m_CreateDSP(type);
+			if(!dsp)
+				break;
+			m_dsps.Add({ type, dsp, false });
+		}
+	}
+}
+void DSPPool::Clear()
+{
+	// Apply pending removals, after this the audio thread no longer uses any of the DSPs
+	if(m_track)
+		m_track->FlushDSPCommands();
+	for(Entry& entry : m_dsps)
+	{
+		assert(!entry.inUse);
+		delete entry.dsp;
+	}
+	m_dsps.clear();
+	m_maxLengths.clear();
+	m_track = nullptr;
+}
+
+DSP* DSPPool::Acquire(EffectType type)
+{
+	Entry* queued = nullptr;
+	for(Entry& entry : m_dsps)
+	{
+		if(entry.type != type || entry.inUse)
+			continue;
+		if(entry.dsp->IsQueued())
+		{
+			queued = &entry;
+			continue;
+		}
+		entry.inUse = true;
+		entry.dsp->Reset();
+		entry.dsp->mix = 1.0f;
+		return entry.dsp;
+	}
+
+	if(queued)
+	{
+		// Effect was retriggered more times than expected before the audio thread could remove the old one
+		m_track->FlushDSPCommands();
+		queued->inUse = true;
+		queued->dsp->Reset();
+		queued->dsp->mix = 1.0f;
+		return queued->dsp;
+	}
+
+	Logf("No preallocated DSP for effect \"%s\"", Logger::Warning, Enum_EffectType::ToString(type));
+	DSP* dsp = m_CreateDSP(type);
+	if(dsp)
+		m_dsps.Add({ type, dsp, true });
+	return dsp;
+}
+void DSPPool::Release(DSP* dsp)
+{
+	for(Entry& entry : m_dsps)
+	{
+		if(entry.dsp == dsp)
+		{
+			entry.inUse = false;
+			return;
+		}
+	}
+	assert(false);
+}
+
+uint32 DSPPool::GetNumDSPs() const
+{
+	return (uint32)m_dsps.size();
+}
+
+DSP* DSPPool::m_CreateDSP(EffectType type)
+{
+	DSP* ret = nullptr;
+	switch(type)
+	{
+	case EffectType::Bitcrush:
+		ret = new BitCrusherDSP();
+		break;
+	case EffectType::Echo:
+		ret = new EchoDSP();
+		break;
+	case EffectType::PeakingFilter:
+	case EffectType::LowPassFilter:
+	case EffectType::HighPassFilter:
+		ret = new BQFDSP();
+		break;
+	case EffectType::Gate:
+		ret = new GateDSP();
+		break;
+	case EffectType::TapeStop:
+		ret = new TapeStopDSP();
+		break;
+	case EffectType::Retrigger:
+		ret = new RetriggerDSP();
+		break;
+	case EffectType::Wobble:
+		ret = new WobbleDSP();
+		break;
+	case EffectType::Phaser:
+		ret = new PhaserDSP();
+		break;
+	case EffectType::Flanger:
+		ret = new FlangerDSP();
+		break;
+	case EffectType::SideChain:
+		ret = new SidechainDSP();
+		break;
+	case EffectType::PitchShift:
+		ret = new PitchShiftDSP();
+		break;
+	}
+	if(!ret)
+		return nullptr;
+
+	ret->audio = m_track->audio;
+	uint32* maxLength = m_maxLengths.Find(type);
+	if(maxLength)
+		ret->SetMaxLength(*maxLength);
+	if(type == EffectType::Flanger)
+		((FlangerDSP*)ret)->SetDelayRange(0, m_maxFlangerDelay);
+	return ret;
+}
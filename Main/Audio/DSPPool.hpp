@@ -0,0 +1,41 @@
+#pragma once
+#include <Beatmap/Beatmap.hpp>
+#include <Beatmap/AudioEffects.hpp>
+
+/*
+	Preallocated DSPs for the effects used by a map
+	all DSPs and their delay buffers are created when the map is loaded, so triggering an effect during gameplay doesn't allocate memory
+*/
+class DSPPool : Unique
+{
+public:
+	~DSPPool();
+
+	// Creates the DSPs for all the effects used by this map, sized for the longest effect durations in the map
+	//	the DSPs are used on the given track
+	void Init(const Beatmap& beatmap, class AudioBase* track);
+	// Deletes all DSPs, the DSPs should not be in use anymore
+	void Clear();
+
+	// Returns an unused DSP for an effect type with it's processing state reset
+	class DSP* Acquire(EffectType type);
+	// Returns a DSP to the pool, it can be reused once it has been removed from the track
+	void Release(class DSP* dsp);
+
+	uint32 GetNumDSPs() const;
+
+private:
+	struct Entry
+	{
+		EffectType type;
+		class DSP* dsp;
+		bool inUse;
+	};
+	class DSP* m_CreateDSP(EffectType type);
+
+	Vector<Entry> m_dsps;
+	// Buffer sizes used for each effect type in ms
+	Map<EffectType, uint32> m_maxLengths;
+	uint32 m_maxFlangerDelay = 0;
+	class AudioBase* m_track = nullptr;
+};
@@ -4,33 +4,33 @@
 #include <Audio/DSP.hpp>
 #include <Audio/Audio.hpp>
 
-DSP* GameAudioEffect::CreateDSP(class AudioBase* audioTrack, AudioPlayback& playback)
+DSP* GameAudioEffect::CreateDSP(DSPPool& pool, AudioPlayback& playback)
 {
-	DSP* ret = nullptr;
+	DSP* ret = pool.Acquire(type);
+	if(!ret)
+	{
+		Logf("Failed to create game audio effect for type \"%s\"", Logger::Warning, Enum_EffectType::ToString(type));
+		return nullptr;
+	}
 
 	const TimingPoint& tp = playback.GetBeatmapPlayback().GetCurrentTimingPoint();
 	double noteDuration = tp.GetWholeNoteLength();
 
 	float filterInput = playback.GetLaserFilterInput();
 	uint32 actualLength = duration.Sample(filterInput).Absolute(noteDuration);
-	uint32 maxLength = Math::Max(duration.Sample(0.f).Absolute(noteDuration), duration.Sample(1.f).Absolute(noteDuration));
 	switch(type)
 	{
 	case EffectType::Bitcrush:
 	{
-		BitCrusherDSP* bcDSP = new BitCrusherDSP();
-		audioTrack->AddDSP(bcDSP);
+		BitCrusherDSP* bcDSP = (BitCrusherDSP*)ret;
 		bcDSP->SetPeriod((float)bitcrusher.reduction.Sample(filterInput));
-		ret = bcDSP;
 		break;
 	}
 	case EffectType::Echo:
 	{
-		EchoDSP* echoDSP = new EchoDSP();
-		audioTrack->AddDSP(echoDSP);
+		EchoDSP* echoDSP = (EchoDSP*)ret;
 		echoDSP->feedback = echo.feedback.Sample(filterInput);
 		echoDSP->SetLength(actualLength);
-		ret = echoDSP;
 		break;
 	}
 	case EffectType::PeakingFilter:
@@ -38,96 +38,71 @@ DSP* GameAudioEffect::CreateDSP(class AudioBase* audioTrack, AudioPlayback& play
 	case EffectType::HighPassFilter:
 	{
 		// Don't set anthing for biquad Filters
-		BQFDSP* bqfDSP = new BQFDSP();
-		audioTrack->AddDSP(bqfDSP);
-		ret = bqfDSP;
 		break;
 	}
 	case EffectType::Gate:
 	{
-		GateDSP* gateDSP = new GateDSP();
-		audioTrack->AddDSP(gateDSP);
+		GateDSP* gateDSP = (GateDSP*)ret;
 		gateDSP->SetLength(actualLength);
 		gateDSP->SetGating(gate.gate.Sample(filterInput));
-		ret = gateDSP;
 		break;
 	}
 	case EffectType::TapeStop:
 	{
-		TapeStopDSP* tapestopDSP = new TapeStopDSP();
-		audioTrack->AddDSP(tapestopDSP);
+		TapeStopDSP* tapestopDSP = (TapeStopDSP*)ret;
 		tapestopDSP->SetLength(actualLength);
-		ret = tapestopDSP;
 		break;
 	}
 	case EffectType::Retrigger:
 	{
-		RetriggerDSP* retriggerDSP = new RetriggerDSP();
-		audioTrack->AddDSP(retriggerDSP);
-		retriggerDSP->SetMaxLength(maxLength);
+		RetriggerDSP* retriggerDSP = (RetriggerDSP*)ret;
 		retriggerDSP->SetLength(actualLength);
 		retriggerDSP->SetGating(retrigger.gate.Sample(filterInput));
 		retriggerDSP->SetResetDuration(retrigger.reset.Sample(filterInput).Absolute(noteDuration));
-		ret = retriggerDSP;
 		break;
 	}
 	case EffectType::Wobble:
 	{
-		WobbleDSP* wb = new WobbleDSP();
-		audioTrack->AddDSP(wb);
+		WobbleDSP* wb = (WobbleDSP*)ret;
 		wb->SetLength(actualLength);
 		wb->q = wobble.q.Sample(filterInput);
 		wb->fmax = wobble.max.Sample(filterInput);
 		wb->fmin = wobble.min.Sample(filterInput);
-		ret = wb;
 		break;
 	}
 	case EffectType::Phaser:
 	{
-		PhaserDSP* phs = new PhaserDSP();
-		audioTrack->AddDSP(phs);
+		PhaserDSP* phs = (PhaserDSP*)ret;
 		phs->SetLength(actualLength);
 		phs->dmin = phaser.min.Sample(filterInput);
 		phs->dmax = phaser.max.Sample(filterInput);
 		phs->fb = phaser.feedback.Sample(filterInput);
-		ret = phs;
 		break;
 	}
 	case EffectType::Flanger:
 	{
-		FlangerDSP* fl = new FlangerDSP();
-		audioTrack->AddDSP(fl);
+		FlangerDSP* fl = (FlangerDSP*)ret;
 		fl->SetLength(actualLength);
 		fl->SetDelayRange(flanger.offset.Sample(filterInput),
 			flanger.depth.Sample(filterInput));
-		ret = fl;
 		break;
 	}
 	case EffectType::SideChain:
 	{
-		SidechainDSP* sc = new SidechainDSP();
-		audioTrack->AddDSP(sc);
+		SidechainDSP* sc = (SidechainDSP*)ret;
 		sc->SetLength(actualLength);
 		sc->amount = 1.0f;
 		sc->curve = Interpolation::CubicBezier(0.39, 0.575, 0.565, 1);
-		ret = sc;
 		break;
 	}
 	case EffectType::PitchShift:
 	{
-		PitchShiftDSP* ps = new PitchShiftDSP();
-		audioTrack->AddDSP(ps);
+		PitchShiftDSP* ps = (PitchShiftDSP*)ret;
 		ps->amount = pitchshift.amount.Sample(filterInput);
-		ret = ps;
 		break;
 	}
 	}
 
-	if(!ret)
-	{
-		Logf("Failed to create game audio effect for type \"%s\"", Logger::Warning, Enum_EffectType::ToString(type));
-	}
-
 	return ret;
 }
 void GameAudioEffect::SetParams(DSP* dsp, AudioPlayback& playback, HoldObjectState* object)
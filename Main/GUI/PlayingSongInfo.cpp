@@ -43,6 +43,12 @@ PlayingSongInfo::PlayingSongInfo(Game& game)
 
 void PlayingSongInfo::PreRender(GUIRenderData rd, GUIElementBase *& inputElement)
 {
+	// The desired size depends on the window size instead of the area
+	if(g_resolution.x != m_layoutResolution.x || g_resolution.y != m_layoutResolution.y)
+	{
+		m_layoutResolution = g_resolution;
+		InvalidateLayout();
+	}
 	Canvas::PreRender(rd, inputElement);
 }
 
@@ -79,6 +85,7 @@ void PlayingSongInfo::SetJacket(Texture jacket)
 {
 	m_jacketImage = jacket;
 	m_jacket->texture = jacket;
+	m_jacket->InvalidateLayout();
 }
 
 SongTitleArtist::SongTitleArtist(String title, String artist, PlayingSongInfo* info)
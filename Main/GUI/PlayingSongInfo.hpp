@@ -69,6 +69,8 @@ private:
 	float m_progress = 0.5f;
 	String m_jacketPath;
 	Texture m_jacketImage;
+	// Window size used for the last layout
+	Vector2i m_layoutResolution;
 
 };
 
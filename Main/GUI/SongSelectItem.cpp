@@ -8,6 +8,8 @@
 #include <Beatmap/MapDatabase.hpp>
 
 static float padding = 5.0f;
+static const uint32 titleFontSize = 40;
+static const uint32 artistFontSize = 32;
 
 /* A frame that displays the jacket+frame of a single map difficulty */
 class SongDifficultyFrame : public GUIElementBase
@@ -153,13 +155,13 @@ SongSelectItem::SongSelectItem(Ref<SongSelectStyle> style)
 	// Add Titles
 	{
 		m_title = new Label();
-		m_title->SetFontSize(40);
+		m_title->SetFontSize(titleFontSize);
 		m_title->SetText(L"<title>");
 		LayoutBox::Slot* slot = m_mainVert->Add(m_title->MakeShared());
 		slot->padding = Margin(0, -5.0f);
 
 		m_artist = new Label();
-		m_artist->SetFontSize(32);
+		m_artist->SetFontSize(artistFontSize);
 		m_artist->SetText(L"<artist>");
 		slot = m_mainVert->Add(m_artist->MakeShared());
 		slot->padding = Margin(0, -5.0f);
@@ -180,6 +182,53 @@ SongSelectItem::SongSelectItem(Ref<SongSelectStyle> style)
 	SwitchCompact(true);
 }
 
+// Preload jobs that may still be running, they use the GUI font without holding a reference to it
+static Vector<Job> preloadJobs;
+
+void SongSelectItem::PreloadGlyphs(const Vector<MapIndex*>& maps)
+{
+	if(maps.empty())
+		return;
+
+	// Every character only needs to be rendered once
+	Set<wchar_t> titleChars;
+	Set<wchar_t> artistChars;
+	for(auto m : maps)
+	{
+		const BeatmapSettings& settings = m->difficulties[0]->settings;
+		for(wchar_t c : Utility::ConvertToWString(settings.title))
+			titleChars.Add(c);
+		for(wchar_t c : Utility::ConvertToWString(settings.artist))
+			artistChars.Add(c);
+	}
+	WString titles;
+	for(wchar_t c : titleChars)
+		titles += c;
+	WString artists;
+	for(wchar_t c : artistChars)
+		artists += c;
+
+	// The font is owned by the GUI renderer, which outlives the song select that waits for these jobs in CancelPreloads
+	Graphics::FontRes* font = g_guiRenderer->font.GetData();
+	Job job = JobBase::CreateLambda([font, titles, artists]()
+	{
+		font->PreloadGlyphs(titles, titleFontSize);
+		font->PreloadGlyphs(artists, artistFontSize);
+		return true;
+	});
+	// Only needed once the item scrolls into view
+	job->priority = JobPriority::Low;
+
+	preloadJobs.erase(std::remove_if(preloadJobs.begin(), preloadJobs.end(), [](const Job& j) { return j->IsFinished(); }), preloadJobs.end());
+	preloadJobs.Add(job);
+	g_jobSheduler->Queue(job);
+}
+void SongSelectItem::CancelPreloads()
+{
+	for(Job& job : preloadJobs)
+		job->Terminate();
+	preloadJobs.clear();
+}
 void SongSelectItem::PreRender(GUIRenderData rd, GUIElementBase*& inputElement)
 {
 	Canvas::PreRender(rd, inputElement);
@@ -260,6 +309,9 @@ void SongSelectItem::SwitchCompact(bool compact)
 		mainSlot->autoSizeY = true;
 		mainSlot->alignment = Vector2(0.0f, 0.5f);
 	}
+
+	// The desired size of this item is the size of the background texture
+	InvalidateLayout();
 }
 void SongSelectItem::SetSelectedDifficulty(int32 selectedIndex)
 {
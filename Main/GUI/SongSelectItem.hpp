@@ -54,6 +54,32 @@ private:
 	Vector<DifficultyIndex*> m_diffs;
 };
 
+// Compact reference to a song select index
+//	used for the (filtered) lists of the song wheel, the full SongSelectIndex is only created for visible items
+struct SongSelectEntry
+{
+	SongSelectEntry() = default;
+	SongSelectEntry(MapIndex* map, int32 difficulty = -1) : map(map), difficulty(difficulty)
+	{
+	}
+
+	// Same id as the SongSelectIndex this entry refers to
+	int32 GetId() const
+	{
+		return map->id * 10 + difficulty + 1;
+	}
+	SongSelectIndex GetIndex() const
+	{
+		if(difficulty < 0)
+			return SongSelectIndex(map);
+		return SongSelectIndex(map, map->difficulties[difficulty]);
+	}
+
+	MapIndex* map = nullptr;
+	// Index of a single difficulty or -1 to include all of them
+	int32 difficulty = -1;
+};
+
 // Song select item
 //	either shows only artist and title in compact mode
 //	or shows all the difficulties
@@ -72,6 +98,11 @@ public:
 	// Select compact of full display
 	void SwitchCompact(bool compact);
 
+	// Renders the glyphs needed to display these maps on a job thread
+	static void PreloadGlyphs(const Vector<MapIndex*>& maps);
+	// Cancels or waits for the preload jobs, after this the GUI font is no longer used by them
+	static void CancelPreloads();
+
 	// Set selected difficulty
 	void SetSelectedDifficulty(int32 selectedIndex);
 
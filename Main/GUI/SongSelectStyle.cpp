@@ -2,6 +2,19 @@
 #include "SongSelectStyle.hpp"
 #include "Shared/Jobs.hpp"
 #include "Application.hpp"
+#include "GameConfig.hpp"
+
+// Hash used to name thumbnails on disk (FNV-1a)
+static uint64 HashBytes(const void* data, size_t length, uint64 hash = 14695981039346656037ULL)
+{
+	const uint8* bytes = (const uint8*)data;
+	for(size_t i = 0; i < length; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
 
 Ref<SongSelectStyle> SongSelectStyle::instance;
 Ref<SongSelectStyle> SongSelectStyle::Get(Application* application)
@@ -36,6 +49,11 @@ SongSelectStyle::SongSelectStyle(Application* application)
 	}
 	diffFrameMaterial = application->LoadMaterial("diffFrame");
 	diffFrameMaterial->opaque = false;
+
+	m_maxJacketBytes = (size_t)Math::Max(g_gameConfig.GetInt(GameConfigKeys::JacketCacheSize), 1) * 1024 * 1024;
+	m_jacketCachePath = Path::Normalize(Path::Absolute("cache/jackets"));
+	if(!Path::IsDirectory(m_jacketCachePath) && !Path::CreateDirRecursive(m_jacketCachePath))
+		Logf("Failed to create jacket cache folder \"%s\"", Logger::Warning, m_jacketCachePath);
 }
 SongSelectStyle::~SongSelectStyle()
 {
@@ -52,55 +70,105 @@ Texture SongSelectStyle::GetJacketThumnail(const String& path)
 {
 	Texture ret = loadingJacketImage;
 
-	auto it = m_jacketImages.find(path);
-	if(it == m_jacketImages.end() || !it->second)
+	CachedJacketImage** cached = m_jacketImages.Find(path);
+	if(!cached)
 	{
 		CachedJacketImage* newImage = new CachedJacketImage();
+		newImage->path = path;
 		JacketLoadingJob* job = new JacketLoadingJob();
 		job->imagePath = path;
+		job->cachePath = m_jacketCachePath;
+		job->jobFlags = JobFlags::IO;
 		job->target = newImage;
+		job->style = this;
 		newImage->loadingJob = Ref<JobBase>(job);
-		newImage->lastUsage = m_timer.SecondsAsFloat();
+		newImage->usage = m_jacketUsage.insert(m_jacketUsage.begin(), newImage);
 		g_jobSheduler->Queue(newImage->loadingJob);
 
 		m_jacketImages.Add(path, newImage);
 	}
 	else
 	{
-		it->second->lastUsage = m_timer.SecondsAsFloat();
+		CachedJacketImage* image = *cached;
+		m_jacketUsage.splice(m_jacketUsage.begin(), m_jacketUsage, image->usage);
 		// If loaded set texture
-		if(it->second->texture)
+		if(image->texture)
 		{
-			ret = it->second->texture;
+			ret = image->texture;
 		}
 	}
 
-	// cleanup
-	/*
-	auto now = m_timer.SecondsAsFloat();
-	for (auto& jacket : m_jacketImages){
-		if (jacket.second){
-			// evict jackets not used in past minute
-			if (now - jacket.second->lastUsage > 60){
-				delete jacket.second;
-				jacket.second = nullptr;
-			}
-		}
+	return ret;
+}
+size_t SongSelectStyle::GetJacketMemoryUsage() const
+{
+	return m_jacketBytes;
+}
+void SongSelectStyle::m_OnJacketLoaded(CachedJacketImage* image)
+{
+	image->loaded = true;
+	if(image->texture)
+	{
+		Vector2i size = image->texture->GetSize();
+		image->textureBytes = size.x * size.y * 4;
+	}
+	else
+	{
+		image->textureBytes = sizeof(CachedJacketImage) + image->path.size();
 	}
-	//*/
+	m_jacketBytes += image->textureBytes;
 
-	return ret;
+	// Release the least recently used jackets, jackets that are still loading don't use any memory yet
+	auto it = m_jacketUsage.end();
+	while(m_jacketBytes > m_maxJacketBytes && it != m_jacketUsage.begin())
+	{
+		--it;
+		CachedJacketImage* evicted = *it;
+		if(!evicted->loaded || evicted == image)
+			continue;
+		m_jacketBytes -= evicted->textureBytes;
+		m_jacketImages.erase(evicted->path);
+		delete evicted;
+		it = m_jacketUsage.erase(it);
+	}
 }
+
+// Changes when the way thumbnails are made changes, so old thumbnails aren't used
+static const uint32 thumbnailVersion = 2;
+
 bool JacketLoadingJob::Run()
 {
-	// Create loading task
-	loadedImage = ImageRes::Create(imagePath);
-	if (loadedImage.IsValid()){
-		if (loadedImage->GetSize().x > 150 || loadedImage->GetSize().y > 150){
-			loadedImage->ReSize({150,150});
-		}
+	Vector2i maxSize = Vector2i(SongSelectStyle::jacketThumbnailSize);
+
+	// Thumbnails are named after the path, modification time and size of the image, so changed images get a new thumbnail
+	File file;
+	if(!file.OpenRead(imagePath))
+		return false;
+	uint64 lastWriteTime = file.GetLastWriteTime();
+	uint64 fileSize = file.GetSize();
+	file.Close();
+	uint64 hash = HashBytes(imagePath.data(), imagePath.size());
+	hash = HashBytes(&lastWriteTime, sizeof(lastWriteTime), hash);
+	hash = HashBytes(&fileSize, sizeof(fileSize), hash);
+	hash = HashBytes(&thumbnailVersion, sizeof(thumbnailVersion), hash);
+	String thumbnailPath = cachePath + Path::sep + Utility::Sprintf("%08x%08x.jpg", (uint32)(hash >> 32), (uint32)hash);
+
+	if(Path::FileExists(thumbnailPath))
+	{
+		loadedImage = ImageRes::Create(thumbnailPath);
+		if(loadedImage.IsValid() && loadedImage->GetSize().x <= maxSize.x && loadedImage->GetSize().y <= maxSize.y)
+			return true;
 	}
-	return loadedImage.IsValid();
+
+	loadedImage = ImageRes::Create(imagePath, maxSize);
+	if(!loadedImage.IsValid())
+		return false;
+
+	// Written to a temporary file first, so a partially written thumbnail is never used
+	String tempPath = thumbnailPath + ".tmp";
+	if(!ImageLoader::SaveJPEG(loadedImage.GetData(), tempPath) || !Path::Rename(tempPath, thumbnailPath, true))
+		Logf("Failed to store jacket thumbnail for \"%s\"", Logger::Warning, imagePath);
+	return true;
 }
 void JacketLoadingJob::Finalize()
 {
@@ -109,4 +177,5 @@ void JacketLoadingJob::Finalize()
 		target->texture = TextureRes::Create(g_gl, loadedImage);
 		target->texture->SetWrap(TextureWrap::Clamp, TextureWrap::Clamp);
 	}
-}
\ No newline at end of file
+	style->m_OnJacketLoaded(target);
+}
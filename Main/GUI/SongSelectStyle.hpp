@@ -3,12 +3,21 @@
 
 struct CachedJacketImage
 {
-	float lastUsage;
+	String path;
 	Texture texture;
-	bool loaded = false;
 	Job loadingJob;
+	// Set when the loading job finished, also when it failed
+	bool loaded = false;
+	// Memory used by the texture, jackets that failed to load use a small fixed amount so they are evicted eventually
+	size_t textureBytes = 0;
+	// Position in the list of recently used jackets
+	List<CachedJacketImage*>::iterator usage;
 };
 
+/*
+	Loads a jacket thumbnail
+	thumbnails are stored on disk, so only the first time a jacket is shown requires decoding the full image
+*/
 class JacketLoadingJob : public JobBase
 {
 public:
@@ -17,7 +26,10 @@ public:
 
 	Image loadedImage;
 	String imagePath;
+	// Folder that contains the thumbnails on disk
+	String cachePath;
 	CachedJacketImage* target;
+	class SongSelectStyle* style;
 };
 
 class SongSelectStyle : public Unique
@@ -45,10 +57,23 @@ public:
 	// Material used for compositing difficulty frames with jacket images
 	Material diffFrameMaterial;
 
+	// Maximum width and height of jacket thumbnails, jackets are scaled down to fit keeping their aspect ratio
+	static const int32 jacketThumbnailSize = 150;
+
 	// Cached jacket images
+	//	loaded jackets are kept until the memory limit is reached, then the least recently used jackets are released
 	Texture GetJacketThumnail(const String& path);
+	// Memory used by the loaded jackets in bytes
+	size_t GetJacketMemoryUsage() const;
 
 private:
-	Timer m_timer;
+	friend class JacketLoadingJob;
+	void m_OnJacketLoaded(CachedJacketImage* image);
+
 	Map<String, CachedJacketImage*> m_jacketImages;
+	// Most recently used jackets first
+	List<CachedJacketImage*> m_jacketUsage;
+	size_t m_jacketBytes = 0;
+	size_t m_maxJacketBytes;
+	String m_jacketCachePath;
 };
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include <Beatmap/BeatmapPlayback.hpp>
 #include <Shared/Profiling.hpp>
 #include "Scoring.hpp"
+#include "Replay.hpp"
 #include <Audio/Audio.hpp>
 #include "Track.hpp"
 #include "Camera.hpp"
@@ -98,8 +99,12 @@ private:
 
 	// The beatmap
 	Ref<Beatmap> m_beatmap;
+	// All score ticks of the beatmap
+	ScoringTimeline m_scoringTimeline;
 	// Scoring system object
 	Scoring m_scoring;
+	// Recording of the input of the current play
+	Replay m_replay;
 	// Beatmap playback manager (object and timing point selector)
 	BeatmapPlayback m_playback;
 	// Audio playback manager (music and FX))
@@ -204,6 +209,10 @@ public:
 	}
 
 	AsyncAssetLoader loader;
+	virtual AsyncAssetLoader* GetAssetLoader() override
+	{
+		return &loader;
+	}
 	virtual bool AsyncLoad() override
 	{
 		ProfilerScope $("AsyncLoad Game");
@@ -222,6 +231,7 @@ public:
 			Logf("Failed to load map", Logger::Warning);
 			return false;
 		}
+		m_scoringTimeline.Build(*m_beatmap);
 
 		// Enable debug functionality
 		if(g_application->GetAppCommandLine().Contains("-debug"))
@@ -331,6 +341,7 @@ public:
 
 		// Intialize track graphics
 		m_track = new Track();
+		m_track->parentLoader = &loader;
 		loader.AddLoadable(*m_track, "Track");
 
 		// Load particle textures
@@ -373,13 +384,18 @@ public:
 		CheckedLoad(m_foreground = CreateBackground(this, true));
 
 		// Do this here so we don't get input events while still loading
+		m_replay.mapPath = m_mapPath;
+		m_scoring.SetReplay(&m_replay);
 		m_scoring.SetFlags(m_flags);
 		m_scoring.SetPlayback(m_playback);
+		m_scoring.SetTimeline(&m_scoringTimeline);
 		m_scoring.SetInput(&g_input);
 		m_scoring.Reset(); // Initialize
 
 		g_input.OnButtonPressed.Add(this, &Game_Impl::m_OnButtonPressed);
 
+		// Button index each chart button is moved to, the same mapping is stored in the replay
+		uint8 buttonMapping[6] = { 0,1,2,3,4,5 };
 		if ((m_flags & GameFlags::Random) != GameFlags::None)
 		{
 			//Randomize
@@ -408,50 +424,25 @@ public:
 				flipFx = (std::rand() % 2) == 1;
 			}
 
-			const Vector<ObjectState*> chartObjects = m_playback.GetBeatmap().GetLinearObjects();
-			for (ObjectState* currentobj : chartObjects)
+			for (size_t i = 0; i < 4; i++)
+				buttonMapping[i] = swaps[i];
+			if (flipFx)
 			{
-				if (currentobj->type == ObjectType::Single || currentobj->type == ObjectType::Hold)
-				{
-					ButtonObjectState* bos = (ButtonObjectState*)currentobj;
-					if (bos->index < 4)
-					{
-						bos->index = swaps[bos->index];
-					}
-					else if (flipFx)
-					{
-						bos->index = (bos->index - 3) % 2;
-						bos->index += 4;
-					}
-				}
+				buttonMapping[4] = 5;
+				buttonMapping[5] = 4;
 			}
-
 		}
 
 		if ((m_flags & GameFlags::Mirror) != GameFlags::None)
 		{
-			int buttonSwaps[] = { 3,2,1,0,5,4 };
-
-			const Vector<ObjectState*> chartObjects = m_playback.GetBeatmap().GetLinearObjects();
-			for (ObjectState* currentobj : chartObjects)
-			{
-				if (currentobj->type == ObjectType::Single || currentobj->type == ObjectType::Hold)
-				{
-					ButtonObjectState* bos = (ButtonObjectState*)currentobj;
-					bos->index = buttonSwaps[bos->index];
-				}
-				else if (currentobj->type == ObjectType::Laser)
-				{
-					LaserObjectState* los = (LaserObjectState*)currentobj;
-					los->index = (los->index + 1) % 2;
-					for (size_t i = 0; i < 2; i++)
-					{
-						los->points[i] = fabsf(los->points[i] - 1.0f);
-					}
-				}
-			}
+			uint8 buttonSwaps[] = { 3,2,1,0,5,4 };
+			for (size_t i = 0; i < 6; i++)
+				buttonMapping[i] = buttonSwaps[buttonMapping[i]];
 		}
 
+		// Also mirrors the lasers
+		memcpy(m_replay.buttonMapping, buttonMapping, sizeof(buttonMapping));
+		m_replay.ApplyChartModifiers(*m_beatmap);
 
 		return true;
 	}
@@ -536,6 +527,8 @@ public:
 	}
 	virtual void Render(float deltaTime) override
 	{
+		PROFILE_ZONE("Game::Render");
+
 		// 8 beats (2 measures) in view at 1x hi-speed
 		m_track->SetViewRange(8.0f / (m_hispeed)); 
 
@@ -594,6 +587,7 @@ public:
 		{
 			m_track->DrawObjectState(renderQueue, m_playback, object, m_scoring.IsObjectHeld(object));
 		}
+		m_track->DrawLasers(renderQueue);
 
 		m_track->DrawDarkTrack(renderQueue);
 
@@ -936,6 +930,8 @@ public:
 
 		// Update beatmap playback
 		MapTime playbackPositionMs = m_audioPlayback.GetPosition() - m_audioOffset;
+		// Input time matching the sampled playback position, used to judge input events at the time they happened
+		double inputTime = Input::GetTime();
 		m_playback.Update(playbackPositionMs);
 
 		MapTime delta = playbackPositionMs - m_lastMapTime;
@@ -973,7 +969,7 @@ public:
 		// Update scoring
 		if (!m_ended)
 		{
-			m_scoring.Tick(deltaTime);
+			m_scoring.Tick(deltaTime, inputTime);
 		}
 
 		// Update scoring gauge
@@ -1027,6 +1023,19 @@ public:
 		if(m_ended)
 			return;
 
+		// Keep a replay of actual plays
+		if(!m_scoring.autoplay && !m_scoring.autoplayButtons && !m_replay.frames.empty())
+		{
+			m_replay.score = m_scoring.CalculateCurrentScore();
+			String mapName;
+			Path::RemoveLast(m_mapPath, &mapName);
+			mapName = Path::ReplaceExtension(mapName, "");
+			Path::CreateDir("replays");
+			String replayPath = Utility::Sprintf("replays/%s_%lld.fxr", mapName, (int64)time(nullptr));
+			if(!m_replay.Save(replayPath))
+				Logf("Failed to save replay to %s", Logger::Warning, replayPath);
+		}
+
 		// Transition to score screen
 		TransitionScreen* transition = TransitionScreen::Create(ScoreScreen::Create(this));
 		transition->OnLoadingComplete.Add(this, &Game_Impl::OnScoreScreenLoaded);
@@ -1157,8 +1166,15 @@ public:
 		textPos.y += RenderText(bms.title, textPos).y;
 		textPos.y += RenderText(bms.artist, textPos).y;
 		textPos.y += RenderText(Utility::Sprintf("%.2f FPS", g_application->GetRenderFPS()), textPos).y;
+		const FramePacer& pacer = g_application->GetFramePacer();
+		textPos.y += RenderText(Utility::Sprintf("Frame time p50: %.2fms p99: %.2fms",
+			pacer.GetFrameTimePercentile(0.5f) * 1000.0, pacer.GetFrameTimePercentile(0.99f) * 1000.0), textPos).y;
 		textPos.y += RenderText(Utility::Sprintf("Audio Offset: %d ms", g_audio->audioLatency), textPos).y;
 
+		SpriteMapUploadStats atlasStats = SpriteMapRes::GetUploadStats();
+		textPos.y += RenderText(Utility::Sprintf("Atlas Uploads: %d (%d full) %.1f KB", (uint32)atlasStats.numUploads,
+			(uint32)atlasStats.numFullUploads, (float)atlasStats.bytesUploaded / 1024.0f), textPos).y;
+
 		float currentBPM = (float)(60000.0 / tp.beatDuration);
 		textPos.y += RenderText(Utility::Sprintf("BPM: %.1f", currentBPM), textPos).y;
 		textPos.y += RenderText(Utility::Sprintf("Time Signature: %d/4", tp.numerator), textPos).y;
@@ -1167,6 +1183,10 @@ public:
 
 		textPos.y += RenderText(Utility::Sprintf("Score: %d (Max: %d)", m_scoring.currentHitScore, m_scoring.mapTotals.maxScore), textPos).y;
 		textPos.y += RenderText(Utility::Sprintf("Actual Score: %d", m_scoring.CalculateCurrentScore()), textPos).y;
+		const HitStatistics& hitStatistics = m_scoring.hitStatistics;
+		textPos.y += RenderText(Utility::Sprintf("Hit Delta: %.1fms (SD %.1fms, P90 %dms) Early: %d Late: %d",
+			hitStatistics.GetMean(), hitStatistics.GetStandardDeviation(), hitStatistics.GetPercentile(0.9f),
+			hitStatistics.GetEarly(), hitStatistics.GetLate()), textPos).y;
 
 		textPos.y += RenderText(Utility::Sprintf("Health Gauge: %f", m_scoring.currentGauge), textPos).y;
 
@@ -1179,6 +1199,21 @@ public:
 		Vector2 buttonStateTextPos = Vector2(g_resolution.x - 200.0f, 100.0f);
 		RenderText(g_input.GetControllerStateString(), buttonStateTextPos);
 
+		// Time spent in the zones of the last frame while the profiler is recording (F10)
+		if(Profiler::IsEnabled())
+		{
+			Vector2 profilerTextPos = Vector2(g_resolution.x - 400.0f, 200.0f);
+			profilerTextPos.y += RenderText(Utility::Sprintf("Frame: %.2fms", Profiler::GetLastFrameTime() * 1000.0), profilerTextPos).y;
+			uint32 zonesShown = 0;
+			for(const Profiler::FrameZone& zone : Profiler::GetLastFrameZones())
+			{
+				if(zonesShown++ >= 24)
+					break;
+				String indent((size_t)zone.depth * 2 + 2, ' ');
+				profilerTextPos.y += RenderText(Utility::Sprintf("%s%s: %.2fms (x%d)", indent, zone.name, zone.duration * 1000.0, zone.count), profilerTextPos).y;
+			}
+		}
+
 		if(m_scoring.autoplay)
 			textPos.y += RenderText("Autoplay enabled", textPos, Color::Blue).y;
 
@@ -1542,19 +1577,3 @@ Game* Game::Create(const String& difficulty, GameFlags flags)
 	Game_Impl* impl = new Game_Impl(difficulty, flags);
 	return impl;
 }
-
-GameFlags operator|(const GameFlags & a, const GameFlags & b)
-{
-	return (GameFlags)((uint8)a | (uint8)b);
-
-}
-
-GameFlags operator&(const GameFlags & a, const GameFlags & b)
-{
-	return (GameFlags)((uint8)a & (uint8)b);
-}
-
-GameFlags operator~(const GameFlags & a)
-{
-	return (GameFlags)(~(uint8)a);
-}
@@ -19,9 +19,18 @@ enum class GameFlags : uint8
 
 	AutoLaser = 0b100000,
 End};
-GameFlags operator|(const GameFlags& a, const GameFlags& b);
-GameFlags operator&(const GameFlags& a, const GameFlags& b);
-GameFlags operator~(const GameFlags& a);
+inline GameFlags operator|(const GameFlags& a, const GameFlags& b)
+{
+	return (GameFlags)((uint8)a | (uint8)b);
+}
+inline GameFlags operator&(const GameFlags& a, const GameFlags& b)
+{
+	return (GameFlags)((uint8)a & (uint8)b);
+}
+inline GameFlags operator~(const GameFlags& a)
+{
+	return (GameFlags)(~(uint8)a);
+}
 
 /*
 	Main game scene / logic manager
@@ -33,6 +33,11 @@ void GameConfig::InitDefaults()
 	Set(GameConfigKeys::GlobalOffset, 0);
 	Set(GameConfigKeys::InputOffset, 0);
 	Set(GameConfigKeys::FPSTarget, 0);
+	Set(GameConfigKeys::SimulationRate, 0);
+	Set(GameConfigKeys::RenderThread, false);
+	Set(GameConfigKeys::JobThreads, 0);
+	Set(GameConfigKeys::IOJobs, 2);
+	Set(GameConfigKeys::JacketCacheSize, 64);
 	Set(GameConfigKeys::LaserAssistLevel, 1.5f);
 	Set(GameConfigKeys::UseMMod, false);
 	Set(GameConfigKeys::UseCMod, false);
@@ -27,6 +27,15 @@ DefineEnum(GameConfigKeys,
 	Laser0Color,
 	Laser1Color,
 	FPSTarget,
+	// Fixed rate at which the game is updated, 0 updates once every frame
+	SimulationRate,
+	RenderThread,
+	// Number of job threads, 0 uses the number of cores minus 2
+	JobThreads,
+	// Number of file loading jobs that can run at the same time
+	IOJobs,
+	// Memory used for jacket images in song select, in MB
+	JacketCacheSize,
 	LaserAssistLevel,
 
 	// Input device setting per element
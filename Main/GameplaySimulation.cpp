@@ -0,0 +1,64 @@
+#include "stdafx.h"
+#include "GameplaySimulation.hpp"
+
+GameplaySimulation::GameplaySimulation(Beatmap& beatmap) : m_beatmap(beatmap), m_playback(beatmap)
+{
+	m_timeline.Build(m_beatmap);
+}
+
+SimulationResult GameplaySimulation::Run(const Replay& replay, Replay* record)
+{
+	replay.ApplyChartModifiers(m_beatmap);
+
+	// Same setup as the game
+	m_playback.hittableObjectEnter = Scoring::missHitTime;
+	m_playback.hittableObjectLeave = Scoring::goodHitTime;
+	m_playback.Reset(replay.startTime);
+
+	m_scoring.SetReplay(record);
+	m_scoring.SetFlags(replay.flags);
+	m_scoring.SetPlayback(m_playback);
+	m_scoring.SetTimeline(&m_timeline);
+	m_scoring.Reset(replay.inputOffset, replay.laserAssistLevel);
+	if(record)
+	{
+		record->mapPath = replay.mapPath;
+		memcpy(record->buttonMapping, replay.buttonMapping, sizeof(record->buttonMapping));
+	}
+
+	for(const ReplayFrame& frame : replay.frames)
+	{
+		// The input clock is aligned to the map time so events are judged at exactly their recorded time
+		for(uint32 i = 0; i < frame.numEvents; i++)
+		{
+			const ReplayEvent& evt = replay.events[frame.firstEvent + i];
+			InputEvent inputEvent;
+			inputEvent.button = evt.button;
+			inputEvent.pressed = evt.pressed;
+			inputEvent.time = evt.time / 1000.0;
+			if(!m_scoring.GetInputQueue().Push(inputEvent))
+				Logf("Too many events in a single replay frame, dropping event", Logger::Warning);
+		}
+		m_scoring.SetLaserInput(0, frame.laserInput[0]);
+		m_scoring.SetLaserInput(1, frame.laserInput[1]);
+
+		m_playback.Update(frame.time);
+		m_scoring.Tick(frame.deltaTime, frame.time / 1000.0);
+	}
+
+	SimulationResult result;
+	result.score = m_scoring.CalculateCurrentScore();
+	result.maxCombo = m_scoring.maxComboCounter;
+	memcpy(result.categorizedHits, m_scoring.categorizedHits, sizeof(result.categorizedHits));
+	result.gauge = m_scoring.currentGauge;
+	if(record)
+		record->score = result.score;
+
+	m_scoring.SetReplay(nullptr);
+	return result;
+}
+
+Scoring& GameplaySimulation::GetScoring()
+{
+	return m_scoring;
+}
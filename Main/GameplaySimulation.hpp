@@ -0,0 +1,38 @@
+#pragma once
+#include <Beatmap/BeatmapPlayback.hpp>
+#include "Scoring.hpp"
+#include "Replay.hpp"
+
+// Scoring results of a simulated play
+struct SimulationResult
+{
+	uint32 score = 0;
+	uint32 maxCombo = 0;
+	// Miss, Good, Perfect
+	uint32 categorizedHits[3] = { 0 };
+	float gauge = 0.0f;
+};
+
+/*
+	Runs playback and scoring of a chart without a window, audio device or real time
+	the input comes from a recorded or scripted replay and every recorded tick is replayed as is,
+	so the result matches the recorded play exactly and runs many times faster than real time
+*/
+class GameplaySimulation : public Unique
+{
+public:
+	// The chart modifiers of replays are applied to the beatmap, so use a freshly loaded chart for every replay
+	GameplaySimulation(Beatmap& beatmap);
+
+	// Scores a replay, optionally recording the processed input into another replay
+	SimulationResult Run(const Replay& replay, Replay* record = nullptr);
+
+	// Scoring state of the last run
+	Scoring& GetScoring();
+
+private:
+	Beatmap& m_beatmap;
+	ScoringTimeline m_timeline;
+	BeatmapPlayback m_playback;
+	Scoring m_scoring;
+};
@@ -0,0 +1,114 @@
+#include "stdafx.h"
+#include "HitStatistics.hpp"
+
+HitStatistics::HitStatistics()
+{
+	Reset();
+}
+void HitStatistics::Reset()
+{
+	m_count = 0;
+	m_mean = 0.0;
+	m_m2 = 0.0;
+	memset(m_histogram, 0, sizeof(m_histogram));
+	memset(m_early, 0, sizeof(m_early));
+	memset(m_late, 0, sizeof(m_late));
+}
+
+void HitStatistics::AddHit(uint32 lane, MapTime delta, ScoreHitRating rating)
+{
+	assert(lane < numLanes);
+	if(rating == ScoreHitRating::Miss || rating == ScoreHitRating::Idle)
+		return;
+
+	m_count++;
+	double diff = (double)delta - m_mean;
+	m_mean += diff / (double)m_count;
+	m_m2 += diff * ((double)delta - m_mean);
+
+	m_histogram[Math::Clamp(delta, -maxDelta, maxDelta) + maxDelta]++;
+
+	if(rating == ScoreHitRating::Good)
+	{
+		if(delta < 0)
+			m_early[lane]++;
+		else
+			m_late[lane]++;
+	}
+}
+
+uint32 HitStatistics::GetCount() const
+{
+	return m_count;
+}
+double HitStatistics::GetMean() const
+{
+	return m_mean;
+}
+double HitStatistics::GetVariance() const
+{
+	if(m_count < 2)
+		return 0.0;
+	return m_m2 / (double)m_count;
+}
+double HitStatistics::GetStandardDeviation() const
+{
+	return sqrt(GetVariance());
+}
+MapTime HitStatistics::GetPercentile(float fraction) const
+{
+	if(m_count == 0)
+		return 0;
+	uint32 rank = (uint32)(Math::Clamp(fraction, 0.0f, 1.0f) * (float)m_count);
+	return m_GetDeltaAtRank(Math::Min(rank, m_count - 1));
+}
+MapTime HitStatistics::GetMedian() const
+{
+	if(m_count == 0)
+		return 0;
+	return m_GetDeltaAtRank(m_count / 2);
+}
+MapTime HitStatistics::m_GetDeltaAtRank(uint32 rank) const
+{
+	// Same element a sorted list of all deltas would have at this index
+	uint32 sum = 0;
+	for(uint32 i = 0; i < numBuckets; i++)
+	{
+		sum += m_histogram[i];
+		if(sum > rank)
+			return (MapTime)i - maxDelta;
+	}
+	return maxDelta;
+}
+
+uint32 HitStatistics::GetEarly(uint32 lane) const
+{
+	assert(lane < numLanes);
+	return m_early[lane];
+}
+uint32 HitStatistics::GetLate(uint32 lane) const
+{
+	assert(lane < numLanes);
+	return m_late[lane];
+}
+uint32 HitStatistics::GetEarly() const
+{
+	uint32 sum = 0;
+	for(uint32 i = 0; i < numLanes; i++)
+		sum += m_early[i];
+	return sum;
+}
+uint32 HitStatistics::GetLate() const
+{
+	uint32 sum = 0;
+	for(uint32 i = 0; i < numLanes; i++)
+		sum += m_late[i];
+	return sum;
+}
+
+uint32 HitStatistics::GetHistogram(MapTime delta) const
+{
+	if(delta < -maxDelta || delta > maxDelta)
+		return 0;
+	return m_histogram[delta + maxDelta];
+}
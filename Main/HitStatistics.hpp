@@ -0,0 +1,54 @@
+#pragma once
+#include "HitStat.hpp"
+
+/*
+	Running statistics of the timing of button hits
+	every hit is added in constant time and all values can be read at any point during or after a play,
+	the timing histogram has a bucket for every millisecond in the hit window so percentiles are exact
+*/
+class HitStatistics
+{
+public:
+	// Range of hit deltas that are tracked [-maxDelta, maxDelta]
+	static const MapTime maxDelta = 100;
+	static const uint32 numBuckets = maxDelta * 2 + 1;
+	// BT[4] / FX[2]
+	static const uint32 numLanes = 6;
+
+	HitStatistics();
+	void Reset();
+
+	// Adds a hit on a button lane, misses are not counted
+	void AddHit(uint32 lane, MapTime delta, ScoreHitRating rating);
+
+	// Number of hits added
+	uint32 GetCount() const;
+	// Mean/Variance of the hit deltas (ms), 0 when there are no hits
+	double GetMean() const;
+	double GetVariance() const;
+	double GetStandardDeviation() const;
+	// Hit delta below which the given fraction [0,1] of the hits lie
+	MapTime GetPercentile(float fraction) const;
+	MapTime GetMedian() const;
+
+	// Number of hits that were not rated perfect because they were too early or late, per lane
+	uint32 GetEarly(uint32 lane) const;
+	uint32 GetLate(uint32 lane) const;
+	// Total over all lanes
+	uint32 GetEarly() const;
+	uint32 GetLate() const;
+
+	// Number of hits with a given delta
+	uint32 GetHistogram(MapTime delta) const;
+
+private:
+	MapTime m_GetDeltaAtRank(uint32 rank) const;
+
+	uint32 m_count;
+	// Welford's running mean and sum of squared differences
+	double m_mean;
+	double m_m2;
+	uint32 m_histogram[numBuckets];
+	uint32 m_early[numLanes];
+	uint32 m_late[numLanes];
+};
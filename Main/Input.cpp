@@ -2,6 +2,9 @@
 #include "Input.hpp"
 #include "GameConfig.hpp"
 
+// Clock used for input event timestamps
+static Timer inputClock;
+
 Input::~Input()
 {
 	// Shoud be set to null by Cleanup
@@ -161,6 +164,19 @@ void Input::Update(float deltaTime)
 	}
 }
 
+void Input::AddEventQueue(InputEventQueue* queue)
+{
+	m_eventQueues.AddUnique(queue);
+}
+void Input::RemoveEventQueue(InputEventQueue* queue)
+{
+	m_eventQueues.Remove(queue);
+}
+double Input::GetTime()
+{
+	return inputClock.SecondsAsDouble();
+}
+
 bool Input::GetButton(Button button) const
 {
 	return m_buttonStates[(size_t)button];
@@ -265,6 +281,17 @@ void Input::m_OnButtonInput(Button b, bool pressed)
 	if(state != pressed)
 	{
 		state = pressed;
+
+		InputEvent evt;
+		evt.button = b;
+		evt.pressed = pressed;
+		evt.time = GetTime();
+		for(InputEventQueue* queue : m_eventQueues)
+		{
+			if(!queue->Push(evt))
+				Logf("Input event queue is full, dropping button event", Logger::Warning);
+		}
+
 		if(state)
 		{
 			OnButtonPressed.Call(b);
@@ -1,4 +1,5 @@
 #pragma once
+#include <Shared/LockFreeQueue.hpp>
 
 // Types of input device
 DefineEnum(InputDevice,
@@ -8,6 +9,9 @@ DefineEnum(InputDevice,
 
 typedef Ref<int32> MouseLockHandle;
 
+struct InputEvent;
+typedef LockFreeQueue<InputEvent> InputEventQueue;
+
 /*
 	Class that handles game keyboard (and soon controller input)
 */
@@ -53,6 +57,14 @@ public:
 	// Request laser input state
 	float GetInputLaserDir(uint32 laserIdx);
 
+	// Registers a queue that receives all button state changes along with the time they happened at
+	//	used to process input independently from the frame rate
+	void AddEventQueue(InputEventQueue* queue);
+	void RemoveEventQueue(InputEventQueue* queue);
+
+	// Time in seconds used to timestamp input events
+	static double GetTime();
+
 	// Button delegates
 	Delegate<Button> OnButtonPressed;
 	Delegate<Button> OnButtonReleased;
@@ -95,5 +107,17 @@ private:
 
 	Ref<Gamepad> m_gamepad;
 
+	// Receivers of timestamped button events
+	Vector<InputEventQueue*> m_eventQueues;
+
 	Graphics::Window* m_window = nullptr;
 };
+
+// A button state change
+struct InputEvent
+{
+	Input::Button button;
+	bool pressed;
+	// Time on the input clock in seconds, see Input::GetTime
+	double time;
+};
@@ -15,13 +15,48 @@ LaserTrackBuilder::LaserTrackBuilder(class OpenGL* gl, class Track* track, uint3
 	laserEntryTextureSize = track->laserTailTextures[0]->GetSize();
 	laserExitTextureSize = track->laserTailTextures[1]->GetSize();
 }
-Mesh LaserTrackBuilder::GenerateTrackMesh(class BeatmapPlayback& playback, LaserObjectState* laser)
+void LaserTrackBuilder::GenerateSegment(class BeatmapPlayback& playback, LaserObjectState* laser, LaserSegmentPart part,
+	Vector3 offset, float objectGlow, int32 hitState, Vector<LaserVertex>& out)
 {
-	if(m_objectCache.Contains(laser))
-		return m_objectCache[laser];
+	const SegmentVertices& verts = m_GetSegment(playback, laser, part);
+	Vector3 params = Vector3(objectGlow, (float)hitState, (float)part);
+	for(const MeshGenerators::SimpleVertex& v : verts)
+	{
+		out.emplace_back(v.pos + offset, v.tex, params);
+	}
+}
 
-	Mesh newMesh = MeshRes::Create(m_gl);
+const LaserTrackBuilder::SegmentVertices& LaserTrackBuilder::m_GetSegment(class BeatmapPlayback& playback, LaserObjectState* laser, LaserSegmentPart part)
+{
+	uint64 key = m_GetSegmentKey(laser, part);
+	CachedSegment* cached = m_segmentCache.Find(key);
+	if(cached)
+		return cached->vertices;
+
+	CachedSegment& segment = m_segmentCache.Add(key, CachedSegment());
+	segment.endTime = laser->time + laser->duration;
+	switch(part)
+	{
+	case LaserSegmentPart::Body:
+		m_GenerateTrackMesh(playback, laser, segment.vertices);
+		break;
+	case LaserSegmentPart::Entry:
+		m_GenerateTrackEntry(playback, laser, segment.vertices);
+		break;
+	case LaserSegmentPart::Exit:
+		m_GenerateTrackExit(playback, laser, segment.vertices);
+		break;
+	}
+	return segment.vertices;
+}
+uint64 LaserTrackBuilder::m_GetSegmentKey(LaserObjectState* laser, LaserSegmentPart part)
+{
+	uint64 slam = (laser->flags & LaserObjectState::flag_Instant) != 0 ? 1 : 0;
+	return ((uint64)(uint32)laser->time << 8) | (slam << 4) | (uint64)part;
+}
 
+void LaserTrackBuilder::m_GenerateTrackMesh(class BeatmapPlayback& playback, LaserObjectState* laser, SegmentVertices& out)
+{
 	float length = playback.DurationToViewDistanceAtTime(laser->time, laser->duration);
 
 	if((laser->flags & LaserObjectState::flag_Instant) != 0) // Slam segment
@@ -165,8 +200,7 @@ Mesh LaserTrackBuilder::GenerateTrackMesh(class BeatmapPlayback& playback, Laser
 				verts.Add(v);
 		}
 
-		newMesh->SetData(verts);
-		newMesh->SetPrimitiveType(PrimitiveType::TriangleList);
+		out = std::move(verts);
 	}
 	else
 	{
@@ -206,23 +240,13 @@ Mesh LaserTrackBuilder::GenerateTrackMesh(class BeatmapPlayback& playback, Laser
 			{ { points[1].x - halfWidth, points[1].y,  0.0f },{ uMin, vMin } }, // TL
 		};
 
-
-		newMesh->SetData(verts);
-		newMesh->SetPrimitiveType(PrimitiveType::TriangleList);
+		out = std::move(verts);
 	}
-
-	// Cache this mesh
-	m_objectCache.Add(laser, newMesh);
-	return newMesh;
 }
 
-Mesh LaserTrackBuilder::GenerateTrackEntry(class BeatmapPlayback& playback, LaserObjectState* laser)
+void LaserTrackBuilder::m_GenerateTrackEntry(class BeatmapPlayback& playback, LaserObjectState* laser, SegmentVertices& verts)
 {
 	assert(laser->prev == nullptr);
-	if(m_cachedEntries.Contains(laser))
-		return m_cachedEntries[laser];
-
-	Mesh newMesh = MeshRes::Create(m_gl);
 
 	// Starting point of laser
 	float startingX = laser->points[0] * effectiveWidth - effectiveWidth * 0.5f;
@@ -235,26 +259,13 @@ Mesh LaserTrackBuilder::GenerateTrackEntry(class BeatmapPlayback& playback, Lase
 	float length = (float)laserEntryTextureSize.y / (float)laserEntryTextureSize.x * actualLaserWidth;
 
 	float halfWidth = actualLaserWidth * 0.5f;
-	Vector<MeshGenerators::SimpleVertex> verts;
 	Rect3D pos = Rect3D(Vector2(startingX - halfWidth, -length), Vector2(halfWidth * 2, length));
 	Rect uv = Rect(0.0f, 0.0f, 1.0f, 1.0f);
 	MeshGenerators::GenerateSimpleXYQuad(pos, uv, verts);
-
-	newMesh->SetData(verts);
-	newMesh->SetPrimitiveType(PrimitiveType::TriangleList);
-
-	// Cache this mesh
-	m_cachedEntries.Add(laser, newMesh);
-	return newMesh;
-
 }
-Mesh LaserTrackBuilder::GenerateTrackExit(class BeatmapPlayback& playback, LaserObjectState* laser)
+void LaserTrackBuilder::m_GenerateTrackExit(class BeatmapPlayback& playback, LaserObjectState* laser, SegmentVertices& verts)
 {
 	assert(laser->next == nullptr);
-	if(m_cachedExits.Contains(laser))
-		return m_cachedExits[laser];
-
-	Mesh newMesh = MeshRes::Create(m_gl);
 
 	// Ending point of laser 
 	float startingX = laser->points[1] * effectiveWidth - effectiveWidth * 0.5f;
@@ -276,17 +287,9 @@ Mesh LaserTrackBuilder::GenerateTrackExit(class BeatmapPlayback& playback, Laser
 	}
 
 	float halfWidth = actualLaserWidth * 0.5f;
-	Vector<MeshGenerators::SimpleVertex> verts;
 	Rect3D pos = Rect3D(Vector2(startingX - halfWidth, prevLength), Vector2(halfWidth * 2, length));
 	Rect uv = Rect(0.0f, 0.0f, 1.0f, 1.0f);
 	MeshGenerators::GenerateSimpleXYQuad(pos, uv, verts);
-
-	newMesh->SetData(verts);
-	newMesh->SetPrimitiveType(PrimitiveType::TriangleList);
-
-	// Cache this mesh
-	m_cachedExits.Add(laser, newMesh);
-	return newMesh;
 }
 
 float LaserTrackBuilder::GetLaserLengthScaleAt(MapTime time)
@@ -321,31 +324,21 @@ void LaserTrackBuilder::m_RecalculateConstants()
 	effectiveWidth = m_trackWidth - m_laserWidth;
 }
 
-void LaserTrackBuilder::m_Cleanup(MapTime newTime, Map<LaserObjectState*, Mesh>& arr)
+void LaserTrackBuilder::Reset()
+{
+	m_segmentCache.clear();
+	m_RecalculateConstants();
+}
+void LaserTrackBuilder::Update(MapTime newTime)
 {
-	// Cleanup unused meshes
-	for(auto it = arr.begin(); it != arr.end();)
+	// Cleanup segments that are no longer visible
+	for(auto it = m_segmentCache.begin(); it != m_segmentCache.end();)
 	{
-		LaserObjectState* obj = it->first;
-		MapTime endTime = obj->time + obj->duration + 1000;
-		if(newTime > endTime)
+		if(newTime > it->second.endTime + 1000)
 		{
-			it = arr.erase(it);
+			it = m_segmentCache.erase(it);
 			continue;
 		}
 		it++;
 	}
-}
-void LaserTrackBuilder::Reset()
-{
-	m_objectCache.clear();
-	m_cachedEntries.clear();
-	m_cachedExits.clear();
-	m_RecalculateConstants();
-}
-void LaserTrackBuilder::Update(MapTime newTime)
-{
-	m_Cleanup(newTime, m_objectCache);
-	m_Cleanup(newTime, m_cachedEntries);
-	m_Cleanup(newTime, m_cachedExits);
 }
\ No newline at end of file
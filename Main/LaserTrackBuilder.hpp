@@ -1,6 +1,25 @@
 #pragma once
 #include <Beatmap/BeatmapObjects.hpp>
 
+// Parts of a laser segment, each part uses a different texture
+enum class LaserSegmentPart : uint8
+{
+	Body = 0,
+	Entry,
+	Exit,
+};
+
+// Vertex of the laser geometry drawn in a frame, the position includes the segment's offset on the track
+struct LaserVertex : public VertexFormat<Vector3, Vector2, Vector3>
+{
+	LaserVertex() = default;
+	LaserVertex(Vector3 pos, Vector2 tex, Vector3 params) : pos(pos), tex(tex), params(params) {};
+	Vector3 pos;
+	Vector2 tex;
+	// Object glow, hit state and the texture to use (LaserSegmentPart)
+	Vector3 params;
+};
+
 class LaserTrackBuilder
 {
 public:
@@ -8,13 +27,10 @@ public:
 	void Reset();
 	void Update(MapTime newTime);
 
-	// Generates a normal segment
-	Mesh GenerateTrackMesh(class BeatmapPlayback& playback, LaserObjectState* laser);
-
-	// Generate the starting segment of a laser
-	Mesh GenerateTrackEntry(class BeatmapPlayback& playback, LaserObjectState* laser);
-	// Generate the ending segment of a laser
-	Mesh GenerateTrackExit(class BeatmapPlayback& playback, LaserObjectState* laser);
+	// Adds the vertices of a part of a segment to out
+	//	offset is the position of the segment on the track, objectGlow and hitState are the parameters for the laser shader
+	void GenerateSegment(class BeatmapPlayback& playback, LaserObjectState* laser, LaserSegmentPart part,
+		Vector3 offset, float objectGlow, int32 hitState, Vector<LaserVertex>& out);
 
 	// Laser length scale at a given position
 	float GetLaserLengthScaleAt(MapTime time);
@@ -52,15 +68,33 @@ private:
 	float effectiveWidth;
 
 private:
+	typedef Vector<MeshGenerators::SimpleVertex> SegmentVertices;
+	struct CachedSegment
+	{
+		// Time after which the segment is no longer visible
+		MapTime endTime;
+		SegmentVertices vertices;
+	};
+
+	// Vertices of a segment part relative to the start of the segment
+	const SegmentVertices& m_GetSegment(class BeatmapPlayback& playback, LaserObjectState* laser, LaserSegmentPart part);
+	// Generates a normal segment
+	void m_GenerateTrackMesh(class BeatmapPlayback& playback, LaserObjectState* laser, SegmentVertices& verts);
+	// Generate the starting segment of a laser
+	void m_GenerateTrackEntry(class BeatmapPlayback& playback, LaserObjectState* laser, SegmentVertices& verts);
+	// Generate the ending segment of a laser
+	void m_GenerateTrackExit(class BeatmapPlayback& playback, LaserObjectState* laser, SegmentVertices& verts);
+
+	// Segments on one side are identified by their time, whether they are slams and the part
+	//	a slam and the segment after it start at the same time
+	static uint64 m_GetSegmentKey(LaserObjectState* laser, LaserSegmentPart part);
+
 	void m_RecalculateConstants();
-	void m_Cleanup(MapTime newTime, Map<LaserObjectState*, Mesh>& arr);
 	class OpenGL* m_gl;
 	class Track* m_track;
 
 	float m_trackWidth;
 	float m_laserWidth;
 	uint32 m_laserIndex;
-	Map<LaserObjectState*, Mesh> m_objectCache;
-	Map<LaserObjectState*, Mesh> m_cachedEntries;
-	Map<LaserObjectState*, Mesh> m_cachedExits;
+	Map<uint64, CachedSegment> m_segmentCache;
 };
\ No newline at end of file
@@ -0,0 +1,264 @@
+#include "stdafx.h"
+#include "Replay.hpp"
+#include <Shared/File.hpp>
+#include <Shared/FileStream.hpp>
+
+static const uint32 c_replayVersion = 1;
+
+// Per frame flags
+static const uint8 c_frameLaser0 = 0x1;
+static const uint8 c_frameLaser1 = 0x2;
+static const uint8 c_frameEvents = 0x4;
+static const uint8 c_frameDeltaTime = 0x8;
+
+// Variable length signed integer, values within [-64,63] take a single byte
+static void SerializeVarInt(BinaryStream& stream, int32& value)
+{
+	if(stream.IsReading())
+	{
+		uint32 zigzag = 0;
+		uint32 shift = 0;
+		uint8 b = 0;
+		do
+		{
+			stream << b;
+			zigzag |= (uint32)(b & 0x7f) << shift;
+			shift += 7;
+		} while((b & 0x80) && shift < 35);
+		value = (int32)(zigzag >> 1) ^ -(int32)(zigzag & 1);
+	}
+	else
+	{
+		uint32 zigzag = ((uint32)value << 1) ^ (uint32)(value >> 31);
+		do
+		{
+			uint8 b = zigzag & 0x7f;
+			zigzag >>= 7;
+			if(zigzag)
+				b |= 0x80;
+			stream << b;
+		} while(zigzag);
+	}
+}
+
+Replay::Replay()
+{
+	for(uint8 i = 0; i < 6; i++)
+		buttonMapping[i] = i;
+}
+void Replay::Clear()
+{
+	frames.clear();
+	events.clear();
+	score = 0;
+}
+void Replay::AddFrame(MapTime time, float deltaTime, const float laserInput[2])
+{
+	ReplayFrame& frame = frames.Add();
+	frame.time = time;
+	frame.deltaTime = deltaTime;
+	frame.laserInput[0] = laserInput[0];
+	frame.laserInput[1] = laserInput[1];
+	frame.firstEvent = (uint32)events.size();
+	frame.numEvents = 0;
+}
+void Replay::AddEvent(MapTime time, Input::Button button, bool pressed)
+{
+	assert(!frames.empty());
+	ReplayEvent& evt = events.Add();
+	evt.time = time;
+	evt.button = button;
+	evt.pressed = pressed;
+	frames.back().numEvents++;
+}
+
+Replay Replay::CreateScripted(const Vector<ReplayEvent>& events, MapTime startTime, MapTime endTime, MapTime timestep)
+{
+	assert(timestep > 0);
+	Replay replay;
+	replay.startTime = startTime;
+	const float noLaserInput[2] = { 0.0f };
+	uint32 nextEvent = 0;
+	for(MapTime time = startTime; time <= endTime; time += timestep)
+	{
+		replay.AddFrame(time, timestep / 1000.0f, noLaserInput);
+		while(nextEvent < events.size() && events[nextEvent].time <= time)
+		{
+			const ReplayEvent& evt = events[nextEvent++];
+			replay.AddEvent(evt.time, evt.button, evt.pressed);
+		}
+	}
+	return replay;
+}
+
+void Replay::ApplyChartModifiers(Beatmap& beatmap) const
+{
+	bool mirror = (flags & GameFlags::Mirror) != GameFlags::None;
+	for(ObjectState* obj : beatmap.GetLinearObjects())
+	{
+		if(obj->type == ObjectType::Single || obj->type == ObjectType::Hold)
+		{
+			ButtonObjectState* bos = (ButtonObjectState*)obj;
+			bos->index = buttonMapping[bos->index];
+		}
+		else if(obj->type == ObjectType::Laser && mirror)
+		{
+			LaserObjectState* los = (LaserObjectState*)obj;
+			los->index = (los->index + 1) % 2;
+			for(size_t i = 0; i < 2; i++)
+			{
+				los->points[i] = fabsf(los->points[i] - 1.0f);
+			}
+		}
+	}
+}
+
+bool Replay::Load(BinaryStream& stream)
+{
+	return m_Serialize(stream);
+}
+bool Replay::Save(BinaryStream& stream) const
+{
+	// Const cast because serialize is universal for loading and saving
+	return const_cast<Replay*>(this)->m_Serialize(stream);
+}
+bool Replay::Load(const String& path)
+{
+	File file;
+	if(!file.OpenRead(path))
+		return false;
+	FileReader reader(file);
+	return Load(reader);
+}
+bool Replay::Save(const String& path) const
+{
+	File file;
+	if(!file.OpenWrite(path))
+		return false;
+	FileWriter writer(file);
+	return Save(writer);
+}
+
+bool Replay::m_Serialize(BinaryStream& stream)
+{
+	static const uint32 c_magic = *(uint32*)"FXRP";
+	uint32 magic = c_magic;
+	uint32 version = c_replayVersion;
+	stream << magic;
+	stream << version;
+
+	// Validate headers when reading
+	if(stream.IsReading())
+	{
+		if(magic != c_magic)
+		{
+			Log("Invalid replay format", Logger::Warning);
+			return false;
+		}
+		if(version != c_replayVersion)
+		{
+			Logf("Incompatible replay version [%d], loader is version %d", Logger::Warning, version, c_replayVersion);
+			return false;
+		}
+	}
+
+	stream << mapPath;
+	stream << (uint8&)flags;
+	stream << inputOffset;
+	stream << laserAssistLevel;
+	stream << startTime;
+	stream.Serialize(buttonMapping, sizeof(buttonMapping));
+	stream << score;
+
+	uint32 numFrames = (uint32)frames.size();
+	uint32 numEvents = (uint32)events.size();
+	stream << numFrames;
+	stream << numEvents;
+	if(stream.IsReading())
+	{
+		// Every frame and event takes at least a byte
+		size_t remaining = stream.GetSize() - stream.Tell();
+		if(numFrames + (size_t)numEvents > remaining)
+		{
+			Log("Replay data is truncated", Logger::Warning);
+			return false;
+		}
+		for(uint8& b : buttonMapping)
+		{
+			if(b >= 6)
+				return false;
+		}
+		frames.resize(numFrames);
+		events.resize(numEvents);
+	}
+
+	MapTime lastTime = startTime;
+	float lastDeltaTime = 0.0f;
+	uint32 eventIndex = 0;
+	for(ReplayFrame& frame : frames)
+	{
+		uint8 frameFlags = 0;
+		if(stream.IsWriting())
+		{
+			if(frame.laserInput[0] != 0.0f)
+				frameFlags |= c_frameLaser0;
+			if(frame.laserInput[1] != 0.0f)
+				frameFlags |= c_frameLaser1;
+			if(frame.numEvents > 0)
+				frameFlags |= c_frameEvents;
+			if(frame.deltaTime != lastDeltaTime)
+				frameFlags |= c_frameDeltaTime;
+		}
+		stream << frameFlags;
+
+		int32 timeDelta = frame.time - lastTime;
+		SerializeVarInt(stream, timeDelta);
+		frame.time = lastTime + timeDelta;
+		lastTime = frame.time;
+
+		if(frameFlags & c_frameDeltaTime)
+			stream << frame.deltaTime;
+		else
+			frame.deltaTime = lastDeltaTime;
+		lastDeltaTime = frame.deltaTime;
+
+		for(uint32 i = 0; i < 2; i++)
+		{
+			if(frameFlags & (c_frameLaser0 << i))
+				stream << frame.laserInput[i];
+			else
+				frame.laserInput[i] = 0.0f;
+		}
+
+		int32 frameEvents = (int32)frame.numEvents;
+		if(frameFlags & c_frameEvents)
+			SerializeVarInt(stream, frameEvents);
+		else
+			frameEvents = 0;
+		if(frameEvents < 0 || eventIndex + frameEvents > numEvents)
+		{
+			Log("Invalid event count in replay", Logger::Warning);
+			return false;
+		}
+		frame.firstEvent = eventIndex;
+		frame.numEvents = frameEvents;
+
+		// Events are stored relative to their frame, with the pressed state in the high bit of the button
+		for(int32 i = 0; i < frameEvents; i++)
+		{
+			ReplayEvent& evt = events[eventIndex++];
+			int32 eventDelta = evt.time - frame.time;
+			SerializeVarInt(stream, eventDelta);
+			evt.time = frame.time + eventDelta;
+
+			uint8 button = (uint8)evt.button | (evt.pressed ? 0x80 : 0);
+			stream << button;
+			evt.button = (Input::Button)(button & 0x7f);
+			evt.pressed = (button & 0x80) != 0;
+			if(evt.button >= Input::Button::Length)
+				return false;
+		}
+	}
+
+	return eventIndex == numEvents;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <Beatmap/Beatmap.hpp>
+#include "Input.hpp"
+#include "Game.hpp"
+
+// Button state change recorded in a replay
+struct ReplayEvent
+{
+	// Map time at which the event was judged
+	MapTime time;
+	Input::Button button;
+	bool pressed;
+};
+
+// A single scoring tick recorded in a replay
+struct ReplayFrame
+{
+	// Playback position at this tick
+	MapTime time;
+	float deltaTime;
+	// Laser input for this tick
+	float laserInput[2];
+	// Range of events that were processed in this tick
+	uint32 firstEvent;
+	uint32 numEvents;
+};
+
+/*
+	Input of a single play, recorded per scoring tick so that the play can be scored again with the exact same result
+	stored as time deltas and only the laser input that is non-zero, so a full song takes a few hundred kilobytes at most
+*/
+class Replay
+{
+public:
+	Replay();
+
+	// Removes all recorded frames and events
+	void Clear();
+	// Starts a new scoring tick
+	void AddFrame(MapTime time, float deltaTime, const float laserInput[2]);
+	// Adds an event to the last frame
+	void AddEvent(MapTime time, Input::Button button, bool pressed);
+
+	// Creates a replay with a fixed timestep from scripted button events, the events need to be sorted by time
+	//	laser input can be filled in afterwards through the frames
+	static Replay CreateScripted(const Vector<ReplayEvent>& events, MapTime startTime, MapTime endTime, MapTime timestep);
+
+	// Applies the button mapping and mirroring this replay was recorded with to a freshly loaded chart
+	void ApplyChartModifiers(Beatmap& beatmap) const;
+
+	bool Load(BinaryStream& stream);
+	bool Save(BinaryStream& stream) const;
+	bool Load(const String& path);
+	bool Save(const String& path) const;
+
+	// Path to the chart the replay was recorded on
+	String mapPath;
+	GameFlags flags = GameFlags::None;
+	// Timing settings used while recording
+	int32 inputOffset = 0;
+	float laserAssistLevel = 1.5f;
+	// Playback position when scoring was reset
+	MapTime startTime = 0;
+	// Button index each chart button was moved to by the random/mirror modifiers
+	uint8 buttonMapping[6];
+	// Score at the end of the recording
+	uint32 score = 0;
+
+	Vector<ReplayFrame> frames;
+	Vector<ReplayEvent> events;
+
+private:
+	bool m_Serialize(BinaryStream& stream);
+};
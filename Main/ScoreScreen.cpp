@@ -45,6 +45,7 @@ private:
 	uint32 m_timedHits[2];
 	float m_meanHitDelta;
 	MapTime m_medianHitDelta;
+	float m_hitDeltaDeviation;
 
 	Ref<SongSelectStyle> m_songSelectStyle;
 
@@ -70,6 +71,7 @@ public:
 		memcpy(m_categorizedHits, scoring.categorizedHits, sizeof(scoring.categorizedHits));
 		m_meanHitDelta = scoring.GetMeanHitDelta();
 		m_medianHitDelta = scoring.GetMedianHitDelta();
+		m_hitDeltaDeviation = (float)scoring.hitStatistics.GetStandardDeviation();
 		// Don't save the score if autoplay was on or if the song was launched using command line
 		if(!m_autoplay && !m_autoButtons && game->GetDifficultyIndex().mapId != -1)
 			m_mapDatabase.AddScore(game->GetDifficultyIndex(), m_score, m_categorizedHits[2], m_categorizedHits[1], m_categorizedHits[0], m_finalGaugeValue);
@@ -101,6 +103,10 @@ public:
 	}
 
 	AsyncAssetLoader loader;
+	virtual AsyncAssetLoader* GetAssetLoader() override
+	{
+		return &loader;
+	}
 	virtual bool AsyncLoad() override
 	{
 		m_guiStyle = g_commonGUIStyle;
@@ -364,6 +370,14 @@ public:
 					boxSlot->fillX = true;
 					boxSlot->padding = Margin(3 * scale, 3 * scale, 0, 0);
 				}
+				{
+					Label* timingStat = new Label();
+					timingStat->SetText(Utility::WSprintf(L"Hit delta deviation: %.2fms", m_hitDeltaDeviation));
+					timingStat->SetFontSize(24 * scale);
+					LayoutBox::Slot* boxSlot = statsList->Add(timingStat->MakeShared());
+					boxSlot->fillX = true;
+					boxSlot->padding = Margin(3 * scale, 3 * scale, 0, 0);
+				}
 				slot = m_timingStatsCanvas->Add(statsList->MakeShared());
 				slot->anchor = Anchors::Full;
 				m_timingStatsCanvas->visibility = Visibility::Hidden;
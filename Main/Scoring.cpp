@@ -3,6 +3,8 @@
 #include <Beatmap/BeatmapPlayback.hpp>
 #include <math.h>
 #include "GameConfig.hpp"
+#include "Replay.hpp"
+#include <Shared/Profiler.hpp>
 
 const MapTime Scoring::missHitTime = 275;
 const MapTime Scoring::goodHitTime = 100;
@@ -60,26 +62,35 @@ void Scoring::SetInput(Input* input)
 	if(input)
 	{
 		m_input = input;
-		m_input->OnButtonPressed.Add(this, &Scoring::m_OnButtonPressed);
-		m_input->OnButtonReleased.Add(this, &Scoring::m_OnButtonReleased);
+		m_input->AddEventQueue(&m_inputQueue);
 	}
 }
 void Scoring::SetFlags(GameFlags flags)
 {
 	m_flags = flags;
 }
+void Scoring::SetTimeline(const ScoringTimeline* timeline)
+{
+	m_timeline = timeline;
+}
 void Scoring::m_CleanupInput()
 {
 	if(m_input)
 	{
-		m_input->OnButtonPressed.RemoveAll(this);
-		m_input->OnButtonReleased.RemoveAll(this);
+		m_input->RemoveEventQueue(&m_inputQueue);
 		m_input = nullptr;
 	}
 }
 
 void Scoring::Reset()
 {
+	Reset(g_gameConfig.GetInt(GameConfigKeys::InputOffset), g_gameConfig.GetFloat(GameConfigKeys::LaserAssistLevel));
+}
+void Scoring::Reset(int32 inputOffset, float laserAssistLevel)
+{
+	m_inputOffset = inputOffset;
+	m_assistLevel = laserAssistLevel;
+
 	// Reset score/combo counters
 	currentMaxScore = 0;
 	currentHitScore = 0;
@@ -101,11 +112,12 @@ void Scoring::Reset()
 	// Clear hit statistics
 	hitStats.clear();
 
-	// Get input offset
-	m_inputOffset = g_gameConfig.GetInt(GameConfigKeys::InputOffset);
-	// Get laser assist level
-	m_assistLevel = g_gameConfig.GetFloat(GameConfigKeys::LaserAssistLevel);
 	// Recalculate maximum score
+	if(!m_timeline || m_timeline == &m_playbackTimeline)
+	{
+		m_playbackTimeline.Build(m_playback->GetBeatmap());
+		m_timeline = &m_playbackTimeline;
+	}
 	mapTotals = CalculateMapTotals();
 
 	// Recalculate gauge gain
@@ -135,16 +147,107 @@ void Scoring::Reset()
 	m_heldObjects.clear();
 	memset(m_holdObjects, 0, sizeof(m_holdObjects));
 	memset(m_currentLaserSegments, 0, sizeof(m_currentLaserSegments));
+
+	// Discard input from before the reset
+	InputEvent evt;
+	while(m_inputQueue.Pop(evt))
+	{
+	}
+	m_pendingInput.clear();
+	m_lastInputTime = m_playback->GetLastTime();
+	for(uint32 i = 0; i < (uint32)Input::Button::Length; i++)
+		m_buttonHeld[i] = m_input && m_input->GetButton((Input::Button)i);
+	memset(m_laserInputSample, 0, sizeof(m_laserInputSample));
+
+	// Start a new recording
+	if(m_replay)
+	{
+		m_replay->Clear();
+		m_replay->startTime = m_playback->GetLastTime();
+		m_replay->inputOffset = (int32)m_inputOffset;
+		m_replay->laserAssistLevel = m_assistLevel;
+		m_replay->flags = m_flags;
+	}
+
 	m_CleanupHitStats();
+	m_hitStatPool.AddBack().reserve(m_timeline->GetNumObjects());
+	hitStats.reserve(m_timeline->GetNumObjects());
+	hitStatistics.Reset();
 	m_CleanupTicks();
 
 	OnScoreChanged.Call(0);
 }
 
-void Scoring::Tick(float deltaTime)
+void Scoring::Tick(float deltaTime, double inputTime)
 {
+	PROFILE_ZONE("Scoring::Tick");
+	MapTime frameTime = m_playback->GetLastTime();
+
+	// Sample laser input for this tick
+	if(m_input)
+	{
+		for(uint32 i = 0; i < 2; i++)
+			m_laserInputSample[i] = m_input->GetInputLaserDir(i);
+	}
+	if(m_replay)
+		m_replay->AddFrame(frameTime, deltaTime, m_laserInputSample);
+
+	m_ProcessInputEvents(frameTime, inputTime);
 	m_UpdateLasers(deltaTime);
-	m_UpdateTicks();
+	m_UpdateTicks(frameTime);
+}
+InputEventQueue& Scoring::GetInputQueue()
+{
+	return m_inputQueue;
+}
+void Scoring::SetLaserInput(uint32 index, float input)
+{
+	assert(index < 2);
+	m_laserInputSample[index] = input;
+}
+void Scoring::SetReplay(Replay* replay)
+{
+	m_replay = replay;
+}
+
+void Scoring::m_ProcessInputEvents(MapTime frameTime, double inputTime)
+{
+	InputEvent evt;
+	while(m_inputQueue.Pop(evt))
+		m_pendingInput.Add(evt);
+
+	// Events from different devices are not guaranteed to arrive in order
+	std::stable_sort(m_pendingInput.begin(), m_pendingInput.end(), [](const InputEvent& l, const InputEvent& r)
+	{
+		return l.time < r.time;
+	});
+
+	uint32 numProcessed = 0;
+	for(; numProcessed < m_pendingInput.size(); numProcessed++)
+	{
+		const InputEvent& pending = m_pendingInput[numProcessed];
+		// Happened after the playback position was sampled, handle this next tick
+		if(pending.time > inputTime)
+			break;
+
+		// Map the event onto the audio clock relative to the sampled playback position
+		MapTime eventTime = frameTime + (MapTime)floor((pending.time - inputTime) * 1000.0 + 0.5);
+		eventTime = Math::Max(eventTime, m_lastInputTime);
+		m_lastInputTime = eventTime;
+
+		// Bring button ticks up to date so misses and holds are judged with the state at the time of the event
+		m_UpdateTicks(eventTime, false);
+
+		m_buttonHeld[(size_t)pending.button] = pending.pressed;
+		if(m_replay)
+			m_replay->AddEvent(eventTime, pending.button, pending.pressed);
+		if(pending.pressed)
+			m_OnButtonPressed(pending.button, eventTime);
+		else
+			m_OnButtonReleased(pending.button, eventTime);
+	}
+	m_pendingInput.erase(m_pendingInput.begin(), m_pendingInput.begin() + numProcessed);
+	m_lastInputTime = Math::Max(m_lastInputTime, frameTime);
 }
 
 float Scoring::GetLaserRollOutput(uint32 index)
@@ -184,30 +287,11 @@ float Scoring::GetLaserOutput()
 }
 float Scoring::GetMeanHitDelta()
 {
-	float sum = 0;
-	uint32 count = 0;
-	for (auto hit : hitStats)
-	{
-		if (hit->object->type != ObjectType::Single || hit->rating == ScoreHitRating::Miss)
-			continue;
-		sum += hit->delta;
-		count++;
-	}
-	return sum / count;
+	return (float)hitStatistics.GetMean();
 }
 int16 Scoring::GetMedianHitDelta()
 {
-	Vector<MapTime> deltas;
-	for (auto hit : hitStats)
-	{
-		if (hit->object->type != ObjectType::Single || hit->rating == ScoreHitRating::Miss)
-			continue;
-		deltas.Add(hit->delta);
-	}
-	if (deltas.size() == 0)
-		return 0;
-	std::sort(deltas.begin(), deltas.end());
-	return deltas[deltas.size() / 2];
+	return (int16)hitStatistics.GetMedian();
 }
 float Scoring::m_GetLaserOutputRaw()
 {
@@ -247,46 +331,29 @@ void Scoring::m_UpdateLaserOutput(float deltaTime)
 	}
 }
 
-HitStat* Scoring::m_AddOrUpdateHitStat(ObjectState* object)
+HitStat* Scoring::m_AddOrUpdateHitStat(const ScoreTick* tick)
 {
+	ObjectState* object = tick->object;
 	if(object->type == ObjectType::Single)
 	{
-		HitStat* stat = new HitStat(object);
+		HitStat* stat = m_AllocateHitStat(object);
 		hitStats.Add(stat);
 		return stat;
 	}
-	else if(object->type == ObjectType::Hold)
+	else if(object->type == ObjectType::Hold || object->type == ObjectType::Laser)
 	{
-		HoldObjectState* hold = (HoldObjectState*)object;
+		// Hold segments have their own stat, laser chains share the stat of their root
+		//	the stat is looked up and stored under the root, so ticks of later segments find it even if the first scored tick
+		//	wasn't on the root segment (e.g. after starting in the middle of a laser)
+		if(object->type == ObjectType::Laser)
+			object = tick->root;
 		HitStat** foundStat = m_holdHitStats.Find(object);
 		if(foundStat)
 			return *foundStat;
-		HitStat* stat = new HitStat(object);
+		HitStat* stat = m_AllocateHitStat(object);
 		hitStats.Add(stat);
 		m_holdHitStats.Add(object, stat);
-
-		// Get tick count
-		Vector<MapTime> ticks;
-		m_CalculateHoldTicks(hold, ticks);
-		stat->holdMax = (uint32)ticks.size();
-
-		return stat;
-	}
-	else if(object->type == ObjectType::Laser)
-	{
-		LaserObjectState* rootLaser = ((LaserObjectState*)object)->GetRoot();
-		HitStat** foundStat = m_holdHitStats.Find(*rootLaser);
-		if(foundStat)
-			return *foundStat;
-		HitStat* stat = new HitStat(*rootLaser);
-		hitStats.Add(stat);
-		m_holdHitStats.Add(object, stat);
-
-		// Get tick count
-		Vector<ScoreTick> ticks;
-		m_CalculateLaserTicks(rootLaser, ticks);
-		stat->holdMax = (uint32)ticks.size();
-
+		stat->holdMax = m_timeline->GetNumTicks(object);
 		return stat;
 	}
 
@@ -295,12 +362,19 @@ HitStat* Scoring::m_AddOrUpdateHitStat(ObjectState* object)
 	return nullptr;
 }
 
+HitStat* Scoring::m_AllocateHitStat(ObjectState* object)
+{
+	// Every object has at most one stat, so the chunk reserved on reset normally holds all of them
+	//	a full chunk is never grown, since that would move the stats that are already referenced
+	if(m_hitStatPool.empty() || m_hitStatPool.back().size() == m_hitStatPool.back().capacity())
+		m_hitStatPool.AddBack().reserve(Math::Max<size_t>(m_hitStatPool.empty() ? 0 : m_hitStatPool.front().capacity(), 64));
+	return &m_hitStatPool.back().Add(HitStat(object));
+}
 void Scoring::m_CleanupHitStats()
 {
-	for(HitStat* hit : hitStats)
-		delete hit;
 	hitStats.clear();
 	m_holdHitStats.clear();
+	m_hitStatPool.clear();
 }
 
 bool Scoring::IsObjectHeld(ObjectState* object)
@@ -352,121 +426,16 @@ bool Scoring::IsLaserIdle(uint32 index) const
 	return m_laserSegmentQueue.empty() && m_currentLaserSegments[0] == nullptr && m_currentLaserSegments[1] == nullptr;
 }
 
-void Scoring::m_CalculateHoldTicks(HoldObjectState* hold, Vector<MapTime>& ticks) const
-{
-	const TimingPoint* tp = m_playback->GetTimingPointAt(hold->time);
-
-	// Tick rate based on BPM
-	const double tickNoteValue = 16 / (pow(2, Math::Max((int)(log2(tp->GetBPM())) - 7, 0)));
-	const double tickInterval = tp->GetWholeNoteLength() / tickNoteValue;
-
-	uint32 numTicks = (uint32)Math::Floor((double)hold->duration / tickInterval);
-	if(numTicks < 1)
-		numTicks = 1; // At least 1 tick at the start
-
-	for(uint32 i = 0; i < numTicks; i++)
-	{
-		ticks.Add((MapTime)((double)hold->time + tickInterval * (double)i));
-	}
-}
-void Scoring::m_CalculateLaserTicks(LaserObjectState* laserRoot, Vector<ScoreTick>& ticks) const
-{
-	assert(laserRoot->prev == nullptr);
-	const TimingPoint* tp = m_playback->GetTimingPointAt(laserRoot->time);
-
-	// Tick rate based on BPM
-	const double tickNoteValue = 16 / (pow(2, Math::Max((int)(log2(tp->GetBPM())) - 7,0)));
-	const double tickInterval = tp->GetWholeNoteLength() / tickNoteValue;
-
-	LaserObjectState* sectionStart = laserRoot;
-	MapTime sectionStartTime = laserRoot->time;
-	MapTime combinedDuration = 0;
-	LaserObjectState* lastSlam = nullptr;
-	auto AddTicks = [&]()
-	{
-		uint32 numTicks = (uint32)Math::Floor((double)combinedDuration / tickInterval);
-		for(uint32 i = 0; i < numTicks; i++)
-		{
-			if(lastSlam && i == 0) // No first tick if connected to slam
-				continue;
-
-			ScoreTick& t = ticks.Add(ScoreTick(*sectionStart));
-			t.time = sectionStartTime + (MapTime)(tickInterval*(double)i);
-			t.flags = TickFlags::Laser;
-			
-			// Link this tick to the correct segment
-			if(sectionStart->next && (sectionStart->time + sectionStart->duration) <= t.time)
-			{
-				assert((sectionStart->next->flags & LaserObjectState::flag_Instant) == 0);
-				t.object = *(sectionStart = sectionStart->next);
-			}
-
-
-			if(!lastSlam && i == 0)
-				t.SetFlag(TickFlags::Start);
-		}
-		combinedDuration = 0;
-	};
-
-	for(auto it = laserRoot; it; it = it->next)
-	{
-		if((it->flags & LaserObjectState::flag_Instant) != 0)
-		{
-			AddTicks();
-			ScoreTick& t = ticks.Add(ScoreTick(*it));
-			t.time = it->time;
-			t.flags = TickFlags::Laser | TickFlags::Slam;
-			lastSlam = it;
-			if(it->next)
-			{
-				sectionStart = it->next;
-				sectionStartTime = it->next->time;
-			}
-			else
-			{
-				sectionStart = nullptr;
-				sectionStartTime = it->time;
-			}		  
-		}
-		else
-		{
-			combinedDuration += it->duration;
-		}
-	}
-	AddTicks();
-	if(ticks.size() > 0)
-		ticks.back().SetFlag(TickFlags::End);
-}
-
 void Scoring::m_OnObjectEntered(ObjectState* obj)
 {
-	// The following code registers which ticks exist depending on the object type / duration
-	if(obj->type == ObjectType::Single)
+	// Register the ticks of this object, lasers only have ticks on the root of a chain
+	uint32 numTicks = 0;
+	const ScoreTick* ticks = m_timeline->GetTicks(obj, numTicks);
+	if(obj->type == ObjectType::Single || obj->type == ObjectType::Hold)
 	{
 		ButtonObjectState* bt = (ButtonObjectState*)obj;
-		ScoreTick* t = m_ticks[bt->index].Add(new ScoreTick(obj));
-		t->time = bt->time;
-		t->SetFlag(TickFlags::Button);
-
-	}
-	else if(obj->type == ObjectType::Hold)
-	{
-		const TimingPoint* tp = m_playback->GetTimingPointAt(obj->time);
-		HoldObjectState* hold = (HoldObjectState*)obj;
-		
-		// Add all hold ticks
-		Vector<MapTime> holdTicks;
-		m_CalculateHoldTicks(hold, holdTicks);
-		for(size_t i = 0; i < holdTicks.size(); i++)
-		{
-			ScoreTick* t = m_ticks[hold->index].Add(new ScoreTick(obj));
-			t->SetFlag(TickFlags::Hold);
-			if(i == 0 && !hold->prev)
-				t->SetFlag(TickFlags::Start);
-			if(i == holdTicks.size() - 1 && !hold->next)
-				t->SetFlag(TickFlags::End);
-			t->time = holdTicks[i];
-		}
+		for(uint32 i = 0; i < numTicks; i++)
+			m_ticks[bt->index].Add(ticks[i]);
 	}
 	else if(obj->type == ObjectType::Laser)
 	{
@@ -494,13 +463,8 @@ void Scoring::m_OnObjectEntered(ObjectState* obj)
 				}
 			}
 			// All laser ticks, including slam segments
-			Vector<ScoreTick> laserTicks;
-			m_CalculateLaserTicks(laser, laserTicks);
-			for(size_t i = 0; i < laserTicks.size(); i++)
-			{
-				// Add copy
-				m_ticks[laser->index + 6].Add(new ScoreTick(laserTicks[i]));
-			}
+			for(uint32 i = 0; i < numTicks; i++)
+				m_ticks[laser->index + 6].Add(ticks[i]);
 		}
 
 		// Add to laser segment queue
@@ -519,143 +483,121 @@ void Scoring::m_OnObjectLeaved(ObjectState* obj)
 	m_ReleaseHoldObject(obj);
 }
 
-void Scoring::m_UpdateTicks()
+void Scoring::m_UpdateTicks(MapTime currentTime, bool includeLasers)
 {
-	MapTime currentTime = m_playback->GetLastTime();
-
 	// This loop checks for ticks that are missed
-	for(uint32 buttonCode = 0; buttonCode < 8; buttonCode++)
+	uint32 numButtonCodes = includeLasers ? 8 : 6;
+	for(uint32 buttonCode = 0; buttonCode < numButtonCodes; buttonCode++)
 	{
 		Input::Button button = (Input::Button)buttonCode;
 
-		// List of ticks for the current button code
+		// Ticks for the current button code, sorted by time so only the ones that are due are visited
 		auto& ticks = m_ticks[buttonCode];
-		for(uint32 i = 0; i < ticks.size(); i++)
+		while(!ticks.empty())
 		{
-			ScoreTick* tick = ticks[i];
-			MapTime delta = currentTime - ticks[i]->time;
-			bool shouldMiss = delta > tick->GetHitWindow();
+			ScoreTick* tick = &ticks.Front();
+			MapTime delta = currentTime - tick->time;
+			if(delta < 0)
+				break;
+
 			bool processed = false;
-			if(delta >= 0)
+			if(tick->HasFlag(TickFlags::Button) && (autoplay || autoplayButtons))
 			{
-				if(tick->HasFlag(TickFlags::Button) && (autoplay || autoplayButtons))
+				m_TickHit(tick, buttonCode, 0);
+				processed = true;
+			}
+
+			if(tick->HasFlag(TickFlags::Hold))
+			{
+				// Ignore the first hold note ticks
+				//	except for autoplay, which just hits it.
+				if(!tick->HasFlag(TickFlags::Start) || (autoplay || autoplayButtons))
 				{
-					m_TickHit(tick, buttonCode, 0);
-					processed = true;
+					// Check buttons here for holds
+					if((m_buttonHeld[(size_t)button] && tick->rootTime - goodHitTime < m_buttonHitTime[(uint8)button]) || autoplay || autoplayButtons)
+					{							
+						m_TickHit(tick, buttonCode);
+						processed = true;
+					}
 				}
-
-				if(tick->HasFlag(TickFlags::Hold))
+			}
+			else if(tick->HasFlag(TickFlags::Laser))
+			{
+				LaserObjectState* laserObject = (LaserObjectState*)tick->object;
+				if(tick->HasFlag(TickFlags::Slam))
 				{
-					// Ignore the first hold note ticks
-					//	except for autoplay, which just hits it.
-					if(!tick->HasFlag(TickFlags::Start) || (autoplay || autoplayButtons))
+					// Check if slam hit
+					float dirSign = Math::Sign(laserObject->GetDirection());
+					float inputSign = Math::Sign(m_laserInputSample[buttonCode - 6]);
+					float posDelta = (laserObject->points[1] - laserPositions[buttonCode - 6]) * dirSign;
+					if (autoplay)
 					{
-						HoldObjectState* hos = (HoldObjectState*)tick->object;
-
-						MapTime holdStart = 0;
-						while (hos)
-						{
-							holdStart = hos->time;
-							hos = hos->prev;
-						}
-
-						// Check buttons here for holds
-						if((m_input && m_input->GetButton(button) && holdStart - goodHitTime < m_buttonHitTime[(uint8)button]) || autoplay || autoplayButtons)
-						{							
-							m_TickHit(tick, buttonCode);
-							processed = true;
-						}
+						inputSign = dirSign;
+						posDelta = 1;
+					}
+					if(dirSign == inputSign && delta > -10 && posDelta >= -laserDistanceLeniency)
+					{
+						m_TickHit(tick, buttonCode);
+						processed = true;
 					}
 				}
-				else if(tick->HasFlag(TickFlags::Laser))
+				else
 				{
-					LaserObjectState* laserObject = (LaserObjectState*)tick->object;
-					if(tick->HasFlag(TickFlags::Slam))
+					// Snap to first laser tick
+					/// TODO: Find better solution
+					if (tick->HasFlag(TickFlags::Start))
 					{
-						// Check if slam hit
-						float dirSign = Math::Sign(laserObject->GetDirection());
-						float inputSign = Math::Sign(m_input->GetInputLaserDir(buttonCode - 6));
-						float posDelta = (laserObject->points[1] - laserPositions[buttonCode - 6]) * dirSign;
-						if (autoplay)
-						{
-							inputSign = dirSign;
-							posDelta = 1;
-						}
-						if(dirSign == inputSign && delta > -10 && posDelta >= -laserDistanceLeniency)
-						{
-							m_TickHit(tick, buttonCode);
-							processed = true;
-						}
+						laserPositions[laserObject->index] = laserTargetPositions[laserObject->index];
+						m_autoLaserTime[laserObject->index] = m_assistTime;
 					}
-					else
+
+					// Check laser input
+					float laserDelta = fabs(laserPositions[laserObject->index] - laserTargetPositions[laserObject->index]);\
+
+					if(laserDelta < laserDistanceLeniency)
 					{
-						// Snap to first laser tick
-						/// TODO: Find better solution
-						if (tick->HasFlag(TickFlags::Start))
-						{
-							laserPositions[laserObject->index] = laserTargetPositions[laserObject->index];
-							m_autoLaserTime[laserObject->index] = m_assistTime;
-						}
-
-						// Check laser input
-						float laserDelta = fabs(laserPositions[laserObject->index] - laserTargetPositions[laserObject->index]);\
-
-						if(laserDelta < laserDistanceLeniency)
-						{
-							m_TickHit(tick, buttonCode);
-							processed = true;
-						}
+						m_TickHit(tick, buttonCode);
+						processed = true;
 					}
 				}
+			}
 
-				if(delta > Scoring::goodHitTime && !processed)
-				{
-					m_TickMiss(tick, buttonCode, delta);
-					processed = true;
-				}
+			if(delta > Scoring::goodHitTime && !processed)
+			{
+				m_TickMiss(tick, buttonCode, delta);
+				processed = true;
+			}
 
-				if(processed)
-				{
-					delete tick;
-					ticks.Remove(tick, false);
-					i--;
-				}
-				else
-				{
-					// No further ticks to process
-					break;
-				}
+			if(processed)
+			{
+				ticks.PopFront();
+			}
+			else
+			{
+				// No further ticks to process
+				break;
 			}
 		}
 	}
 }
-ObjectState* Scoring::m_ConsumeTick(uint32 buttonCode)
+ObjectState* Scoring::m_ConsumeTick(uint32 buttonCode, MapTime currentTime)
 {
-	MapTime currentTime = m_playback->GetLastTime();
-
 	assert(buttonCode < 8);
 	auto& ticks = m_ticks[buttonCode];
-	for(uint32 i = 0; i < ticks.size(); i++)
-	{
-		ScoreTick* tick = ticks[i];
-		MapTime delta = currentTime - ticks[i]->time + m_inputOffset;
-		ObjectState* hitObject = tick->object;
-
-		if(tick->HasFlag(TickFlags::Laser))
-		{
-			// Ignore laser ticks
-			continue;
-		}
-		if(abs(delta) <= Scoring::goodHitTime)
-			m_TickHit(tick, buttonCode, delta);
-		else
-			m_TickMiss(tick, buttonCode, delta);
-		delete tick;
-		ticks.Remove(tick, false);
+	// Laser lanes only contain laser ticks, which can't be hit by pressing a button
+	if(ticks.empty() || ticks.Front().HasFlag(TickFlags::Laser))
+		return nullptr;
+
+	ScoreTick* tick = &ticks.Front();
+	MapTime delta = currentTime - tick->time + m_inputOffset;
+	ObjectState* hitObject = tick->object;
+	if(abs(delta) <= Scoring::goodHitTime)
+		m_TickHit(tick, buttonCode, delta);
+	else
+		m_TickMiss(tick, buttonCode, delta);
+	ticks.PopFront();
 
-		return hitObject;
-	}
-	return nullptr;
+	return hitObject;
 }
 
 void Scoring::m_OnTickProcessed(ScoreTick* tick, uint32 index)
@@ -667,12 +609,13 @@ void Scoring::m_OnTickProcessed(ScoreTick* tick, uint32 index)
 }
 void Scoring::m_TickHit(ScoreTick* tick, uint32 index, MapTime delta /*= 0*/)
 {
-	HitStat* stat = m_AddOrUpdateHitStat(tick->object);
+	HitStat* stat = m_AddOrUpdateHitStat(tick);
 	if(tick->HasFlag(TickFlags::Button))
 	{
 		stat->delta = delta;
 		stat->rating = tick->GetHitRatingFromDelta(delta);
 		OnButtonHit.Call((Input::Button)index, stat->rating, tick->object, Math::Sign(delta) > 0);
+		hitStatistics.AddHit(index, delta, stat->rating);
 
 		if (stat->rating == ScoreHitRating::Perfect)
 		{
@@ -703,7 +646,7 @@ void Scoring::m_TickHit(ScoreTick* tick, uint32 index, MapTime delta /*= 0*/)
 	else if(tick->HasFlag(TickFlags::Laser))
 	{
 		LaserObjectState* object = (LaserObjectState*)tick->object;
-		LaserObjectState* rootObject = ((LaserObjectState*)tick->object)->GetRoot();
+		ObjectState* rootObject = tick->root;
 		if(tick->HasFlag(TickFlags::Slam))
 		{
 			OnLaserSlamHit.Call((LaserObjectState*)tick->object);
@@ -712,14 +655,14 @@ void Scoring::m_TickHit(ScoreTick* tick, uint32 index, MapTime delta /*= 0*/)
 			laserPositions[object->index] = object->points[1];
 			m_autoLaserTime[object->index] = m_assistTime;
 		}
-		if(m_holdObjects[object->index + 6] != *rootObject)
+		if(m_holdObjects[object->index + 6] != rootObject)
 		{
 			// Only set active hold object if object hasn't passed yet
 			LaserObjectState* endObject = ((LaserObjectState*)tick->object)->GetTail();
 			if(endObject->time + endObject->duration > m_playback->GetLastTime())
-				m_SetHoldObject(*rootObject, index);
+				m_SetHoldObject(rootObject, index);
 		}
-		m_SetHoldObject(*rootObject, index);
+		m_SetHoldObject(rootObject, index);
 		currentGauge += tickGaugeGain;
 		m_AddScore(2);
 
@@ -733,7 +676,7 @@ void Scoring::m_TickHit(ScoreTick* tick, uint32 index, MapTime delta /*= 0*/)
 }
 void Scoring::m_TickMiss(ScoreTick* tick, uint32 index, MapTime delta)
 {
-	HitStat* stat = m_AddOrUpdateHitStat(tick->object);
+	HitStat* stat = m_AddOrUpdateHitStat(tick);
 	stat->hasMissed = true;
 	float shortMissDrain = 0.02f;
 	if ((m_flags & GameFlags::Hard) != GameFlags::None)
@@ -780,11 +723,7 @@ void Scoring::m_TickMiss(ScoreTick* tick, uint32 index, MapTime delta)
 void Scoring::m_CleanupTicks()
 {
 	for(uint32 i = 0; i < 8; i++)
-	{
-		for(ScoreTick* tick : m_ticks[i])
-			delete tick;
-		m_ticks[i].clear();
-	}
+		m_ticks[i].Clear();
 }
 
 void Scoring::m_AddScore(uint32 score)
@@ -894,7 +833,7 @@ void Scoring::m_UpdateLasers(float deltaTime)
 			}
 		}
 
-		m_laserInput[i] = autoplay ? 0.0f : m_input->GetInputLaserDir(i);
+		m_laserInput[i] = autoplay ? 0.0f : m_laserInputSample[i];
 
 		bool notAffectingGameplay = true;
 		if(currentSegment)
@@ -966,7 +905,7 @@ void Scoring::m_UpdateLasers(float deltaTime)
 	m_UpdateLaserOutput(deltaTime);
 }
 
-void Scoring::m_OnButtonPressed(Input::Button buttonCode)
+void Scoring::m_OnButtonPressed(Input::Button buttonCode, MapTime time)
 {
 	// Ignore buttons on autoplay
 	if(autoplay)
@@ -974,8 +913,8 @@ void Scoring::m_OnButtonPressed(Input::Button buttonCode)
 
 	if(buttonCode < Input::Button::BT_S)
 	{
-		m_buttonHitTime[(uint32)buttonCode] = m_playback->GetLastTime();
-		ObjectState* obj = m_ConsumeTick((uint32)buttonCode);
+		m_buttonHitTime[(uint32)buttonCode] = time;
+		ObjectState* obj = m_ConsumeTick((uint32)buttonCode, time);
 		if(!obj)
 		{
 			// Fire event for idle hits
@@ -986,57 +925,19 @@ void Scoring::m_OnButtonPressed(Input::Button buttonCode)
 	{
 		ObjectState* obj = nullptr;
 		if(buttonCode < Input::Button::LS_1Neg)
-			obj = m_ConsumeTick(6); // Laser L
+			obj = m_ConsumeTick(6, time); // Laser L
 		else
-			obj = m_ConsumeTick(7); // Laser R
+			obj = m_ConsumeTick(7, time); // Laser R
 	}
 }
-void Scoring::m_OnButtonReleased(Input::Button buttonCode)
+void Scoring::m_OnButtonReleased(Input::Button buttonCode, MapTime time)
 {
 }
 
 MapTotals Scoring::CalculateMapTotals() const
 {
-	MapTotals ret = { 0 };
-	const Beatmap& map = m_playback->GetBeatmap();
-
-	Set<LaserObjectState*> processedLasers;
-
-	assert(m_playback);
-	auto& objects = map.GetLinearObjects();
-	for(auto& _obj : objects)
-	{
-		MultiObjectState* obj = *_obj;
-		const TimingPoint* tp = m_playback->GetTimingPointAt(obj->time);
-		if(obj->type == ObjectType::Single)
-		{
-			ret.maxScore += (uint32)ScoreHitRating::Perfect;
-			ret.numSingles += 1;
-		}
-		else if(obj->type == ObjectType::Hold)
-		{
-			Vector<MapTime> holdTicks;
-			m_CalculateHoldTicks((HoldObjectState*)obj, holdTicks);
-			ret.maxScore += (uint32)ScoreHitRating::Perfect * (uint32)holdTicks.size();
-			ret.numTicks += (uint32)holdTicks.size();
-		}
-		else if(obj->type == ObjectType::Laser)
-		{
-			LaserObjectState* laserRoot = obj->laser.GetRoot();
-
-			// Don't evaluate ticks for every segment, only for entire chains of segments
-			if(!processedLasers.Contains(laserRoot))
-			{
-				Vector<ScoreTick> laserTicks;
-				m_CalculateLaserTicks((LaserObjectState*)obj, laserTicks);
-				ret.maxScore += (uint32)ScoreHitRating::Perfect * (uint32)laserTicks.size();
-				ret.numTicks += (uint32)laserTicks.size();
-				processedLasers.Add(laserRoot);
-			}
-		}
-	}
-
-	return ret;
+	assert(m_timeline);
+	return m_timeline->GetMapTotals();
 }
 
 uint32 Scoring::CalculateCurrentScore() const
@@ -1,60 +1,11 @@
 #pragma once
 #include <Beatmap/BeatmapPlayback.hpp>
 #include "HitStat.hpp"
+#include "HitStatistics.hpp"
 #include "Input.hpp"
 #include "Game.hpp"
-
-enum class TickFlags : uint8
-{
-	None = 0,
-	// Used for segment start/end parts
-	Start = 0x1,
-	End = 0x2,
-	// Hold notes (BT or FX)
-	Hold = 0x4,
-	// Normal/Single hit buttons
-	Button = 0x8,
-	// For lasers only
-	Laser = 0x10,
-	Slam = 0x20,
-};
-TickFlags operator|(const TickFlags& a, const TickFlags& b);
-TickFlags operator&(const TickFlags& a, const TickFlags& b);
-
-// Tick object to record hits
-struct ScoreTick
-{
-public:
-	ScoreTick() = default;
-	ScoreTick(ObjectState* object) : object(object) {};
-
-	// Returns the time frame in which this tick can be hit
-	MapTime GetHitWindow() const;
-	// Hit rating when hitting object at given time
-	ScoreHitRating GetHitRating(MapTime currentTime) const;
-	// Hit rating when hitting object give a delta 
-	ScoreHitRating GetHitRatingFromDelta(MapTime delta) const;
-	// Check a flag
-	bool HasFlag(TickFlags flag) const;
-	void SetFlag(TickFlags flag);
-
-	TickFlags flags = TickFlags::None;
-	MapTime time;
-	ObjectState* object = nullptr;
-};
-
-// Various information about all the objects in a map
-struct MapTotals
-{
-	// Number of single notes
-	uint32 numSingles;
-	// Number of laser/hold ticks
-	uint32 numTicks;
-	// The maximum possible score a map can give
-	// The score is calculated per 2 (2 = critical, 1 = near)
-	// Hold buttons, lasers, etc. give 2 points per tick
-	uint32 maxScore;
-};
+#include "ScoringTimeline.hpp"
+#include <Shared/RingBuffer.hpp>
 
 /*
 	Calculates game score and checks which objects are hit
@@ -77,18 +28,35 @@ public:
 
 	void SetFlags(GameFlags flags);
 
+	// Ticks of the chart that is played, built on Reset from the playback when not set
+	//	the timeline needs to stay alive while scoring
+	void SetTimeline(const ScoringTimeline* timeline);
+
 	// Resets/Initializes the scoring system
 	// Called after SetPlayback
 	void Reset();
+	// Same as above but with the timing settings given instead of read from the game config
+	void Reset(int32 inputOffset, float laserAssistLevel);
 
 	// Updates the list of objects that are possible to hit
-	void Tick(float deltaTime);
+	//	inputTime is the input clock time (Input::GetTime) at which the playback position was sampled
+	//	queued input events are judged at the map time they happened at instead of the current frame time
+	void Tick(float deltaTime, double inputTime);
+
+	// Receives button events from the input, processed on the next tick
+	InputEventQueue& GetInputQueue();
+	// Sets the laser input used on the next tick, for when there is no input set
+	void SetLaserInput(uint32 index, float input);
+
+	// Records all processed input into the given replay, the recording is restarted on Reset
+	void SetReplay(class Replay* replay);
 
 	float GetLaserRollOutput(uint32 index);
 	// Check if any lasers are currently active
 	bool GetLaserActive();
 	float GetLaserOutput();
 
+	// Timing of button hits, read from hitStatistics
 	float GetMeanHitDelta();
 	int16 GetMedianHitDelta();
 
@@ -104,7 +72,7 @@ public:
 	// Checks if a laser is currently not used or needed soon
 	bool IsLaserIdle(uint32 index) const;
 
-	// Calculates the maximum score of the current map
+	// Maximum score and number of ticks of the current map
 	MapTotals CalculateMapTotals() const;
 
 	// Actual score, in the range 0-10,000,000
@@ -182,7 +150,11 @@ public:
 
 	// The timings of hit objects, sorted by time hit
 	// these are used for debugging
+	//	buttons get a stat per hit, holds a stat per segment and lasers a single stat per chain
+	//	a laser stat belongs to the root segment and counts the ticks of all segments in the chain
 	Vector<HitStat*> hitStats;
+	// Timing statistics of all button hits, updated on every hit
+	HitStatistics hitStatistics;
 
 	// Autoplay mode
 	bool autoplay = false;
@@ -200,23 +172,21 @@ public:
 	// Time since laser has been used
 	float timeSinceLaserUsed[2];
 private:
-	// Calculates the times at which a single hold object ticks
-	void m_CalculateHoldTicks(HoldObjectState* hold, Vector<MapTime>& ticks) const;
-	// Calculates the times at which a single laser chain object ticks
-	//	use the root laser object
-	void m_CalculateLaserTicks(LaserObjectState* laserRoot, Vector<ScoreTick>& ticks) const;
 	void m_OnObjectEntered(ObjectState* obj);
 	void m_OnObjectLeaved(ObjectState* obj);
 
 	// Button event handlers
-	void m_OnButtonPressed(Input::Button buttonCode);
-	void m_OnButtonReleased(Input::Button buttonCode);
+	void m_OnButtonPressed(Input::Button buttonCode, MapTime time);
+	void m_OnButtonReleased(Input::Button buttonCode, MapTime time);
 	void m_CleanupInput();
+	// Judges queued input events that happened before inputTime
+	void m_ProcessInputEvents(MapTime frameTime, double inputTime);
 
-	// Updates all pending ticks
-	void m_UpdateTicks();
+	// Updates all pending ticks up to the given time
+	//	lasers are only checked when includeLasers is set since laser positions are only updated per frame
+	void m_UpdateTicks(MapTime currentTime, bool includeLasers = true);
 	// Tries to trigger a hit event on an approaching tick
-	ObjectState* m_ConsumeTick(uint32 buttonCode);
+	ObjectState* m_ConsumeTick(uint32 buttonCode, MapTime time);
 	// Called whenether missed or not
 	void m_OnTickProcessed(ScoreTick* tick, uint32 index);
 	void m_TickHit(ScoreTick* tick, uint32 index, MapTime delta = 0);
@@ -243,7 +213,8 @@ private:
 	void m_UpdateLaserOutput(float deltaTime);
 
 	// Creates or retrieves an existing hit stat and returns it
-	HitStat* m_AddOrUpdateHitStat(ObjectState* object);
+	HitStat* m_AddOrUpdateHitStat(const ScoreTick* tick);
+	HitStat* m_AllocateHitStat(ObjectState* object);
 	void m_CleanupHitStats();
 
 	// Updates laser output with or without interpolation
@@ -259,12 +230,23 @@ private:
 
 	// Input values for laser [-1,1]
 	float m_laserInput[2] = { 0.0f };
+	// Laser input for the current tick, read from the input or set with SetLaserInput
+	float m_laserInputSample[2] = { 0.0f };
 	// Keeps being set to the last direction the laser was moving in to create laser intertia
 	float m_lastLaserInputDirection[2] = { 0.0f };
 	// Decides if the coming tick should be auto completed
 	float m_autoLaserTime[2] = { 0,0 };
 	// Saves the time when a button was hit, used to decide if a button was held before a hold object was active
 	MapTime m_buttonHitTime[6] = { -1,-1,-1,-1,-1,-1 };
+	// Button states as of the last processed input event
+	bool m_buttonHeld[(size_t)Input::Button::Length] = { false };
+
+	// Timestamped button events from the input
+	InputEventQueue m_inputQueue;
+	// Events taken from the queue that happened after the last tick
+	Vector<InputEvent> m_pendingInput;
+	// Map time of the last judged input event, events are never judged before this time
+	MapTime m_lastInputTime = 0;
 	// Max number of ticks to assist
 	float m_assistLevel = 1.5f;
 	float m_assistTime = 0.0f;
@@ -272,7 +254,11 @@ private:
 	uint32 m_inputOffset = 0;
 
 	// used the update the amount of hit ticks for hold/laser notes
+	//	keyed by the hold segment or the root of the laser chain
 	Map<ObjectState*, HitStat*> m_holdHitStats;
+	// Storage for hitStats, chunks are never grown beyond their reserved size so the stats never move
+	//	the first chunk is reserved for every object of the map on reset, so normally nothing is allocated while playing
+	List<Vector<HitStat>> m_hitStatPool;
 
 	// Laser objects currently in range
 	//	used to sample target laser positions
@@ -280,12 +266,19 @@ private:
 	// Queue for the above list
 	Vector<LaserObjectState*> m_laserSegmentQueue;
 
-	// Ticks for each BT[4] / FX[2] / Laser[2]
-	Vector<ScoreTick*> m_ticks[8];
+	// Ticks for each BT[4] / FX[2] / Laser[2], sorted by time
+	//	the buffers are reused between objects so adding ticks doesn't allocate once they're large enough
+	RingBuffer<ScoreTick> m_ticks[8];
+	// Source of the ticks that are added when objects enter
+	const ScoringTimeline* m_timeline = nullptr;
+	// Used when no timeline is set
+	ScoringTimeline m_playbackTimeline;
 	// Hold objects
 	ObjectState* m_holdObjects[8];
 	Set<ObjectState*> m_heldObjects;
 
-	GameFlags m_flags;
+	GameFlags m_flags = GameFlags::None;
+
+	class Replay* m_replay = nullptr;
 };
 
@@ -0,0 +1,308 @@
+#include "stdafx.h"
+#include "ScoringTimeline.hpp"
+#include <Shared/Profiling.hpp>
+
+static const uint32 c_timelineVersion = 1;
+
+// Same selection as the playback, the last timing point at or before the given time
+static const TimingPoint* GetTimingPointAt(const Beatmap& beatmap, MapTime time)
+{
+	const Vector<TimingPoint*>& timingPoints = beatmap.GetLinearTimingPoints();
+	assert(!timingPoints.empty());
+	auto it = std::upper_bound(timingPoints.begin(), timingPoints.end(), time, [](MapTime t, const TimingPoint* tp)
+	{
+		return t < tp->time;
+	});
+	if(it == timingPoints.begin())
+		return timingPoints.front();
+	return *(it - 1);
+}
+
+// Tick interval based on BPM
+static double GetTickInterval(const TimingPoint* tp)
+{
+	const double tickNoteValue = 16 / (pow(2, Math::Max((int)(log2(tp->GetBPM())) - 7, 0)));
+	return tp->GetWholeNoteLength() / tickNoteValue;
+}
+
+void ScoringTimeline::Build(const Beatmap& beatmap)
+{
+	ProfilerScope $("Build Scoring Timeline");
+	Clear();
+	for(ObjectState* obj : beatmap.GetLinearObjects())
+	{
+		if(obj->type == ObjectType::Single)
+		{
+			m_objectTicks.Add(obj, { (uint32)m_ticks.size(), 1 });
+			ScoreTick& t = m_ticks.Add(ScoreTick(obj));
+			t.time = obj->time;
+			t.rootTime = obj->time;
+			t.SetFlag(TickFlags::Button);
+
+			m_totals.maxScore += (uint32)ScoreHitRating::Perfect;
+			m_totals.numSingles += 1;
+		}
+		else if(obj->type == ObjectType::Hold)
+		{
+			m_AddHoldTicks(beatmap, (HoldObjectState*)obj);
+		}
+		else if(obj->type == ObjectType::Laser)
+		{
+			// Don't evaluate ticks for every segment, only for entire chains of segments
+			LaserObjectState* laser = (LaserObjectState*)obj;
+			if(!laser->prev)
+				m_AddLaserTicks(beatmap, laser);
+		}
+	}
+}
+void ScoringTimeline::Clear()
+{
+	m_ticks.clear();
+	m_objectTicks.clear();
+	m_totals = { 0 };
+}
+
+const ScoreTick* ScoringTimeline::GetTicks(const ObjectState* object, uint32& numTicks) const
+{
+	const TickRange* range = m_objectTicks.Find(object);
+	if(!range || range->count == 0)
+	{
+		numTicks = 0;
+		return nullptr;
+	}
+	numTicks = range->count;
+	return m_ticks.data() + range->first;
+}
+uint32 ScoringTimeline::GetNumTicks(const ObjectState* object) const
+{
+	const TickRange* range = m_objectTicks.Find(object);
+	return range ? range->count : 0;
+}
+uint32 ScoringTimeline::GetNumObjects() const
+{
+	return (uint32)m_objectTicks.size();
+}
+const Vector<ScoreTick>& ScoringTimeline::GetAllTicks() const
+{
+	return m_ticks;
+}
+const MapTotals& ScoringTimeline::GetMapTotals() const
+{
+	return m_totals;
+}
+
+void ScoringTimeline::m_AddHoldTicks(const Beatmap& beatmap, HoldObjectState* hold)
+{
+	const double tickInterval = GetTickInterval(GetTimingPointAt(beatmap, hold->time));
+
+	uint32 numTicks = (uint32)Math::Floor((double)hold->duration / tickInterval);
+	if(numTicks < 1)
+		numTicks = 1; // At least 1 tick at the start
+
+	HoldObjectState* root = hold->GetRoot();
+	m_objectTicks.Add(*hold, { (uint32)m_ticks.size(), numTicks });
+	for(uint32 i = 0; i < numTicks; i++)
+	{
+		ScoreTick& t = m_ticks.Add(ScoreTick(*hold));
+		t.SetFlag(TickFlags::Hold);
+		if(i == 0 && !hold->prev)
+			t.SetFlag(TickFlags::Start);
+		if(i == numTicks - 1 && !hold->next)
+			t.SetFlag(TickFlags::End);
+		t.time = (MapTime)((double)hold->time + tickInterval * (double)i);
+		t.root = *root;
+		t.rootTime = root->time;
+	}
+
+	m_totals.maxScore += (uint32)ScoreHitRating::Perfect * numTicks;
+	m_totals.numTicks += numTicks;
+}
+void ScoringTimeline::m_AddLaserTicks(const Beatmap& beatmap, LaserObjectState* laserRoot)
+{
+	assert(laserRoot->prev == nullptr);
+	const double tickInterval = GetTickInterval(GetTimingPointAt(beatmap, laserRoot->time));
+
+	uint32 firstTick = (uint32)m_ticks.size();
+	LaserObjectState* sectionStart = laserRoot;
+	MapTime sectionStartTime = laserRoot->time;
+	MapTime combinedDuration = 0;
+	LaserObjectState* lastSlam = nullptr;
+	auto AddTick = [&](LaserObjectState* object) -> ScoreTick&
+	{
+		ScoreTick& t = m_ticks.Add(ScoreTick(*object));
+		t.root = *laserRoot;
+		t.rootTime = laserRoot->time;
+		return t;
+	};
+	auto AddTicks = [&]()
+	{
+		uint32 numTicks = (uint32)Math::Floor((double)combinedDuration / tickInterval);
+		for(uint32 i = 0; i < numTicks; i++)
+		{
+			if(lastSlam && i == 0) // No first tick if connected to slam
+				continue;
+
+			ScoreTick& t = AddTick(sectionStart);
+			t.time = sectionStartTime + (MapTime)(tickInterval*(double)i);
+			t.flags = TickFlags::Laser;
+
+			// Link this tick to the correct segment
+			if(sectionStart->next && (sectionStart->time + sectionStart->duration) <= t.time)
+			{
+				assert((sectionStart->next->flags & LaserObjectState::flag_Instant) == 0);
+				t.object = *(sectionStart = sectionStart->next);
+			}
+
+			if(!lastSlam && i == 0)
+				t.SetFlag(TickFlags::Start);
+		}
+		combinedDuration = 0;
+	};
+
+	for(auto it = laserRoot; it; it = it->next)
+	{
+		if((it->flags & LaserObjectState::flag_Instant) != 0)
+		{
+			AddTicks();
+			ScoreTick& t = AddTick(it);
+			t.time = it->time;
+			t.flags = TickFlags::Laser | TickFlags::Slam;
+			lastSlam = it;
+			if(it->next)
+			{
+				sectionStart = it->next;
+				sectionStartTime = it->next->time;
+			}
+			else
+			{
+				sectionStart = nullptr;
+				sectionStartTime = it->time;
+			}
+		}
+		else
+		{
+			combinedDuration += it->duration;
+		}
+	}
+	AddTicks();
+
+	uint32 numTicks = (uint32)m_ticks.size() - firstTick;
+	if(numTicks > 0)
+		m_ticks.back().SetFlag(TickFlags::End);
+	m_objectTicks.Add(*laserRoot, { firstTick, numTicks });
+
+	m_totals.maxScore += (uint32)ScoreHitRating::Perfect * numTicks;
+	m_totals.numTicks += numTicks;
+}
+
+bool ScoringTimeline::Load(BinaryStream& stream, const Beatmap& beatmap)
+{
+	static const uint32 c_magic = *(uint32*)"FXST";
+	uint32 magic = 0;
+	uint32 version = 0;
+	stream << magic;
+	stream << version;
+	if(magic != c_magic)
+	{
+		Log("Invalid scoring timeline format", Logger::Warning);
+		return false;
+	}
+	if(version != c_timelineVersion)
+	{
+		Logf("Incompatible scoring timeline version [%d], loader is version %d", Logger::Warning, version, c_timelineVersion);
+		return false;
+	}
+
+	Clear();
+	const Vector<ObjectState*>& objects = beatmap.GetLinearObjects();
+	uint32 numObjects = 0;
+	uint32 numTicks = 0;
+	stream << numObjects;
+	stream << numTicks;
+	// Every entry takes more than a byte
+	if(numObjects + (size_t)numTicks > stream.GetSize() - stream.Tell())
+	{
+		Log("Scoring timeline data is truncated", Logger::Warning);
+		return false;
+	}
+
+	for(uint32 i = 0; i < numObjects; i++)
+	{
+		uint32 objectIndex = 0;
+		uint32 tickCount = 0;
+		stream << objectIndex;
+		stream << tickCount;
+		if(objectIndex >= objects.size())
+			return false;
+		m_objectTicks.Add(objects[objectIndex], { (uint32)m_ticks.size(), tickCount });
+
+		for(uint32 j = 0; j < tickCount; j++)
+		{
+			uint32 tickObject = 0;
+			uint32 tickRoot = 0;
+			ScoreTick& t = m_ticks.Add();
+			stream << (uint8&)t.flags;
+			stream << t.time;
+			stream << tickObject;
+			stream << tickRoot;
+			if(tickObject >= objects.size() || tickRoot >= objects.size())
+				return false;
+			t.object = objects[tickObject];
+			t.root = objects[tickRoot];
+			t.rootTime = t.root->time;
+		}
+	}
+	stream << m_totals.numSingles;
+	stream << m_totals.numTicks;
+	stream << m_totals.maxScore;
+
+	return m_ticks.size() == numTicks;
+}
+bool ScoringTimeline::Save(BinaryStream& stream, const Beatmap& beatmap) const
+{
+	static const uint32 c_magic = *(uint32*)"FXST";
+	uint32 magic = c_magic;
+	uint32 version = c_timelineVersion;
+	stream << magic;
+	stream << version;
+
+	Map<const ObjectState*, uint32> objectIndices;
+	const Vector<ObjectState*>& objects = beatmap.GetLinearObjects();
+	for(uint32 i = 0; i < objects.size(); i++)
+		objectIndices.Add(objects[i], i);
+
+	uint32 numObjects = (uint32)m_objectTicks.size();
+	uint32 numTicks = (uint32)m_ticks.size();
+	stream << numObjects;
+	stream << numTicks;
+
+	// Stored in tick order so loading adds the ranges in the same order
+	Vector<std::pair<const ObjectState*, TickRange>> ranges(m_objectTicks.begin(), m_objectTicks.end());
+	std::sort(ranges.begin(), ranges.end(), [](const std::pair<const ObjectState*, TickRange>& l, const std::pair<const ObjectState*, TickRange>& r)
+	{
+		return l.second.first < r.second.first;
+	});
+	for(auto& range : ranges)
+	{
+		uint32 objectIndex = objectIndices.at(range.first);
+		uint32 tickCount = range.second.count;
+		stream << objectIndex;
+		stream << tickCount;
+		for(uint32 j = 0; j < tickCount; j++)
+		{
+			ScoreTick t = m_ticks[range.second.first + j];
+			uint32 tickObject = objectIndices.at(t.object);
+			uint32 tickRoot = objectIndices.at(t.root);
+			stream << (uint8&)t.flags;
+			stream << t.time;
+			stream << tickObject;
+			stream << tickRoot;
+		}
+	}
+	MapTotals totals = m_totals;
+	stream << totals.numSingles;
+	stream << totals.numTicks;
+	stream << totals.maxScore;
+
+	return true;
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <Beatmap/Beatmap.hpp>
+#include "HitStat.hpp"
+
+enum class TickFlags : uint8
+{
+	None = 0,
+	// Used for segment start/end parts
+	Start = 0x1,
+	End = 0x2,
+	// Hold notes (BT or FX)
+	Hold = 0x4,
+	// Normal/Single hit buttons
+	Button = 0x8,
+	// For lasers only
+	Laser = 0x10,
+	Slam = 0x20,
+};
+TickFlags operator|(const TickFlags& a, const TickFlags& b);
+TickFlags operator&(const TickFlags& a, const TickFlags& b);
+
+// Tick object to record hits
+//	plain data, stored by value in the scoring timeline and the per lane tick queues
+struct ScoreTick
+{
+public:
+	ScoreTick() = default;
+	ScoreTick(ObjectState* object) : object(object), root(object) {};
+
+	// Returns the time frame in which this tick can be hit
+	MapTime GetHitWindow() const;
+	// Hit rating when hitting object at given time
+	ScoreHitRating GetHitRating(MapTime currentTime) const;
+	// Hit rating when hitting object give a delta
+	ScoreHitRating GetHitRatingFromDelta(MapTime delta) const;
+	// Check a flag
+	bool HasFlag(TickFlags flag) const;
+	void SetFlag(TickFlags flag);
+
+	TickFlags flags = TickFlags::None;
+	MapTime time;
+	// Start time of the first object in the hold or laser chain this tick belongs to
+	MapTime rootTime = 0;
+	ObjectState* object = nullptr;
+	// First object in the hold or laser chain this tick belongs to
+	ObjectState* root = nullptr;
+};
+
+// Various information about all the objects in a map
+struct MapTotals
+{
+	// Number of single notes
+	uint32 numSingles;
+	// Number of laser/hold ticks
+	uint32 numTicks;
+	// The maximum possible score a map can give
+	// The score is calculated per 2 (2 = critical, 1 = near)
+	// Hold buttons, lasers, etc. give 2 points per tick
+	uint32 maxScore;
+};
+
+/*
+	Every judgeable tick of a chart, compiled once when the chart is loaded
+	ticks are stored contiguously per object in the order objects appear in the chart,
+	the ticks of a laser chain are all stored on the root segment of that chain.
+	The lane of a tick is the index of its object, so the button mapping of replays can be applied after building this
+*/
+class ScoringTimeline
+{
+public:
+	// Calculates the ticks of all objects in the chart
+	void Build(const Beatmap& beatmap);
+	void Clear();
+
+	// Ticks added when an object becomes hittable, sorted by time
+	//	returns nullptr and sets numTicks to 0 for objects without ticks
+	const ScoreTick* GetTicks(const ObjectState* object, uint32& numTicks) const;
+	// Number of ticks of a hold segment or an entire laser chain (by it's root)
+	uint32 GetNumTicks(const ObjectState* object) const;
+	// Number of objects that have ticks, singles, hold segments and laser chains
+	uint32 GetNumObjects() const;
+	const Vector<ScoreTick>& GetAllTicks() const;
+	const MapTotals& GetMapTotals() const;
+
+	// Cache the timeline, the objects are stored as indices into the linear objects of the given chart
+	bool Load(BinaryStream& stream, const Beatmap& beatmap);
+	bool Save(BinaryStream& stream, const Beatmap& beatmap) const;
+
+private:
+	struct TickRange
+	{
+		uint32 first;
+		uint32 count;
+	};
+
+	// Calculates the times at which a single hold object ticks
+	void m_AddHoldTicks(const Beatmap& beatmap, HoldObjectState* hold);
+	// Calculates the times at which a single laser chain object ticks
+	//	use the root laser object
+	void m_AddLaserTicks(const Beatmap& beatmap, LaserObjectState* laserRoot);
+
+	Vector<ScoreTick> m_ticks;
+	Map<const ObjectState*, TickRange> m_objectTicks;
+	MapTotals m_totals = { 0 };
+};
@@ -1,21 +1,24 @@
 #include "stdafx.h"
 #include "SongFilter.hpp"
 
-Map<int32, SongSelectIndex> LevelFilter::GetFiltered(const Map<int32, SongSelectIndex>& source)
+void LevelFilter::Filter(const Vector<SongSelectEntry>& source, Vector<SongSelectEntry>& out)
 {
-	Map<int32, SongSelectIndex> filtered;
-	for (auto kvp : source)
+	out.clear();
+	for (const SongSelectEntry& entry : source)
 	{
-		for (auto diff : kvp.second.GetDifficulties())
+		const Vector<DifficultyIndex*>& diffs = entry.map->difficulties;
+		if (entry.difficulty >= 0)
 		{
-			if (diff->settings.level == m_level)
-			{
-				SongSelectIndex index(kvp.second.GetMap(), diff);
-				filtered.Add(index.id, index);
-			}
+			if (diffs[entry.difficulty]->settings.level == m_level)
+				out.Add(entry);
+			continue;
+		}
+		for (size_t i = 0; i < diffs.size(); i++)
+		{
+			if (diffs[i]->settings.level == m_level)
+				out.Add(SongSelectEntry(entry.map, (int32)i));
 		}
 	}
-	return filtered;
 }
 
 String LevelFilter::GetName()
@@ -28,17 +31,16 @@ bool LevelFilter::IsAll()
 	return false;
 }
 
-Map<int32, SongSelectIndex> FolderFilter::GetFiltered(const Map<int32, SongSelectIndex>& source)
+void FolderFilter::Filter(const Vector<SongSelectEntry>& source, Vector<SongSelectEntry>& out)
 {
 	Map<int32, MapIndex*> maps = m_mapDatabase->FindMapsByFolder(m_folder);
 
-	Map<int32, SongSelectIndex> filtered;
-	for (auto m : maps)
+	out.clear();
+	for (const SongSelectEntry& entry : source)
 	{
-		SongSelectIndex index(m.second);
-		filtered.Add(index.id, index);
+		if (maps.Contains(entry.map->id))
+			out.Add(entry);
 	}
-	return filtered;
 }
 
 String FolderFilter::GetName()
@@ -16,7 +16,8 @@ public:
 	SongFilter() = default;
 	~SongFilter() = default;
 
-	virtual Map<int32, SongSelectIndex> GetFiltered(const Map<int32, SongSelectIndex>& source) { return source; }
+	// Filters a list of entries sorted by id, the output stays sorted
+	virtual void Filter(const Vector<SongSelectEntry>& source, Vector<SongSelectEntry>& out) { out = source; }
 	virtual String GetName() { return m_name; }
 	virtual bool IsAll() { return true; }
 	virtual FilterType GetType() { return FilterType::All; }
@@ -30,7 +31,7 @@ class LevelFilter : public SongFilter
 {
 public:
 	LevelFilter(uint16 level) : m_level(level) {}
-	virtual Map<int32, SongSelectIndex> GetFiltered(const Map<int32, SongSelectIndex>& source) override;
+	virtual void Filter(const Vector<SongSelectEntry>& source, Vector<SongSelectEntry>& out) override;
 	virtual String GetName() override;
 	virtual bool IsAll() override;
 	virtual FilterType GetType() { return FilterType::Level; }
@@ -44,7 +45,7 @@ class FolderFilter : public SongFilter
 {
 public:
 	FolderFilter(String folder, MapDatabase* database) : m_folder(folder), m_mapDatabase(database) {}
-	virtual Map<int32, SongSelectIndex> GetFiltered(const Map<int32, SongSelectIndex>& source);
+	virtual void Filter(const Vector<SongSelectEntry>& source, Vector<SongSelectEntry>& out) override;
 	virtual String GetName() override;
 	virtual bool IsAll() override;
 	virtual FilterType GetType() { return FilterType::Folder; }
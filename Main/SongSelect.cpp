@@ -95,15 +95,95 @@ private:
 };
 const float PreviewPlayer::m_fadeDuration = 0.5f;
 
+/*
+	Opens a preview stream and seeks to the preview offset on a job thread
+	opening a stream can take a while, mp3 streams are indexed when they are opened
+*/
+class PreviewLoadingJob : public JobBase
+{
+public:
+	virtual bool Run() override
+	{
+		// Skip requests that were superseded before they started
+		if(cancelled)
+			return false;
+		stream = g_audio->CreateStream(path);
+		if(!stream)
+			return false;
+		stream->SetPosition(offset);
+		return true;
+	}
+
+	String path;
+	MapTime offset = 0;
+	AudioStream stream;
+	std::atomic<bool> cancelled = { false };
+};
+
+/*
+	Loads preview streams without blocking the main thread
+	only the latest request is handed out, starting a new one cancels the previous one
+*/
+class PreviewLoader
+{
+public:
+	~PreviewLoader()
+	{
+		Cancel();
+	}
+	void Load(const String& path, MapTime offset)
+	{
+		Cancel();
+		m_request = new PreviewLoadingJob();
+		m_request->path = path;
+		m_request->offset = offset;
+		m_request->jobFlags = JobFlags::IO;
+		// Shares the IO lane with the jacket jobs, the preview of the selected map shouldn't wait for every jacket in view
+		m_request->priority = JobPriority::High;
+		m_job = Job(m_request);
+		g_jobSheduler->Queue(m_job);
+	}
+	void Cancel()
+	{
+		if(m_job)
+		{
+			// The job can't be waited for without blocking, so it is only flagged and it's stream is discarded when it finishes
+			m_request->cancelled = true;
+			m_job.Release();
+			m_request = nullptr;
+		}
+	}
+	// Returns true when the requested stream is ready to play or failed to open, in which case the stream is invalid
+	bool Update(AudioStream& stream)
+	{
+		if(!m_job || !m_job->IsFinished())
+			return false;
+		stream = m_request->stream;
+		m_request->stream.Release();
+		m_job.Release();
+		m_request = nullptr;
+		return true;
+	}
+
+private:
+	Job m_job;
+	PreviewLoadingJob* m_request = nullptr;
+};
+
 /*
 	Song selection wheel
 */
 class SelectionWheel : public Canvas
 {
-	// keyed on SongSelectIndex::id
+	// Visible items keyed on SongSelectIndex::id
 	Map<int32, Ref<SongSelectItem>> m_guiElements;
-	Map<int32, SongSelectIndex> m_maps;
-	Map<int32, SongSelectIndex> m_mapFilter;
+	// Items that went out of view, reused for newly visible maps
+	Vector<Ref<SongSelectItem>> m_itemPool;
+
+	// All maps, sorted by id
+	Vector<SongSelectEntry> m_maps;
+	// Filtered view of the maps, sorted by id
+	Vector<SongSelectEntry> m_mapFilter;
 	bool m_filterSet = false;
 
 	// Currently selected map ID
@@ -117,41 +197,61 @@ class SelectionWheel : public Canvas
 	// Style to use for everything song select related
 	Ref<SongSelectStyle> m_style;
 
+	// Number of items shown on each side of the selected item
+	static const int32 m_numVisibleItems = 10;
+
 public:
 	SelectionWheel(Ref<SongSelectStyle> style) : m_style(style)
 	{
 	}
 	void OnMapsAdded(Vector<MapIndex*> maps)
 	{
+		size_t oldSize = m_maps.size();
 		for(auto m : maps)
 		{
-			SongSelectIndex index(m);
-			m_maps.Add(index.id, index);
+			m_maps.Add(SongSelectEntry(m));
 		}
+
+		// Keep the list sorted without resorting the existing part
+		auto middle = m_maps.begin() + oldSize;
+		std::sort(middle, m_maps.end(), &SelectionWheel::m_CompareEntries);
+		std::inplace_merge(m_maps.begin(), middle, m_maps.end(), &SelectionWheel::m_CompareEntries);
+
+		SongSelectItem::PreloadGlyphs(maps);
 		if(!m_currentSelection)
 			AdvanceSelection(0);
 	}
 	void OnMapsRemoved(Vector<MapIndex*> maps)
 	{
+		Set<int32> removedIds;
 		for(auto m : maps)
 		{
-			// TODO(local): don't hard-code the id calc here, maybe make it a utility function?
-			SongSelectIndex index = m_maps.at(m->id * 10);
-			m_maps.erase(index.id);
+			removedIds.Add(m->id);
+		}
+		auto isRemoved = [&](const SongSelectEntry& entry)
+		{
+			return removedIds.Contains(entry.map->id);
+		};
+		m_maps.erase(std::remove_if(m_maps.begin(), m_maps.end(), isRemoved), m_maps.end());
+		m_mapFilter.erase(std::remove_if(m_mapFilter.begin(), m_mapFilter.end(), isRemoved), m_mapFilter.end());
 
-			auto it = m_guiElements.find(index.id);
-			if(it != m_guiElements.end())
+		// TODO(local): don't hard-code the id calc here, maybe make it a utility function?
+		for(auto it = m_guiElements.begin(); it != m_guiElements.end();)
+		{
+			if(removedIds.Contains(it->first / 10))
 			{
 				// Clear selection if a removed item was selected
 				if(m_currentSelection == it->second)
 					m_currentSelection.Release();
 
 				// Remove this item from the canvas that displays the items
-				Remove(it->second.As<GUIElementBase>());
-				m_guiElements.erase(it);
+				m_RecycleGUIElement(it->second);
+				it = m_guiElements.erase(it);
+				continue;
 			}
+			it++;
 		}
-		if(!m_maps.Contains(m_currentlySelectedId))
+		if(m_FindPosition(m_currentlySelectedId) < 0)
 		{
 			AdvanceSelection(1);
 		}
@@ -160,13 +260,16 @@ public:
 	{
 		for(auto m : maps)
 		{
-			// TODO(local): don't hard-code the id calc here, maybe make it a utility function?
-			SongSelectIndex index = m_maps.at(m->id * 10);
-
-			auto it = m_guiElements.find(index.id);
-			if(it != m_guiElements.end())
+			for(auto& g : m_guiElements)
 			{
-				it->second->SetIndex(index.GetMap());
+				if(g.first / 10 != m->id)
+					continue;
+				int32 position = m_FindPosition(g.first);
+				if(position < 0)
+					continue;
+				const SongSelectEntry& entry = m_SourceCollection()[position];
+				if(entry.difficulty < (int32)m->difficulties.size())
+					g.second->SetIndex(entry.GetIndex());
 			}
 		}
 	}
@@ -175,17 +278,21 @@ public:
 		m_currentSelection.Release();
 		for(auto g : m_guiElements)
 		{
-			Remove(g.second.As<GUIElementBase>());
+			m_RecycleGUIElement(g.second);
 		}
 		m_guiElements.clear();
 		m_filterSet = false;
 		m_mapFilter.clear();
 		m_maps.clear();
+		m_maps.reserve(newList.size());
+		Vector<MapIndex*> newMaps;
 		for (auto m : newList)
 		{
-			SongSelectIndex index(m.second);
-			m_maps.Add(index.id, index);
+			// Map is ordered by id already
+			m_maps.Add(SongSelectEntry(m.second));
+			newMaps.Add(m.second);
 		}
+		SongSelectItem::PreloadGlyphs(newMaps);
 		if(m_maps.size() > 0)
 		{
 			// Doing this here, before applying filters, causes our wheel to go
@@ -200,95 +307,80 @@ public:
 		if(m_SourceCollection().empty())
 			return;
 		uint32 selection = Random::IntRange(0, (int32)m_SourceCollection().size() - 1);
-		auto it = m_SourceCollection().begin();
-		std::advance(it, selection);
-		SelectMap(it->first);
+		SelectMap(m_SourceCollection()[selection].GetId());
 	}
 	void SelectMap(int32 newIndex)
 	{
 		Set<int32> visibleIndices;
 		auto& srcCollection = m_SourceCollection();
-		auto it = srcCollection.find(newIndex);
-		if(it != srcCollection.end())
+		int32 position = m_FindPosition(newIndex);
+		if(position >= 0)
 		{
 			const float initialSpacing = 0.65f * m_style->frameMain->GetSize().y;
 			const float spacing = 0.8f * m_style->frameSub->GetSize().y;
 			const Anchor anchor = Anchor(0.0f, 0.5f, 1.0f, 0.5f);
 
-			static const int32 numItems = 10;
-
-			int32 istart;
-			for(istart = 0; istart > -numItems;)
+			// Only items in the visible window get a GUI element
+			int32 istart = Math::Max(-m_numVisibleItems, -position);
+			int32 iend = Math::Min(m_numVisibleItems, (int32)srcCollection.size() - 1 - position);
+			for(int32 i = istart; i <= iend; i++)
 			{
-				if(it == srcCollection.begin())
-					break;
-				it--;
-				istart--;
-			}
+				const SongSelectEntry& entry = srcCollection[position + i];
+				int32 id = entry.GetId();
 
-			for(int32 i = istart; i <= numItems; i++)
-			{
-				if(it != srcCollection.end())
-				{
-					SongSelectIndex index = it->second;
-					int32 id = index.id;
-
-					visibleIndices.Add(id);
+				visibleIndices.Add(id);
 
-					// Add a new map slot
-					bool newItem = m_guiElements.find(id) == m_guiElements.end();
-					Ref<SongSelectItem> item = m_GetMapGUIElement(index);
-					float offset = 0;
-					if(i != 0)
-					{
-						offset = initialSpacing * Math::Sign(i) +
-							spacing * (i - Math::Sign(i));
-					}
-					Canvas::Slot* slot = Add(item.As<GUIElementBase>());
-
-					int32 z = -abs(i);
-					slot->SetZOrder(z);
+				// Add a new map slot
+				bool newItem = m_guiElements.find(id) == m_guiElements.end();
+				Ref<SongSelectItem> item = m_GetMapGUIElement(entry);
+				float offset = 0;
+				if(i != 0)
+				{
+					offset = initialSpacing * Math::Sign(i) +
+						spacing * (i - Math::Sign(i));
+				}
+				Canvas::Slot* slot = Add(item.As<GUIElementBase>());
 
-					slot->anchor = anchor;
-					slot->autoSizeX = true;
-					slot->autoSizeY = true;
-					slot->alignment = Vector2(0, 0.5f);
-					if(newItem)
-					{
-						// Hard set target position
-						slot->offset.pos = Vector2(0, offset);
-						slot->offset.size.x = z * 50.0f;
-					}
-					else
-					{
-						// Animate towards target position
-						item->AddAnimation(Ref<IGUIAnimation>(
-							new GUIAnimation<Vector2>(&slot->offset.pos, Vector2(0, offset), 0.1f)), true);
-						item->AddAnimation(Ref<IGUIAnimation>(
-							new GUIAnimation<float>(&slot->offset.size.x, z * 50.0f, 0.1f)), true);
-					}
+				int32 z = -abs(i);
+				slot->SetZOrder(z);
 
-					item->fade = 1.0f - ((float)abs(i) / (float)numItems);
-					item->innerOffset = item->fade * 100.0f;
+				slot->anchor = anchor;
+				slot->autoSizeX = true;
+				slot->autoSizeY = true;
+				slot->alignment = Vector2(0, 0.5f);
+				if(newItem)
+				{
+					// Hard set target position
+					slot->offset.pos = Vector2(0, offset);
+					slot->offset.size.x = z * 50.0f;
+				}
+				else
+				{
+					// Animate towards target position
+					item->AddAnimation(Ref<IGUIAnimation>(
+						new GUIAnimation<Vector2>(&slot->offset.pos, Vector2(0, offset), 0.1f)), true);
+					item->AddAnimation(Ref<IGUIAnimation>(
+						new GUIAnimation<float>(&slot->offset.size.x, z * 50.0f, 0.1f)), true);
+				}
 
-					if(i == 0)
-					{
-						m_currentlySelectedId = newIndex;
-						m_OnMapSelected(index);
-					}
+				item->fade = 1.0f - ((float)abs(i) / (float)m_numVisibleItems);
+				item->innerOffset = item->fade * 100.0f;
 
-					it++;
+				if(i == 0)
+				{
+					m_currentlySelectedId = newIndex;
+					m_OnMapSelected(entry);
 				}
 			}
 		}
 		m_currentlySelectedId = newIndex;
 
-		// Cleanup invisible elements
+		// Recycle elements that went out of view
 		for(auto it = m_guiElements.begin(); it != m_guiElements.end();)
 		{
 			if(!visibleIndices.Contains(it->first))
 			{
-				Remove(it->second.As<GUIElementBase>());
+				m_RecycleGUIElement(it->second);
 				it = m_guiElements.erase(it);
 				continue;
 			}
@@ -298,57 +390,44 @@ public:
 	void AdvanceSelection(int32 offset)
 	{
 		auto& srcCollection = m_SourceCollection();
-		auto it = srcCollection.find(m_currentlySelectedId);
-		if(it == srcCollection.end())
+		int32 position = m_FindPosition(m_currentlySelectedId);
+		if(position < 0)
 		{
 			if(srcCollection.empty())
 			{
 				// Remove all elements, empty
 				m_currentSelection.Release();
-				Clear();
+				for(auto g : m_guiElements)
+				{
+					m_RecycleGUIElement(g.second);
+				}
 				m_guiElements.clear();
 				return;
 			}
-			it = srcCollection.begin();
-		}
-		for(uint32 i = 0; i < (uint32)abs(offset); i++)
-		{
-			auto itn = it;
-			if(offset < 0)
-			{
-				if(itn == srcCollection.begin())
-					break;
-				itn--;
-			}
-			else
-				itn++;
-			if(itn == srcCollection.end())
-				break;
-			it = itn;
-		}
-		if(it != srcCollection.end())
-		{
-			SelectMap(it->first);
+			position = 0;
 		}
+		position = Math::Clamp(position + offset, 0, (int32)srcCollection.size() - 1);
+		SelectMap(srcCollection[position].GetId());
 	}
 	void SelectDifficulty(int32 newDiff)
 	{
 		m_currentSelection->SetSelectedDifficulty(newDiff);
 		m_currentlySelectedDiff = newDiff;
 
-		Map<int32, SongSelectIndex> maps = m_SourceCollection();
-		SongSelectIndex* map = maps.Find(m_currentlySelectedId);
-		if(map)
+		DifficultyIndex* diff = GetSelectedDifficulty();
+		if(diff)
 		{
-			OnDifficultySelected.Call(map[0].GetDifficulties()[m_currentlySelectedDiff]);
+			OnDifficultySelected.Call(diff);
 		}
 	}
 	void AdvanceDifficultySelection(int32 offset)
 	{
 		if(!m_currentSelection)
 			return;
-		Map<int32, SongSelectIndex> maps = m_SourceCollection();
-		SongSelectIndex map = maps[m_currentlySelectedId];
+		int32 position = m_FindPosition(m_currentlySelectedId);
+		if(position < 0)
+			return;
+		SongSelectIndex map = m_SourceCollection()[position].GetIndex();
 		int32 newIdx = m_currentlySelectedDiff + offset;
 		newIdx = Math::Clamp(newIdx, 0, (int32)map.GetDifficulties().size() - 1);
 		SelectDifficulty(newIdx);
@@ -362,26 +441,29 @@ public:
 	void SetFilter(Map<int32, MapIndex *> filter)
 	{
 		m_mapFilter.clear();
+		m_mapFilter.reserve(filter.size());
 		for (auto m : filter)
 		{
-			SongSelectIndex index(m.second);
-			m_mapFilter.Add(index.id, index);
+			m_mapFilter.Add(SongSelectEntry(m.second));
 		}
 		m_filterSet = true;
 		AdvanceSelection(0);
 	}
 	void SetFilter(SongFilter* filter[2])
 	{
+		// Filters produce views on the full map list, filters that include everything are skipped
 		bool isFiltered = false;
-		m_mapFilter = m_maps;
+		Vector<SongSelectEntry> filtered;
 		for (size_t i = 0; i < 2; i++)
 		{
-			if (!filter[i])
+			if (!filter[i] || filter[i]->IsAll())
 				continue;
-			m_mapFilter = filter[i]->GetFiltered(m_mapFilter);
-			if (!filter[i]->IsAll())
-				isFiltered = true;
+			filter[i]->Filter(isFiltered ? m_mapFilter : m_maps, filtered);
+			m_mapFilter.swap(filtered);
+			isFiltered = true;
 		}
+		if (!isFiltered)
+			m_mapFilter.clear();
 		m_filterSet = isFiltered;
 		AdvanceSelection(0);
 	}
@@ -396,51 +478,89 @@ public:
 
 	MapIndex* GetSelection() const
 	{
-		SongSelectIndex const* map = m_SourceCollection().Find(m_currentlySelectedId);
-		if(map)
-			return map->GetMap();
+		int32 position = m_FindPosition(m_currentlySelectedId);
+		if(position >= 0)
+			return m_SourceCollection()[position].map;
 		return nullptr;
 	}
 	DifficultyIndex* GetSelectedDifficulty() const
 	{
-		SongSelectIndex const* map = m_SourceCollection().Find(m_currentlySelectedId);
-		if(map)
-			return map->GetDifficulties()[m_currentlySelectedDiff];
-		return nullptr;
+		int32 position = m_FindPosition(m_currentlySelectedId);
+		if(position < 0)
+			return nullptr;
+		const SongSelectEntry& entry = m_SourceCollection()[position];
+		if(entry.difficulty >= 0)
+			return entry.map->difficulties[entry.difficulty];
+		return entry.map->difficulties[m_currentlySelectedDiff];
 	}
 
 private:
-	const Map<int32, SongSelectIndex>& m_SourceCollection() const
+	static bool m_CompareEntries(const SongSelectEntry& l, const SongSelectEntry& r)
+	{
+		return l.GetId() < r.GetId();
+	}
+	const Vector<SongSelectEntry>& m_SourceCollection() const
 	{
 		return m_filterSet ? m_mapFilter : m_maps;
 	}
-	Ref<SongSelectItem> m_GetMapGUIElement(SongSelectIndex index)
+	// Position of an id in the current source collection or -1 if not found
+	int32 m_FindPosition(int32 id) const
 	{
-		auto it = m_guiElements.find(index.id);
+		auto& srcCollection = m_SourceCollection();
+		auto it = std::lower_bound(srcCollection.begin(), srcCollection.end(), id,
+			[](const SongSelectEntry& entry, int32 id)
+		{
+			return entry.GetId() < id;
+		});
+		if(it == srcCollection.end() || it->GetId() != id)
+			return -1;
+		return (int32)(it - srcCollection.begin());
+	}
+	Ref<SongSelectItem> m_GetMapGUIElement(const SongSelectEntry& entry)
+	{
+		int32 id = entry.GetId();
+		auto it = m_guiElements.find(id);
 		if(it != m_guiElements.end())
 			return it->second;
 
-		Ref<SongSelectItem> newItem = Ref<SongSelectItem>(new SongSelectItem(m_style));
+		Ref<SongSelectItem> newItem;
+		if(!m_itemPool.empty())
+		{
+			newItem = m_itemPool.back();
+			m_itemPool.pop_back();
+		}
+		else
+		{
+			newItem = Ref<SongSelectItem>(new SongSelectItem(m_style));
+		}
 
-		// Send first map as metadata settings
-		const BeatmapSettings& firstSettings = index.GetDifficulties()[0]->settings;
-		newItem->SetIndex(index);
-		m_guiElements.Add(index.id, newItem);
+		newItem->SetIndex(entry.GetIndex());
+		m_guiElements.Add(id, newItem);
 		return newItem;
 	}
+	// Removes an item from the wheel and keeps it for reuse
+	void m_RecycleGUIElement(Ref<SongSelectItem> item)
+	{
+		Remove(item.As<GUIElementBase>());
+		// Animations target the removed slot
+		item->ClearAnimations();
+		item->SwitchCompact(true);
+		m_itemPool.Add(item);
+	}
 	// TODO(local): pretty sure this should be m_OnIndexSelected, and we should filter a call to OnMapSelected
-	void m_OnMapSelected(SongSelectIndex index)
+	void m_OnMapSelected(const SongSelectEntry& entry)
 	{
 		// Update compact mode selection views
 		if(m_currentSelection)
 			m_currentSelection->SwitchCompact(true);
-		m_currentSelection = m_guiElements[index.id];
+		m_currentSelection = m_guiElements[entry.GetId()];
 		m_currentSelection->SwitchCompact(false);
 
 		//if(map && map->id == m_currentlySelectedId)
 		//	return;
 
 		// Clamp diff selection
+		SongSelectIndex index = entry.GetIndex();
 		int32 selectDiff = m_currentlySelectedDiff;
 		if(m_currentlySelectedDiff >= (int32)index.GetDifficulties().size())
 		{
@@ -581,9 +701,8 @@ public:
 		m_mapDB = db;
 		for (String p : Path::GetSubDirs(g_gameConfig.GetString(GameConfigKeys::SongFolder)))
 		{
-			SongFilter* filter = new FolderFilter(p, m_mapDB);
-			if(filter->GetFiltered(Map<int32, SongSelectIndex>()).size() > 0)
-				AddFilter(filter, FilterType::Folder);
+			if(m_mapDB->FindMapsByFolder(p).size() > 0)
+				AddFilter(new FolderFilter(p, m_mapDB), FilterType::Folder);
 		}
 	}
 
@@ -742,12 +861,17 @@ private:
 	
 	Ref<Label> m_filterStatus;
 
+	// Shows GUI draw calls and text rendering time, toggled with F8
+	Ref<Label> m_renderStats;
+
 	// Score list canvas
 	Ref<Canvas> m_scoreCanvas;
 	Ref<LayoutBox> m_scoreList;
 
 	// Player of preview music
 	PreviewPlayer m_previewPlayer;
+	PreviewLoader m_previewLoader;
+	String m_previewPath;
 
 	// Current map that has music being preview played
 	MapIndex* m_currentPreviewAudio;
@@ -865,6 +989,15 @@ public:
 		}
 		m_filterSelection->SetMapDB(&m_mapDatabase);
 
+		{
+			m_renderStats = Ref<Label>(new Label());
+			m_renderStats->visibility = Visibility::Collapsed;
+			Canvas::Slot* slot = m_canvas->Add(m_renderStats->MakeShared());
+			slot->anchor = Anchor(0.0f, 0.0f);
+			slot->autoSizeX = true;
+			slot->autoSizeY = true;
+		}
+
 		// Select interface sound
 		m_selectSound = g_audio->CreateSample("audio/menu_click.wav");
 
@@ -886,6 +1019,8 @@ public:
 	}
 	~SongSelect_Impl()
 	{
+		SongSelectItem::CancelPreloads();
+
 		// Clear callbacks
 		m_mapDatabase.OnMapsCleared.Clear();
 		g_input.OnButtonPressed.RemoveAll(this);
@@ -901,19 +1036,10 @@ public:
 			}else if (!m_previewLoaded){
 				// Set current preview audio
 				DifficultyIndex* previewDiff = m_currentPreviewAudio->difficulties[0];
-				String audioPath = m_currentPreviewAudio->path + Path::sep + previewDiff->settings.audioNoFX;
+				m_previewPath = m_currentPreviewAudio->path + Path::sep + previewDiff->settings.audioNoFX;
 
-				AudioStream previewAudio = g_audio->CreateStream(audioPath);
-				if (previewAudio)
-				{
-					previewAudio->SetPosition(previewDiff->settings.previewOffset);
-					m_previewPlayer.FadeTo(previewAudio);
-				}
-				else
-				{
-					Logf("Failed to load preview audio from [%s]", Logger::Warning, audioPath);
-					m_previewPlayer.FadeTo(AudioStream());
-				}
+				// Faded in once it's ready
+				m_previewLoader.Load(m_previewPath, previewDiff->settings.previewOffset);
 				m_previewLoaded = true;
 				// m_previewPlayer.Restore();
 			}
@@ -922,6 +1048,7 @@ public:
 			m_previewDelayTicks = 15;
 			m_currentPreviewAudio = map;
 			m_previewLoaded = false;
+			m_previewLoader.Cancel();
 		}
 	}
 	// When a difficulty is selected in the song wheel
@@ -1231,6 +1358,11 @@ public:
 			{
 				m_selectionWheel->SelectRandom();
 			}
+			else if (key == SDLK_F8)
+			{
+				bool show = m_renderStats->visibility != Visibility::Visible;
+				m_renderStats->visibility = show ? Visibility::Visible : Visibility::Collapsed;
+			}
 			else if (key == SDLK_ESCAPE)
 			{
 				m_suspended = true;
@@ -1259,10 +1391,27 @@ public:
         
 		m_filterStatus->SetText(Utility::ConvertToWString(m_filterSelection->GetStatusText()));
 
+		if(m_renderStats->visibility == Visibility::Visible)
+		{
+			const GUIRenderStats& stats = g_guiRenderer->GetLastFrameStats();
+			FontRes::TextCacheStats textStats = FontRes::GetTextCacheStats();
+			m_renderStats->SetText(Utility::WSprintf(L"Draw Calls: %d (%d batched)\nText: %d in %.3f ms\nText Cache: %d hits, %d misses, %d evicted",
+				stats.drawCalls, stats.batchedDrawCalls, stats.textCount, stats.textTime,
+				(uint32)textStats.hits, (uint32)textStats.misses, (uint32)textStats.evictions));
+		}
+
         // Tick navigation
 		if (!IsSuspended())
 		{
 			TickNavigation(deltaTime);
+
+			AudioStream previewAudio;
+			if(m_previewLoader.Update(previewAudio))
+			{
+				if(!previewAudio)
+					Logf("Failed to load preview audio from [%s]", Logger::Warning, m_previewPath);
+				m_previewPlayer.FadeTo(previewAudio);
+			}
 			m_previewPlayer.Update(deltaTime);
 
 			// Ugly hack to get previews working with the delaty
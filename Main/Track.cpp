@@ -40,7 +40,7 @@ Track::~Track()
 }
 bool Track::AsyncLoad()
 {
-	loader = new AsyncAssetLoader();
+	loader = new AsyncAssetLoader(parentLoader);
 	String skin = g_gameConfig.GetString(GameConfigKeys::Skin);
 	// Load laser colors
 
@@ -202,6 +202,10 @@ bool Track::AsyncFinalize()
 		m_laserTrackBuilder[i]->Reset(); // Also initializes the track builder
 	}
 
+	// Laser geometry is replaced every frame
+	m_laserMesh = MeshRes::Create(g_gl);
+	m_laserMesh->SetPrimitiveType(PrimitiveType::TriangleList);
+
 	// Generate simple planes for the playfield track and elements
 	trackMesh = MeshGenerators::Quad(g_gl, Vector2(-trackWidth * 0.5f, -trackLength), Vector2(trackWidth, trackLength * 2));
 	trackDarkMesh = MeshGenerators::Quad(g_gl, Vector2(-trackWidth, -trackLength), Vector2(trackWidth * 2, trackLength));
@@ -316,6 +320,8 @@ void Track::Tick(class BeatmapPlayback& playback, float deltaTime)
 
 void Track::DrawLaserBase(RenderQueue& rq, class BeatmapPlayback& playback, const Vector<ObjectState*>& objects)
 {
+	// The base is the first range in the laser geometry of this frame
+	m_laserVertices.clear();
 	for (auto obj : objects)
 	{
 		if (obj->type != ObjectType::Laser)
@@ -325,26 +331,43 @@ void Track::DrawLaserBase(RenderQueue& rq, class BeatmapPlayback& playback, cons
 		if ((laser->flags & LaserObjectState::flag_Extended) != 0 || m_trackHide > 0.f)
 		{
 			// Calculate height based on time on current track
-			float viewRange = trackViewRange.y - trackViewRange.x;
 			float position = playback.TimeToViewDistance(obj->time);
 			float posmult = trackLength / (m_viewRange * laserSpeedOffset);
 
-			Mesh laserMesh = m_laserTrackBuilder[laser->index]->GenerateTrackMesh(playback, laser);
-
-			MaterialParameterSet laserParams;
-			laserParams.SetParameter("mainTex", laserTexture);
+			// Position of this laser segment, with a small amount of elevation
+			Vector3 offset = Vector3{ 0.0f, posmult * position, 0.007f + 0.003f * laser->index };
+			m_laserTrackBuilder[laser->index]->GenerateSegment(playback, laser, LaserSegmentPart::Body, offset, 0.0f, 0, m_laserVertices);
+		}
+	}
 
-			// Get the length of this laser segment
-			Transform laserTransform = trackOrigin;
-			laserTransform *= Transform::Translation(Vector3{ 0.0f, posmult * position,
-				0.007f + 0.003f * laser->index }); // Small amount of elevation
+	// Vertices are uploaded by DrawLasers before the queue is processed
+	MaterialParameterSet laserParams;
+	laserParams.SetParameter("mainTex", laserTexture);
+	rq.DrawRange(trackOrigin, m_laserMesh, 0, (uint32)m_laserVertices.size(), blackLaserMaterial, laserParams);
+}
+void Track::DrawLasers(RenderQueue& rq)
+{
+	// Put both sides after the base in the same buffer
+	uint32 sideStart[2];
+	for(uint32 i = 0; i < 2; i++)
+	{
+		sideStart[i] = (uint32)m_laserVertices.size();
+		m_laserVertices.insert(m_laserVertices.end(), m_laserSideVertices[i].begin(), m_laserSideVertices[i].end());
+	}
+	if(!m_laserVertices.empty())
+		m_laserMesh->SetData(m_laserVertices);
 
-			if (laserMesh)
-			{
-				rq.Draw(laserTransform, laserMesh, blackLaserMaterial, laserParams);
-			}
-		}
+	for(uint32 i = 0; i < 2; i++)
+	{
+		MaterialParameterSet laserParams;
+		laserParams.SetParameter("mainTex", laserTexture);
+		laserParams.SetParameter("entryTex", laserTailTextures[0]);
+		laserParams.SetParameter("exitTex", laserTailTextures[1]);
+		laserParams.SetParameter("color", laserColors[i]);
+		rq.DrawRange(trackOrigin, m_laserMesh, sideStart[i], (uint32)m_laserSideVertices[i].size(), laserMaterial, laserParams);
+		m_laserSideVertices[i].clear();
 	}
+	m_laserVertices.clear();
 }
 
 void Track::DrawBase(class RenderQueue& rq)
@@ -437,55 +460,37 @@ void Track::DrawObjectState(RenderQueue& rq, class BeatmapPlayback& playback, Ob
 		float posmult = trackLength / (m_viewRange * laserSpeedOffset);
 		LaserObjectState* laser = (LaserObjectState*)obj;
 
-		// Draw segment function
-		auto DrawSegment = [&](Mesh mesh, Texture texture)
+		// Make not yet hittable lasers slightly glowing
+		float laserGlow;
+		int32 hitState;
+		if ((laser->GetRoot()->time + Scoring::goodHitTime) > playback.GetLastTime())
 		{
-			MaterialParameterSet laserParams;
-
-			// Make not yet hittable lasers slightly glowing
-			if ((laser->GetRoot()->time + Scoring::goodHitTime) > playback.GetLastTime())
-			{
-				laserParams.SetParameter("objectGlow", 0.2f);
-				laserParams.SetParameter("hitState", 1);
-			}
-			else
-			{
-				laserParams.SetParameter("objectGlow", active ? objectGlow : 0.0f);
-				laserParams.SetParameter("hitState", active ? 2 + objectGlowState : 0);
-			}
-			laserParams.SetParameter("mainTex", texture);
-
-			// Get the length of this laser segment
-			Transform laserTransform = trackOrigin;
-			laserTransform *= Transform::Translation(Vector3{ 0.0f, posmult * position,
-				0.007f + 0.003f * laser->index }); // Small amount of elevation
-
-			// Set laser color
-			laserParams.SetParameter("color", laserColors[laser->index]);
-
-			if(mesh)
-			{
-				rq.Draw(laserTransform, mesh, laserMaterial, laserParams);
-			}
-		};
+			laserGlow = 0.2f;
+			hitState = 1;
+		}
+		else
+		{
+			laserGlow = active ? objectGlow : 0.0f;
+			hitState = active ? 2 + objectGlowState : 0;
+		}
+
+		// Position of this laser segment, with a small amount of elevation
+		Vector3 offset = Vector3{ 0.0f, posmult * position, 0.007f + 0.003f * laser->index };
+
+		// Segments are added to the geometry of this side and drawn together by DrawLasers
+		LaserTrackBuilder* builder = m_laserTrackBuilder[laser->index];
+		Vector<LaserVertex>& verts = m_laserSideVertices[laser->index];
 
 		// Draw entry?
 		if(!laser->prev)
-		{
-			Mesh laserTail = m_laserTrackBuilder[laser->index]->GenerateTrackEntry(playback, laser);
-			DrawSegment(laserTail, laserTailTextures[0]);
-		}
+			builder->GenerateSegment(playback, laser, LaserSegmentPart::Entry, offset, laserGlow, hitState, verts);
 
 		// Body
-		Mesh laserMesh = m_laserTrackBuilder[laser->index]->GenerateTrackMesh(playback, laser);
-		DrawSegment(laserMesh, laserTexture);
+		builder->GenerateSegment(playback, laser, LaserSegmentPart::Body, offset, laserGlow, hitState, verts);
 
 		// Draw exit?
 		if(!laser->next && (laser->flags & LaserObjectState::flag_Instant) != 0) // Only draw exit on slams
-		{
-			Mesh laserTail = m_laserTrackBuilder[laser->index]->GenerateTrackExit(playback, laser);
-			DrawSegment(laserTail, laserTailTextures[1]);
-		}
+			builder->GenerateSegment(playback, laser, LaserSegmentPart::Exit, offset, laserGlow, hitState, verts);
 	}
 }
 void Track::DrawOverlays(class RenderQueue& rq)
@@ -552,29 +557,29 @@ void Track::DrawCombo(RenderQueue& rq, uint32 score, Color color, float scale)
 {
 	if(score == 0)
 		return;
-	Vector<Mesh> meshes;
+	// Digits from least to most significant, a uint32 has at most 10 digits
+	uint32 digits[10];
+	uint32 numDigits = 0;
 	while(score > 0)
 	{
-		uint32 c = score % 10;
-		meshes.Add(comboSpriteMeshes[c]);
-		score -= c;
+		digits[numDigits++] = score % 10;
 		score /= 10;
 	}
 	const float charWidth = trackWidth * 0.15f * scale;
 	const float seperation = charWidth * 0.7f;
-	float size = (float)(meshes.size()-1) * seperation;
+	float size = (float)(numDigits-1) * seperation;
 	float halfSize = size * 0.5f;
 
 	MaterialParameterSet params;
 	params.SetParameter("mainTex", comboSpriteSheet);
 	params.SetParameter("color", color);
-	for(uint32 i = 0; i < meshes.size(); i++)
+	for(uint32 i = 0; i < numDigits; i++)
 	{
-		float xpos = -halfSize + seperation * (meshes.size()-1-i);
+		float xpos = -halfSize + seperation * (numDigits-1-i);
 		Transform t = trackOrigin;
 		t *= Transform::Translation({ xpos, 0.3f, -0.004f});
 		t *= Transform::Scale({charWidth, charWidth, 1.0f});
-		rq.Draw(t, meshes[i], spriteMaterial, params);
+		rq.Draw(t, comboSpriteMeshes[digits[i]], spriteMaterial, params);
 	}
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 #include "Scoring.hpp"
 #include "AsyncLoadable.hpp"
+#include "LaserTrackBuilder.hpp"
 
 /*
 	The object responsible for drawing the track.
@@ -31,6 +32,8 @@ public:
 	Color hitColors[4] = {};
 
 	class AsyncAssetLoader* loader = nullptr;
+	// Loader that loads this track, the track's assets are reported to it
+	class AsyncAssetLoader* parentLoader = nullptr;
 
 public:
 	Track();
@@ -44,7 +47,10 @@ public:
 	// Just the board with tick lines
 	void DrawBase(RenderQueue& rq);
 	// Draws an object
+	//	lasers are added to the laser geometry, which is drawn by DrawLasers
 	void DrawObjectState(RenderQueue& rq, class BeatmapPlayback& playback, ObjectState* obj, bool active = false);
+	// Draws the lasers added by DrawObjectState with one draw call for each side, should be called once per frame after all objects are drawn
+	void DrawLasers(RenderQueue& rq);
 	// Things like the laser pointers, hit bar and effect
 	void DrawOverlays(RenderQueue& rq);
 	// Draws a plane over the track
@@ -141,6 +147,10 @@ public:
 private:
 	// Laser track generators
 	class LaserTrackBuilder* m_laserTrackBuilder[2] = { 0 };
+	// Laser geometry of the current frame, shared by the black laser base and both sides
+	Mesh m_laserMesh;
+	Vector<LaserVertex> m_laserVertices;
+	Vector<LaserVertex> m_laserSideVertices[2];
 
 	const TimingPoint* m_lastTimingPoint;
 
@@ -5,12 +5,23 @@
 #include <GUI/GUI.hpp>
 #include <GUI/Spinner.hpp>
 #include "AsyncLoadable.hpp"
+#include "AsyncAssetLoader.hpp"
+
+// Time spent finalizing loaded assets every frame, so the loading screen keeps animating
+static const double finalizeBudget = 0.004;
 
 class TransitionScreen_Impl : public TransitionScreen
 {
 	Ref<Canvas> m_loadingOverlay;
+	Canvas::Slot* m_progressSlot = nullptr;
 	IAsyncLoadableApplicationTickable* m_tickableToLoad;
 	Job m_loadingJob;
+	bool m_loadingDone = false;
+	bool m_loadingSuccessful = false;
+
+	// Loader of the tickable's assets, if it uses one
+	AsyncAssetLoader* m_assetLoader = nullptr;
+	float m_progress = 0.0f;
 
 	enum Transition
 	{
@@ -41,7 +52,11 @@ public:
 		
 		if(m_transition == In)
 		{
-
+			// Upload assets that finished loading while the rest is still loading
+			bool finalized = !m_assetLoader || m_assetLoader->FinalizeReady(finalizeBudget);
+			m_UpdateProgress();
+			if(m_loadingDone && finalized)
+				m_CompleteLoading();
 		}
 		else if(m_transition == Out)
 		{
@@ -74,6 +89,17 @@ public:
 		spinnerSlot->autoSizeY = true;
 		spinnerSlot->alignment = Vector2(1.0f, 1.0f);
 		spinnerSlot->SetZOrder(1);
+
+		// Progress bar along the bottom of the screen
+		Panel* progressBar = new Panel();
+		progressBar->color = Color(0.5f);
+		m_progressSlot = m_loadingOverlay->Add(progressBar->MakeShared());
+		m_progressSlot->anchor = Anchor(0.0f, 1.0f, 0.0f, 1.0f);
+		m_progressSlot->padding = Margin(0, -4, 0, 0);
+		m_progressSlot->SetZOrder(1);
+		IAsyncLoadable* loadable = dynamic_cast<IAsyncLoadable*>(m_tickableToLoad);
+		if(loadable)
+			m_assetLoader = loadable->GetAssetLoader();
 		
 		Canvas::Slot* slot = g_rootCanvas->Add(m_loadingOverlay.As<GUIElementBase>());
 		slot->anchor = Anchors::Full;
@@ -91,9 +117,18 @@ public:
 
 	void OnFinished(Job job)
 	{
+		// Completed once the loaded assets are finalized
+		m_loadingDone = true;
+		m_loadingSuccessful = job->IsSuccessfull();
+	}
+	void m_CompleteLoading()
+	{
+		// The loader is owned by the tickable, which is deleted if it failed
+		m_assetLoader = nullptr;
+
 		// Finalize?
 		IAsyncLoadable* loadable = dynamic_cast<IAsyncLoadable*>(m_tickableToLoad);
-		if(job->IsSuccessfull())
+		if(m_loadingSuccessful)
 		{
 			if(loadable && !loadable->AsyncFinalize())
 			{
@@ -119,6 +154,20 @@ public:
 		m_transition = Out;
 		m_transitionTimer = 0.0f;
 	}
+	void m_UpdateProgress()
+	{
+		// Loading and finalizing each count for half of an operation
+		if(m_assetLoader)
+		{
+			AsyncLoadProgress progress = m_assetLoader->GetProgress();
+			if(progress.numOperations > 0)
+			{
+				float done = (float)(progress.numLoaded + progress.numFinalized) / (float)(progress.numOperations * 2);
+				m_progress = Math::Max(m_progress, Math::Min(done, 1.0f));
+			}
+		}
+		m_progressSlot->anchor.right = m_progress;
+	}
 	bool DoLoad()
 	{
 		if(!m_tickableToLoad)
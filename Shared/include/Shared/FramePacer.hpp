@@ -0,0 +1,138 @@
+#pragma once
+#include "Shared/Unique.hpp"
+#include "Shared/Action.hpp"
+#include "Shared/Timer.hpp"
+
+/*
+	Time source used by the frame pacer, replaced by a simulated clock in tests
+*/
+class IFrameClock
+{
+public:
+	virtual ~IFrameClock() = default;
+	// Current time in seconds
+	virtual double GetTime() = 0;
+	// Sleeps for at least the given time in seconds, may wake up later than requested
+	virtual void Sleep(double seconds) = 0;
+	// Gives up the rest of the time slice while spinning
+	virtual void Relax() = 0;
+};
+
+// Clock that uses the high resolution clock and thread sleeps
+class SystemFrameClock : public IFrameClock
+{
+public:
+	virtual double GetTime() override;
+	virtual void Sleep(double seconds) override;
+	virtual void Relax() override;
+
+private:
+	Timer m_timer;
+};
+
+/*
+	Decides when frames are started and how many fixed simulation steps run in each frame
+	waits sleep in short slices until shortly before the deadline and spin for the rest,
+	the spin time adapts to how late the sleeps of the system wake up.
+	Frames are started early by the measured time it takes to render a frame,
+	and the buffer swap waits for the present deadline so frames are shown on a fixed cadence even when the render time varies
+
+	usage per frame:
+		WaitForFrame, BeginFrame, run the simulation steps, render, WaitForPresent, BeginPresent, swap buffers, EndPresent
+		or SkipPresent instead of the present steps when nothing is rendered
+*/
+class FramePacer : public Unique
+{
+public:
+	// Number of frames the timing statistics are calculated over
+	static const uint32 numSamples = 256;
+
+	// Uses the system clock
+	FramePacer();
+	// Uses the given clock, the clock needs to stay alive while the pacer is used
+	FramePacer(IFrameClock& clock);
+
+	// Rate at which frames are presented, 0 for unlimited
+	void SetTargetFrameRate(double framesPerSecond);
+	// Rate of the fixed simulation step, 0 to run a single step of the frame's duration every frame
+	void SetSimulationRate(double stepsPerSecond);
+	// Maximum number of simulation steps in a single frame, time over this limit is dropped
+	void SetMaxSimulationSteps(uint32 maxSteps);
+	// Longest time to sleep before calling the poll function again
+	void SetPollInterval(double seconds);
+
+	// Called in between sleeps while waiting for the next frame, returning false stops the wait
+	Action<bool> onPoll;
+
+	// Waits until the next frame should be started
+	//	returns false when the poll function returned false
+	bool WaitForFrame();
+	// Starts a new frame and returns the number of simulation steps to run this frame
+	uint32 BeginFrame();
+	// Waits until the frame should be presented
+	//	returns false when the poll function returned false
+	bool WaitForPresent();
+	// Call around the buffer swap to measure present timing
+	void BeginPresent();
+	void EndPresent();
+	// Call instead of presenting when a frame isn't shown, e.g. while minimized
+	//	keeps the cadence going so the next frame still waits for its turn
+	void SkipPresent();
+
+	// Time at which the current frame started
+	double GetFrameStartTime() const;
+	// Time between the start of the previous and current frame
+	float GetFrameDelta() const;
+	// Duration of a single simulation step
+	float GetSimulationStep() const;
+	// How far the frame is into the next simulation step [0,1], for interpolation
+	float GetSimulationAlpha() const;
+
+	// Time between presented frames at the given fraction of the recent frames sorted by duration, 0.5 = p50, 0.99 = p99
+	double GetFrameTimePercentile(float fraction) const;
+	// Time the buffer swap took, at the given fraction of the recent frames
+	double GetPresentTimePercentile(float fraction) const;
+	uint32 GetNumFrameSamples() const;
+	// Time before a deadline at which the pacer stops sleeping and starts spinning
+	double GetSpinMargin() const;
+
+private:
+	// Sleeps and spins until the given time
+	bool m_WaitUntil(double time);
+	// Moves the present deadline to the next frame
+	void m_AdvanceCadence(double now);
+	static double m_GetPercentile(const double* samples, uint32 numSamples, float fraction);
+
+	SystemFrameClock m_systemClock;
+	IFrameClock& m_clock;
+
+	double m_targetFrameTime = 0.0;
+	double m_simulationStep = 0.0;
+	uint32 m_maxSimulationSteps = 8;
+	double m_pollInterval = 0.001;
+
+	bool m_firstFrame = true;
+	double m_frameStart = 0.0;
+	double m_frameDelta = 0.0;
+	double m_simulationTime = 0.0;
+	// Time at which the next frame should be presented
+	double m_nextPresent = 0.0;
+	bool m_cadenceStarted = false;
+	// Measured time from the start of a frame until it is ready to be presented
+	double m_frameWork = 0.0;
+	// Measured time the buffer swap takes
+	double m_presentWork = 0.0;
+
+	double m_presentStart = 0.0;
+	double m_lastPresent = 0.0;
+	bool m_hasPresented = false;
+
+	// Average time sleeps wake up late
+	double m_sleepOvershoot = 0.0;
+	double m_spinMargin = 0.002;
+
+	double m_frameTimes[numSamples];
+	double m_presentTimes[numSamples];
+	uint32 m_numSamples = 0;
+	uint32 m_sampleIndex = 0;
+};
@@ -5,10 +5,14 @@
 #include "Shared/Unique.hpp"
 #include "Shared/Ref.hpp"
 #include "Shared/Delegate.hpp"
+#include "Shared/Vector.hpp"
+#include <atomic>
+#include <chrono>
+#include <functional>
 
 /*
 	Additional job flags,
-	this allows clustering IO operation onto the same thread as to not lock up the system
+	IO jobs run in a separate lane that limits how many of them run at the same time as to not lock up the system
 */
 enum class JobFlags : uint8
 {
@@ -18,6 +22,17 @@ enum class JobFlags : uint8
 JobFlags operator|(JobFlags a, JobFlags b);
 JobFlags operator&(JobFlags a, JobFlags b);
 
+/*
+	Order in which queued jobs are started, jobs with a higher priority are always started first
+*/
+enum class JobPriority : uint8
+{
+	Low = 0,
+	Normal,
+	High,
+	_Length
+};
+
 /*
 	A single task that gets completed by the JobSheduler
 	abstract
@@ -33,11 +48,13 @@ public:
 	bool IsQueued() const;
 
 	// Either cancel this job or wait till it finished if it is already being processed
+	//	a terminated job can not be queued again
 	void Terminate();
 	
 	// Flags for jobs
 	// make sure to add the IO flag if this job performs file operations
 	JobFlags jobFlags = JobFlags::None;
+	JobPriority priority = JobPriority::Normal;
 
 	// Performs the task to be done, returns success
 	virtual bool Run() = 0;
@@ -54,9 +71,23 @@ public:
 
 private:
 	bool m_ret = false;
-	bool m_finished = false;
+	std::atomic<bool> m_finished = { false };
+	std::atomic<bool> m_cancelled = { false };
+	// Set once Run has returned or the job was skipped, guarded by the sheduler's dependency lock
+	bool m_ran = false;
+	// Internal jobs are released by the job thread instead of being finalized on the main thread
+	bool m_internal = false;
 	class JobSheduler_Impl* m_sheduler = nullptr;
+
+	// Jobs that wait for this job to run, guarded by the sheduler's dependency lock
+	Vector<Ref<JobBase>> m_continuations;
+	// Number of dependencies that still need to run before this job can start
+	std::atomic<int32> m_numDependencies = { 0 };
+	// Time at which the job could start, used to measure the start latency
+	std::chrono::steady_clock::time_point m_readyTime;
+
 	friend class JobSheduler_Impl;
+	friend class JobSheduler;
 };
 
 /*
@@ -93,14 +124,29 @@ Job JobBase::CreateLambda(Lambda&& obj, Args... args)
 	return Ref<JobBase>(new LambdaJob<Lambda, Args...>(obj, args...));
 }
 
+// Timing statistics of the jobs started by a sheduler
+struct JobShedulerStats
+{
+	uint64 numJobsStarted = 0;
+	// Time between a job becoming ready to run and it being started, in seconds
+	double averageLatency = 0.0;
+	double maxLatency = 0.0;
+};
+
 /*
 	The manager for performing asynchronous tasks
 	you should only have one of these
+
+	Every job thread has it's own queue, idle threads sleep on a condition variable and take work from the other queues when theirs is empty.
+	Jobs queued from a job thread go to that thread's queue, jobs from other threads are spread over all queues.
+	IO jobs are kept in a separate queue and only a limited number of them run at the same time.
 */
 class JobSheduler : public Unique
 {
 public:
-	JobSheduler();
+	// numThreads = 0 uses the number of cores minus 2, at least 1
+	// maxIOJobs is the number of IO jobs that can run at the same time
+	JobSheduler(uint32 numThreads = 0, uint32 maxIOJobs = 2);
 	~JobSheduler();
 
 	// Runs callbacks on finished tasks on the main thread
@@ -109,6 +155,18 @@ public:
 
 	// Queue job
 	bool Queue(Job job);
+	// Queue a job that starts after all the given jobs have run
+	//	dependencies that already ran or aren't queued are ignored
+	bool Queue(Job job, const Vector<Job>& dependencies);
+
+	// Calls func(begin, end) for ranges of at most batchSize items out of [0, count)
+	//	the ranges are processed by the job threads and the calling thread, returns when all of them are done
+	//	batchSize = 0 splits the work evenly over the threads
+	void ParallelFor(uint32 count, const std::function<void(uint32 begin, uint32 end)>& func, uint32 batchSize = 0);
+
+	uint32 GetNumThreads() const;
+	JobShedulerStats GetStats() const;
+	void ResetStats();
 
 private:
 	class JobSheduler_Impl* m_impl;
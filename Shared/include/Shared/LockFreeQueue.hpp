@@ -0,0 +1,106 @@
+#pragma once
+#include <atomic>
+#include "Types.hpp"
+
+/*
+	Bounded queue that can be used by multiple producer and consumer threads without locking
+	the capacity is rounded up to a power of 2, Push fails when the queue is full
+*/
+template<typename T>
+class LockFreeQueue
+{
+public:
+	LockFreeQueue(size_t capacity = 1024)
+	{
+		size_t size = 2;
+		while(size < capacity)
+			size *= 2;
+		m_mask = size - 1;
+		m_cells = new Cell[size];
+		for(size_t i = 0; i < size; i++)
+			m_cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	~LockFreeQueue()
+	{
+		delete[] m_cells;
+	}
+	LockFreeQueue(const LockFreeQueue&) = delete;
+	LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+	// Adds an item to the queue, returns false if the queue is full
+	bool Push(const T& item)
+	{
+		Cell* cell;
+		size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+		while(true)
+		{
+			cell = &m_cells[pos & m_mask];
+			size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+			if(diff == 0)
+			{
+				if(m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if(diff < 0)
+			{
+				// Full
+				return false;
+			}
+			else
+			{
+				pos = m_enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+		cell->data = item;
+		cell->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+	// Takes the oldest item from the queue, returns false if the queue is empty
+	bool Pop(T& item)
+	{
+		Cell* cell;
+		size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+		while(true)
+		{
+			cell = &m_cells[pos & m_mask];
+			size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+			if(diff == 0)
+			{
+				if(m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if(diff < 0)
+			{
+				// Empty
+				return false;
+			}
+			else
+			{
+				pos = m_dequeuePos.load(std::memory_order_relaxed);
+			}
+		}
+		item = cell->data;
+		cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+		return true;
+	}
+
+	size_t GetCapacity() const
+	{
+		return m_mask + 1;
+	}
+
+private:
+	struct Cell
+	{
+		std::atomic<size_t> sequence;
+		T data;
+	};
+
+	Cell* m_cells;
+	size_t m_mask;
+	// Kept on separate cache lines so producers and consumers don't contend
+	alignas(64) std::atomic<size_t> m_enqueuePos{0};
+	alignas(64) std::atomic<size_t> m_dequeuePos{0};
+};
@@ -6,6 +6,12 @@
 	Logging utility class
 	formats loggin messages with time stamps and module names
 	allows message coloring on platforms that support it
+
+	Messages are put into a bounded lock-free queue and written to the console and log file by a background thread,
+	so logging never waits for the output.
+	Messages shorter than 200 characters are stored in the queue without allocating,
+	longer messages and String arguments to Logf are copied to the heap, which should be avoided on the audio thread.
+	Messages are dropped when the queue is full, the number of dropped messages is written to the log once there is space again
 */
 class Logger : Unique
 {
@@ -38,12 +44,19 @@ public:
 	void SetColor(Color color);
 	// Log a string to the logging output, 
 	void Log(const String& msg, Logger::Severity severity);
+	// Log a message formatted with printf style arguments
+	void LogFormat(Logger::Severity severity, const char* format, ...);
 
 	// Write log message header, (timestamp, etc..)
 	void WriteHeader(Logger::Severity severity);
 	// Writes string without newline
 	void Write(const String& msg);
 
+	// Writes all queued messages on the calling thread
+	void Flush();
+	// Number of messages that were dropped because the queue was full
+	uint64 GetNumDropped() const;
+
 private:
 	class Logger_Impl* m_impl;
 };
@@ -52,8 +65,8 @@ private:
 template<typename... Args>
 void Logf(const char* format, Logger::Severity severity, Args... args)
 {
-	String msg = Utility::Sprintf<Args...>(format, args...);
-	Logger::Get().Log(msg, severity);
+	// Formatted directly into the queued message
+	Logger::Get().LogFormat(severity, format, Utility::SprintfArgFilter(args)...);
 }
 // Log to Logger::Get()
 void Log(const String& msg, Logger::Severity severity = Logger::Normal);
@@ -15,6 +15,8 @@ class Path
 public:
 	// Working dir
 	static String GetCurrentPath();
+	// Changes the working dir, relative paths used after this are relative to the new working dir
+	static bool SetCurrentPath(const String& path);
 	static String GetExecutablePath();
 	// The filename of the executable
 	static String GetModuleName();
@@ -0,0 +1,84 @@
+#pragma once
+#include "Shared/Vector.hpp"
+#include "Shared/String.hpp"
+#include "Shared/Macro.hpp"
+#include <atomic>
+
+/*
+	Low overhead instrumentation for finding out where time goes
+	zones, counters and frame markers are recorded into a ring buffer per thread with nanosecond timestamps,
+	recorded events can be exported to the chrome trace format (chrome://tracing or https://ui.perfetto.dev)
+
+	When recording is disabled a zone only checks a single flag
+	names passed to zones and counters need to stay valid while the profiler is used, string literals or Profiler::InternName
+*/
+class Profiler
+{
+public:
+	// Zone times of the main thread, summed per zone over a frame
+	struct FrameZone
+	{
+		const char* name;
+		uint32 depth;
+		uint32 count;
+		double duration;
+	};
+
+	// Number of events kept for each thread
+	static const uint32 bufferSize = 1 << 16;
+
+	static void SetEnabled(bool enabled);
+	static bool IsEnabled()
+	{
+		return m_enabled.load(std::memory_order_relaxed);
+	}
+
+	// Name of the calling thread in exported traces
+	static void SetThreadName(const char* name);
+	// Returns a copy of the name that stays valid until the program exits
+	static const char* InternName(const String& name);
+
+	// Time in nanoseconds since the profiler was initialized
+	static uint64 GetTime();
+
+	static void BeginZone(const char* name);
+	static void EndZone();
+	static void Counter(const char* name, double value);
+	// Marks the start of a frame, should be called from the main thread
+	//	this also updates the zone times of the last frame
+	static void BeginFrame();
+
+	// Zones that were recorded on the main thread during the last complete frame, in the order they started
+	static const Vector<FrameZone>& GetLastFrameZones();
+	static double GetLastFrameTime();
+
+	// Writes the recorded events of all threads to a chrome trace json file
+	static bool ExportChromeTrace(const String& path);
+
+private:
+	static std::atomic<bool> m_enabled;
+};
+
+// Records the time spent in the current scope when the profiler is enabled
+class ProfileZone
+{
+public:
+	ProfileZone(const char* name)
+	{
+		if(Profiler::IsEnabled())
+		{
+			Profiler::BeginZone(name);
+			m_active = true;
+		}
+	}
+	~ProfileZone()
+	{
+		if(m_active)
+			Profiler::EndZone();
+	}
+
+private:
+	bool m_active = false;
+};
+
+#define PROFILE_ZONE(__name) ProfileZone CONCAT(_profileZone, __LINE__)(__name)
@@ -1,17 +1,30 @@
 #pragma once
+#include "Shared/Profiler.hpp"
 
+/*
+	Logs how long a task took
+	also recorded as a zone when the profiler is enabled
+*/
 class ProfilerScope
 {
 public:
 	ProfilerScope(const String& name) : name(name)
 	{
 		Logf("Starting task \"%s\"", Logger::Info, name);
+		if(Profiler::IsEnabled())
+		{
+			Profiler::BeginZone(Profiler::InternName(name));
+			zone = true;
+		}
 	}
 	~ProfilerScope()
 	{
+		if(zone)
+			Profiler::EndZone();
 		Logf("Finished task \"%s\" in  %d ms", Logger::Info, name, t.Milliseconds());
 	}
 private:
 	Timer t;
 	String name;
+	bool zone = false;
 };
\ No newline at end of file
@@ -1,9 +1,15 @@
 #pragma once
 #include <assert.h>
 #include <type_traits>
+#include <atomic>
 
 template<typename T> class RefCounted;
 
+// Reference counter shared by all references to an object, references can be copied and released on multiple threads
+//	a negative count means the object was destroyed and only the counter is still referenced
+//	every change of the count is a single compare and swap, so a release can't race with a Destroy on another thread
+typedef std::atomic<int32_t> RefCounter;
+
 /*
 	Basic shared pointer class
 	the object should be constructed once explicitly with a pointer to the object to manage
@@ -14,36 +20,30 @@ class Ref
 {
 protected:
 	T* m_data;
-	int32_t* m_refCount;
+	RefCounter* m_refCount;
 	void m_Dec()
 	{
 		if(m_refCount)
 		{
-			assert(m_refCount[0] != 0);
-			if(m_refCount[0] >= 0)
+			// Counts of destroyed objects go up towards zero
+			int32_t count = m_refCount->load(std::memory_order_relaxed);
+			int32_t next;
+			do
 			{
-				m_refCount[0]--;
-				if(m_refCount[0] == 0)
-				{
-					delete m_data;
-					delete m_refCount;
-					m_refCount = nullptr;
-#if _DEBUG
-					m_data = nullptr;
-#endif
-				}
-			}
-			else
+				assert(count != 0);
+				next = count > 0 ? count - 1 : count + 1;
+			} while(!m_refCount->compare_exchange_weak(count, next, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+			// Only the thread that removes the last reference deletes the object and counter
+			if(next == 0)
 			{
-				m_refCount[0]++;
-				if(m_refCount[0] == 0)
-				{
-					delete m_refCount;
-					m_refCount = nullptr;
+				if(count > 0)
+					delete m_data;
+				delete m_refCount;
+				m_refCount = nullptr;
 #if _DEBUG
-					m_data = nullptr;
+				m_data = nullptr;
 #endif
-				}
 			}
 		}
 	}
@@ -51,21 +51,19 @@ protected:
 	{
 		if(m_refCount)
 		{
-			if(m_refCount[0] >= 0)
+			int32_t count = m_refCount->load(std::memory_order_relaxed);
+			int32_t next;
+			do
 			{
-				m_refCount[0]++;
-			}
-			else
-			{
-				m_refCount[0]--;
-			}
+				next = count >= 0 ? count + 1 : count - 1;
+			} while(!m_refCount->compare_exchange_weak(count, next, std::memory_order_relaxed));
 		}
 	}
 	void m_AssignCounter();
-	int32* m_CreateNewCounter();
+	RefCounter* m_CreateNewCounter();
 
 public:
-	explicit Ref(T* data, int32_t* refCount)
+	explicit Ref(T* data, RefCounter* refCount)
 		: m_data(data), m_refCount(refCount)
 	{
 		m_Inc();
@@ -161,13 +159,25 @@ public:
 		return m_refCount && m_data != other;
 	}
 
+	// Deletes the object while there can still be other references to it, those references become invalid
+	//	other threads can still copy and release their references, but they must not use the object at the same time
 	inline void Destroy()
 	{
 		assert(IsValid());
-		assert(m_refCount[0] > 0);
-		m_refCount[0] = -m_refCount[0] + 1;
+		// Removes this reference, the others keep the counter alive
+		int32_t count = m_refCount->load(std::memory_order_relaxed);
+		int32_t next;
+		do
+		{
+			assert(count > 0);
+			next = -(count - 1);
+		} while(!m_refCount->compare_exchange_weak(count, next, std::memory_order_acq_rel, std::memory_order_relaxed));
+		RefCounter* counter = m_refCount;
 		m_refCount = nullptr;
+		// Counted objects still read their counter when they are deleted
 		delete m_data;
+		if(next == 0)
+			delete counter;
 	}
 	inline void Release()
 	{
@@ -175,10 +185,14 @@ public:
 		m_refCount = nullptr;
 	}
 
-	inline bool IsValid() const { return m_refCount != nullptr && m_refCount[0] > 0; }
+	inline bool IsValid() const { return m_refCount != nullptr && m_refCount->load(std::memory_order_relaxed) > 0; }
 	inline operator bool() const { return IsValid(); }
 
-	inline int32_t GetRefCount() const { if(m_refCount && m_refCount[0] > 0) return m_refCount[0]; else return 0; }
+	inline int32_t GetRefCount() const
+	{
+		int32_t count = m_refCount ? m_refCount->load(std::memory_order_relaxed) : 0;
+		return count > 0 ? count : 0;
+	}
 
 	inline T* GetData() { assert(IsValid()); return m_data; }
 	inline const T* GetData() const { assert(IsValid()); return m_data; }
@@ -201,7 +215,7 @@ namespace Utility
 class IRefCounted
 {
 protected:
-	int32* m_refCount = (int32*)0;
+	RefCounter* m_refCount = (RefCounter*)0;
 public:
 #if _DEBUG
 	~IRefCounted()
@@ -212,18 +226,18 @@ public:
 #endif
 	int32 GetRefCount() const
 	{
-		return (m_refCount) ? m_refCount[0] : 0;
+		return (m_refCount) ? m_refCount->load() : 0;
 	}
 	// Internal use, assigns the reference counter when constructing a Ref object without calling RefCounted::MakeShared
-	void _AssignRefCounter(int32* counter)
+	void _AssignRefCounter(RefCounter* counter)
 	{
 		assert(m_refCount == nullptr || m_refCount == counter);
 		m_refCount = counter;
 	}
-	int32* _GetRefCounter()
+	RefCounter* _GetRefCounter()
 	{
 		if(!m_refCount)
-			m_refCount = new int32(0);
+			m_refCount = new RefCounter(0);
 		return m_refCount;
 	}
 };
@@ -243,21 +257,21 @@ public:
 // Possibly assign reference counter in RefCounted object
 template<typename T, bool> struct RefCounterHelper
 {
-	static void Assign(T* obj, int32* counter)
+	static void Assign(T* obj, RefCounter* counter)
 	{
 	}
-	static int32* CreateCounter(T* obj)
+	static RefCounter* CreateCounter(T* obj)
 	{
-		return new int32(0);
+		return new RefCounter(0);
 	}
 };
 template<typename T> struct RefCounterHelper<T, true>
 {
-	static void Assign(T* obj, int32* counter)
+	static void Assign(T* obj, RefCounter* counter)
 	{
 		obj->_AssignRefCounter(counter);
 	}
-	static int32* CreateCounter(T* obj)
+	static RefCounter* CreateCounter(T* obj)
 	{
 		return obj->_GetRefCounter();
 	}
@@ -267,7 +281,7 @@ template<typename T> void Ref<T>::m_AssignCounter()
 	assert(m_data);
 	RefCounterHelper<T, std::is_base_of<IRefCounted, T>::value>::Assign((T*)m_data, m_refCount);
 }
-template<typename T> int32* Ref<T>::m_CreateNewCounter()
+template<typename T> RefCounter* Ref<T>::m_CreateNewCounter()
 {
 	assert(m_data);
 	return RefCounterHelper<T, std::is_base_of<IRefCounted, T>::value>::CreateCounter((T*)m_data);
@@ -1,6 +1,7 @@
 #pragma once
 #include "Shared/String.hpp"
 #include "Shared/Vector.hpp"
+#include "Shared/SlotMap.hpp"
 #include "Shared/Ref.hpp"
 #include "Shared/TypeInfo.hpp"
 #include "Shared/Unique.hpp"
@@ -10,9 +11,11 @@
 class IResourceManager
 {
 public:
-	// Collects unused object
-	virtual void GarbageCollect() = 0;
+	// Collects unused objects, checks at most maxObjects objects
+	//	each call continues where the previous one stopped
+	virtual void GarbageCollect(size_t maxObjects) = 0;
 	// Forcefully releases all objects from this resource manager
+	//	objects are deleted even if they are still referenced, so no other thread may be using them
 	virtual void ReleaseAll() = 0;
 	virtual ~IResourceManager() = default;
 };
@@ -25,7 +28,9 @@ template<typename T>
 class ResourceManager : public IResourceManager, Unique
 {
 	// List of managed object
-	Vector<Ref<T>> m_objects;
+	SlotMap<Ref<T>> m_objects;
+	// Next object to check for garbage collection
+	size_t m_gcPosition = 0;
 	Mutex m_lock;
 public:
 	ResourceManager()
@@ -36,27 +41,51 @@ public:
 	}
 	// Creates a new reference counted object to this object and returns it
 	// when the object is no longer referenced the resource manager will collect it when the next garbage collection triggers
-	const Ref<T> Register(T* pObject)
+	//	optionally returns a handle that can be used to get the object again while it's not collected
+	const Ref<T> Register(T* pObject, SlotHandle* handle = nullptr)
 	{
 		Ref<T> ret = Utility::MakeRef(pObject);
 		m_lock.lock();
-		m_objects.push_back(ret);
+		SlotHandle added = m_objects.Add(ret);
 		m_lock.unlock();
+		if(handle)
+			*handle = added;
 		return ret;
 	}
-	virtual void GarbageCollect() override
+	// Returns a null reference if the object was collected
+	Ref<T> Get(SlotHandle handle)
+	{
+		Ref<T> ret;
+		m_lock.lock();
+		Ref<T>* object = m_objects.Find(handle);
+		if(object)
+			ret = *object;
+		m_lock.unlock();
+		return ret;
+	}
+	size_t GetNumObjects()
+	{
+		m_lock.lock();
+		size_t ret = m_objects.size();
+		m_lock.unlock();
+		return ret;
+	}
+	virtual void GarbageCollect(size_t maxObjects) override
 	{
 		size_t numCleanedUp = 0;
 		m_lock.lock();
-		for(auto it = m_objects.begin(); it != m_objects.end();)
+		if(m_gcPosition >= m_objects.size())
+			m_gcPosition = 0;
+		for(size_t i = 0; i < maxObjects && m_gcPosition < m_objects.size(); i++)
 		{
-			if(it->GetRefCount() <= 1)
+			if(m_objects[m_gcPosition].GetRefCount() <= 1)
 			{
+				// The last object is moved to this position, so it's checked next
 				numCleanedUp++;
-				it = m_objects.erase(it);
+				m_objects.RemoveAt(m_gcPosition);
 				continue;
 			}
-			it++;
+			m_gcPosition++;
 		}
 		m_lock.unlock();
 		if(numCleanedUp > 0)
@@ -74,6 +103,7 @@ public:
 				it->Destroy();
 		}
 		m_objects.clear();
+		m_gcPosition = 0;
 		m_lock.unlock();
 		if(numCleanedUp > 0)
 		{
@@ -0,0 +1,103 @@
+#pragma once
+#include "Shared/Vector.hpp"
+
+/*
+	First in first out queue stored in a single growing array
+	storage is reused after items are removed, so a queue that stays within its capacity never allocates
+*/
+template<typename T>
+class RingBuffer
+{
+public:
+	RingBuffer(size_t capacity = 16)
+	{
+		Reserve(capacity);
+	}
+
+	// Adds a new item to the back and returns it
+	T& Add(const T& item = T())
+	{
+		if(m_size == m_items.size())
+			Reserve(m_items.size() * 2);
+		T& dst = m_items[(m_start + m_size) & m_mask];
+		dst = item;
+		m_size++;
+		return dst;
+	}
+	// Removes the item at the front
+	void PopFront()
+	{
+		assert(m_size > 0);
+		m_start = (m_start + 1) & m_mask;
+		m_size--;
+	}
+	void Clear()
+	{
+		m_start = 0;
+		m_size = 0;
+	}
+
+	T& Front()
+	{
+		assert(m_size > 0);
+		return m_items[m_start];
+	}
+	const T& Front() const
+	{
+		assert(m_size > 0);
+		return m_items[m_start];
+	}
+	T& Back()
+	{
+		assert(m_size > 0);
+		return m_items[(m_start + m_size - 1) & m_mask];
+	}
+	// Index relative to the front
+	T& operator[](size_t index)
+	{
+		assert(index < m_size);
+		return m_items[(m_start + index) & m_mask];
+	}
+	const T& operator[](size_t index) const
+	{
+		assert(index < m_size);
+		return m_items[(m_start + index) & m_mask];
+	}
+
+	size_t size() const
+	{
+		return m_size;
+	}
+	bool empty() const
+	{
+		return m_size == 0;
+	}
+	size_t GetCapacity() const
+	{
+		return m_items.size();
+	}
+
+	// Makes sure the buffer can hold at least capacity items without growing, rounded up to a power of 2
+	void Reserve(size_t capacity)
+	{
+		size_t newCapacity = 1;
+		while(newCapacity < capacity)
+			newCapacity *= 2;
+		if(newCapacity <= m_items.size())
+			return;
+
+		// Move items to the start of the new array
+		Vector<T> newItems(newCapacity);
+		for(size_t i = 0; i < m_size; i++)
+			newItems[i] = m_items[(m_start + i) & m_mask];
+		m_items = std::move(newItems);
+		m_start = 0;
+		m_mask = newCapacity - 1;
+	}
+
+private:
+	Vector<T> m_items;
+	size_t m_start = 0;
+	size_t m_size = 0;
+	size_t m_mask = 0;
+};
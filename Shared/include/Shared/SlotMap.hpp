@@ -0,0 +1,135 @@
+#pragma once
+#include "Shared/Types.hpp"
+#include "Shared/Vector.hpp"
+
+/*
+	Handle to an item in a SlotMap
+	the generation of a slot changes when it's item is removed, so handles to removed items never refer to items added later
+*/
+struct SlotHandle
+{
+	uint32 index = UINT32_MAX;
+	uint32 generation = 0;
+
+	bool IsValid() const { return index != UINT32_MAX; }
+	bool operator==(const SlotHandle& other) const { return index == other.index && generation == other.generation; }
+	bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+};
+
+/*
+	Container that keeps it's items in a contiguous array and gives out handles that stay valid until the item is removed
+	removing an item moves the last item into it's place, so the order of items changes when items are removed
+*/
+template<typename T>
+class SlotMap
+{
+public:
+	SlotHandle Add(T item)
+	{
+		uint32 slotIndex;
+		if(m_freeSlots.empty())
+		{
+			slotIndex = (uint32)m_slots.size();
+			m_slots.push_back(Slot());
+		}
+		else
+		{
+			slotIndex = m_freeSlots.back();
+			m_freeSlots.pop_back();
+		}
+
+		Slot& slot = m_slots[slotIndex];
+		slot.item = (uint32)m_items.size();
+		m_items.push_back(std::move(item));
+		m_itemSlots.push_back(slotIndex);
+
+		SlotHandle handle;
+		handle.index = slotIndex;
+		handle.generation = slot.generation;
+		return handle;
+	}
+	// Returns false if the item was already removed
+	bool Remove(SlotHandle handle)
+	{
+		if(!Contains(handle))
+			return false;
+		RemoveAt(m_slots[handle.index].item);
+		return true;
+	}
+	// Removes the item at an index in the item array, the last item is moved to this index
+	void RemoveAt(size_t index)
+	{
+		assert(index < m_items.size());
+		uint32 slotIndex = m_itemSlots[index];
+		size_t last = m_items.size() - 1;
+		if(index != last)
+		{
+			m_items[index] = std::move(m_items[last]);
+			m_itemSlots[index] = m_itemSlots[last];
+			m_slots[m_itemSlots[index]].item = (uint32)index;
+		}
+		m_items.pop_back();
+		m_itemSlots.pop_back();
+
+		Slot& slot = m_slots[slotIndex];
+		slot.item = UINT32_MAX;
+		slot.generation++;
+		m_freeSlots.push_back(slotIndex);
+	}
+
+	bool Contains(SlotHandle handle) const
+	{
+		return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation &&
+			m_slots[handle.index].item != UINT32_MAX;
+	}
+	// Returns null if the item was removed
+	T* Find(SlotHandle handle)
+	{
+		if(!Contains(handle))
+			return nullptr;
+		return &m_items[m_slots[handle.index].item];
+	}
+	const T* Find(SlotHandle handle) const
+	{
+		if(!Contains(handle))
+			return nullptr;
+		return &m_items[m_slots[handle.index].item];
+	}
+	// Handle to the item at an index in the item array
+	SlotHandle GetHandle(size_t index) const
+	{
+		SlotHandle handle;
+		handle.index = m_itemSlots[index];
+		handle.generation = m_slots[handle.index].generation;
+		return handle;
+	}
+
+	void clear()
+	{
+		// Keep the slots, so old handles stay invalid
+		for(size_t i = m_items.size(); i > 0; i--)
+			RemoveAt(i - 1);
+	}
+	size_t size() const { return m_items.size(); }
+	bool empty() const { return m_items.empty(); }
+
+	T& operator[](size_t index) { return m_items[index]; }
+	const T& operator[](size_t index) const { return m_items[index]; }
+	typename Vector<T>::iterator begin() { return m_items.begin(); }
+	typename Vector<T>::iterator end() { return m_items.end(); }
+	typename Vector<T>::const_iterator begin() const { return m_items.begin(); }
+	typename Vector<T>::const_iterator end() const { return m_items.end(); }
+
+private:
+	struct Slot
+	{
+		// Index in the item array or UINT32_MAX when the slot is free
+		uint32 item = UINT32_MAX;
+		uint32 generation = 0;
+	};
+	Vector<T> m_items;
+	// Slot used by each item
+	Vector<uint32> m_itemSlots;
+	Vector<Slot> m_slots;
+	Vector<uint32> m_freeSlots;
+};
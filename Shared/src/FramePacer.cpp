@@ -0,0 +1,226 @@
+#include "stdafx.h"
+#include "FramePacer.hpp"
+#include "Math.hpp"
+#include <thread>
+#include <algorithm>
+
+// Spin margin limits
+static const double minSpinMargin = 0.00025;
+static const double maxSpinMargin = 0.004;
+// Extra time given to rendering on top of the measured render time
+static const double renderMargin = 0.0005;
+
+double SystemFrameClock::GetTime()
+{
+	return m_timer.SecondsAsDouble();
+}
+void SystemFrameClock::Sleep(double seconds)
+{
+	std::this_thread::sleep_for(std::chrono::microseconds((int64)(seconds * 1000000.0)));
+}
+void SystemFrameClock::Relax()
+{
+	std::this_thread::yield();
+}
+
+FramePacer::FramePacer() : m_clock(m_systemClock)
+{
+}
+FramePacer::FramePacer(IFrameClock& clock) : m_clock(clock)
+{
+}
+
+void FramePacer::SetTargetFrameRate(double framesPerSecond)
+{
+	double frameTime = framesPerSecond > 0.0 ? 1.0 / framesPerSecond : 0.0;
+	if(frameTime != m_targetFrameTime)
+	{
+		m_targetFrameTime = frameTime;
+		// Restart the cadence
+		m_cadenceStarted = false;
+	}
+}
+void FramePacer::SetSimulationRate(double stepsPerSecond)
+{
+	m_simulationStep = stepsPerSecond > 0.0 ? 1.0 / stepsPerSecond : 0.0;
+	m_simulationTime = 0.0;
+}
+void FramePacer::SetMaxSimulationSteps(uint32 maxSteps)
+{
+	m_maxSimulationSteps = Math::Max(maxSteps, 1u);
+}
+void FramePacer::SetPollInterval(double seconds)
+{
+	m_pollInterval = seconds;
+}
+
+bool FramePacer::WaitForFrame()
+{
+	// Unlimited or no frame presented yet
+	if(m_targetFrameTime <= 0.0 || !m_cadenceStarted)
+		return true;
+
+	// Start early enough to have the frame rendered before the present deadline
+	double frameWork = Math::Min(m_frameWork + m_presentWork + renderMargin, m_targetFrameTime);
+	return m_WaitUntil(m_nextPresent - frameWork);
+}
+bool FramePacer::WaitForPresent()
+{
+	double now = m_clock.GetTime();
+
+	// Track the longest recent render time, so frames that take a bit longer still make the deadline
+	double frameWork = now - m_frameStart;
+	if(frameWork > m_frameWork)
+		m_frameWork = frameWork;
+	else
+		m_frameWork += (frameWork - m_frameWork) * 0.02;
+
+	if(m_targetFrameTime <= 0.0)
+		return true;
+	return m_WaitUntil(m_nextPresent - m_presentWork);
+}
+bool FramePacer::m_WaitUntil(double time)
+{
+	while(true)
+	{
+		double now = m_clock.GetTime();
+		double remaining = time - now;
+		if(remaining <= 0.0)
+			return true;
+
+		if(remaining > m_spinMargin)
+		{
+			double sleepTime = Math::Min(remaining - m_spinMargin, m_pollInterval);
+			m_clock.Sleep(sleepTime);
+
+			// Keep enough margin to cover the usual oversleep
+			double overshoot = Math::Max(0.0, m_clock.GetTime() - now - sleepTime);
+			m_sleepOvershoot = m_sleepOvershoot * 0.9 + overshoot * 0.1;
+			m_spinMargin = Math::Clamp(m_sleepOvershoot * 2.0 + minSpinMargin, minSpinMargin, maxSpinMargin);
+
+			if(onPoll.IsBound() && !onPoll.Call())
+				return false;
+		}
+		else
+		{
+			m_clock.Relax();
+		}
+	}
+}
+
+uint32 FramePacer::BeginFrame()
+{
+	double now = m_clock.GetTime();
+	m_frameDelta = m_firstFrame ? 0.0 : now - m_frameStart;
+	m_frameStart = now;
+
+	if(m_targetFrameTime > 0.0 && !m_cadenceStarted)
+	{
+		m_nextPresent = now;
+		m_cadenceStarted = true;
+	}
+
+	// Always run a step in the first frame so everything is updated before rendering
+	if(m_firstFrame || m_simulationStep <= 0.0)
+	{
+		m_firstFrame = false;
+		m_simulationTime = 0.0;
+		return 1;
+	}
+
+	m_simulationTime += m_frameDelta;
+	uint32 numSteps = (uint32)(m_simulationTime / m_simulationStep);
+	if(numSteps > m_maxSimulationSteps)
+	{
+		// Can't keep up, drop the time instead of falling further behind
+		numSteps = m_maxSimulationSteps;
+		m_simulationTime = 0.0;
+	}
+	else
+	{
+		m_simulationTime -= numSteps * m_simulationStep;
+	}
+	return numSteps;
+}
+void FramePacer::BeginPresent()
+{
+	m_presentStart = m_clock.GetTime();
+}
+void FramePacer::EndPresent()
+{
+	double now = m_clock.GetTime();
+
+	double presentTime = now - m_presentStart;
+	m_presentWork = m_presentWork * 0.9 + presentTime * 0.1;
+	m_presentTimes[m_sampleIndex] = presentTime;
+	if(m_hasPresented)
+	{
+		m_frameTimes[m_sampleIndex] = now - m_lastPresent;
+		m_sampleIndex = (m_sampleIndex + 1) % numSamples;
+		m_numSamples = Math::Min(m_numSamples + 1, numSamples);
+	}
+	m_lastPresent = now;
+	m_hasPresented = true;
+
+	m_AdvanceCadence(now);
+}
+void FramePacer::SkipPresent()
+{
+	m_AdvanceCadence(m_clock.GetTime());
+}
+void FramePacer::m_AdvanceCadence(double now)
+{
+	if(m_targetFrameTime > 0.0)
+	{
+		m_nextPresent += m_targetFrameTime;
+		// Missed more than a frame, restart the cadence instead of rushing to catch up
+		if(m_nextPresent < now)
+			m_nextPresent = now + m_targetFrameTime;
+	}
+}
+
+double FramePacer::GetFrameStartTime() const
+{
+	return m_frameStart;
+}
+float FramePacer::GetFrameDelta() const
+{
+	return (float)m_frameDelta;
+}
+float FramePacer::GetSimulationStep() const
+{
+	return m_simulationStep > 0.0 ? (float)m_simulationStep : (float)m_frameDelta;
+}
+float FramePacer::GetSimulationAlpha() const
+{
+	if(m_simulationStep <= 0.0)
+		return 1.0f;
+	return (float)(m_simulationTime / m_simulationStep);
+}
+
+double FramePacer::GetFrameTimePercentile(float fraction) const
+{
+	return m_GetPercentile(m_frameTimes, m_numSamples, fraction);
+}
+double FramePacer::GetPresentTimePercentile(float fraction) const
+{
+	return m_GetPercentile(m_presentTimes, m_numSamples, fraction);
+}
+uint32 FramePacer::GetNumFrameSamples() const
+{
+	return m_numSamples;
+}
+double FramePacer::GetSpinMargin() const
+{
+	return m_spinMargin;
+}
+double FramePacer::m_GetPercentile(const double* samples, uint32 numSamples, float fraction)
+{
+	if(numSamples == 0)
+		return 0.0;
+	double sorted[FramePacer::numSamples];
+	memcpy(sorted, samples, sizeof(double) * numSamples);
+	uint32 index = Math::Min((uint32)(Math::Clamp(fraction, 0.0f, 1.0f) * (float)numSamples), numSamples - 1);
+	std::nth_element(sorted, sorted + index, sorted + numSamples);
+	return sorted[index];
+}
@@ -4,8 +4,12 @@
 #include "Vector.hpp"
 #include "Log.hpp"
 #include "Thread.hpp"
+#include "Math.hpp"
+#include "Profiler.hpp"
 #include <thread>
-#include "Timer.hpp"
+#include <deque>
+#include <condition_variable>
+#include <memory>
 
 JobFlags operator|(JobFlags a, JobFlags b)
 {
@@ -16,46 +20,106 @@ JobFlags operator&(JobFlags a, JobFlags b)
 	return (JobFlags)((uint8)a & (uint8)b);
 }
 
+static const uint32 numPriorities = (uint32)JobPriority::_Length;
+
+// Job threads access jobs through this instead of GetData,
+//	since the owner of the job can change the reference count at any time and Cast doesn't read it
+static JobBase* GetJobData(Job& job)
+{
+	return job.Cast<JobBase>();
+}
+
+/*
+	Jobs waiting to be started, one list for each priority
+	Job references are only ever moved in and out of the queue,
+	so the reference count is never touched by more than one thread
+*/
+struct JobQueue
+{
+	Mutex lock;
+	std::deque<Job> jobs[numPriorities];
+
+	void Push(Job&& job)
+	{
+		std::lock_guard<Mutex> guard(lock);
+		jobs[(uint32)GetJobData(job)->priority].push_back(std::move(job));
+	}
+	bool Pop(uint32 priority, Job& out)
+	{
+		std::lock_guard<Mutex> guard(lock);
+		std::deque<Job>& list = jobs[priority];
+		if(list.empty())
+			return false;
+		out = std::move(list.front());
+		list.pop_front();
+		return true;
+	}
+	// Moves all queued jobs into the given list
+	void Drain(List<Job>& out)
+	{
+		std::lock_guard<Mutex> guard(lock);
+		for(auto& list : jobs)
+		{
+			for(auto& job : list)
+				out.push_back(std::move(job));
+			list.clear();
+		}
+	}
+};
+
 struct JobThread
 {
 	// Thread index
 	uint32 index = 0;
-	bool terminate = false;
 	Thread thread;
+	JobQueue queue;
 
 	// Job currently being processed
-	Job activeJob;
-
-	Timer idleDuration;
-
-	// Terminate this thread
-	void Terminate()
-	{
-		if(terminate)
-			return; // Already terminated
-		terminate = true;
-		if(thread.joinable())
-			thread.join();
-	}
-	bool IsActive() const { return activeJob.IsValid(); }
+	std::atomic<JobBase*> activeJob = { nullptr };
 };
 
+// The sheduler and thread index of the job thread the code is running on
+static thread_local class JobSheduler_Impl* t_sheduler = nullptr;
+static thread_local uint32 t_threadIndex = 0;
+
 class JobSheduler_Impl
 {
 public:
-	// Contains tasks to be done
-	List<Job> m_jobQueue;
+	Vector<JobThread*> m_threadPool;
+
+	// IO jobs, shared by all threads
+	JobQueue m_ioQueue;
+	uint32 m_maxIOJobs = 1;
+	std::atomic<int32> m_numIOJobsActive = { 0 };
+
+	// Number of jobs in the thread queues and in the IO queue
+	std::atomic<int32> m_numQueued = { 0 };
+	std::atomic<int32> m_numIOQueued = { 0 };
+	// Queue used for the next job queued from outside of the job threads
+	std::atomic<uint32> m_nextQueue = { 0 };
+
+	// Idle threads wait for this
+	Mutex m_sleepLock;
+	std::condition_variable_any m_wake;
+	std::atomic<bool> m_terminate = { false };
+
+	// Guards the continuation lists of jobs
+	Mutex m_dependencyLock;
+
 	// Contains tasks that are done
+	Mutex m_finishedLock;
 	List<Job> m_finishedJobs;
-	
-	Mutex m_lock;
-	Vector<JobThread*> m_threadPool;
+
+	std::atomic<uint64> m_numJobsStarted = { 0 };
+	std::atomic<uint64> m_totalLatency = { 0 };
+	std::atomic<uint64> m_maxLatency = { 0 };
 
 	friend class JobBase;
 
-	JobSheduler_Impl()
+	JobSheduler_Impl(uint32 numThreads, uint32 maxIOJobs)
 	{
-		AllocateThreads();
+		m_maxIOJobs = Math::Max(maxIOJobs, 1u);
+		AllocateThreads(numThreads);
 	}
 	~JobSheduler_Impl()
 	{
@@ -63,55 +127,70 @@ public:
 	}
 	void ClearThreads()
 	{
+		{
+			std::lock_guard<Mutex> guard(m_sleepLock);
+			m_terminate = true;
+		}
+		m_wake.notify_all();
 		for(JobThread* t : m_threadPool)
 		{
-			t->Terminate();
-			delete t;
+			if(t->thread.joinable())
+				t->thread.join();
 		}
-		m_lock.lock();
+
 		// Unregister jobs
-		for(auto job : m_jobQueue)
+		List<Job> remaining;
+		for(JobThread* t : m_threadPool)
 		{
-			job->m_sheduler = nullptr;
+			t->queue.Drain(remaining);
+			delete t;
 		}
-		for(auto job : m_finishedJobs)
+		m_ioQueue.Drain(remaining);
+		m_finishedLock.lock();
+		remaining.splice(remaining.end(), m_finishedJobs);
+		m_finishedLock.unlock();
+		for(auto& job : remaining)
 		{
 			job->m_sheduler = nullptr;
+			job->m_continuations.clear();
 		}
 		m_threadPool.clear();
-		m_lock.unlock();
 	}
-	void AllocateThreads()
+	void AllocateThreads(uint32 numThreads)
 	{
 		assert(m_threadPool.empty());
 
-		unsigned concurentThreadsSupported = std::thread::hardware_concurrency();
-		int32 targetThreadCount = concurentThreadsSupported - 2;
+		int32 targetThreadCount = numThreads;
 		if(targetThreadCount <= 0)
-			targetThreadCount = 1;
+		{
+			unsigned concurentThreadsSupported = std::thread::hardware_concurrency();
+			targetThreadCount = concurentThreadsSupported - 2;
+			if(targetThreadCount <= 0)
+				targetThreadCount = 1;
+		}
 
+		// Job threads are not pinned to cores, the system can move them around the main thread
 		for(int32 i = 0; i < targetThreadCount; i++)
 		{
-			// Create affinity mask for job threads
-			// always skip the first core since it runs the main thread
-			uint32 affinityMask = 1 << (i+1);
-
 			JobThread* thread = m_threadPool.Add(new JobThread());
 			thread->index = i;
-			thread->thread = Thread(&JobSheduler_Impl::m_JobThread, this, thread);
-			thread->thread.SetAffinityMask(affinityMask);
 		}
+		for(JobThread* thread : m_threadPool)
+			thread->thread = Thread(&JobSheduler_Impl::m_JobThread, this, thread);
 	}
 
 	void Update()
 	{
-		m_lock.lock();
-		List<Job> finished = m_finishedJobs;
+		m_finishedLock.lock();
+		List<Job> finished = std::move(m_finishedJobs);
 		m_finishedJobs.clear();
-		m_lock.unlock();
+		m_finishedLock.unlock();
 
 		for(Job& j : finished)
 		{
+			// Terminated while queued
+			if(j->m_cancelled)
+				continue;
 			j->Finalize();
 			j->OnFinished.Call(j);
 			j->m_finished = true;
@@ -119,74 +198,235 @@ public:
 		}
 	}
 
-	bool QueueUnchecked(Job job)
+	bool QueueUnchecked(Job job, const Vector<Job>* dependencies = nullptr)
 	{
 		job->m_sheduler = this;
+		job->m_ran = false;
 
-		m_lock.lock();
-		m_jobQueue.AddBack(job);
-		m_lock.unlock();
+		// Hold the job until all dependencies are registered
+		job->m_numDependencies = 1;
+		if(dependencies)
+		{
+			std::lock_guard<Mutex> guard(m_dependencyLock);
+			for(Job dependency : *dependencies)
+			{
+				if(!dependency || dependency->m_sheduler != this || dependency->m_ran)
+					continue;
+				dependency->m_continuations.Add(job);
+				job->m_numDependencies++;
+			}
+		}
+		if(--job->m_numDependencies == 0)
+			m_Push(std::move(job));
 
 		return true;
 	}
 
+	// Waits until the given job is no longer being processed and removes it from the finished list
+	void Unregister(JobBase* job)
+	{
+		for(JobThread* t : m_threadPool)
+		{
+			while(t->activeJob == job)
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		std::lock_guard<Mutex> guard(m_finishedLock);
+		for(auto it = m_finishedJobs.begin(); it != m_finishedJobs.end(); it++)
+		{
+			if(*it == job)
+			{
+				m_finishedJobs.erase(it);
+				return;
+			}
+		}
+	}
+
+	JobShedulerStats GetStats() const
+	{
+		JobShedulerStats stats;
+		stats.numJobsStarted = m_numJobsStarted;
+		if(stats.numJobsStarted > 0)
+			stats.averageLatency = (double)m_totalLatency / (double)stats.numJobsStarted * 1e-9;
+		stats.maxLatency = (double)m_maxLatency * 1e-9;
+		return stats;
+	}
+	void ResetStats()
+	{
+		m_numJobsStarted = 0;
+		m_totalLatency = 0;
+		m_maxLatency = 0;
+	}
+
 private:
-	// Single job thread
-	void m_JobThread(JobThread* myThread)
+	// Adds a job that is ready to run to a queue and wakes up a thread for it
+	void m_Push(Job&& job)
 	{
-		while(!myThread->terminate)
+		JobBase* jobPtr = GetJobData(job);
+		jobPtr->m_readyTime = std::chrono::steady_clock::now();
+		if((jobPtr->jobFlags & JobFlags::IO) == JobFlags::IO)
+		{
+			m_ioQueue.Push(std::move(job));
+			m_numIOQueued++;
+		}
+		else
 		{
-			if(!m_jobQueue.empty())
+			// Jobs queued by a job thread are most likely to be picked up by the same thread
+			uint32 queueIndex = t_sheduler == this ? t_threadIndex : (m_nextQueue++ % (uint32)m_threadPool.size());
+			m_threadPool[queueIndex]->queue.Push(std::move(job));
+			int32 numQueued = ++m_numQueued;
+			Profiler::Counter("Queued Jobs", numQueued);
+		}
+		m_WakeOne();
+	}
+	void m_WakeOne()
+	{
+		// Taking the lock makes sure a thread that is about to wait sees the new job
+		{
+			std::lock_guard<Mutex> guard(m_sleepLock);
+		}
+		m_wake.notify_one();
+	}
+	bool m_HasWork() const
+	{
+		return m_numQueued > 0 || (m_numIOQueued > 0 && m_numIOJobsActive < (int32)m_maxIOJobs);
+	}
+
+	bool m_TakeIOJob(uint32 priority, Job& out)
+	{
+		if(m_numIOQueued <= 0)
+			return false;
+
+		// Reserve a slot in the IO lane
+		int32 active = m_numIOJobsActive;
+		do
+		{
+			if(active >= (int32)m_maxIOJobs)
+				return false;
+		} while(!m_numIOJobsActive.compare_exchange_weak(active, active + 1));
+
+		if(m_ioQueue.Pop(priority, out))
+		{
+			m_numIOQueued--;
+			return true;
+		}
+		m_numIOJobsActive--;
+		return false;
+	}
+	// Takes the job with the highest priority, from this thread's queue first, then the IO queue and then the other threads
+	bool m_TakeJob(uint32 index, Job& out)
+	{
+		uint32 numThreads = (uint32)m_threadPool.size();
+		for(int32 p = numPriorities - 1; p >= 0; p--)
+		{
+			if(m_threadPool[index]->queue.Pop(p, out))
 			{
-				m_lock.lock();
-				if(!m_jobQueue.empty())
-				{
-					myThread->idleDuration.Restart();
-
-					// Process a job
-					Job peekJob = m_jobQueue.front();
-					if((peekJob->jobFlags & JobFlags::IO) != JobFlags::IO || (myThread->index != 0)) // Only perform IO on first thread
-					{
-						myThread->activeJob = m_jobQueue.PopFront();
-						m_lock.unlock();
-
-						// Run
-						myThread->activeJob->m_ret = myThread->activeJob->Run();
-						myThread->activeJob->m_finished = true;
-
-						// Add to finished queue
-						m_lock.lock();
-						m_finishedJobs.AddBack(myThread->activeJob);
-						m_lock.unlock();
-
-						// Clear the active job
-						myThread->activeJob.Release();
-					}
-					else
-					{
-						m_lock.unlock();
-					}
-				}
-				else
+				m_numQueued--;
+				return true;
+			}
+			if(m_TakeIOJob(p, out))
+				return true;
+			for(uint32 i = 1; i < numThreads; i++)
+			{
+				if(m_threadPool[(index + i) % numThreads]->queue.Pop(p, out))
 				{
-					// Just do nothing
-					m_lock.unlock();
+					m_numQueued--;
+					return true;
 				}
 			}
+		}
+		return false;
+	}
+
+	void m_RunJob(JobThread* myThread, Job&& job)
+	{
+		JobBase* jobPtr = GetJobData(job);
+		bool isIO = (jobPtr->jobFlags & JobFlags::IO) == JobFlags::IO;
+
+		// Terminate checks the active job after cancelling, so either the job is skipped here or waited for there
+		myThread->activeJob = jobPtr;
+		if(!jobPtr->m_cancelled)
+		{
+			uint64 latency = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - jobPtr->m_readyTime).count();
+			m_numJobsStarted++;
+			m_totalLatency += latency;
+			uint64 maxLatency = m_maxLatency;
+			while(latency > maxLatency && !m_maxLatency.compare_exchange_weak(maxLatency, latency))
+			{
+			}
+
+			// Run
+			PROFILE_ZONE(isIO ? "IO Job" : "Job");
+			jobPtr->m_ret = jobPtr->Run();
+			jobPtr->m_finished = true;
+		}
+
+		// Start jobs that were waiting for this one
+		Vector<Job> continuations;
+		m_dependencyLock.lock();
+		jobPtr->m_ran = true;
+		std::swap(continuations, jobPtr->m_continuations);
+		m_dependencyLock.unlock();
+		for(Job& continuation : continuations)
+		{
+			if(--GetJobData(continuation)->m_numDependencies == 0)
+				m_Push(std::move(continuation));
+		}
+
+		if(!jobPtr->m_internal)
+		{
+			// Add to finished queue
+			m_finishedLock.lock();
+			m_finishedJobs.push_back(std::move(job));
+			m_finishedLock.unlock();
+		}
+		else
+		{
+			// Only referenced by the queue
+			job.Release();
+		}
+
+		// Clear the active job
+		myThread->activeJob = nullptr;
+
+		if(isIO)
+		{
+			m_numIOJobsActive--;
+			if(m_numIOQueued > 0)
+				m_WakeOne();
+		}
+	}
+
+	// Single job thread
+	void m_JobThread(JobThread* myThread)
+	{
+		t_sheduler = this;
+		t_threadIndex = myThread->index;
+		Profiler::SetThreadName(Profiler::InternName(Utility::Sprintf("Job %d", myThread->index)));
+
+		while(true)
+		{
+			Job job;
+			if(m_TakeJob(myThread->index, job))
+			{
+				m_RunJob(myThread, std::move(job));
+				continue;
+			}
 
-			// Various idle levels
-			if(myThread->idleDuration.Minutes() > 1)
-				std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-			if(myThread->idleDuration.Seconds() > 1)
-				std::this_thread::sleep_for(std::chrono::milliseconds(500));
-			else
-				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			// Sleep until there is work to do
+			std::unique_lock<Mutex> lock(m_sleepLock);
+			m_wake.wait(lock, [this]() { return m_terminate || m_HasWork(); });
+			if(m_terminate)
+				break;
 		}
 	}
 };
-JobSheduler::JobSheduler()
+
+JobSheduler::JobSheduler(uint32 numThreads, uint32 maxIOJobs)
 {
-	m_impl = new JobSheduler_Impl();
+	m_impl = new JobSheduler_Impl(numThreads, maxIOJobs);
 }
 JobSheduler::~JobSheduler()
 {
@@ -205,7 +445,7 @@ bool JobSheduler::Queue(Job job)
 		return false;
 	}
 	// Can't queue finished jobs
-	if(job->IsFinished())
+	if(job->IsFinished() || job->m_cancelled)
 	{
 		Logf("Tried to register a finished job", Logger::Warning);
 		return false;
@@ -213,6 +453,108 @@ bool JobSheduler::Queue(Job job)
 
 	return m_impl->QueueUnchecked(job);
 }
+bool JobSheduler::Queue(Job job, const Vector<Job>& dependencies)
+{
+	if(job->IsQueued())
+	{
+		Logf("Tried to register a job twice", Logger::Warning);
+		return false;
+	}
+	if(job->IsFinished() || job->m_cancelled)
+	{
+		Logf("Tried to register a finished job", Logger::Warning);
+		return false;
+	}
+
+	return m_impl->QueueUnchecked(job, &dependencies);
+}
+
+// Work shared by the threads running a parallel for
+struct ParallelForState
+{
+	std::function<void(uint32, uint32)> func;
+	uint32 count;
+	uint32 batchSize;
+	uint32 numBatches;
+	std::atomic<uint32> nextBatch = { 0 };
+	std::atomic<uint32> numBatchesDone = { 0 };
+	Mutex lock;
+	std::condition_variable_any done;
+
+	// Processes batches until none are left
+	void Process()
+	{
+		uint32 numProcessed = 0;
+		while(true)
+		{
+			uint32 batch = nextBatch++;
+			if(batch >= numBatches)
+				break;
+			uint32 begin = batch * batchSize;
+			func(begin, Math::Min(begin + batchSize, count));
+			numProcessed++;
+		}
+		if(numProcessed > 0 && (numBatchesDone += numProcessed) == numBatches)
+		{
+			std::lock_guard<Mutex> guard(lock);
+			done.notify_all();
+		}
+	}
+};
+void JobSheduler::ParallelFor(uint32 count, const std::function<void(uint32 begin, uint32 end)>& func, uint32 batchSize)
+{
+	if(count == 0)
+		return;
+
+	uint32 numThreads = GetNumThreads();
+	if(batchSize == 0)
+		batchSize = (count + numThreads) / (numThreads + 1);
+	batchSize = Math::Max(batchSize, 1u);
+	uint32 numBatches = (count + batchSize - 1) / batchSize;
+	if(numBatches == 1)
+	{
+		func(0, count);
+		return;
+	}
+
+	// Helper jobs keep the state alive, in case they only start after all the work is done
+	std::shared_ptr<ParallelForState> state = std::make_shared<ParallelForState>();
+	state->func = func;
+	state->count = count;
+	state->batchSize = batchSize;
+	state->numBatches = numBatches;
+
+	uint32 numHelpers = Math::Min(numBatches - 1, numThreads);
+	for(uint32 i = 0; i < numHelpers; i++)
+	{
+		Job job = JobBase::CreateLambda([state]()
+		{
+			state->Process();
+			return true;
+		});
+		job->priority = JobPriority::High;
+		job->m_internal = true;
+		m_impl->QueueUnchecked(std::move(job));
+	}
+
+	// The calling thread helps out, this also keeps nested calls from job threads from waiting on themselves
+	state->Process();
+	std::unique_lock<Mutex> lock(state->lock);
+	state->done.wait(lock, [&]() { return state->numBatchesDone == state->numBatches; });
+}
+
+uint32 JobSheduler::GetNumThreads() const
+{
+	return (uint32)m_impl->m_threadPool.size();
+}
+JobShedulerStats JobSheduler::GetStats() const
+{
+	return m_impl->GetStats();
+}
+void JobSheduler::ResetStats()
+{
+	m_impl->ResetStats();
+}
 
 bool JobBase::IsFinished() const
 {
@@ -230,48 +572,12 @@ void JobBase::Terminate()
 {
 	if(!m_sheduler)
 		return; // Nothing to do
-	JobSheduler_Impl* sheduler = m_sheduler;
-
-	// Try to erase from queue first
-	m_sheduler->m_lock.lock();
-	for(auto it = sheduler->m_jobQueue.begin(); it != sheduler->m_jobQueue.end(); it++)
-	{
-		if(*it == this)
-		{
-			sheduler->m_jobQueue.erase(it);
-			m_sheduler = nullptr;
-			m_sheduler->m_lock.unlock();
-			return; // Ok
-		}
-	}
-	m_sheduler->m_lock.unlock();
-
-	// Wait for running job
-	for(JobThread* t : m_sheduler->m_threadPool)
-	{
-		if(t->activeJob == this)
-		{
-			// Wait for job to complete
-			while(t->activeJob == this)
-			{
-				std::this_thread::yield();
-			}
-			break;
-		}
-	}
 
-	// Remove from finished jobs list
-	m_sheduler->m_lock.lock();
-	for(auto it = m_sheduler->m_finishedJobs.rbegin(); it != m_sheduler->m_finishedJobs.rend(); it++)
-	{
-		if(*it == this)
-		{
-			m_sheduler->m_finishedJobs.erase(--(it.base()));
-			m_sheduler->m_lock.unlock();
-			return;
-		}
-	}
-	m_sheduler->m_lock.unlock();
+	// Queued jobs are skipped when a thread takes them
+	m_cancelled = true;
+	// Wait for running job and remove it from the finished jobs list
+	m_sheduler->Unregister(this);
+	m_sheduler = nullptr;
 }
 void JobBase::Finalize()
 {
@@ -3,9 +3,71 @@
 #include "Path.hpp"
 #include "File.hpp"
 #include "FileStream.hpp"
-#include "TextStream.hpp"
+#include "LockFreeQueue.hpp"
+#include "Thread.hpp"
+#include "Profiler.hpp"
 #include <ctime>
-#include <map>
+#include <cstdarg>
+#include <exception>
+#include <condition_variable>
+
+enum class LogRecordType : uint8
+{
+	// Full log line, header, message and newline
+	Message,
+	Header,
+	Text,
+	Color,
+};
+
+/*
+	Single queued log record
+	short messages are stored in the record itself, longer ones are copied to the heap
+*/
+struct LogRecord
+{
+	LogRecordType type;
+	// Severity or color
+	uint8 value;
+	uint32 length;
+	time_t time;
+	char* longText;
+	char text[200];
+
+	const char* GetText() const
+	{
+		return longText ? longText : text;
+	}
+};
+
+// Severity strings
+static const char* severityNames[] =
+{
+	"Normal",
+	"Warning",
+	"Error",
+	"Info",
+};
+
+static Logger::Color GetSeverityColor(Logger::Severity severity)
+{
+	switch(severity)
+	{
+	case Logger::Info:
+		return Logger::Gray;
+	case Logger::Warning:
+		return Logger::Yellow;
+	case Logger::Error:
+		return Logger::Red;
+	default:
+		return Logger::White;
+	}
+}
+
+// Maximum number of records waiting to be written
+static const uint32 queueSize = 4096;
+// Time the writer thread waits before checking for new records, in milliseconds
+static const uint32 writeInterval = 10;
 
 class Logger_Impl
 {
@@ -13,8 +75,25 @@ private:
 	File m_logFile;
 	FileWriter m_writer;
 
+	LockFreeQueue<LogRecord> m_queue;
+	std::atomic<uint64> m_numDropped;
+	uint64 m_numDroppedReported = 0;
+
+	// Held while records are being written, keeps the output in order when flushing from other threads
+	Mutex m_outputLock;
+	String m_consoleBuffer;
+	String m_fileBuffer;
+
+	Thread m_thread;
+	Mutex m_sleepLock;
+	std::condition_variable_any m_sleepCondition;
+	bool m_running = true;
+
+	static Logger_Impl* s_instance;
+	static std::terminate_handler s_oldTerminateHandler;
+
 public:
-	Logger_Impl()
+	Logger_Impl() : m_queue(queueSize), m_numDropped(0)
 	{
 		// Store the name of the executable
 		moduleName = Path::GetModuleName();
@@ -27,42 +106,250 @@ public:
 		// Log to file
 		m_logFile.OpenWrite(Utility::Sprintf("log_%s.txt", moduleName));
 		m_writer = FileWriter(m_logFile);
+
+		m_thread = Thread(&Logger_Impl::m_WriterThread, this);
+
+		// Write out queued messages before terminating because of an unhandled exception
+		//	fatal signals are left alone, writing the log isn't async-signal-safe
+		s_instance = this;
+		s_oldTerminateHandler = std::set_terminate(&Logger_Impl::TerminateHandler);
+	}
+	~Logger_Impl()
+	{
+		m_sleepLock.lock();
+		m_running = false;
+		m_sleepLock.unlock();
+		m_sleepCondition.notify_all();
+		if(m_thread.joinable())
+			m_thread.join();
+		Flush();
+		s_instance = nullptr;
 	}
 
-	void WriteHeader(Logger::Severity severity)
+	void Push(LogRecordType type, uint8 value, const char* text, size_t length)
 	{
-		// Severity strings
-		const char* severityNames[] =
+		LogRecord record;
+		record.type = type;
+		record.value = value;
+		record.time = type == LogRecordType::Header || type == LogRecordType::Message ? time(0) : 0;
+		record.length = (uint32)length;
+		record.longText = nullptr;
+		if(length < sizeof(record.text))
 		{
-			"Normal",
-			"Warning",
-			"Error",
-			"Info",
-		};
+			memcpy(record.text, text, length);
+			record.text[length] = 0;
+		}
+		else
+		{
+			record.longText = new char[length + 1];
+			memcpy(record.longText, text, length);
+			record.longText[length] = 0;
+		}
+		m_Push(record);
+	}
+	void PushFormat(Logger::Severity severity, const char* format, va_list args)
+	{
+		LogRecord record;
+		record.type = LogRecordType::Message;
+		record.value = (uint8)severity;
+		record.time = time(0);
+		record.longText = nullptr;
+
+		va_list argsCopy;
+		va_copy(argsCopy, args);
+		int32 length = vsnprintf(record.text, sizeof(record.text), format, args);
+		if(length < 0)
+		{
+			length = 0;
+			record.text[0] = 0;
+		}
+		else if(length >= (int32)sizeof(record.text))
+		{
+			record.longText = new char[length + 1];
+			vsnprintf(record.longText, length + 1, format, argsCopy);
+		}
+		va_end(argsCopy);
+		record.length = (uint32)length;
+		m_Push(record);
+	}
+
+	// Writes all queued records on the calling thread
+	void Flush()
+	{
+		std::lock_guard<Mutex> guard(m_outputLock);
+		m_WriteQueued();
+	}
+	// Flush that doesn't wait forever if another thread is stuck while writing
+	void FlushOnCrash()
+	{
+		for(uint32 i = 0; i < 100; i++)
+		{
+			if(m_outputLock.try_lock())
+			{
+				m_WriteQueued();
+				m_outputLock.unlock();
+				return;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+	uint64 GetNumDropped() const
+	{
+		return m_numDropped.load(std::memory_order_relaxed);
+	}
 
+#ifdef _WIN32
+	HANDLE consoleHandle;
+#endif
+	String moduleName;
+
+private:
+	void m_Push(LogRecord& record)
+	{
+		if(!m_queue.Push(record))
+		{
+			delete[] record.longText;
+			m_numDropped.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	void m_WriterThread()
+	{
+		Profiler::SetThreadName("Log");
+		std::unique_lock<Mutex> lock(m_sleepLock);
+		while(m_running)
+		{
+			// Producers never wake this thread, so logging doesn't need any system calls
+			m_sleepCondition.wait_for(lock, std::chrono::milliseconds(writeInterval));
+			lock.unlock();
+			Flush();
+			lock.lock();
+		}
+	}
+
+	// Needs the output lock
+	void m_WriteQueued()
+	{
+		LogRecord record;
+		while(m_queue.Pop(record))
+		{
+			switch(record.type)
+			{
+			case LogRecordType::Message:
+				m_WriteColor(GetSeverityColor((Logger::Severity)record.value));
+				m_WriteHeader((Logger::Severity)record.value, record.time);
+				m_WriteText(record.GetText(), record.length);
+				m_WriteText("\n", 1);
+				break;
+			case LogRecordType::Header:
+				m_WriteHeader((Logger::Severity)record.value, record.time);
+				break;
+			case LogRecordType::Text:
+				m_WriteText(record.GetText(), record.length);
+				break;
+			case LogRecordType::Color:
+				m_WriteColor((Logger::Color)record.value);
+				break;
+			}
+			delete[] record.longText;
+		}
+
+		uint64 numDropped = m_numDropped.load(std::memory_order_relaxed);
+		if(numDropped != m_numDroppedReported)
+		{
+			String msg = Utility::Sprintf("[%d log messages dropped]", (uint32)(numDropped - m_numDroppedReported));
+			m_numDroppedReported = numDropped;
+			m_WriteColor(Logger::Yellow);
+			m_WriteHeader(Logger::Warning, time(0));
+			m_WriteText(msg.data(), msg.size());
+			m_WriteText("\n", 1);
+		}
+
+		m_WriteBuffers();
+	}
+	void m_WriteHeader(Logger::Severity severity, time_t recordTime)
+	{
 		// Format a timestamp string
 		char timeStr[64];
-		time_t currentTime = time(0);
-		tm* currentLocalTime = localtime(&currentTime);
-		strftime(timeStr, sizeof(timeStr), "%T", currentLocalTime);
+		tm* localTime = localtime(&recordTime);
+		strftime(timeStr, sizeof(timeStr), "%T", localTime);
 
 		// Write the formated header
-		Write(Utility::Sprintf("[%s][%s] ", timeStr, severityNames[(size_t)severity]));
+		char header[128];
+		int32 length = snprintf(header, sizeof(header), "[%s][%s] ", timeStr, severityNames[(size_t)severity]);
+		m_WriteText(header, length);
 	}
-	void Write(const String& msg)
+	void m_WriteText(const char* text, size_t length)
+	{
+		m_consoleBuffer.append(text, length);
+		m_fileBuffer.append(text, length);
+	}
+	void m_WriteColor(Logger::Color color)
 	{
 #ifdef _WIN32
-		OutputDebugStringA(*msg);
+		// The console color applies to text written after it is set
+		m_WriteConsole();
+		if(consoleHandle)
+		{
+			static uint8 params[] =
+			{
+				FOREGROUND_INTENSITY | FOREGROUND_RED,
+				FOREGROUND_INTENSITY | FOREGROUND_GREEN,
+				FOREGROUND_INTENSITY | FOREGROUND_BLUE,
+				FOREGROUND_INTENSITY | FOREGROUND_BLUE | FOREGROUND_GREEN, // Yellow,
+				FOREGROUND_INTENSITY | FOREGROUND_BLUE | FOREGROUND_RED, // Cyan,
+				FOREGROUND_INTENSITY | FOREGROUND_GREEN | FOREGROUND_RED, // Magenta,
+				FOREGROUND_BLUE | FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_INTENSITY, // White
+				FOREGROUND_BLUE | FOREGROUND_RED | FOREGROUND_GREEN, // Gray
+			};
+			SetConsoleTextAttribute(consoleHandle, params[(size_t)color]);
+		}
+#else
+		static const char* params[] =
+		{
+			"\x1b[38;2;200;0;0m", // Red
+			"\x1b[38;2;0;200;0m", // Green
+			"\x1b[38;2;0;70;200m", // Blue
+			"\x1b[38;2;200;180;0m", // Yellow
+			"\x1b[38;2;0;200;200m", // Cyan
+			"\x1b[38;2;200;0;200m", // Magenta
+			"\x1b[39m", // White
+			"\x1b[38;2;140;140;140m", // Gray
+		};
+		m_consoleBuffer += params[(size_t)color];
 #endif
-		printf("%s", msg.c_str());
-		TextStream::Write(m_writer, msg);
 	}
-
+	void m_WriteConsole()
+	{
+		if(m_consoleBuffer.empty())
+			return;
+		fwrite(m_consoleBuffer.data(), 1, m_consoleBuffer.size(), stdout);
+		fflush(stdout);
+		m_consoleBuffer.clear();
+	}
+	void m_WriteBuffers()
+	{
+		m_WriteConsole();
+		if(m_fileBuffer.empty())
+			return;
 #ifdef _WIN32
-	HANDLE consoleHandle;
+		OutputDebugStringA(*m_fileBuffer);
 #endif
-	String moduleName;
+		m_writer.Serialize(&m_fileBuffer.front(), m_fileBuffer.size());
+		m_fileBuffer.clear();
+	}
+
+	static void TerminateHandler()
+	{
+		if(s_instance)
+			s_instance->FlushOnCrash();
+		if(s_oldTerminateHandler)
+			s_oldTerminateHandler();
+		abort();
+	}
 };
+Logger_Impl* Logger_Impl::s_instance = nullptr;
+std::terminate_handler Logger_Impl::s_oldTerminateHandler = nullptr;
 
 Logger::Logger()
 {
@@ -70,11 +357,11 @@ Logger::Logger()
 }
 Logger::~Logger()
 {
+	delete m_impl;
 #ifndef _WIN32
 	// Reset terminal colors
 	printf("\x1b[39m\x1b[0m");
 #endif
-	delete m_impl;
 }
 Logger& Logger::Get()
 {
@@ -83,67 +370,34 @@ Logger& Logger::Get()
 }
 void Logger::SetColor(Color color)
 {
-#ifdef _WIN32
-	if(m_impl->consoleHandle)
-	{
-		static uint8 params[] =
-		{
-			FOREGROUND_INTENSITY | FOREGROUND_RED,
-			FOREGROUND_INTENSITY | FOREGROUND_GREEN,
-			FOREGROUND_INTENSITY | FOREGROUND_BLUE,
-			FOREGROUND_INTENSITY | FOREGROUND_BLUE | FOREGROUND_GREEN, // Yellow,
-			FOREGROUND_INTENSITY | FOREGROUND_BLUE | FOREGROUND_RED, // Cyan,
-			FOREGROUND_INTENSITY | FOREGROUND_GREEN | FOREGROUND_RED, // Magenta,
-			FOREGROUND_BLUE | FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_INTENSITY, // White
-			FOREGROUND_BLUE | FOREGROUND_RED | FOREGROUND_GREEN, // Gray
-		};
-		SetConsoleTextAttribute(m_impl->consoleHandle, params[(size_t)color]);
-	}
-#else
-	static std::map<Color, const char*> params = {
-		{Color::Red,     "200;0;0"},
-		{Color::Green,   "0;200;0"},
-		{Color::Blue,    "0;70;200"},
-		{Color::Yellow,  "200;180;0"},
-		{Color::Cyan,    "0;200;200"},
-		{Color::Magenta, "200;0;200"},
-		{Color::Gray,    "140;140;140"}
-	};
-	if(color == Color::White)
-		printf("\x1b[39m");
-	else
-		printf("\x1b[38;2;%sm", params[color]);
-#endif
+	m_impl->Push(LogRecordType::Color, (uint8)color, "", 0);
 }
 void Logger::Log(const String& msg, Logger::Severity severity)
 {
-	switch(severity)
-	{
-	case Normal:
-		SetColor(White);
-		break;
-	case Info:
-		SetColor(Gray);
-		break;
-	case Warning:
-		SetColor(Yellow);
-		break;
-	case Error:
-		SetColor(Red);
-		break;
-	}
-
-	m_impl->WriteHeader(severity);
-	m_impl->Write(msg);
-	m_impl->Write("\n");
+	m_impl->Push(LogRecordType::Message, (uint8)severity, msg.data(), msg.size());
+}
+void Logger::LogFormat(Logger::Severity severity, const char* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	m_impl->PushFormat(severity, format, args);
+	va_end(args);
 }
 void Logger::WriteHeader(Severity severity)
 {
-	m_impl->WriteHeader(severity);
+	m_impl->Push(LogRecordType::Header, (uint8)severity, "", 0);
 }
 void Logger::Write(const String& msg)
 {
-	m_impl->Write(msg);
+	m_impl->Push(LogRecordType::Text, 0, msg.data(), msg.size());
+}
+void Logger::Flush()
+{
+	m_impl->Flush();
+}
+uint64 Logger::GetNumDropped() const
+{
+	return m_impl->GetNumDropped();
 }
 void Log(const String& msg, Logger::Severity severity)
 {
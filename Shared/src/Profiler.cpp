@@ -0,0 +1,279 @@
+#include "stdafx.h"
+#include "Profiler.hpp"
+#include "Thread.hpp"
+#include "File.hpp"
+#include "Log.hpp"
+#include "Math.hpp"
+#include "Set.hpp"
+#include <chrono>
+
+std::atomic<bool> Profiler::m_enabled(false);
+
+enum class ProfilerEventType : uint8
+{
+	Begin,
+	End,
+	Counter,
+	Frame,
+};
+struct ProfilerEvent
+{
+	const char* name;
+	uint64 time;
+	double value;
+	ProfilerEventType type;
+};
+
+/*
+	Events recorded by a single thread, only written by that thread
+	buffers are kept until the program exits so events of threads that have stopped can still be exported
+
+	Other threads read the buffer like a sequence lock, they copy the events and then check which of them were overwritten while copying
+*/
+struct ProfilerThreadBuffer
+{
+	uint32 id;
+	std::atomic<const char*> name;
+	// Number of events that started being written
+	std::atomic<uint64> numStarted;
+	// Total number of events written, the buffer holds the last bufferSize of them
+	std::atomic<uint64> numEvents;
+	ProfilerEvent events[Profiler::bufferSize];
+};
+
+static const std::chrono::steady_clock::time_point s_startTime = std::chrono::steady_clock::now();
+static Mutex s_lock;
+static Vector<ProfilerThreadBuffer*> s_buffers;
+static Set<String> s_internedNames;
+
+static thread_local ProfilerThreadBuffer* t_buffer = nullptr;
+static thread_local const char* t_threadName = nullptr;
+
+// Frame analysis, only used by the main thread
+static uint64 s_frameEventIndex = 0;
+static uint64 s_frameStartTime = 0;
+static bool s_hasFrame = false;
+static Vector<Profiler::FrameZone> s_lastFrameZones;
+static double s_lastFrameTime = 0.0;
+
+static ProfilerThreadBuffer* GetThreadBuffer()
+{
+	if(!t_buffer)
+	{
+		ProfilerThreadBuffer* buffer = new ProfilerThreadBuffer();
+		buffer->numStarted = 0;
+		buffer->numEvents = 0;
+		std::lock_guard<Mutex> guard(s_lock);
+		buffer->id = (uint32)s_buffers.size();
+		buffer->name = t_threadName;
+		s_buffers.Add(buffer);
+		t_buffer = buffer;
+	}
+	return t_buffer;
+}
+static void AddEvent(ProfilerEventType type, const char* name, double value = 0.0)
+{
+	ProfilerThreadBuffer* buffer = GetThreadBuffer();
+	uint64 index = buffer->numEvents.load(std::memory_order_relaxed);
+	buffer->numStarted.store(index + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	ProfilerEvent& event = buffer->events[index % Profiler::bufferSize];
+	event.type = type;
+	event.name = name;
+	event.value = value;
+	event.time = Profiler::GetTime();
+	buffer->numEvents.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::SetEnabled(bool enabled)
+{
+	m_enabled = enabled;
+	Logf("Profiler %s", Logger::Info, enabled ? "enabled" : "disabled");
+}
+void Profiler::SetThreadName(const char* name)
+{
+	if(t_threadName == name)
+		return;
+	t_threadName = name;
+	if(t_buffer)
+		t_buffer->name = name;
+}
+const char* Profiler::InternName(const String& name)
+{
+	std::lock_guard<Mutex> guard(s_lock);
+	// Set elements don't move
+	return s_internedNames.insert(name).first->c_str();
+}
+
+uint64 Profiler::GetTime()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_startTime).count();
+}
+
+void Profiler::BeginZone(const char* name)
+{
+	AddEvent(ProfilerEventType::Begin, name);
+}
+void Profiler::EndZone()
+{
+	AddEvent(ProfilerEventType::End, nullptr);
+}
+void Profiler::Counter(const char* name, double value)
+{
+	if(!IsEnabled())
+		return;
+	AddEvent(ProfilerEventType::Counter, name, value);
+}
+
+void Profiler::BeginFrame()
+{
+	if(!IsEnabled())
+	{
+		s_hasFrame = false;
+		return;
+	}
+
+	ProfilerThreadBuffer* buffer = GetThreadBuffer();
+	uint64 frameEnd = buffer->numEvents;
+	uint64 now = GetTime();
+	if(s_hasFrame && frameEnd - s_frameEventIndex < bufferSize)
+	{
+		// Sum up the zones of the previous frame, zones are added when they start to keep them in order
+		s_lastFrameZones.clear();
+		Vector<std::pair<size_t, uint64>> stack;
+		for(uint64 i = s_frameEventIndex; i < frameEnd; i++)
+		{
+			const ProfilerEvent& event = buffer->events[i % bufferSize];
+			if(event.type == ProfilerEventType::Begin)
+			{
+				uint32 depth = (uint32)stack.size();
+				size_t index = 0;
+				for(; index < s_lastFrameZones.size(); index++)
+				{
+					if(s_lastFrameZones[index].depth == depth && strcmp(s_lastFrameZones[index].name, event.name) == 0)
+						break;
+				}
+				if(index == s_lastFrameZones.size())
+					s_lastFrameZones.Add({ event.name, depth, 0, 0.0 });
+				stack.Add({ index, event.time });
+			}
+			else if(event.type == ProfilerEventType::End && !stack.empty())
+			{
+				FrameZone& zone = s_lastFrameZones[stack.back().first];
+				zone.count++;
+				zone.duration += (double)(event.time - stack.back().second) * 1e-9;
+				stack.pop_back();
+			}
+		}
+		s_lastFrameTime = (double)(now - s_frameStartTime) * 1e-9;
+	}
+
+	AddEvent(ProfilerEventType::Frame, "Frame");
+	s_frameEventIndex = buffer->numEvents;
+	s_frameStartTime = now;
+	s_hasFrame = true;
+}
+const Vector<Profiler::FrameZone>& Profiler::GetLastFrameZones()
+{
+	return s_lastFrameZones;
+}
+double Profiler::GetLastFrameTime()
+{
+	return s_lastFrameTime;
+}
+
+// Escapes a name for use in a json string
+static String EscapeJson(const char* str)
+{
+	String ret;
+	for(; *str; str++)
+	{
+		if(*str == '"' || *str == '\\')
+			ret += '\\';
+		if((uint8)*str < 0x20)
+			continue;
+		ret += *str;
+	}
+	return ret;
+}
+bool Profiler::ExportChromeTrace(const String& path)
+{
+	Vector<ProfilerThreadBuffer*> buffers;
+	s_lock.lock();
+	buffers = s_buffers;
+	s_lock.unlock();
+
+	String json = "{\"traceEvents\":[\n";
+	bool first = true;
+	auto AddJson = [&](const String& event)
+	{
+		if(!first)
+			json += ",\n";
+		json += event;
+		first = false;
+	};
+	size_t numEvents = 0;
+	for(ProfilerThreadBuffer* buffer : buffers)
+	{
+		const char* name = buffer->name;
+		String threadName = name ? EscapeJson(name) : Utility::Sprintf("Thread %d", buffer->id);
+		AddJson(Utility::Sprintf("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", buffer->id, threadName));
+
+		// Copy the events first, the thread can still be recording
+		uint64 end = buffer->numEvents.load(std::memory_order_acquire);
+		uint64 start = end > bufferSize ? end - bufferSize : 0;
+		Vector<ProfilerEvent> events;
+		events.resize((size_t)(end - start));
+		for(uint64 i = start; i < end; i++)
+			events[(size_t)(i - start)] = buffer->events[i % bufferSize];
+
+		// Events that were overwritten by writes that started during the copy are skipped
+		std::atomic_thread_fence(std::memory_order_acquire);
+		uint64 numStarted = buffer->numStarted.load(std::memory_order_relaxed);
+		uint64 firstValid = numStarted > bufferSize ? numStarted - bufferSize : 0;
+
+		// Zones are written as complete events, zones without a start or end in the buffer are left out
+		Vector<const ProfilerEvent*> stack;
+		for(uint64 i = Math::Max(start, firstValid); i < end; i++)
+		{
+			const ProfilerEvent& event = events[(size_t)(i - start)];
+			double time = (double)event.time / 1000.0;
+			switch(event.type)
+			{
+			case ProfilerEventType::Begin:
+				stack.Add(&event);
+				break;
+			case ProfilerEventType::End:
+				if(!stack.empty())
+				{
+					const ProfilerEvent* begin = stack.back();
+					stack.pop_back();
+					AddJson(Utility::Sprintf("{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+						EscapeJson(begin->name), buffer->id, (double)begin->time / 1000.0, (double)(event.time - begin->time) / 1000.0));
+					numEvents++;
+				}
+				break;
+			case ProfilerEventType::Counter:
+				AddJson(Utility::Sprintf("{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"args\":{\"value\":%f}}",
+					EscapeJson(event.name), buffer->id, time, event.value));
+				numEvents++;
+				break;
+			case ProfilerEventType::Frame:
+				AddJson(Utility::Sprintf("{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":%d,\"ts\":%.3f}", buffer->id, time));
+				numEvents++;
+				break;
+			}
+		}
+	}
+	json += "\n]}\n";
+
+	File file;
+	if(!file.OpenWrite(path))
+	{
+		Logf("Failed to open profiler trace file for writing: %s", Logger::Warning, path);
+		return false;
+	}
+	file.Write(json.data(), json.size());
+	Logf("Exported %d profiler events to %s", Logger::Info, (uint32)numEvents, path);
+	return true;
+}
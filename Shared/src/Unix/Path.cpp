@@ -81,6 +81,10 @@ String Path::GetCurrentPath()
 	getcwd(currDir, MAX_PATH);
 	return currDir;
 }
+bool Path::SetCurrentPath(const String& path)
+{
+	return chdir(*path) == 0;
+}
 String Path::GetExecutablePath()
 {
 	#ifdef __APPLE__
@@ -57,6 +57,10 @@ String Path::GetCurrentPath()
 	GetCurrentDirectoryA(sizeof(currDir), currDir);
 	return currDir;
 }
+bool Path::SetCurrentPath(const String& path)
+{
+	return SetCurrentDirectoryA(*path) == TRUE;
+}
 String Path::GetExecutablePath()
 {
 	char filename[MAX_PATH];
@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include <Audio/Audio.hpp>
 #include <Audio/DSP.hpp>
+#include <Audio/AudioStreamBase.hpp>
 #include <float.h>
 #include "TestMusicPlayer.hpp"
 
@@ -45,6 +46,44 @@ Test("Audio.Playback")
 	delete audio;
 }
 
+Test("Audio.DSPCommands")
+{
+	class SilentAudio : public AudioBase
+	{
+	public:
+		virtual void Process(float* out, uint32 numSamples) override
+		{
+		}
+	};
+	SilentAudio track;
+
+	PanDSP dsps[3];
+	dsps[0].priority = 2;
+	dsps[1].priority = 0;
+	dsps[2].priority = 1;
+	for(auto& dsp : dsps)
+		track.QueueAddDSP(&dsp);
+	// Nothing changes until the audio thread applies the commands
+	TestEnsure(track.DSPs.empty() && dsps[0].IsQueued());
+	track.ApplyDSPCommands();
+	TestEnsure(!dsps[0].IsQueued() && dsps[0].audioBase == &track);
+	// Sorted by priority
+	TestEnsure(track.DSPs.size() == 3 && track.DSPs[0] == &dsps[1] && track.DSPs[1] == &dsps[2] && track.DSPs[2] == &dsps[0]);
+
+	// More commands than fit in the queue
+	for(uint32 i = 0; i < 500; i++)
+	{
+		track.QueueRemoveDSP(&dsps[i % 3]);
+		track.QueueAddDSP(&dsps[i % 3]);
+	}
+	for(auto& dsp : dsps)
+		track.QueueRemoveDSP(&dsp);
+	track.ApplyDSPCommands();
+	TestEnsure(track.DSPs.empty());
+	for(auto& dsp : dsps)
+		TestEnsure(!dsp.IsQueued() && dsp.audioBase == nullptr);
+}
+
 Test("Audio.Music.Phaser")
 {
 	class MusicPlayer : public TestMusicPlayer
@@ -310,3 +349,119 @@ Test("Audio.Music.Flanger")
 	mp.Init(testSongPath, testSongOffset);
 	mp.Run();
 }
+
+Test("Audio.MP3SeekIndex")
+{
+	Audio* audio = new Audio();
+	TestEnsure(audio->Init());
+
+	// Silent MPEG1 layer III frames, 44.1kHz stereo
+	//	the bitrate changes every frame, so seeking to the wrong frame doesn't line up with the frame lengths
+	const uint32 numFrames = 1000;
+	const uint8 bitrateBytes[] = { 0x90, 0x50, 0xB2 }; // 128kbps, 64kbps, 192kbps with padding
+	const uint32 frameLengths[] = { 417, 208, 627 };
+	Buffer data;
+	for(uint32 i = 0; i < numFrames; i++)
+	{
+		size_t start = data.size();
+		data.resize(start + frameLengths[i % 3]);
+		memset(data.data() + start, 0, frameLengths[i % 3]);
+		uint8* header = data.data() + start;
+		header[0] = 0xFF;
+		header[1] = 0xFB;
+		header[2] = bitrateBytes[i % 3];
+		header[3] = 0x00;
+	}
+	String path = Path::Normalize(TestBasePath + "/seekindex.mp3");
+	String indexPath = path + ".seekindex";
+	Path::Delete(indexPath);
+	File file;
+	TestEnsure(file.OpenWrite(path));
+	file.Write(data.data(), data.size());
+	file.Close();
+
+	// Sample positions of the frames when decoding from the start, opening the stream decodes the first frame
+	//	every frame has 1152 samples, the last frame isn't decoded because reaching the end of the data ends the stream
+	Vector<int32> frameStarts = { 0 };
+	int32 endPosition = 0;
+	{
+		AudioStream stream = audio->CreateStream(path, true);
+		TestEnsure(stream.IsValid());
+		AudioStreamBase* base = dynamic_cast<AudioStreamBase*>(stream.GetData());
+		while(true)
+		{
+			int32 start = base->GetStreamPosition_Internal();
+			if(base->DecodeData_Internal() <= 0)
+				break;
+			frameStarts.Add(start);
+		}
+		endPosition = base->GetStreamPosition_Internal();
+	}
+	TestEnsure(frameStarts.size() == numFrames - 1);
+	for(uint32 i = 0; i < frameStarts.size(); i++)
+		TestEnsure(frameStarts[i] == (int32)i * 1152);
+	// Decoding to the end completes the index
+	TestEnsure(Path::FileExists(indexPath));
+	Path::Delete(indexPath);
+
+	// Seeking to the start or into a frame lands on the start of that frame,
+	//	decoding from there gives the same frames as decoding from the start
+	auto SeeksLikeLinearDecode = [&](AudioStream stream)
+	{
+		AudioStreamBase* base = dynamic_cast<AudioStreamBase*>(stream.GetData());
+		const size_t frames[] = { 300, 17, 0, 16, frameStarts.size() - 1, 161 };
+		for(size_t frame : frames)
+		{
+			for(int32 offset : { 0, 700 })
+			{
+				base->SetPosition_Internal(frameStarts[frame] + offset);
+				if(base->GetStreamPosition_Internal() != frameStarts[frame])
+					return false;
+				size_t numDecoded = 0;
+				while(base->DecodeData_Internal() > 0)
+					numDecoded++;
+				if(numDecoded != frameStarts.size() - frame || base->GetStreamPosition_Internal() != endPosition)
+					return false;
+			}
+		}
+		return true;
+	};
+
+	// Only the frames up to the playback position are scanned, so there is no complete index to store yet
+	{
+		AudioStream stream = audio->CreateStream(path, true);
+		TestEnsure(stream.IsValid());
+		stream->SetPosition(5000);
+	}
+	TestEnsure(!Path::FileExists(indexPath));
+
+	// Seeking past the end scans the remaining frames
+	{
+		AudioStream stream = audio->CreateStream(path, true);
+		TestEnsure(stream.IsValid());
+		stream->SetPosition(60000);
+	}
+	TestEnsure(Path::FileExists(indexPath));
+	Path::Delete(indexPath);
+
+	// Index built while seeking
+	{
+		AudioStream stream = audio->CreateStream(path, true);
+		TestEnsure(stream.IsValid());
+		TestEnsure(SeeksLikeLinearDecode(stream));
+	}
+	TestEnsure(Path::FileExists(indexPath));
+
+	// Stored index is used the next time the file is opened
+	{
+		AudioStream stream = audio->CreateStream(path, true);
+		TestEnsure(stream.IsValid());
+		TestEnsure(SeeksLikeLinearDecode(stream));
+		stream->SetPosition(20000);
+		TestEnsure(!stream->HasEnded());
+	}
+
+	Path::Delete(indexPath);
+	Path::Delete(path);
+	delete audio;
+}
@@ -0,0 +1,234 @@
+#include "stdafx.h"
+#include <Beatmap/Database.hpp>
+#include <Beatmap/DatabaseWriter.hpp>
+
+// Path of a database in the test folder, files left by earlier runs are deleted so the database starts out empty
+static String NewDatabasePath(TestContext& context, const String& name)
+{
+	String path = Path::Normalize(TestBasePath + "/" + name);
+	Path::Delete(path);
+	Path::Delete(path + "-wal");
+	Path::Delete(path + "-shm");
+	return path;
+}
+
+// Fills a database with the same tables as the map database
+static void GenerateMapDatabase(Database& database, uint32 numMaps)
+{
+	database.Exec("CREATE TABLE Maps(artist TEXT, title TEXT, tags TEXT, path TEXT)");
+	database.Exec("CREATE TABLE Scores(score INTEGER, crit INTEGER, near INTEGER, miss INTEGER, gauge REAL, diffid INTEGER)");
+	database.Exec("BEGIN");
+	for(uint32 i = 0; i < numMaps; i++)
+	{
+		DBStatement addMap = database.CachedQuery("INSERT INTO Maps(path,artist,title,tags,rowid) VALUES(?,?,?,?,?)");
+		addMap.BindString(1, Utility::Sprintf("songs/pack%d/map%d", i / 100, i));
+		addMap.BindString(2, Utility::Sprintf("Artist %d", i % 1000));
+		addMap.BindString(3, Utility::Sprintf("Title %d", i));
+		addMap.BindString(4, "");
+		addMap.BindInt(5, i + 1);
+		addMap.Step();
+	}
+	database.Exec("END");
+}
+
+Test("Database.StatementCache")
+{
+	Database database;
+	TestEnsure(database.Open(NewDatabasePath(context, "cache.db")));
+	GenerateMapDatabase(database, 1000);
+	TestEnsure(database.GetNumCachedStatements() == 1);
+
+	{
+		DBStatement first = database.CachedQuery("SELECT title FROM Maps WHERE rowid=?");
+		first.BindInt(1, 10);
+		TestEnsure(first.StepRow() && first.StringColumn(0) == "Title 9");
+
+		// Still in use, so this gets a separate statement
+		DBStatement second = database.CachedQuery("SELECT title FROM Maps WHERE rowid=?");
+		second.BindInt(1, 20);
+		TestEnsure(second.StepRow() && second.StringColumn(0) == "Title 19");
+	}
+	TestEnsure(database.GetNumCachedStatements() == 2);
+
+	// Reused statements start over with cleared bindings
+	DBStatement reused = database.CachedQuery("SELECT title FROM Maps WHERE rowid=?");
+	TestEnsure(!reused.StepRow());
+	reused.Finish();
+	TestEnsure(database.GetNumCachedStatements() == 2);
+	database.Close();
+}
+
+Test("Database.Benchmark")
+{
+	const uint32 numMaps = 50000;
+	const uint32 numLookups = 20000;
+	const uint32 numCommits = 200;
+
+	for(uint32 tuned = 0; tuned < 2; tuned++)
+	{
+		Database database;
+		String path = NewDatabasePath(context, Utility::Sprintf("benchmark%d.db", tuned));
+		TestEnsure(database.Open(path, tuned ? DatabaseSettings::Tuned() : DatabaseSettings()));
+
+		Timer timer;
+		GenerateMapDatabase(database, numMaps);
+		double generateTime = timer.SecondsAsDouble();
+
+		// Lookups with and without compiling the statement every time
+		int64 uncachedSum = 0;
+		timer.Restart();
+		for(uint32 i = 0; i < numLookups; i++)
+		{
+			DBStatement lookup = database.Query("SELECT rowid,path FROM Maps WHERE rowid=?");
+			lookup.BindInt(1, (i * 7919) % numMaps + 1);
+			if(lookup.StepRow())
+				uncachedSum += lookup.IntColumn(0);
+		}
+		double uncachedTime = timer.SecondsAsDouble();
+
+		int64 cachedSum = 0;
+		timer.Restart();
+		for(uint32 i = 0; i < numLookups; i++)
+		{
+			DBStatement lookup = database.CachedQuery("SELECT rowid,path FROM Maps WHERE rowid=?");
+			lookup.BindInt(1, (i * 7919) % numMaps + 1);
+			if(lookup.StepRow())
+				cachedSum += lookup.IntColumn(0);
+		}
+		double cachedTime = timer.SecondsAsDouble();
+		TestEnsure(cachedSum == uncachedSum);
+
+		// Small transactions, like adding scores
+		timer.Restart();
+		for(uint32 i = 0; i < numCommits; i++)
+		{
+			database.Exec("BEGIN");
+			DBStatement addScore = database.CachedQuery("INSERT INTO Scores(score,crit,near,miss,gauge,diffid) VALUES(?,?,?,?,?,?)");
+			addScore.BindInt(1, 9000000 + i);
+			addScore.BindInt(2, i);
+			addScore.BindInt(3, 0);
+			addScore.BindInt(4, 0);
+			addScore.BindDouble(5, 1.0);
+			addScore.BindInt(6, i % numMaps + 1);
+			addScore.Step();
+			addScore.Finish();
+			database.Exec("END");
+		}
+		double commitTime = timer.SecondsAsDouble();
+
+		Logf("%s settings: generated %d maps in %.1f ms, %d lookups %.1f ms uncached / %.1f ms cached, %d commits in %.1f ms", Logger::Info,
+			tuned ? "Tuned" : "Default", numMaps, generateTime * 1000.0, numLookups, uncachedTime * 1000.0, cachedTime * 1000.0,
+			numCommits, commitTime * 1000.0);
+		database.Close();
+	}
+}
+
+Test("Database.Writer")
+{
+	String path = NewDatabasePath(context, "writer.db");
+	Database database;
+	TestEnsure(database.Open(path, DatabaseSettings::Tuned()));
+	database.Exec("CREATE TABLE Scores(score INTEGER, diffid INTEGER)");
+
+	const uint32 numScores = 1000;
+	uint32 numCallbacks = 0;
+	Vector<std::future<bool>> results;
+	{
+		DatabaseWriter writer;
+		TestEnsure(writer.Open(path, DatabaseSettings::Tuned()));
+		for(uint32 i = 0; i < numScores; i++)
+		{
+			results.emplace_back(writer.Queue([=](Database& db)
+			{
+				DBStatement addScore = db.CachedQuery("INSERT INTO Scores(score,diffid) VALUES(?,?)");
+				addScore.BindInt(1, i);
+				addScore.BindInt(2, i % 10);
+				return addScore.Step();
+			}, [&](bool success)
+			{
+				if(success)
+					numCallbacks++;
+			}));
+		}
+		// Failing commands are rolled back without affecting the others
+		results.emplace_back(writer.Queue([](Database& db)
+		{
+			db.Exec("INSERT INTO Scores(score,diffid) VALUES(-1,-1)");
+			return false;
+		}));
+
+		// Reads see the pending writes after a flush
+		writer.Flush();
+		TestEnsure(!writer.HasPendingWrites());
+		DBStatement count = database.Query("SELECT COUNT(*) FROM Scores");
+		TestEnsure(count.StepRow() && count.IntColumn(0) == numScores);
+		count.Finish();
+		for(uint32 i = 0; i < numScores; i++)
+			TestEnsure(results[i].get());
+		TestEnsure(!results.back().get());
+		// Writes are grouped into a few transactions
+		Logf("%d commands written in %d transactions", Logger::Info, numScores + 1, writer.GetNumTransactions());
+		TestEnsure(writer.GetNumTransactions() < numScores / 10);
+
+		// Callbacks are called on the thread that updates the writer
+		TestEnsure(numCallbacks == 0);
+		writer.Update();
+		TestEnsure(numCallbacks == numScores);
+
+		// Destroying the writer writes the remaining commands
+		writer.Queue([](Database& db)
+		{
+			return db.Exec("INSERT INTO Scores(score,diffid) VALUES(-2,-2)");
+		});
+	}
+	DBStatement last = database.Query("SELECT COUNT(*) FROM Scores WHERE score=-2");
+	TestEnsure(last.StepRow() && last.IntColumn(0) == 1);
+	last.Finish();
+	database.Close();
+}
+
+Test("Database.WriterLocked")
+{
+	String path = NewDatabasePath(context, "writerlocked.db");
+	DatabaseSettings settings = DatabaseSettings::Tuned();
+	settings.busyTimeout = 10;
+	Database database;
+	TestEnsure(database.Open(path, settings));
+	database.Exec("CREATE TABLE Scores(score INTEGER, diffid INTEGER)");
+
+	DatabaseWriter writer;
+	TestEnsure(writer.Open(path, settings));
+	auto AddScore = [&](int32 score)
+	{
+		return writer.Queue([=](Database& db)
+		{
+			return db.Exec(Utility::Sprintf("INSERT INTO Scores(score,diffid) VALUES(%d,0)", score));
+		});
+	};
+	auto CountScores = [&]()
+	{
+		DBStatement count = database.Query("SELECT COUNT(*) FROM Scores");
+		int32 result = count.StepRow() ? count.IntColumn(0) : -1;
+		count.Finish();
+		return result;
+	};
+
+	// Commands fail without being written while another connection holds the write lock
+	TestEnsure(database.Exec("BEGIN IMMEDIATE"));
+	std::future<bool> first = AddScore(1);
+	std::future<bool> second = AddScore(2);
+	writer.Flush();
+	TestEnsure(!first.get());
+	TestEnsure(!second.get());
+	TestEnsure(database.Exec("ROLLBACK"));
+	TestEnsure(CountScores() == 0);
+
+	// Writes again once the lock is released
+	std::future<bool> third = AddScore(3);
+	writer.Flush();
+	TestEnsure(third.get());
+	TestEnsure(CountScores() == 1);
+
+	writer.Close();
+	database.Close();
+}
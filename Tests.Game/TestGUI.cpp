@@ -1 +1,152 @@
-#include "stdafx.h"
\ No newline at end of file
+#include "stdafx.h"
+#include <Graphics/RenderQueue.hpp>
+#include <Graphics/Font.hpp>
+using namespace Graphics;
+#include <GUI/GUI.hpp>
+
+// Element with a fixed size that counts how often its size is requested
+class FixedSizeElement : public GUIElementBase
+{
+public:
+	FixedSizeElement(Vector2 size) : size(size)
+	{
+	}
+	virtual void Render(GUIRenderData rd) override
+	{
+	}
+	virtual Vector2 GetDesiredSize(GUIRenderData rd) override
+	{
+		numSizeRequests++;
+		return size;
+	}
+	void SetSize(Vector2 newSize)
+	{
+		size = newSize;
+		InvalidateLayout();
+	}
+
+	Vector2 size;
+	static uint32 numSizeRequests;
+};
+uint32 FixedSizeElement::numSizeRequests = 0;
+
+// Builds a song select like tree of canvases, layout boxes and panels
+static Ref<Canvas> CreateTestLayout(uint32 numItems, Vector<FixedSizeElement*>& leaves)
+{
+	Ref<Canvas> root = Ref<Canvas>(new Canvas());
+	LayoutBox* list = new LayoutBox();
+	list->layoutDirection = LayoutBox::Vertical;
+	Canvas::Slot* listSlot = root->Add(list->MakeShared());
+	listSlot->anchor = Anchors::Full;
+
+	for(uint32 i = 0; i < numItems; i++)
+	{
+		Panel* panel = new Panel();
+		LayoutBox::Slot* panelSlot = list->Add(panel->MakeShared());
+		panelSlot->fillX = true;
+		panelSlot->padding = Margin(2);
+
+		LayoutBox* row = new LayoutBox();
+		row->layoutDirection = LayoutBox::Horizontal;
+		panel->SetContent(row->MakeShared());
+		for(uint32 j = 0; j < 4; j++)
+		{
+			FixedSizeElement* leaf = new FixedSizeElement(Vector2(50.0f, 20.0f));
+			LayoutBox::Slot* leafSlot = row->Add(leaf->MakeShared());
+			leafSlot->fillX = (j == 0);
+			leaves.Add(leaf);
+		}
+	}
+	return root;
+}
+
+static void LayoutPass(Ref<Canvas> root)
+{
+	GUIRenderData rd;
+	rd.guiRenderer = nullptr;
+	rd.rq = nullptr;
+	rd.area = Rect(0, 0, 1280, 720);
+	rd.deltaTime = 0.0f;
+	GUIElementBase* inputElement = nullptr;
+	root->PreRender(rd, inputElement);
+}
+
+Test("GUI.Layout.Retained")
+{
+	Vector<FixedSizeElement*> leaves;
+	Ref<Canvas> root = CreateTestLayout(50, leaves);
+
+	// First pass computes all sizes
+	FixedSizeElement::numSizeRequests = 0;
+	LayoutPass(root);
+	TestEnsure(FixedSizeElement::numSizeRequests > 0);
+
+	// A static layout should not compute anything again
+	FixedSizeElement::numSizeRequests = 0;
+	LayoutPass(root);
+	TestEnsure(FixedSizeElement::numSizeRequests == 0);
+
+	// Slot settings made while building the tree are detected in the first pass, which places the parents again in the second
+	//	after that all placements are kept
+	uint64 placementsStart = GUISlotBase::GetPlacementUpdates();
+	LayoutPass(root);
+	TestEnsure(GUISlotBase::GetPlacementUpdates() == placementsStart);
+
+	// Changing the last row only places the slots that lead to it again
+	placementsStart = GUISlotBase::GetPlacementUpdates();
+	leaves.back()->SetSize(Vector2(60.0f, 20.0f));
+	LayoutPass(root);
+	uint64 placements = GUISlotBase::GetPlacementUpdates() - placementsStart;
+	TestEnsure(placements > 0);
+	TestEnsure(placements < 10);
+
+	// Only the row containing the invalidated element should be asked for sizes again
+	FixedSizeElement::numSizeRequests = 0;
+	leaves[10]->SetSize(Vector2(80.0f, 30.0f));
+	LayoutPass(root);
+	TestEnsure(FixedSizeElement::numSizeRequests > 0);
+	TestEnsure(FixedSizeElement::numSizeRequests < leaves.size());
+
+	// Padding changes are picked up without explicit invalidation, one pass later for parent elements
+	FixedSizeElement::numSizeRequests = 0;
+	leaves[20]->slot->padding = Margin(4);
+	LayoutPass(root);
+	LayoutPass(root);
+	TestEnsure(FixedSizeElement::numSizeRequests > 0);
+	TestEnsure(FixedSizeElement::numSizeRequests < leaves.size());
+}
+
+Test("GUI.Layout.Benchmark")
+{
+	Vector<FixedSizeElement*> leaves;
+	Ref<Canvas> root = CreateTestLayout(500, leaves);
+	const uint32 numPasses = 200;
+
+	// Static layout
+	uint64 updatesStart = GUISlotBase::GetDesiredSizeUpdates();
+	Timer t;
+	for(uint32 i = 0; i < numPasses; i++)
+	{
+		LayoutPass(root);
+	}
+	float staticTime = t.SecondsAsFloat() * 1000.0f / numPasses;
+	uint64 staticUpdates = GUISlotBase::GetDesiredSizeUpdates() - updatesStart;
+
+	// Changing one element every pass
+	updatesStart = GUISlotBase::GetDesiredSizeUpdates();
+	t.Restart();
+	for(uint32 i = 0; i < numPasses; i++)
+	{
+		leaves[i % leaves.size()]->SetSize(Vector2(50.0f + (i % 2), 20.0f));
+		LayoutPass(root);
+	}
+	float dynamicTime = t.SecondsAsFloat() * 1000.0f / numPasses;
+	uint64 dynamicUpdates = GUISlotBase::GetDesiredSizeUpdates() - updatesStart;
+
+	Logf("Static layout: %.4f ms/pass, %d size updates", Logger::Info, staticTime, (int32)staticUpdates);
+	Logf("Single change layout: %.4f ms/pass, %d size updates", Logger::Info, dynamicTime, (int32)dynamicUpdates);
+
+	// Only the initial passes should compute sizes for a static layout
+	//	the second pass measures the rows again, since the slot settings made while building the tree are detected in the first
+	TestEnsure(staticUpdates <= leaves.size() * 5);
+}
@@ -0,0 +1,43 @@
+#include "stdafx.h"
+#include <Graphics/Image.hpp>
+#include <Graphics/ImageLoader.hpp>
+using namespace Graphics;
+
+Test("Image.Thumbnail")
+{
+	// Left half red, right half blue
+	Image source = ImageRes::Create(Vector2i(1024, 512));
+	Colori* bits = source->GetBits();
+	for(int32 y = 0; y < 512; y++)
+	{
+		for(int32 x = 0; x < 1024; x++)
+			bits[y * 1024 + x] = x < 512 ? Colori(255, 0, 0, 255) : Colori(0, 0, 255, 255);
+	}
+	String sourcePath = Path::Normalize(TestBasePath + "/thumbnail_source.jpg");
+	TestEnsure(ImageLoader::SaveJPEG(source.GetData(), sourcePath, 95));
+
+	Timer timer;
+	Image full = ImageRes::Create(sourcePath);
+	double fullTime = timer.SecondsAsDouble();
+	timer.Restart();
+	Image thumbnail = ImageRes::Create(sourcePath, Vector2i(64, 32));
+	double thumbnailTime = timer.SecondsAsDouble();
+	Logf("Full decode %.2f ms, thumbnail decode %.2f ms", Logger::Info, fullTime * 1000.0, thumbnailTime * 1000.0);
+
+	TestEnsure(full.IsValid() && full->GetSize().x == 1024 && full->GetSize().y == 512);
+	TestEnsure(thumbnail.IsValid() && thumbnail->GetSize().x == 64 && thumbnail->GetSize().y == 32);
+	const Colori* thumbnailBits = thumbnail->GetBits();
+	Colori left = thumbnailBits[16 * 64 + 8];
+	Colori right = thumbnailBits[16 * 64 + 56];
+	TestEnsure(left.x > 200 && left.z < 50);
+	TestEnsure(right.z > 200 && right.x < 50);
+
+	// Scaled to fit keeping the aspect ratio, never scaled up
+	Image fitted = ImageRes::Create(sourcePath, Vector2i(64, 64));
+	TestEnsure(fitted.IsValid() && fitted->GetSize().x == 64 && fitted->GetSize().y == 32);
+	fitted = ImageRes::Create(sourcePath, Vector2i(300, 100));
+	TestEnsure(fitted.IsValid() && fitted->GetSize().x == 200 && fitted->GetSize().y == 100);
+	Image small = ImageRes::Create(sourcePath, Vector2i(2048, 2048));
+	TestEnsure(small.IsValid() && small->GetSize().x == 1024 && small->GetSize().y == 512);
+	Path::Delete(sourcePath);
+}
@@ -0,0 +1,393 @@
+#include "stdafx.h"
+#include <Shared/MemoryStream.hpp>
+#include <Graphics/Window.hpp>
+#include <Graphics/Gamepad.hpp>
+using namespace Graphics;
+#include <Beatmap/Beatmap.hpp>
+#include <Scoring.hpp>
+#include <GameConfig.hpp>
+#include <GameplaySimulation.hpp>
+#include <HitStatistics.hpp>
+
+// Normally defined by the application
+GameConfig g_gameConfig;
+
+// 120 BPM, 8 lines per measure so every line is 250ms
+static const char* testChart =
+	"title=Input timing test\r\n"
+	"t=120\r\n"
+	"o=0\r\n"
+	"--\r\n"
+	"0000|00|--\r\n0000|00|--\r\n0000|00|--\r\n0000|00|--\r\n"
+	"0000|00|--\r\n0000|00|--\r\n0000|00|--\r\n0000|00|--\r\n"
+	"--\r\n"
+	"1000|00|--\r\n0100|00|--\r\n0010|00|--\r\n0001|00|--\r\n"
+	"1000|00|--\r\n0100|00|--\r\n0010|00|--\r\n0001|00|--\r\n"
+	"--\r\n"
+	"2000|00|--\r\n2000|00|--\r\n2000|00|--\r\n2000|00|--\r\n"
+	"0100|00|--\r\n0000|02|--\r\n0010|00|--\r\n0000|20|--\r\n"
+	"--\r\n"
+	"1100|00|--\r\n0000|00|--\r\n0011|00|--\r\n0000|00|--\r\n"
+	"0000|00|--\r\n0000|00|--\r\n0000|00|--\r\n0000|00|--\r\n"
+	"--\r\n";
+
+static bool LoadTestChart(Beatmap& beatmap)
+{
+	String chart = testChart;
+	Buffer chartData;
+	chartData.resize(chart.size());
+	memcpy(chartData.data(), chart.data(), chart.size());
+	MemoryReader reader(chartData);
+	return beatmap.Load(reader);
+}
+
+struct TimedInput
+{
+	MapTime time;
+	Input::Button button;
+	bool pressed;
+};
+
+// Presses every button note with a varying offset, leaves one note unpressed and adds an idle press
+static Vector<TimedInput> GenerateInput(const Beatmap& beatmap)
+{
+	static const MapTime offsets[] = { -37, -13, 0, 11, 29, 44, -60, 70, -95, 3 };
+	Vector<TimedInput> inputs;
+	uint32 noteIndex = 0;
+	for(ObjectState* obj : beatmap.GetLinearObjects())
+	{
+		if(obj->type == ObjectType::Single)
+		{
+			ButtonObjectState* button = (ButtonObjectState*)obj;
+			if(noteIndex++ == 5)
+				continue;
+			MapTime pressTime = obj->time + offsets[noteIndex % 10];
+			inputs.Add({ pressTime, (Input::Button)button->index, true });
+			inputs.Add({ pressTime + 30, (Input::Button)button->index, false });
+		}
+		else if(obj->type == ObjectType::Hold)
+		{
+			HoldObjectState* hold = (HoldObjectState*)obj;
+			inputs.Add({ obj->time - 7, (Input::Button)hold->index, true });
+			inputs.Add({ obj->time + hold->duration + 10, (Input::Button)hold->index, false });
+		}
+	}
+	inputs.Add({ 1500, Input::Button::BT_2, true });
+	inputs.Add({ 1520, Input::Button::BT_2, false });
+	std::stable_sort(inputs.begin(), inputs.end(), [](const TimedInput& l, const TimedInput& r)
+	{
+		return l.time < r.time;
+	});
+	return inputs;
+}
+
+struct ScoringResult
+{
+	uint32 score;
+	uint32 maxCombo;
+	uint32 categorizedHits[3];
+	// Object time, rating, delta and hold ticks of every judged object
+	Vector<String> judgements;
+};
+
+// Plays the chart at a fixed frame rate, feeding the input through the scoring input queue
+//	the input clock is aligned with the map time so inputTime is simply the frame time in seconds
+static ScoringResult SimulatePlay(Beatmap& beatmap, const Vector<TimedInput>& inputs, uint32 fps)
+{
+	BeatmapPlayback playback(beatmap);
+	playback.Reset();
+	Scoring scoring;
+	scoring.SetPlayback(playback);
+	scoring.Reset();
+
+	MapTime endTime = beatmap.GetLinearObjects().back()->time + 1000;
+	uint32 nextInput = 0;
+	float lastFrameTime = 0.0f;
+	for(uint32 frame = 0;; frame++)
+	{
+		MapTime frameTime = (MapTime)((uint64)frame * 1000 / fps);
+		if(frameTime > endTime)
+			break;
+
+		// Events that came in up to half a frame after sampling the playback position wait for the next tick
+		MapTime inputLimit = frameTime + 500 / fps;
+		while(nextInput < inputs.size() && inputs[nextInput].time <= inputLimit)
+		{
+			const TimedInput& ti = inputs[nextInput++];
+			InputEvent evt;
+			evt.button = ti.button;
+			evt.pressed = ti.pressed;
+			evt.time = ti.time / 1000.0;
+			scoring.GetInputQueue().Push(evt);
+		}
+
+		playback.Update(frameTime);
+		float deltaTime = frameTime / 1000.0f - lastFrameTime;
+		lastFrameTime = frameTime / 1000.0f;
+		scoring.Tick(deltaTime, frameTime / 1000.0);
+	}
+
+	ScoringResult result;
+	result.score = scoring.CalculateCurrentScore();
+	result.maxCombo = scoring.maxComboCounter;
+	memcpy(result.categorizedHits, scoring.categorizedHits, sizeof(result.categorizedHits));
+	for(HitStat* stat : scoring.hitStats)
+	{
+		// Misses without a button press store the time at which they were detected, which depends on the frame rate
+		MapTime delta = stat->rating == ScoreHitRating::Miss ? 0 : stat->delta;
+		result.judgements.Add(Utility::Sprintf("%d:%d:%d:%d", stat->object->time, (int32)stat->rating, delta, stat->hold));
+	}
+	std::sort(result.judgements.begin(), result.judgements.end());
+	return result;
+}
+
+Test("Scoring.FrameRateIndependence")
+{
+	Beatmap beatmap;
+	TestEnsure(LoadTestChart(beatmap));
+
+	Vector<TimedInput> inputs = GenerateInput(beatmap);
+
+	ScoringResult reference = SimulatePlay(beatmap, inputs, 240);
+	TestEnsure(reference.score > 0);
+	TestEnsure(!reference.judgements.empty());
+	// The skipped note is a miss
+	TestEnsure(reference.categorizedHits[0] > 0);
+
+	static const uint32 frameRates[] = { 30, 60 };
+	for(uint32 fps : frameRates)
+	{
+		ScoringResult result = SimulatePlay(beatmap, inputs, fps);
+		Logf("%d FPS: score %d, combo %d, %d/%d/%d", Logger::Info, fps, result.score, result.maxCombo,
+			result.categorizedHits[2], result.categorizedHits[1], result.categorizedHits[0]);
+		TestEnsure(result.score == reference.score);
+		TestEnsure(result.maxCombo == reference.maxCombo);
+		TestEnsure(memcmp(result.categorizedHits, reference.categorizedHits, sizeof(result.categorizedHits)) == 0);
+		TestEnsure(result.judgements == reference.judgements);
+	}
+}
+
+Test("Replay.Rescore")
+{
+	Beatmap beatmap;
+	TestEnsure(LoadTestChart(beatmap));
+
+	// Script the input on a fixed timestep, with some laser movement
+	Vector<ReplayEvent> script;
+	for(const TimedInput& ti : GenerateInput(beatmap))
+		script.Add({ ti.time, ti.button, ti.pressed });
+	MapTime endTime = beatmap.GetLinearObjects().back()->time + 1000;
+	Replay scripted = Replay::CreateScripted(script, -1000, endTime, 16);
+	for(uint32 i = 0; i < scripted.frames.size(); i += 7)
+		scripted.frames[i].laserInput[i % 2] = (float)(i % 5) * 0.01f - 0.02f;
+
+	// Record while scoring the script
+	GameplaySimulation simulation(beatmap);
+	Replay recorded;
+	Timer timer;
+	SimulationResult result = simulation.Run(scripted, &recorded);
+	float simulationTime = timer.SecondsAsFloat();
+	TestEnsure(result.score > 0);
+	TestEnsure(recorded.score == result.score);
+	TestEnsure(recorded.frames.size() == scripted.frames.size());
+	TestEnsure(recorded.events.size() == script.size());
+
+	// Save and load the recording
+	Buffer data;
+	MemoryWriter writer(data);
+	TestEnsure(recorded.Save(writer));
+	Replay loaded;
+	MemoryReader reader(data);
+	TestEnsure(loaded.Load(reader));
+	TestEnsure(loaded.frames.size() == recorded.frames.size());
+	TestEnsure(loaded.events.size() == recorded.events.size());
+	Logf("Replay of %d frames and %d events is %d bytes, simulated %d ms of gameplay in %.3f ms", Logger::Info,
+		(int32)loaded.frames.size(), (int32)loaded.events.size(), (int32)data.size(), endTime + 1000, simulationTime * 1000.0f);
+
+	// Scoring the loaded replay on a fresh chart gives the exact same result
+	Beatmap rescoreBeatmap;
+	TestEnsure(LoadTestChart(rescoreBeatmap));
+	GameplaySimulation rescore(rescoreBeatmap);
+	SimulationResult rescored = rescore.Run(loaded);
+	TestEnsure(rescored.score == loaded.score);
+	TestEnsure(rescored.maxCombo == result.maxCombo);
+	TestEnsure(memcmp(rescored.categorizedHits, result.categorizedHits, sizeof(result.categorizedHits)) == 0);
+	TestEnsure(memcmp(&rescored.gauge, &result.gauge, sizeof(float)) == 0);
+}
+
+// Chart with chips on every 16th, FX holds and lasers that sweep across the track every measure
+static String GenerateDenseChart(uint32 numMeasures)
+{
+	String chart = "title=Dense chart\r\nt=180\r\no=0\r\n--\r\n";
+	for(uint32 m = 0; m < numMeasures; m++)
+	{
+		for(uint32 l = 0; l < 16; l++)
+		{
+			char buttons[5] = "0000";
+			buttons[(l % 2 == 0) ? (l % 4) : ((l + 2) % 4)] = '1';
+			char fx[3] = "00";
+			fx[l < 8 ? 0 : 1] = '1';
+			char lasers[3] = "::";
+			if(l == 0)
+			{
+				lasers[0] = '0';
+				lasers[1] = 'o';
+			}
+			else if(l == 15)
+			{
+				lasers[0] = 'o';
+				lasers[1] = '0';
+			}
+			chart += Utility::Sprintf("%s|%s|%s\r\n", buttons, fx, lasers);
+		}
+		chart += "--\r\n";
+	}
+	return chart;
+}
+
+Test("Scoring.Benchmark")
+{
+	String chart = GenerateDenseChart(200);
+	Buffer chartData;
+	chartData.resize(chart.size());
+	memcpy(chartData.data(), chart.data(), chart.size());
+	MemoryReader reader(chartData);
+	Beatmap beatmap;
+	TestEnsure(beatmap.Load(reader));
+
+	// Autoplay at 240 FPS
+	MapTime endTime = beatmap.GetLinearObjects().back()->time + 1000;
+	Replay replay = Replay::CreateScripted(Vector<ReplayEvent>(), -1000, endTime, 4);
+	GameplaySimulation simulation(beatmap);
+	simulation.GetScoring().autoplay = true;
+
+	const uint32 numRuns = 5;
+	SimulationResult result;
+	Timer t;
+	for(uint32 i = 0; i < numRuns; i++)
+		result = simulation.Run(replay);
+	double runTime = t.SecondsAsDouble() / numRuns;
+
+	uint32 numTicks = result.categorizedHits[0] + result.categorizedHits[1] + result.categorizedHits[2];
+	Logf("Scored %d ticks over %d frames in %.3f ms, %.3f us per frame", Logger::Info,
+		numTicks, (int32)replay.frames.size(), runTime * 1000.0, runTime * 1000000.0 / replay.frames.size());
+	TestEnsure(numTicks == simulation.GetScoring().mapTotals.numSingles + simulation.GetScoring().mapTotals.numTicks);
+	TestEnsure(result.categorizedHits[0] == 0);
+}
+
+Test("Scoring.LaserHitStats")
+{
+	String chart = GenerateDenseChart(4);
+	Buffer chartData;
+	chartData.resize(chart.size());
+	memcpy(chartData.data(), chart.data(), chart.size());
+	MemoryReader reader(chartData);
+	Beatmap beatmap;
+	TestEnsure(beatmap.Load(reader));
+	ScoringTimeline timeline;
+	timeline.Build(beatmap);
+
+	// The lasers of this chart are chains with a segment per measure
+	uint32 numChains = 0;
+	uint32 numSegments = 0;
+	for(ObjectState* obj : beatmap.GetLinearObjects())
+	{
+		if(obj->type != ObjectType::Laser)
+			continue;
+		numSegments++;
+		if(!((LaserObjectState*)obj)->prev)
+			numChains++;
+	}
+	TestEnsure(numChains > 0);
+	TestEnsure(numSegments > numChains);
+
+	MapTime endTime = beatmap.GetLinearObjects().back()->time + 1000;
+	Replay replay = Replay::CreateScripted(Vector<ReplayEvent>(), -1000, endTime, 4);
+	GameplaySimulation simulation(beatmap);
+	simulation.GetScoring().autoplay = true;
+	simulation.Run(replay);
+
+	// Every chain is scored into a single stat of its root, which counts the ticks of all segments
+	uint32 numLaserStats = 0;
+	for(HitStat* stat : simulation.GetScoring().hitStats)
+	{
+		if(stat->object->type != ObjectType::Laser)
+			continue;
+		LaserObjectState* root = (LaserObjectState*)stat->object;
+		TestEnsure(root->prev == nullptr);
+		TestEnsure(stat->holdMax == timeline.GetNumTicks(*root));
+		TestEnsure(stat->hold == stat->holdMax);
+		numLaserStats++;
+	}
+	TestEnsure(numLaserStats == numChains);
+}
+
+Test("Scoring.Timeline")
+{
+	Beatmap beatmap;
+	TestEnsure(LoadTestChart(beatmap));
+	ScoringTimeline timeline;
+	timeline.Build(beatmap);
+	const MapTotals& totals = timeline.GetMapTotals();
+	TestEnsure(totals.numSingles == 16);
+	TestEnsure(totals.maxScore == 2 * (totals.numSingles + totals.numTicks));
+	TestEnsure(timeline.GetAllTicks().size() == totals.numSingles + totals.numTicks);
+
+	// Cached timeline restores the same ticks
+	Buffer data;
+	MemoryWriter writer(data);
+	TestEnsure(timeline.Save(writer, beatmap));
+	ScoringTimeline loaded;
+	MemoryReader reader(data);
+	TestEnsure(loaded.Load(reader, beatmap));
+	TestEnsure(memcmp(&loaded.GetMapTotals(), &totals, sizeof(MapTotals)) == 0);
+	TestEnsure(loaded.GetAllTicks().size() == timeline.GetAllTicks().size());
+	for(ObjectState* obj : beatmap.GetLinearObjects())
+	{
+		uint32 numTicks = 0, numLoadedTicks = 0;
+		const ScoreTick* ticks = timeline.GetTicks(obj, numTicks);
+		const ScoreTick* loadedTicks = loaded.GetTicks(obj, numLoadedTicks);
+		TestEnsure(numTicks == numLoadedTicks);
+		for(uint32 i = 0; i < numTicks; i++)
+		{
+			TestEnsure(ticks[i].time == loadedTicks[i].time && ticks[i].flags == loadedTicks[i].flags);
+			TestEnsure(ticks[i].object == loadedTicks[i].object && ticks[i].root == loadedTicks[i].root);
+		}
+	}
+}
+
+Test("Scoring.HitStatistics")
+{
+	static const MapTime deltas[] = { -37, -13, 0, 11, 29, 44, -60, 70, -95, 3, 3, -13 };
+	HitStatistics stats;
+	Vector<MapTime> sorted;
+	double sum = 0.0;
+	for(uint32 i = 0; i < sizeof(deltas) / sizeof(MapTime); i++)
+	{
+		MapTime delta = deltas[i];
+		ScoreHitRating rating = abs(delta) <= Scoring::perfectHitTime ? ScoreHitRating::Perfect : ScoreHitRating::Good;
+		stats.AddHit(i % 6, delta, rating);
+		sorted.Add(delta);
+		sum += delta;
+	}
+	stats.AddHit(0, 150, ScoreHitRating::Miss);
+	std::sort(sorted.begin(), sorted.end());
+
+	double mean = sum / sorted.size();
+	double variance = 0.0;
+	for(MapTime delta : sorted)
+		variance += (delta - mean) * (delta - mean);
+	variance /= sorted.size();
+
+	TestEnsure(stats.GetCount() == sorted.size());
+	TestEnsure(fabs(stats.GetMean() - mean) < 0.0001);
+	TestEnsure(fabs(stats.GetVariance() - variance) < 0.0001);
+	TestEnsure(stats.GetMedian() == sorted[sorted.size() / 2]);
+	TestEnsure(stats.GetPercentile(0.0f) == sorted.front());
+	TestEnsure(stats.GetPercentile(1.0f) == sorted.back());
+	TestEnsure(stats.GetPercentile(0.25f) == sorted[sorted.size() / 4]);
+	TestEnsure(stats.GetHistogram(-13) == 2);
+	// Only hits outside the perfect window are early or late
+	TestEnsure(stats.GetEarly() == 2 && stats.GetLate() == 2);
+	TestEnsure(stats.GetEarly(2) == 1 && stats.GetLate(1) == 1);
+}
@@ -0,0 +1,119 @@
+#include <Shared/Shared.hpp>
+#include <Shared/FramePacer.hpp>
+#include <Tests/Tests.hpp>
+
+// Simulated clock where sleeps wake up late by a varying amount
+class MockFrameClock : public IFrameClock
+{
+public:
+	virtual double GetTime() override
+	{
+		return time;
+	}
+	virtual void Sleep(double seconds) override
+	{
+		// Between 0.3 and 1.7ms late
+		time += seconds + 0.0003 + 0.0014 * (double)(numSleeps++ % 8) / 7.0;
+	}
+	virtual void Relax() override
+	{
+		time += 0.000005;
+		numSpins++;
+	}
+	// Simulates work being done
+	void Advance(double seconds)
+	{
+		time += seconds;
+	}
+
+	double time = 0.0;
+	uint32 numSleeps = 0;
+	uint32 numSpins = 0;
+};
+
+Test("FramePacer.Cadence")
+{
+	MockFrameClock clock;
+	FramePacer pacer(clock);
+	pacer.SetTargetFrameRate(144.0);
+	pacer.SetSimulationRate(240.0);
+	uint32 numPolls = 0;
+	pacer.onPoll.BindLambda([&]() { numPolls++; return true; });
+
+	const uint32 numFrames = 1000;
+	uint32 numSteps = 0;
+	for(uint32 i = 0; i < numFrames; i++)
+	{
+		TestEnsure(pacer.WaitForFrame());
+		numSteps += pacer.BeginFrame();
+		// Varying simulation/render time and a buffer swap
+		clock.Advance(0.002 + 0.001 * (double)(i % 3));
+		TestEnsure(pacer.WaitForPresent());
+		pacer.BeginPresent();
+		clock.Advance(0.0005);
+		pacer.EndPresent();
+	}
+
+	const double frameTime = 1.0 / 144.0;
+	double p50 = pacer.GetFrameTimePercentile(0.5f);
+	double p99 = pacer.GetFrameTimePercentile(0.99f);
+	Logf("Frame time p50: %.3fms p99: %.3fms, target %.3fms, spin margin %.3fms", Logger::Info,
+		p50 * 1000.0, p99 * 1000.0, frameTime * 1000.0, pacer.GetSpinMargin() * 1000.0);
+	TestEnsure(pacer.GetNumFrameSamples() == FramePacer::numSamples);
+	TestEnsure(fabs(p50 - frameTime) < 0.00005);
+	TestEnsure(fabs(p99 - frameTime) < 0.0001);
+	TestEnsure(fabs(pacer.GetPresentTimePercentile(0.5f) - 0.0005) < 0.00001);
+	// Sleeps are used for most of the wait and the oversleep is covered by spinning
+	TestEnsure(numPolls > 0);
+	TestEnsure(pacer.GetSpinMargin() > 0.001);
+
+	// Simulation runs at it's own rate
+	double elapsed = clock.time;
+	TestEnsure(abs((int32)numSteps - (int32)(elapsed * 240.0)) <= 2);
+}
+
+Test("FramePacer.Overload")
+{
+	MockFrameClock clock;
+	FramePacer pacer(clock);
+	pacer.SetTargetFrameRate(120.0);
+	pacer.SetSimulationRate(240.0);
+	pacer.SetMaxSimulationSteps(4);
+
+	for(uint32 i = 0; i < 300; i++)
+	{
+		TestEnsure(pacer.WaitForFrame());
+		uint32 numSteps = pacer.BeginFrame();
+		TestEnsure(numSteps <= 4);
+		// Frames take longer than the target, so no time is spent waiting
+		double before = clock.time;
+		clock.Advance(0.030);
+		TestEnsure(pacer.WaitForPresent());
+		pacer.BeginPresent();
+		pacer.EndPresent();
+		TestEnsure(clock.time - before < 0.0301);
+	}
+	TestEnsure(fabs(pacer.GetFrameTimePercentile(0.5f) - 0.030) < 0.0001);
+	TestEnsure(clock.numSleeps == 0);
+}
+
+Test("FramePacer.SkipPresent")
+{
+	MockFrameClock clock;
+	FramePacer pacer(clock);
+	pacer.SetTargetFrameRate(60.0);
+
+	// Frames that aren't presented still follow the target rate
+	const uint32 numFrames = 60;
+	for(uint32 i = 0; i < numFrames; i++)
+	{
+		TestEnsure(pacer.WaitForFrame());
+		pacer.BeginFrame();
+		clock.Advance(0.0001);
+		pacer.SkipPresent();
+	}
+	double elapsed = clock.time;
+	TestEnsure(fabs(elapsed - (double)(numFrames - 1) / 60.0) < 0.002);
+	TestEnsure(clock.numSleeps > 0);
+	TestEnsure(pacer.GetNumFrameSamples() == 0);
+}
@@ -0,0 +1,179 @@
+#include <Shared/Shared.hpp>
+#include <Shared/Jobs.hpp>
+#include <Tests/Tests.hpp>
+#include <thread>
+#include <atomic>
+
+// Waits until the counter reaches the given value
+static bool WaitForCount(const std::atomic<uint32>& counter, uint32 target, double timeout = 10.0)
+{
+	Timer timer;
+	while(counter < target)
+	{
+		if(timer.SecondsAsDouble() > timeout)
+			return false;
+		std::this_thread::yield();
+	}
+	return true;
+}
+
+Test("Jobs.Dependencies")
+{
+	JobSheduler sheduler(4);
+
+	// Two jobs that need to run before a third one
+	std::atomic<uint32> numRan(0);
+	std::atomic<uint32> order(0);
+	uint32 dependencyOrder[2] = { 0 };
+	uint32 continuationOrder = 0;
+	Job dependencies[2];
+	for(uint32 i = 0; i < 2; i++)
+	{
+		dependencies[i] = JobBase::CreateLambda([&, i]()
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(5 * (i + 1)));
+			dependencyOrder[i] = ++order;
+			numRan++;
+			return true;
+		});
+	}
+	Job continuation = JobBase::CreateLambda([&]()
+	{
+		continuationOrder = ++order;
+		numRan++;
+		return true;
+	});
+	uint32 numFinished = 0;
+	continuation->OnFinished.AddLambda([&](Job job) { numFinished++; });
+
+	TestEnsure(sheduler.Queue(dependencies[0]));
+	TestEnsure(sheduler.Queue(dependencies[1]));
+	TestEnsure(sheduler.Queue(continuation, { dependencies[0], dependencies[1] }));
+	TestEnsure(!sheduler.Queue(continuation));
+	TestEnsure(WaitForCount(numRan, 3));
+	TestEnsure(continuationOrder == 3);
+
+	sheduler.Update();
+	TestEnsure(numFinished == 1);
+	TestEnsure(continuation->IsFinished() && continuation->IsSuccessfull());
+	TestEnsure(!continuation->IsQueued());
+
+	// Parallel for covers every item exactly once, also when called from a job thread
+	const uint32 count = 10000;
+	Vector<uint32> hits(count, 0);
+	sheduler.ParallelFor(count, [&](uint32 begin, uint32 end)
+	{
+		for(uint32 i = begin; i < end; i++)
+			hits[i]++;
+	}, 64);
+	for(uint32 i = 0; i < count; i++)
+		TestEnsure(hits[i] == 1);
+
+	std::atomic<uint32> nestedSum(0);
+	std::atomic<uint32> nestedDone(0);
+	Job outer = JobBase::CreateLambda([&]()
+	{
+		sheduler.ParallelFor(100, [&](uint32 begin, uint32 end)
+		{
+			for(uint32 i = begin; i < end; i++)
+				nestedSum += i;
+		}, 8);
+		nestedDone++;
+		return true;
+	});
+	TestEnsure(sheduler.Queue(outer));
+	TestEnsure(WaitForCount(nestedDone, 1));
+	TestEnsure(nestedSum == 4950);
+	sheduler.Update();
+}
+
+Test("Jobs.IOPriority")
+{
+	JobSheduler sheduler(4, 2);
+
+	// A burst of IO jobs, like the jackets that come into view when scrolling
+	const uint32 numJobs = 20;
+	std::atomic<uint32> order(0);
+	std::atomic<uint32> numRan(0);
+	for(uint32 i = 0; i < numJobs; i++)
+	{
+		Job job = JobBase::CreateLambda([&]()
+		{
+			order++;
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+			numRan++;
+			return true;
+		});
+		job->jobFlags = JobFlags::IO;
+		TestEnsure(sheduler.Queue(job));
+	}
+
+	// Both IO slots are busy with the burst
+	TestEnsure(WaitForCount(order, 2));
+
+	// A high priority IO job queued after them takes the next free IO slot
+	uint32 highOrder = 0;
+	Job high = JobBase::CreateLambda([&]()
+	{
+		highOrder = ++order;
+		numRan++;
+		return true;
+	});
+	high->jobFlags = JobFlags::IO;
+	high->priority = JobPriority::High;
+	TestEnsure(sheduler.Queue(high));
+	TestEnsure(WaitForCount(numRan, numJobs + 1));
+	Logf("High priority IO job started as %d of %d", Logger::Info, highOrder, numJobs + 1);
+	TestEnsure(highOrder == 3);
+	sheduler.Update();
+}
+
+Test("Jobs.Latency")
+{
+	uint32 maxThreads = Math::Max(std::thread::hardware_concurrency(), 2u);
+	for(uint32 numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+	{
+		JobSheduler sheduler(numThreads);
+
+		// Jobs queued while all threads are idle
+		const uint32 numSingleJobs = 100;
+		std::atomic<uint32> numRan(0);
+		for(uint32 i = 0; i < numSingleJobs; i++)
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds(200));
+			Job job = JobBase::CreateLambda([&]() { numRan++; return true; });
+			TestEnsure(sheduler.Queue(job));
+			TestEnsure(WaitForCount(numRan, i + 1));
+		}
+		sheduler.Update();
+		JobShedulerStats idleStats = sheduler.GetStats();
+		// Latencies depend on the machine's load, so they are only logged below
+		TestEnsure(idleStats.numJobsStarted == numSingleJobs);
+
+		// Many small jobs
+		sheduler.ResetStats();
+		const uint32 numJobs = 20000;
+		numRan = 0;
+		Timer timer;
+		for(uint32 i = 0; i < numJobs; i++)
+		{
+			Job job = JobBase::CreateLambda([&]()
+			{
+				volatile uint32 work = 0;
+				for(uint32 j = 0; j < 1000; j++)
+					work = work + j;
+				numRan++;
+				return true;
+			});
+			sheduler.Queue(job);
+		}
+		TestEnsure(WaitForCount(numRan, numJobs, 60.0));
+		double duration = timer.SecondsAsDouble();
+		sheduler.Update();
+		JobShedulerStats stats = sheduler.GetStats();
+
+		Logf("%d threads: idle start latency avg %.3fms max %.3fms, %.0f jobs/s, loaded start latency avg %.3fms", Logger::Info,
+			numThreads, idleStats.averageLatency * 1000.0, idleStats.maxLatency * 1000.0,
+			(double)numJobs / duration, stats.averageLatency * 1000.0);
+	}
+}
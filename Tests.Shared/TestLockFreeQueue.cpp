@@ -0,0 +1,68 @@
+#include <Shared/Shared.hpp>
+#include <Shared/LockFreeQueue.hpp>
+#include <Tests/Tests.hpp>
+#include <thread>
+#include <atomic>
+
+Test("LockFreeQueue.Order")
+{
+	LockFreeQueue<int32> queue(5);
+	TestEnsure(queue.GetCapacity() == 8);
+
+	int32 value;
+	TestEnsure(!queue.Pop(value));
+	for(int32 i = 0; i < 8; i++)
+		TestEnsure(queue.Push(i));
+	// Full
+	TestEnsure(!queue.Push(8));
+
+	for(int32 i = 0; i < 8; i++)
+	{
+		TestEnsure(queue.Pop(value));
+		TestEnsure(value == i);
+	}
+	TestEnsure(!queue.Pop(value));
+}
+
+Test("LockFreeQueue.Threads")
+{
+	LockFreeQueue<uint32> queue(64);
+	const uint32 numProducers = 4;
+	const uint32 numItems = 20000;
+
+	std::atomic<uint64> sum(0);
+	std::atomic<uint32> numReceived(0);
+	auto consume = [&]()
+	{
+		uint32 value;
+		while(numReceived < numProducers * numItems)
+		{
+			if(queue.Pop(value))
+			{
+				sum += value;
+				numReceived++;
+			}
+		}
+	};
+
+	Vector<std::thread> threads;
+	for(uint32 p = 0; p < numProducers; p++)
+	{
+		threads.emplace_back([&]()
+		{
+			for(uint32 i = 1; i <= numItems; i++)
+			{
+				while(!queue.Push(i))
+					std::this_thread::yield();
+			}
+		});
+	}
+	threads.emplace_back(consume);
+	threads.emplace_back(consume);
+	for(auto& t : threads)
+		t.join();
+
+	uint64 expected = (uint64)numProducers * numItems * (numItems + 1) / 2;
+	TestEnsure(numReceived == numProducers * numItems);
+	TestEnsure(sum == expected);
+}
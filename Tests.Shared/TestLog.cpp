@@ -0,0 +1,48 @@
+#include <Shared/Shared.hpp>
+#include <Shared/File.hpp>
+#include <Tests/Tests.hpp>
+#include <thread>
+
+Test("Log.Async")
+{
+	Logger::Get().Flush();
+
+	// Logging from multiple threads only queues the messages
+	const uint32 numThreads = 4;
+	const uint32 numMessages = 250;
+	Vector<std::thread> threads;
+	Vector<double> times(numThreads, 0.0);
+	for(uint32 t = 0; t < numThreads; t++)
+	{
+		threads.emplace_back([&times, t]()
+		{
+			Timer timer;
+			for(uint32 i = 0; i < numMessages; i++)
+			{
+				Logf("Thread %d message %d", Logger::Info, t, i);
+			}
+			times[t] = timer.SecondsAsDouble();
+		});
+	}
+	for(auto& thread : threads)
+		thread.join();
+	double totalTime = 0.0;
+	for(double time : times)
+		totalTime += time;
+	Logf("Average Logf time: %.0fns, %d messages dropped", Logger::Info, totalTime / (numThreads * numMessages) * 1e9, (uint32)Logger::Get().GetNumDropped());
+
+	// Messages longer than a queued record still end up in the log
+	String longMessage = "Long message ";
+	while(longMessage.size() < 1000)
+		longMessage += "0123456789";
+	Logf("%s", Logger::Info, longMessage);
+	Logger::Get().Flush();
+
+	File file;
+	TestEnsure(file.OpenRead(Utility::Sprintf("log_%s.txt", Path::GetModuleName())));
+	String log;
+	log.resize(file.GetSize());
+	file.Read(&log.front(), log.size());
+	TestEnsure(log.find(longMessage) != String::npos);
+	TestEnsure(log.find(Utility::Sprintf("Thread %d message %d", numThreads - 1, numMessages - 1)) != String::npos);
+}
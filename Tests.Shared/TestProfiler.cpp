@@ -0,0 +1,97 @@
+#include <Shared/Shared.hpp>
+#include <Shared/Profiler.hpp>
+#include <Shared/File.hpp>
+#include <Tests/Tests.hpp>
+#include <thread>
+
+Test("Profiler.Zones")
+{
+	Profiler::SetThreadName("Test");
+	Profiler::SetEnabled(true);
+
+	for(uint32 frame = 0; frame < 3; frame++)
+	{
+		Profiler::BeginFrame();
+		PROFILE_ZONE("Frame Work");
+		for(uint32 i = 0; i < 2; i++)
+		{
+			PROFILE_ZONE("Step");
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		Profiler::Counter("Counter", frame);
+	}
+	Profiler::BeginFrame();
+
+	// The zones are summed per frame, in the order they started
+	const Vector<Profiler::FrameZone>& zones = Profiler::GetLastFrameZones();
+	TestEnsure(zones.size() == 2);
+	TestEnsure(strcmp(zones[0].name, "Frame Work") == 0 && zones[0].depth == 0 && zones[0].count == 1);
+	TestEnsure(strcmp(zones[1].name, "Step") == 0 && zones[1].depth == 1 && zones[1].count == 2);
+	TestEnsure(zones[1].duration >= 0.002 && zones[0].duration >= zones[1].duration);
+	TestEnsure(Profiler::GetLastFrameTime() >= zones[0].duration);
+
+	// Zones from other threads end up in the trace
+	std::thread worker([]()
+	{
+		Profiler::SetThreadName("Worker");
+		PROFILE_ZONE("Worker Zone");
+	});
+	worker.join();
+
+	String tracePath = Path::Absolute("profiler_test_trace.json");
+	TestEnsure(Profiler::ExportChromeTrace(tracePath));
+	File file;
+	TestEnsure(file.OpenRead(tracePath));
+	String trace;
+	trace.resize(file.GetSize());
+	file.Read(&trace.front(), trace.size());
+	file.Close();
+	Path::Delete(tracePath);
+	TestEnsure(trace.find("\"ph\":\"X\"") != String::npos);
+	TestEnsure(trace.find("Worker Zone") != String::npos);
+	TestEnsure(trace.find("\"name\":\"Worker\"") != String::npos);
+	TestEnsure(trace.find("\"name\":\"Counter\",\"ph\":\"C\"") != String::npos);
+
+	// Exporting while another thread wraps around its buffer
+	std::atomic<bool> stop(false);
+	std::atomic<uint32> numRecorded(0);
+	std::thread recorder([&]()
+	{
+		Profiler::SetThreadName("Recorder");
+		while(!stop)
+		{
+			PROFILE_ZONE("Recorder Zone");
+			numRecorded++;
+		}
+	});
+	while(numRecorded < Profiler::bufferSize)
+		std::this_thread::yield();
+	for(uint32 i = 0; i < 3; i++)
+	{
+		TestEnsure(Profiler::ExportChromeTrace(tracePath));
+	}
+	stop = true;
+	recorder.join();
+	Path::Delete(tracePath);
+
+	// Overhead of a zone while disabled
+	Profiler::SetEnabled(false);
+	const uint32 numZones = 1000000;
+	Timer timer;
+	for(uint32 i = 0; i < numZones; i++)
+	{
+		PROFILE_ZONE("Disabled");
+	}
+	double disabledTime = timer.SecondsAsDouble();
+	Profiler::SetEnabled(true);
+	timer.Restart();
+	for(uint32 i = 0; i < numZones; i++)
+	{
+		PROFILE_ZONE("Enabled");
+	}
+	double enabledTime = timer.SecondsAsDouble();
+	Profiler::SetEnabled(false);
+	// Timings depend on the machine, so they are only logged
+	Logf("Zone overhead: %.2fns disabled, %.2fns enabled", Logger::Info,
+		disabledTime / numZones * 1e9, enabledTime / numZones * 1e9);
+}
@@ -0,0 +1,133 @@
+#include <Shared/Shared.hpp>
+#include <Shared/ResourceManager.hpp>
+#include <Tests/Tests.hpp>
+#include <thread>
+#include <atomic>
+
+Test("SlotMap.Handles")
+{
+	SlotMap<int32> map;
+	SlotHandle handles[4];
+	for(int32 i = 0; i < 4; i++)
+		handles[i] = map.Add(i);
+	TestEnsure(map.size() == 4);
+
+	// Last item is moved into the removed item's place
+	TestEnsure(map.Remove(handles[1]));
+	TestEnsure(!map.Remove(handles[1]));
+	TestEnsure(map.size() == 3 && map[1] == 3);
+	TestEnsure(*map.Find(handles[3]) == 3);
+	TestEnsure(map.Find(handles[1]) == nullptr);
+
+	// The reused slot gets a new generation
+	SlotHandle reused = map.Add(4);
+	TestEnsure(reused.index == handles[1].index && reused != handles[1]);
+	TestEnsure(map.Find(handles[1]) == nullptr);
+	TestEnsure(*map.Find(reused) == 4);
+	TestEnsure(map.GetHandle(3) == reused);
+
+	map.clear();
+	TestEnsure(map.empty() && !map.Contains(handles[0]));
+}
+
+Test("Ref.DestroyWhileReleasing")
+{
+	struct Resource
+	{
+		std::atomic<int32>* numAlive;
+		Resource(std::atomic<int32>* numAlive) : numAlive(numAlive) { (*numAlive)++; }
+		~Resource() { (*numAlive)--; }
+	};
+
+	// Other threads copy and release references while the object is destroyed, it's deleted exactly once
+	std::atomic<int32> numAlive(0);
+	for(uint32 i = 0; i < 1000; i++)
+	{
+		Ref<Resource> resource = Utility::MakeRef(new Resource(&numAlive));
+		Vector<std::thread> threads;
+		for(uint32 t = 0; t < 2; t++)
+		{
+			threads.emplace_back([copy = resource]() mutable
+			{
+				for(uint32 j = 0; j < 10; j++)
+				{
+					Ref<Resource> other = copy;
+				}
+				copy.Release();
+			});
+		}
+		resource.Destroy();
+		for(auto& thread : threads)
+			thread.join();
+		TestEnsure(numAlive == 0);
+	}
+}
+
+Test("ResourceManager.IncrementalGC")
+{
+	struct Resource
+	{
+		std::atomic<int32>* numAlive;
+		Resource(std::atomic<int32>* numAlive) : numAlive(numAlive) { (*numAlive)++; }
+		~Resource() { (*numAlive)--; }
+	};
+
+	ResourceManager<Resource> manager;
+	std::atomic<int32> numAlive(0);
+	const uint32 numResources = 1000;
+	Vector<Ref<Resource>> kept;
+	SlotHandle keptHandle, releasedHandle;
+	for(uint32 i = 0; i < numResources; i++)
+	{
+		SlotHandle handle;
+		Ref<Resource> resource = manager.Register(new Resource(&numAlive), &handle);
+		if(i % 4 == 0)
+		{
+			kept.Add(resource);
+			keptHandle = handle;
+		}
+		else
+		{
+			releasedHandle = handle;
+		}
+	}
+	TestEnsure(numAlive == numResources);
+
+	// Release the unused references on other threads
+	Vector<Ref<Resource>> shared = kept;
+	Vector<std::thread> threads;
+	for(uint32 t = 0; t < 4; t++)
+	{
+		threads.emplace_back([=]() mutable
+		{
+			for(uint32 i = 0; i < 1000; i++)
+			{
+				Vector<Ref<Resource>> copy = shared;
+				copy.clear();
+			}
+			shared.clear();
+		});
+	}
+	for(auto& thread : threads)
+		thread.join();
+	shared.clear();
+	TestEnsure(kept[0].GetRefCount() == 2);
+
+	// Every call checks a limited number of objects
+	manager.GarbageCollect(100);
+	TestEnsure(numAlive > (int32)numResources / 4);
+	TestEnsure(numAlive < (int32)numResources);
+	uint32 numCalls = 1;
+	while(numAlive > (int32)kept.size())
+	{
+		manager.GarbageCollect(100);
+		numCalls++;
+	}
+	TestEnsure(numCalls == numResources / 100);
+	TestEnsure(manager.GetNumObjects() == kept.size());
+	TestEnsure(manager.Get(keptHandle) == kept.back());
+	TestEnsure(!manager.Get(releasedHandle));
+
+	manager.ReleaseAll();
+	TestEnsure(numAlive == 0);
+}
@@ -1,6 +1,6 @@
 #version 330
 #extension GL_ARB_separate_shader_objects : enable
-layout(location=0) in vec2 inPos;
+layout(location=0) in vec3 inPos;
 layout(location=1) in vec2 inTex;
 
 out gl_PerVertex
@@ -16,5 +16,5 @@ uniform mat4 world;
 void main()
 {
 	fsTex = inTex;
-	gl_Position = proj * camera * world * vec4(inPos.xy, 0, 1);
+	gl_Position = proj * camera * world * vec4(inPos, 1);
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #extension GL_ARB_separate_shader_objects : enable
 
 layout(location=1) in vec2 fsTex;
+layout(location=2) in vec4 fsColor;
 layout(location=0) out vec4 target;
 
 uniform sampler2D mainTex;
@@ -10,5 +11,5 @@ uniform vec4 color;
 void main()
 {
 	float alpha = texelFetch(mainTex, ivec2(fsTex), 0).a;
-	target = vec4(color.xyz, alpha * color.a);
+	target = vec4(color.xyz * fsColor.xyz, alpha * color.a * fsColor.a);
 }
\ No newline at end of file
@@ -3,12 +3,14 @@
 
 layout(location=0) in vec2 inPos;
 layout(location=1) in vec2 inTex;
+layout(location=2) in vec4 inColor;
 
 out gl_PerVertex
 {
 	vec4 gl_Position;
 };
 layout(location=1) out vec2 fsTex;
+layout(location=2) out vec4 fsColor;
 
 uniform mat4 proj;
 uniform mat4 world;
@@ -16,5 +18,6 @@ uniform mat4 world;
 void main()
 {
 	fsTex = inTex;
+	fsColor = inColor;
 	gl_Position = proj * world * vec4(inPos.xy, 0, 1);
 }
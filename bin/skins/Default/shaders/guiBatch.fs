@@ -0,0 +1,15 @@
+#version 330
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(location=1) in vec2 fsTex;
+layout(location=2) in vec4 fsColor;
+layout(location=0) out vec4 target;
+
+uniform sampler2D mainTex;
+
+void main()
+{
+	// Untextured quads have negative texture coordinates
+	vec4 texColor = fsTex.x < 0.0 ? vec4(1.0) : texture(mainTex, fsTex);
+	target = texColor * fsColor;
+}
\ No newline at end of file
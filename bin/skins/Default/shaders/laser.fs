@@ -2,14 +2,17 @@
 #extension GL_ARB_separate_shader_objects : enable
 
 layout(location=1) in vec2 fsTex;
+layout(location=2) in float fsObjectGlow;
+// 20Hz flickering. 0 = Miss, 1 = Inactive, 2 & 3 = Active alternating.
+layout(location=3) flat in int fsHitState;
+// 0 = Laser, 1 = Entry, 2 = Exit
+layout(location=4) flat in int fsTexture;
 layout(location=0) out vec4 target;
 
 uniform sampler2D mainTex;
+uniform sampler2D entryTex;
+uniform sampler2D exitTex;
 uniform vec4 color;
-uniform float objectGlow;
-
-// 20Hz flickering. 0 = Miss, 1 = Inactive, 2 & 3 = Active alternating.
-uniform int hitState;
 
 void main()
 {	
@@ -18,8 +21,14 @@ void main()
     x -= 0.5;
     x /= laserSize;
     x += 0.5;
-	vec4 mainColor = texture(mainTex, vec2(x,fsTex.y));
+	vec4 mainColor;
+	if(fsTexture == 1)
+		mainColor = texture(entryTex, vec2(x,fsTex.y));
+	else if(fsTexture == 2)
+		mainColor = texture(exitTex, vec2(x,fsTex.y));
+	else
+		mainColor = texture(mainTex, vec2(x,fsTex.y));
 	target = mainColor * color;
 	float brightness = (target.x + target.y + target.z) / 3;
-	target.xyz = target.xyz * (0.5 + objectGlow);
+	target.xyz = target.xyz * (0.5 + fsObjectGlow);
 }
\ No newline at end of file
@@ -1,13 +1,18 @@
 #version 330
 #extension GL_ARB_separate_shader_objects : enable
-layout(location=0) in vec2 inPos;
+layout(location=0) in vec3 inPos;
 layout(location=1) in vec2 inTex;
+// Object glow, hit state and texture index
+layout(location=2) in vec3 inParams;
 
 out gl_PerVertex
 {
 	vec4 gl_Position;
 };
 layout(location=1) out vec2 fsTex;
+layout(location=2) out float fsObjectGlow;
+layout(location=3) flat out int fsHitState;
+layout(location=4) flat out int fsTexture;
 
 uniform mat4 proj;
 uniform mat4 camera;
@@ -16,5 +21,8 @@ uniform mat4 world;
 void main()
 {
 	fsTex = inTex;
-	gl_Position = proj * camera * world * vec4(inPos.xy, 0, 1);
+	fsObjectGlow = inParams.x;
+	fsHitState = int(inParams.y);
+	fsTexture = int(inParams.z);
+	gl_Position = proj * camera * world * vec4(inPos, 1);
 }
\ No newline at end of file